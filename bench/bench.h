@@ -0,0 +1,95 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <functional>
+
+/**
+ *  @brief Heap allocations (malloc, calloc, realloc, new) since the start of the program
+ */
+uint64_t BenchAllocations();
+
+/**
+ *  @brief Iterations of one benchmark.
+ *
+ *  The body runs while KeepRunning() is true. The number of iterations is
+ *  grown until the run lasts long enough to be measured.
+ */
+class BenchState
+{
+public:
+	BenchState( uint64_t iterations ) : iterations_(iterations), count_(0) {}
+
+	bool KeepRunning()
+	{
+		return count_++ < iterations_;
+	}
+
+	uint64_t Iterations() const
+	{
+		return iterations_;
+	}
+
+private:
+	uint64_t iterations_;
+	uint64_t count_;
+};
+
+typedef std::function< void( BenchState& state ) > BenchFunction;
+
+/**
+ *  @brief Registered benchmarks
+ */
+class BenchRegistry
+{
+public:
+	struct Bench
+	{
+		std::string name;
+		BenchFunction function;
+	};
+
+	static std::vector< Bench >& Benches();
+
+	BenchRegistry( const char* name, BenchFunction function )
+	{
+		Bench bench = { name, function };
+		Benches().push_back(bench);
+	}
+};
+
+/**
+ *  @brief Define and register a benchmark
+ */
+#define BENCH(name) \
+	static void name( BenchState& state ); \
+	static BenchRegistry name##_registry( #name, name ); \
+	static void name( BenchState& state )
+
+/**
+ *  @brief Keep the compiler from removing a computed value
+ */
+template< typename T > static inline void BenchKeep( const T& value )
+{
+	asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ *  @brief      Waypoints of a realistic route, along a line around Tokyo
+ *  @param[in]  count Number of waypoints
+ *  @return     Latitude and longitude of each waypoint
+ */
+static inline std::vector< std::tuple< double, double > > BenchWaypoints( size_t count )
+{
+	std::vector< std::tuple< double, double > > waypoints;
+	for (size_t i = 0; i < count; i++)
+	{
+		waypoints.push_back( std::make_tuple( 35.6586125 + 0.0012345 * i, 139.7454316 - 0.0023456 * i ) );
+	}
+	return waypoints;
+}
@@ -0,0 +1,165 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "bench.h"
+#include "analyze_request.h"
+#include <stdio.h>
+
+/**
+ *  @brief      Request as parsed by the binder
+ *  @param[in]  text JSON text of the request
+ *  @return     Parsed request
+ */
+static json_object* Request( const char* text )
+{
+	return json_tokener_parse(text);
+}
+
+/**
+ *  @brief      navicore_setwaypoints request as sent by libnavi
+ *  @param[in]  count Number of waypoints
+ *  @return     Parsed request
+ */
+static json_object* SetWaypointsRequest( size_t count )
+{
+	json_object* request = Request("{ \"sessionHandle\": 1, \"route\": 12, \"startFromCurrentPosition\": true }");
+	json_object* waypoints = json_object_new_array();
+
+	std::vector< std::tuple< double, double > > list = BenchWaypoints( count );
+	for (size_t i = 0; i < list.size(); i++)
+	{
+		json_object* point = json_object_new_object();
+		json_object_object_add(point, "latitude", json_object_new_double(std::get<0>(list[i])));
+		json_object_object_add(point, "longitude", json_object_new_double(std::get<1>(list[i])));
+		json_object_array_add(waypoints, point);
+	}
+	json_object_object_add(request, "", waypoints);
+
+	return request;
+}
+
+BENCH(AnalyzeRequest_GetPosition)
+{
+	AnalyzeRequest analyzeRequest;
+	json_object* request = Request("{ \"valuesToReturn\": [ 160, 161, 163, 227 ], \"maxAge\": 100 }");
+
+	while( state.KeepRunning() )
+	{
+		uint32_t mask = 0;
+		uint32_t maxAge = 0;
+		uint32_t horizon = 0;
+		BenchKeep( analyzeRequest.CreateParamsGetPosition( request, mask, maxAge, horizon ) );
+	}
+
+	json_object_put(request);
+}
+
+BENCH(AnalyzeRequest_CreateRoute)
+{
+	AnalyzeRequest analyzeRequest;
+	json_object* request = Request("{ \"sessionHandle\": 1 }");
+
+	while( state.KeepRunning() )
+	{
+		uint32_t sessionHdl = 0;
+		BenchKeep( analyzeRequest.CreateParamsCreateRoute( request, sessionHdl ) );
+	}
+
+	json_object_put(request);
+}
+
+BENCH(AnalyzeRequest_PauseSimulation)
+{
+	AnalyzeRequest analyzeRequest;
+	json_object* request = Request("{ \"sessionHandle\": 1 }");
+
+	while( state.KeepRunning() )
+	{
+		uint32_t sessionHdl = 0;
+		BenchKeep( analyzeRequest.CreateParamsPauseSimulation( request, sessionHdl ) );
+	}
+
+	json_object_put(request);
+}
+
+BENCH(AnalyzeRequest_SetSimulationMode)
+{
+	AnalyzeRequest analyzeRequest;
+	json_object* request = Request("{ \"sessionHandle\": 1, \"simulationMode\": true }");
+
+	while( state.KeepRunning() )
+	{
+		uint32_t sessionHdl = 0;
+		bool simuMode = false;
+		BenchKeep( analyzeRequest.CreateParamsSetSimulationMode( request, sessionHdl, simuMode ) );
+	}
+
+	json_object_put(request);
+}
+
+BENCH(AnalyzeRequest_CancelRouteCalculation)
+{
+	AnalyzeRequest analyzeRequest;
+	json_object* request = Request("{ \"sessionHandle\": 1, \"route\": 12 }");
+
+	while( state.KeepRunning() )
+	{
+		uint32_t sessionHdl = 0;
+		uint32_t routeHdl = 0;
+		BenchKeep( analyzeRequest.CreateParamsCancelRouteCalculation( request, sessionHdl, routeHdl ) );
+	}
+
+	json_object_put(request);
+}
+
+BENCH(AnalyzeRequest_CalculateRoute)
+{
+	AnalyzeRequest analyzeRequest;
+	json_object* request = Request("{ \"sessionHandle\": 1, \"route\": 12 }");
+
+	while( state.KeepRunning() )
+	{
+		uint32_t sessionHdl = 0;
+		uint32_t routeHdl = 0;
+		BenchKeep( analyzeRequest.CreateParamsCalculateRoute( request, sessionHdl, routeHdl ) );
+	}
+
+	json_object_put(request);
+}
+
+/**
+ *  @brief      Analyze a navicore_setwaypoints request
+ *  @param[in]  state Iterations
+ *  @param[in]  count Number of waypoints
+ */
+static void SetWaypoints( BenchState& state, size_t count )
+{
+	AnalyzeRequest analyzeRequest;
+	json_object* request = SetWaypointsRequest( count );
+
+	while( state.KeepRunning() )
+	{
+		uint32_t sessionHdl = 0;
+		uint32_t routeHdl = 0;
+		bool currentPos = false;
+		std::vector< Waypoint > waypointsList;
+		BenchKeep( analyzeRequest.CreateParamsSetWaypoints( request, sessionHdl, routeHdl, currentPos, waypointsList ) );
+	}
+
+	json_object_put(request);
+}
+
+BENCH(AnalyzeRequest_SetWaypoints_2)
+{
+	SetWaypoints( state, 2 );
+}
+
+BENCH(AnalyzeRequest_SetWaypoints_20)
+{
+	SetWaypoints( state, 20 );
+}
+
+BENCH(AnalyzeRequest_SetWaypoints_500)
+{
+	SetWaypoints( state, 500 );
+}
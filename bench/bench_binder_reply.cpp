@@ -0,0 +1,186 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "bench.h"
+#include "binder_reply.h"
+#include "genivi/genivi-navicore-constants.h"
+
+/**
+ *  @brief  Position as returned by Genivi for the default keys of libnavi
+ */
+static NaviPosition Position()
+{
+	NaviPosition position = {0};
+	position.mask = (1u << NAVI_POSITION_LATITUDE) | (1u << NAVI_POSITION_LONGITUDE)
+				  | (1u << NAVI_POSITION_HEADING) | (1u << NAVI_POSITION_SIMULATION_MODE);
+	position.latitude = 35.6586125;
+	position.longitude = 139.7454316;
+	position.heading = 271;
+	position.simulationMode = true;
+	return position;
+}
+
+/**
+ *  @brief      Serialize a response as the binder does, then release it
+ *  @param[in]  response Response to return
+ */
+static void Send( APIResponse& response )
+{
+	BenchKeep( json_object_to_json_string(response.json_data) );
+	json_object_put(response.json_data);
+}
+
+/**
+ *  @brief      Build a position response and serialize it as the binder does
+ *  @param[in]  state Iterations
+ *  @param[in]  mode Response building mode
+ */
+static void ReplyPosition( BenchState& state, BinderReplyMode mode )
+{
+	BinderReply binderReply;
+	binderReply.SetMode( mode );
+	NaviPosition position = Position();
+
+	while( state.KeepRunning() )
+	{
+		APIResponse response = binderReply.ReplyNavicoreGetPosition( position, 0 );
+		Send( response );
+	}
+}
+
+BENCH(BinderReply_GetPosition_Tree)
+{
+	ReplyPosition( state, BINDER_REPLY_MODE_TREE );
+}
+
+BENCH(BinderReply_GetPosition_Template)
+{
+	ReplyPosition( state, BINDER_REPLY_MODE_TEMPLATE );
+}
+
+BENCH(BinderReply_GetAllRoutes_4)
+{
+	BinderReply binderReply;
+	std::vector< uint32_t > allRoutes;
+	for (uint32_t route = 1; route <= 4; route++)
+	{
+		allRoutes.push_back(route);
+	}
+
+	while( state.KeepRunning() )
+	{
+		APIResponse response = binderReply.ReplyNavicoreGetAllRoutes( allRoutes );
+		Send( response );
+	}
+}
+
+BENCH(BinderReply_CreateRoute)
+{
+	BinderReply binderReply;
+
+	while( state.KeepRunning() )
+	{
+		APIResponse response = binderReply.ReplyNavicoreCreateRoute( 12 );
+		Send( response );
+	}
+}
+
+BENCH(BinderReply_GetAllSessions_3)
+{
+	BinderReply binderReply;
+	std::map< uint32_t, std::string > allSessions;
+	allSessions[1] = "navigation";
+	allSessions[2] = "cluster";
+	allSessions[3] = "voice";
+
+	while( state.KeepRunning() )
+	{
+		APIResponse response = binderReply.ReplyNavicoreGetAllSessions( allSessions );
+		Send( response );
+	}
+}
+
+/**
+ *  @brief      Return a response shared by the requests and serialize it as the binder does
+ *  @param[in]  state Iterations
+ *  @param[in]  mode Response building mode
+ */
+static void ReplySessionsShared( BenchState& state, BinderReplyMode mode )
+{
+	BinderReply binderReply;
+	binderReply.SetMode( mode );
+	std::map< uint32_t, std::string > allSessions;
+	allSessions[1] = "navigation";
+	allSessions[2] = "cluster";
+	allSessions[3] = "voice";
+	std::shared_ptr< json_object > shared = binderReply.Share( binderReply.ReplyNavicoreGetAllSessions( allSessions ) );
+
+	while( state.KeepRunning() )
+	{
+		APIResponse response = binderReply.ReplyShared( shared );
+		Send( response );
+	}
+}
+
+BENCH(BinderReply_GetAllSessions_3_Shared)
+{
+	ReplySessionsShared( state, BINDER_REPLY_MODE_TREE );
+}
+
+BENCH(BinderReply_GetAllSessions_3_Shared_Template)
+{
+	ReplySessionsShared( state, BINDER_REPLY_MODE_TEMPLATE );
+}
+
+/**
+ *  @brief      Page of route segments along a straight road, about 20 m each
+ *  @param[in]  count Number of segments
+ *  @return     Segments as returned by Genivi
+ */
+static std::vector< RouteSegment > RouteSegments( size_t count )
+{
+	std::vector< RouteSegment > segments;
+	double latitude = 35.6586125;
+	double longitude = 139.7454316;
+	for (size_t i = 0; i < count; i++)
+	{
+		RouteSegment segment;
+		segment.startLatitude = latitude;
+		segment.startLongitude = longitude;
+		latitude += 0.00012;
+		longitude += 0.00015;
+		segment.endLatitude = latitude;
+		segment.endLongitude = longitude;
+		segment.distance = 20.5;
+		segment.time = 1;
+		segments.push_back(segment);
+	}
+	return segments;
+}
+
+/**
+ *  @brief      Build a page of route segments and serialize it as the binder does
+ *  @param[in]  state Iterations
+ *  @param[in]  encoding How the segments are returned
+ */
+static void ReplyRouteSegments( BenchState& state, RouteSegmentsEncoding encoding )
+{
+	BinderReply binderReply;
+	std::vector< RouteSegment > segments = RouteSegments( ROUTE_SEGMENTS_DEFAULT_LIMIT );
+
+	while( state.KeepRunning() )
+	{
+		APIResponse response = binderReply.ReplyNavicoreGetRouteSegments( 12, 15000, 0, segments, encoding, ROUTE_SEGMENTS_DEFAULT_PRECISION );
+		Send( response );
+	}
+}
+
+BENCH(BinderReply_GetRouteSegments_1000_Json)
+{
+	ReplyRouteSegments( state, ROUTE_SEGMENTS_ENCODING_JSON );
+}
+
+BENCH(BinderReply_GetRouteSegments_1000_Polyline)
+{
+	ReplyRouteSegments( state, ROUTE_SEGMENTS_ENCODING_POLYLINE );
+}
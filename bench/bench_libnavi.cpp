@@ -0,0 +1,201 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "bench.h"
+#include "JsonRequestGenerator.h"
+#include "JsonResponseAnalyzer.h"
+
+/**
+ *  @brief      Reply of the binder as received by libnavi
+ *  @param[in]  response JSON text of the response
+ *  @return     JSON text of the whole reply
+ */
+static std::string Reply( const char* response )
+{
+	return std::string("{ \"jtype\": \"afb-reply\", \"request\": { \"status\": \"success\", \"info\": \"navicore\" }, \"response\": ")
+		+ response + " }";
+}
+
+static const char* positionResponse =
+	"[ { \"key\": 160, \"value\": 35.658612499999998 }, { \"key\": 161, \"value\": 139.74543160000001 }, "
+	"{ \"key\": 163, \"value\": 271 }, { \"key\": 227, \"value\": true } ]";
+
+BENCH(JsonRequestGenerator_GetPosition)
+{
+	std::vector< int32_t > valuesToReturn;
+	valuesToReturn.push_back(naviapi::NAVICORE_LATITUDE);
+	valuesToReturn.push_back(naviapi::NAVICORE_LONGITUDE);
+	valuesToReturn.push_back(naviapi::NAVICORE_HEADING);
+	valuesToReturn.push_back(naviapi::NAVICORE_SIMULATION_MODE);
+
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonRequestGenerator::CreateRequestGetPosition( valuesToReturn ) );
+	}
+}
+
+BENCH(JsonRequestGenerator_GetAllRoutes)
+{
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonRequestGenerator::CreateRequestGetAllRoutes() );
+	}
+}
+
+BENCH(JsonRequestGenerator_CreateRoute)
+{
+	uint32_t sessionHandle = 1;
+
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonRequestGenerator::CreateRequestCreateRoute( &sessionHandle ) );
+	}
+}
+
+BENCH(JsonRequestGenerator_PauseSimulation)
+{
+	uint32_t sessionHandle = 1;
+
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonRequestGenerator::CreateRequestPauseSimulation( &sessionHandle ) );
+	}
+}
+
+BENCH(JsonRequestGenerator_SetSimulationMode)
+{
+	uint32_t sessionHandle = 1;
+	bool activate = true;
+
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonRequestGenerator::CreateRequestSetSimulationMode( &sessionHandle, &activate ) );
+	}
+}
+
+BENCH(JsonRequestGenerator_CancelRouteCalculation)
+{
+	uint32_t sessionHandle = 1;
+	uint32_t routeHandle = 12;
+
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonRequestGenerator::CreateRequestCancelRouteCalculation( &sessionHandle, &routeHandle ) );
+	}
+}
+
+/**
+ *  @brief      Generate a navicore_setwaypoints request
+ *  @param[in]  state Iterations
+ *  @param[in]  count Number of waypoints
+ */
+static void SetWaypoints( BenchState& state, size_t count )
+{
+	uint32_t sessionHandle = 1;
+	uint32_t routeHandle = 12;
+	bool startFromCurrentPosition = true;
+	std::vector< naviapi::Waypoint > waypointsList = BenchWaypoints( count );
+
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonRequestGenerator::CreateRequestSetWaypoints( &sessionHandle, &routeHandle, &startFromCurrentPosition, &waypointsList ) );
+	}
+}
+
+BENCH(JsonRequestGenerator_SetWaypoints_2)
+{
+	SetWaypoints( state, 2 );
+}
+
+BENCH(JsonRequestGenerator_SetWaypoints_20)
+{
+	SetWaypoints( state, 20 );
+}
+
+BENCH(JsonRequestGenerator_SetWaypoints_500)
+{
+	SetWaypoints( state, 500 );
+}
+
+BENCH(JsonRequestGenerator_CalculateRoute)
+{
+	uint32_t sessionHandle = 1;
+	uint32_t routeHandle = 12;
+
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonRequestGenerator::CreateRequestCalculateroute( &sessionHandle, &routeHandle ) );
+	}
+}
+
+BENCH(JsonRequestGenerator_GetAllSessions)
+{
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonRequestGenerator::CreateRequestGetAllSessions() );
+	}
+}
+
+BENCH(JsonRequestGenerator_SetupRoute_20)
+{
+	bool startFromCurrentPosition = true;
+	std::vector< naviapi::Waypoint > waypointsList = BenchWaypoints( 20 );
+
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonRequestGenerator::CreateRequestSetupRoute( &startFromCurrentPosition, &waypointsList ) );
+	}
+}
+
+BENCH(JsonResponseAnalyzer_GetPosition)
+{
+	std::string reply = Reply( positionResponse );
+
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonResponseAnalyzer::AnalyzeResponseGetPosition( reply ) );
+	}
+}
+
+BENCH(JsonResponseAnalyzer_GetAllRoutes)
+{
+	std::string reply = Reply( "[ { \"route\": 1 }, { \"route\": 2 }, { \"route\": 3 }, { \"route\": 4 } ]" );
+
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonResponseAnalyzer::AnalyzeResponseGetAllRoutes( reply ) );
+	}
+}
+
+BENCH(JsonResponseAnalyzer_CreateRoute)
+{
+	std::string reply = Reply( "{ \"route\": 12 }" );
+
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonResponseAnalyzer::AnalyzeResponseCreateRoute( reply ) );
+	}
+}
+
+BENCH(JsonResponseAnalyzer_GetAllSessions)
+{
+	std::string reply = Reply( "[ { \"sessionHandle\": 1, \"client\": \"navigation\" }, "
+	                           "{ \"sessionHandle\": 2, \"client\": \"cluster\" }, "
+	                           "{ \"sessionHandle\": 3, \"client\": \"voice\" } ]" );
+
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonResponseAnalyzer::AnalyzeResponseGetAllSessions( reply ) );
+	}
+}
+
+BENCH(JsonResponseAnalyzer_EventPosition)
+{
+	std::string event = std::string("{ \"jtype\": \"afb-event\", \"event\": \"naviapi/position/0\", \"data\": ")
+		+ positionResponse + " }";
+
+	while( state.KeepRunning() )
+	{
+		BenchKeep( JsonResponseAnalyzer::AnalyzeEventPosition( event ) );
+	}
+}
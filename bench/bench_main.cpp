@@ -0,0 +1,110 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "bench.h"
+#include "binder_time.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <atomic>
+
+/**
+ *  @brief Minimum duration of a measured run (usec)
+ */
+#define BENCH_MIN_TIME	200000
+
+/**
+ *  Heap allocations are counted by wrapping the glibc allocator
+ */
+extern "C" void* __libc_malloc( size_t size );
+extern "C" void* __libc_calloc( size_t count, size_t size );
+extern "C" void* __libc_realloc( void* ptr, size_t size );
+
+static std::atomic< uint64_t > allocations( 0 );
+
+extern "C" void* malloc( size_t size )
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	return __libc_malloc(size);
+}
+
+extern "C" void* calloc( size_t count, size_t size )
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc( void* ptr, size_t size )
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	return __libc_realloc(ptr, size);
+}
+
+uint64_t BenchAllocations()
+{
+	return allocations.load(std::memory_order_relaxed);
+}
+
+std::vector< BenchRegistry::Bench >& BenchRegistry::Benches()
+{
+	static std::vector< Bench > benches;
+	return benches;
+}
+
+/**
+ *  @brief      Run one benchmark until it lasts BENCH_MIN_TIME
+ *  @param[in]  bench Benchmark to run
+ */
+static void RunBench( const BenchRegistry::Bench& bench )
+{
+	uint64_t iterations = 1;
+	uint64_t elapsed = 0;
+	uint64_t allocs = 0;
+
+	for (;;)
+	{
+		BenchState state( iterations );
+		uint64_t allocStart = BenchAllocations();
+		uint64_t start = GetTimeUsec();
+		bench.function( state );
+		elapsed = GetTimeUsec() - start;
+		allocs = BenchAllocations() - allocStart;
+
+		if( elapsed >= BENCH_MIN_TIME || iterations >= (1ULL << 40) )
+		{
+			break;
+		}
+
+		// Aim at 1.5 times the minimum duration
+		uint64_t next = elapsed > 0 ? iterations * BENCH_MIN_TIME * 3 / 2 / elapsed : iterations * 100;
+		iterations = next > iterations * 100 ? iterations * 100 : (next > iterations ? next : iterations * 2);
+	}
+
+	printf("%-48s %12llu %12.1f %10.2f\n", bench.name.c_str(), (unsigned long long)iterations,
+	       elapsed * 1000.0 / iterations, (double)allocs / iterations);
+}
+
+/**
+ *  @brief  Run the benchmarks whose name contains one of the arguments (all by default)
+ */
+int main( int argc, char** argv )
+{
+	printf("%-48s %12s %12s %10s\n", "benchmark", "iterations", "ns/op", "allocs/op");
+
+	std::vector< BenchRegistry::Bench >& benches = BenchRegistry::Benches();
+	for (size_t i = 0; i < benches.size(); i++)
+	{
+		bool selected = (argc < 2);
+		for (int arg = 1; arg < argc && !selected; arg++)
+		{
+			selected = (strstr(benches[i].name.c_str(), argv[arg]) != NULL);
+		}
+
+		if( selected )
+		{
+			RunBench( benches[i] );
+		}
+	}
+
+	return 0;
+}
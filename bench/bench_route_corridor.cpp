@@ -0,0 +1,72 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "bench.h"
+#include "route_corridor.h"
+
+/**
+ *  @brief      Route of 50 m segments heading north-east, about 250 km
+ *  @param[in]  count Number of segments
+ *  @return     Segments
+ */
+static std::vector< RouteSegment > Segments( size_t count )
+{
+	std::vector< RouteSegment > segments(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		segments[i].startLatitude = 35.0 + i * 0.0003;
+		segments[i].startLongitude = 137.0 + i * 0.0003 + (i % 2) * 0.0002;
+		segments[i].endLatitude = 35.0 + (i + 1) * 0.0003;
+		segments[i].endLongitude = 137.0 + (i + 1) * 0.0003 + ((i + 1) % 2) * 0.0002;
+		segments[i].distance = 50;
+		segments[i].time = 2;
+	}
+	return segments;
+}
+
+BENCH(RouteCorridor_Distance_OnRoute_5000)
+{
+	RouteCorridor corridor;
+	corridor.Build( Segments(5000) );
+
+	uint64_t i = 0;
+	while( state.KeepRunning() )
+	{
+		// 10 m beside the route, walking along it
+		double bearing;
+		size_t segment = (i++ * 7) % 5000;
+		BenchKeep( corridor.Distance( 35.0 + segment * 0.0003, 137.0001 + segment * 0.0003, bearing ) );
+	}
+}
+
+BENCH(RouteCorridor_Distance_OffRoute_5000)
+{
+	RouteCorridor corridor;
+	corridor.Build( Segments(5000) );
+
+	while( state.KeepRunning() )
+	{
+		// 1 km away : every segment is measured
+		double bearing;
+		BenchKeep( corridor.Distance( 35.3, 137.8, bearing ) );
+	}
+}
+
+BENCH(RouteCorridor_Build_Diagonal_10km)
+{
+	// One segment across a 7 km x 7 km square : its bounding box holds about 5000 cells
+	std::vector< RouteSegment > segments(1);
+	segments[0].startLatitude = 35.0;
+	segments[0].startLongitude = 137.0;
+	segments[0].endLatitude = 35.063;
+	segments[0].endLongitude = 137.077;
+	segments[0].distance = 10000;
+	segments[0].time = 400;
+
+	RouteCorridor corridor;
+	while( state.KeepRunning() )
+	{
+		corridor.Build( segments );
+		BenchKeep( corridor.IsEmpty() );
+	}
+}
@@ -0,0 +1,68 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "bench.h"
+#include "track_file.h"
+#include <string.h>
+
+/**
+ *  @brief      Position update of a vehicle driving north-east at 10 Hz
+ *  @param[in]  i Index of the update
+ *  @return     Position
+ */
+static NaviPosition Update( uint64_t i )
+{
+	NaviPosition position;
+	position.mask = (1u << NAVI_POSITION_TIMESTAMP) | (1u << NAVI_POSITION_LATITUDE) | (1u << NAVI_POSITION_LONGITUDE)
+				  | (1u << NAVI_POSITION_HEADING) | (1u << NAVI_POSITION_SPEED);
+	position.timestamp = (uint32_t)(i * 100);
+	position.latitude = 35.0 + i * 0.00001;
+	position.longitude = 137.0 + i * 0.000012;
+	position.heading = 45 + i % 3;
+	position.speed = 40 + i % 5;
+	position.simulationMode = false;
+	return position;
+}
+
+BENCH(TrackFile_Encode)
+{
+	TrackState previous;
+	memset(&previous, 0, sizeof(previous));
+	uint8_t record[TRACK_FILE_MAX_RECORD];
+
+	uint64_t i = 0;
+	while( state.KeepRunning() )
+	{
+		NaviPosition position = Update(i++);
+		BenchKeep( TrackWriter::Encode( 100, position, previous, record ) );
+	}
+}
+
+BENCH(TrackFile_Decode)
+{
+	// One hour of updates
+	std::vector< uint8_t > data;
+	TrackState previous;
+	memset(&previous, 0, sizeof(previous));
+	for (uint64_t i = 0; i < 36000; i++)
+	{
+		uint8_t record[TRACK_FILE_MAX_RECORD];
+		size_t size = TrackWriter::Encode( 100, Update(i), previous, record );
+		data.insert(data.end(), record, record + size);
+	}
+
+	size_t offset = 0;
+	memset(&previous, 0, sizeof(previous));
+	while( state.KeepRunning() )
+	{
+		TrackRecord record;
+		size_t size = TrackReader::Decode( &data[offset], data.size() - offset, previous, record );
+		BenchKeep( record );
+		offset += size;
+		if( offset >= data.size() )
+		{
+			offset = 0;
+			memset(&previous, 0, sizeof(previous));
+		}
+	}
+}
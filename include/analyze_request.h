@@ -6,26 +6,57 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <vector>
+#include <string>
+#include <json-c/json.h>
 
 #include "genivi_request.h"
+#include "binder_reply.h"
+#include "geofence_shape.h"
 
 /**
  *  @brief Analyze requests from BinderClient and create arguments to pass to Genivi API.
+ *
+ *  The request object is the one already parsed by the binder (afb_req_json),
+ *  it is borrowed and must not be released by the caller.
  */
 class AnalyzeRequest
 {
 public:
-	bool CreateParamsGetPosition( const char* req_json_str, std::vector< int32_t >& Params );
-	bool CreateParamsCreateRoute( const char* req_json_str, uint32_t& sessionHdl );
-	bool CreateParamsPauseSimulation( const char* req_json_str, uint32_t& sessionHdl );
-	bool CreateParamsSetSimulationMode( const char* req_json_str, uint32_t& sessionHdl, bool& simuMode );
-	bool CreateParamsCancelRouteCalculation( const char* req_json_str, uint32_t& sessionHdl, uint32_t& routeHdl );
-	bool CreateParamsSetWaypoints( const char* req_json_str, uint32_t& sessionHdl, uint32_t& routeHdl,
+	bool CreateParamsGetPosition( json_object* req_json, uint32_t& mask, uint32_t& maxAge, uint32_t& horizon );
+	bool CreateParamsCreateRoute( json_object* req_json, uint32_t& sessionHdl );
+	bool CreateParamsPauseSimulation( json_object* req_json, uint32_t& sessionHdl );
+	bool CreateParamsSetSimulationMode( json_object* req_json, uint32_t& sessionHdl, bool& simuMode );
+	bool CreateParamsCancelRouteCalculation( json_object* req_json, uint32_t& sessionHdl, uint32_t& routeHdl );
+	bool CreateParamsSetWaypoints( json_object* req_json, uint32_t& sessionHdl, uint32_t& routeHdl,
 											   bool& currentPos, std::vector<Waypoint>& waypointsList );
-	bool CreateParamsCalculateRoute( const char* req_json_str, uint32_t& sessionHdl, uint32_t& routeHdl );
+	bool CreateParamsCalculateRoute( json_object* req_json, uint32_t& sessionHdl, uint32_t& routeHdl );
+	bool CreateParamsCalculateRouteWait( json_object* req_json, uint32_t& sessionHdl, uint32_t& routeHdl, uint32_t& timeout );
+	bool CreateParamsGetRouteSegments( json_object* req_json, uint32_t& routeHdl, uint32_t& offset, uint32_t& limit,
+									   RouteSegmentsEncoding& encoding, uint32_t& precision );
+	bool CreateParamsGetRouteBoundingBox( json_object* req_json, uint32_t& routeHdl );
+	bool CreateParamsGetWaypoints( json_object* req_json, uint32_t& routeHdl );
+	bool CreateParamsGetManeuvers( json_object* req_json, uint32_t& routeHdl );
+	bool CreateParamsGetRouteProgress( json_object* req_json, uint32_t& routeHdl );
+	bool CreateParamsGetPositionHistory( json_object* req_json, uint32_t& count, uint32_t& duration, uint32_t& maxPoints );
+	bool CreateParamsSubscribe( json_object* req_json, uint32_t& mask, uint32_t& minInterval );
+	bool CreateParamsSubscribeOffRoute( json_object* req_json, uint32_t& distance, uint32_t& direction );
+	bool CreateParamsSubscribeEvents( json_object* req_json, std::vector< std::string >& events, uint32_t& routeHdl, uint32_t& sessionHdl );
+	bool CreateParamsUnsubscribeEvents( json_object* req_json, std::vector< std::string >& events );
+	bool CreateParamsBatch( json_object* req_json, json_object*& requests );
+	bool CreateParamsStats( json_object* req_json, bool& reset );
+	bool CreateParamsAddGeofence( json_object* req_json, std::vector< GeofenceShape >& shapes );
+	bool CreateParamsRemoveGeofence( json_object* req_json, std::vector< uint32_t >& ids );
+	bool CreateParamsStartRecording( json_object* req_json, std::string& name );
+	bool CreateParamsStartReplay( json_object* req_json, std::string& name, uint32_t& sessionHdl, uint32_t& speed, bool& repeat );
 
 private:
-	bool JsonObjectGetSessionHdl( const char* req_json_str, uint32_t& sessionHdl);
-	bool JsonObjectGetSessionHdlRouteHdl( const char* req_json_str, uint32_t& sessionHdl, uint32_t& routeHdl);
+	bool JsonObjectGetSessionHdl( json_object* req_json, uint32_t& sessionHdl);
+	bool JsonObjectGetValuesToReturn( json_object* jValuesToReturn, uint32_t& mask );
+	bool JsonObjectGetSessionHdlRouteHdl( json_object* req_json, uint32_t& sessionHdl, uint32_t& routeHdl);
+	bool JsonObjectGetRouteHdl( json_object* req_json, uint32_t& routeHdl );
+	bool JsonObjectGetOptionalInt( json_object* req_json, const char* key, uint32_t min, uint32_t max, uint32_t& value );
+	bool JsonObjectGetEvents( json_object* jEvents, std::vector< std::string >& events );
+	bool JsonObjectGetCoordinate( json_object* jPoint, double& latitude, double& longitude );
+	bool JsonObjectGetTrackName( json_object* req_json, std::string& name );
 };
 
@@ -0,0 +1,61 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <memory>
+#include <functional>
+#include <json-c/json.h>
+
+#include "binder_reply.h"
+#include "binder_metrics.h"
+
+/**
+ *  @brief Maximum number of sub-requests in one navicore_batch
+ */
+#define BATCH_MAX_REQUESTS	32
+
+/**
+ *  @brief Processing of one verb, independent of the AFB request.
+ *         The reply is called once with the response (possibly synchronously).
+ */
+typedef std::function< void( APIResponse& response ) > VerbReply;
+typedef std::function< void( json_object* req_json, VerbSamplePtr sample, VerbReply reply ) > VerbExecutor;
+
+/**
+ *  @brief Execute an ordered list of verbs in one navicore_batch request.
+ *
+ *  A string argument "$<step>[.<key>|.<index>...]" is replaced by the
+ *  result of a previous step, e.g. "$1.route" is the route handle
+ *  returned by the second step. Execution stops at the first failure.
+ */
+class BatchRequest
+{
+public:
+	typedef std::function< void( json_object* results ) > BatchCallback;
+
+	BatchRequest( const std::map< std::string, VerbExecutor >& executors, BinderMetrics* metrics );
+
+	void Execute( json_object* requests, BatchCallback callback );
+
+private:
+	struct Batch;
+
+	/**
+	 *  @brief Verb allowed in a batch, with the metrics its steps are counted in
+	 */
+	struct Step
+	{
+		VerbExecutor executor;
+		VerbMetrics* metrics;
+	};
+
+	std::map< std::string, Step > steps_;
+	BinderMetrics* metrics_;
+
+	void ExecuteStep( std::shared_ptr< Batch > batch );
+	static json_object* ResolveArgs( json_object* args, json_object* results );
+	static json_object* ResolveReference( const char* reference, json_object* results );
+};
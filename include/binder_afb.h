@@ -0,0 +1,10 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#define AFB_BINDING_VERSION 2
+
+extern "C" {
+	#include <afb/afb-binding.h>
+}
@@ -0,0 +1,58 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <stdint.h>
+
+#include "binder_afb.h"
+
+/**
+ *  @brief Traces of the binding.
+ *
+ *  The verbosity of the binder is checked before the arguments are
+ *  evaluated, so that a disabled trace costs no formatting. The per-request
+ *  JSON dumps are in addition sampled : only 1 request in N is dumped
+ *  (N set by BinderLogSetSampleRate, 1 by default).
+ *
+ *  Build with -DBINDER_LOG_DISABLE to remove every trace except errors.
+ */
+#define BINDER_LOG_DEFAULT_SAMPLE_RATE	1
+
+void BinderLogSetSampleRate( uint32_t rate );
+bool BinderLogSample();
+
+#ifdef BINDER_LOG_DISABLE
+
+#define BINDER_LOG_ENABLED(level)	(false)
+
+#define BINDER_NOTICE(fmt, args...)		do { } while(0)
+#define BINDER_DEBUG(fmt, args...)		do { } while(0)
+#define BINDER_REQ_NOTICE(req, fmt, args...)	do { } while(0)
+#define BINDER_REQ_DEBUG(req, fmt, args...)	do { } while(0)
+
+#else
+
+#define BINDER_LOG_ENABLED(level)	(afbBindingV2verbosity >= (level))
+
+#define BINDER_NOTICE(fmt, args...) \
+	do { if (BINDER_LOG_ENABLED(AFB_VERBOSITY_LEVEL_NOTICE)) AFB_NOTICE(fmt, ##args); } while(0)
+#define BINDER_DEBUG(fmt, args...) \
+	do { if (BINDER_LOG_ENABLED(AFB_VERBOSITY_LEVEL_DEBUG)) AFB_DEBUG(fmt, ##args); } while(0)
+#define BINDER_REQ_NOTICE(req, fmt, args...) \
+	do { if (BINDER_LOG_ENABLED(AFB_VERBOSITY_LEVEL_NOTICE)) AFB_REQ_NOTICE(req, fmt, ##args); } while(0)
+#define BINDER_REQ_DEBUG(req, fmt, args...) \
+	do { if (BINDER_LOG_ENABLED(AFB_VERBOSITY_LEVEL_DEBUG)) AFB_REQ_DEBUG(req, fmt, ##args); } while(0)
+
+#endif
+
+/**
+ *  @brief Dump a json object of a request whose trace was sampled
+ */
+#define BINDER_REQ_NOTICE_JSON(req, sampled, name, json) \
+	do { if (sampled) BINDER_REQ_NOTICE(req, "%s = %s", name, json_object_to_json_string(json)); } while(0)
+
+/**
+ *  @brief Whether the JSON dumps of a new request are traced
+ */
+#define BINDER_LOG_SAMPLE()	(BINDER_LOG_ENABLED(AFB_VERBOSITY_LEVEL_NOTICE) && BinderLogSample())
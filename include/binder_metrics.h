@@ -0,0 +1,150 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <json-c/json.h>
+
+/**
+ *  @brief Histogram buckets : 1 usec wide below 16 usec, then 8 buckets
+ *         per power of two (precision 12.5%) up to about 9 hours
+ */
+#define LATENCY_LINEAR_BUCKETS	16
+#define LATENCY_SUB_BUCKETS	8
+#define LATENCY_MAX_EXPONENT	35
+#define LATENCY_BUCKETS		(LATENCY_LINEAR_BUCKETS + (LATENCY_MAX_EXPONENT - 3) * LATENCY_SUB_BUCKETS)
+
+/**
+ *  @brief Samples kept for reuse once their request is done
+ */
+#define BINDER_METRICS_SAMPLE_POOL	64
+
+/**
+ *  @brief Latency distribution, recorded without lock
+ */
+class LatencyHistogram
+{
+public:
+	LatencyHistogram();
+
+	void Record( uint64_t usec );
+	void Reset();
+	json_object* ToJson() const;
+
+private:
+	std::atomic< uint64_t > buckets_[LATENCY_BUCKETS];
+	std::atomic< uint64_t > count_;
+	std::atomic< uint64_t > sum_;
+	std::atomic< uint64_t > max_;
+
+	static int BucketIndex( uint64_t usec );
+	static uint64_t BucketUpperBound( int index );
+	uint64_t Percentile( const std::vector< uint64_t >& buckets, uint64_t count, double ratio ) const;
+};
+
+/**
+ *  @brief Phases of a verb
+ */
+enum VerbPhase
+{
+	VERB_PHASE_PARSE,	// Request analysis until the Genivi call
+	VERB_PHASE_DBUS,	// Genivi call until its reply
+	VERB_PHASE_REPLY,	// Response creation and return to BinderClient
+	VERB_PHASE_TOTAL,
+	VERB_PHASE_MAX
+};
+
+/**
+ *  @brief Counters of one verb
+ */
+class VerbMetrics
+{
+public:
+	VerbMetrics();
+
+	void Record( bool isSuccess, const uint64_t phases[VERB_PHASE_MAX], bool calledGenivi );
+	void Reset();
+	json_object* ToJson() const;
+
+private:
+	std::atomic< uint64_t > count_;
+	std::atomic< uint64_t > errors_;
+	LatencyHistogram latency_[VERB_PHASE_MAX];
+};
+
+class BinderMetrics;
+
+/**
+ *  @brief Timing of one request, recorded in its VerbMetrics when done
+ */
+class VerbSample
+{
+public:
+	void Parsed();
+	void Called();
+	void Done( bool isSuccess );
+
+private:
+	friend class VerbSamplePtr;
+	friend class BinderMetrics;
+
+	BinderMetrics* owner_;	// pool the sample is given back to
+	VerbMetrics* metrics_;
+	uint64_t start_;
+	uint64_t parsed_;
+	uint64_t called_;
+	std::atomic< uint32_t > refCount_;
+};
+
+/**
+ *  @brief Shared reference on a sample, given back to its pool with the last reference
+ */
+class VerbSamplePtr
+{
+public:
+	explicit VerbSamplePtr( VerbSample* sample );
+	VerbSamplePtr( const VerbSamplePtr& other );
+	VerbSamplePtr( VerbSamplePtr&& other );
+	~VerbSamplePtr();
+
+	VerbSamplePtr& operator=( VerbSamplePtr other );
+	VerbSample* operator->() const { return sample_; }
+
+private:
+	VerbSample* sample_;
+};
+
+/**
+ *  @brief Metrics of every verb of the binding.
+ *
+ *  Verbs are registered at startup only, so that recording and reading
+ *  need no lock : a request is measured in the metrics of its verb,
+ *  resolved once by AddVerb, with a sample taken from a pool.
+ */
+class BinderMetrics
+{
+public:
+	BinderMetrics();
+	~BinderMetrics();
+
+	VerbMetrics* AddVerb( const char* verb );
+	VerbSamplePtr Start( VerbMetrics* metrics );
+	void Reset();
+	json_object* ToJson() const;
+
+private:
+	friend class VerbSamplePtr;
+
+	std::map< std::string, VerbMetrics* > verbs_;
+	std::atomic< uint64_t > resetTime_;
+	std::vector< VerbSample* > pool_;	// samples of the requests done
+	std::mutex poolMutex_;
+
+	void Release( VerbSample* sample );
+};
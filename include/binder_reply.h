@@ -8,8 +8,14 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <memory>
 #include <json-c/json.h>
 
+#include "genivi_request.h"
+#include "route_calculation.h"
+#include "position_history.h"
+#include "route_progress.h"
+
 /**
  *  @brief Response to return to Binder client.
  */
@@ -20,15 +26,76 @@ typedef struct APIResponse_
 	json_object* json_data;
 }APIResponse;
 
+/**
+ *  @brief How fixed-shape responses are built
+ */
+enum BinderReplyMode
+{
+	BINDER_REPLY_MODE_TREE,		// One json object per element
+	BINDER_REPLY_MODE_TEMPLATE	// Text written from per-key templates, attached to an empty array
+};
+
+/**
+ *  @brief Size of the text buffer of a position response in template mode
+ */
+#define BINDER_REPLY_POSITION_TEXT_SIZE	512
+
+/**
+ *  @brief How the coordinates of route segments are returned
+ */
+enum RouteSegmentsEncoding
+{
+	ROUTE_SEGMENTS_ENCODING_JSON,		// One json object per segment
+	ROUTE_SEGMENTS_ENCODING_POLYLINE	// Points in one string, delta + zigzag varint (encoded polyline)
+};
+
+/**
+ *  @brief Number of route segments returned by one request
+ */
+#define ROUTE_SEGMENTS_DEFAULT_LIMIT	1000
+#define ROUTE_SEGMENTS_MAX_LIMIT		10000
+
+/**
+ *  @brief Decimal digits kept by the encoded polyline (5 : about 1 m)
+ */
+#define ROUTE_SEGMENTS_DEFAULT_PRECISION	5
+#define ROUTE_SEGMENTS_MAX_PRECISION		7
+
 /**
  *  @brief Convert information acquired by Genevi API to JSON format.
+ *
+ *  In template mode, the position response is an empty array whose
+ *  serializer returns the prebuilt text : its elements can only be read
+ *  back by parsing json_object_to_json_string(). A shared response is the
+ *  json tree itself, or such an array holding its text in template mode.
  */
 class BinderReply
 {
 public:
-	APIResponse ReplyNavicoreGetPosition( std::map<int32_t, double>& posList );
+	BinderReply();
+
+	void SetMode( BinderReplyMode mode );
+
+	APIResponse ReplyNavicoreGetPosition( const NaviPosition& position, uint32_t extrapolated );
 	APIResponse ReplyNavicoreGetAllRoutes( std::vector< uint32_t > &allRoutes );
 	APIResponse ReplyNavicoreCreateRoute( uint32_t route );
 	APIResponse ReplyNavicoreGetAllSessions( std::map<uint32_t, std::string> &allSessions );
+	APIResponse ReplyNavicoreCalculateRouteWait( uint32_t route, RouteCalculationResult result, int32_t errorCode,
+												 const std::map< int32_t, int32_t >& unfullfilledPreferences );
+	APIResponse ReplyNavicoreGetRouteSegments( uint32_t route, uint32_t total, uint32_t offset, const std::vector< RouteSegment >& segments,
+											   RouteSegmentsEncoding encoding, uint32_t precision );
+	APIResponse ReplyNavicoreGetRouteBoundingBox( uint32_t route, const RouteBoundingBox& boundingBox );
+	APIResponse ReplyNavicoreGetWaypoints( uint32_t route, bool startFromCurrentPosition, const std::vector< Waypoint >& waypointsList );
+	APIResponse ReplyNavicoreGetManeuvers( uint32_t route, const std::vector< RouteManeuver >& maneuvers );
+	APIResponse ReplyNavicoreGetPositionHistory( const PositionSamples& samples );
+	APIResponse ReplyNavicoreAddGeofence( const std::vector< uint32_t >& ids );
+	APIResponse ReplyNavicoreGetRouteProgress( const RouteProgressInfo& progress );
+	APIResponse ReplyShared( const std::shared_ptr< json_object >& shared );
+	std::shared_ptr< json_object > Share( APIResponse response );
+
+private:
+	BinderReplyMode mode_;
+
+	APIResponse ReplyNavicoreGetPositionTemplate( const NaviPosition& position, uint32_t extrapolated );
 };
 
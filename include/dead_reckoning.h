@@ -0,0 +1,43 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <mutex>
+#include <stdint.h>
+
+#include "navi_position.h"
+#include "position_cache.h"
+#include "genivi_signal_listener.h"
+
+/**
+ *  @brief Time a position is predicted ahead of the last fix (msec)
+ */
+#define DEAD_RECKONING_DEFAULT_HORIZON	2000
+#define DEAD_RECKONING_MAX_HORIZON		10000
+
+/**
+ *  @brief Predict the position at request time from the last fix.
+ *
+ *  The vehicle is assumed to keep the heading and the speed (km/h) of the
+ *  last fix. Positions are notified about once a second, so a client
+ *  rendering the map at a higher rate gets a smooth motion without asking
+ *  Genivi. The prediction stops at the horizon: a vehicle whose fixes
+ *  stopped coming is not moved any further.
+ */
+class DeadReckoning : public PositionCacheListener, public GeniviSignalListener
+{
+public:
+	DeadReckoning( PositionCache* positionCache );
+
+	bool Get( uint32_t mask, uint32_t horizon, NaviPosition& position, uint32_t& extrapolated );
+
+	void OnPositionChanged( const NaviPosition& changedList );
+	void OnServiceStatusChanged( bool isAvailable );
+
+private:
+	NaviPosition fix_;		// latest value of each field
+	uint64_t fixTime_;		// usec, monotonic, when the coordinates were received
+	bool isValid_;			// coordinates received since Genivi is available
+	std::mutex mutex_;
+};
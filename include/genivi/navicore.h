@@ -5,7 +5,9 @@
 
 #include <dbus-c++-1/dbus-c++/dbus.h>
 #include "genivi-navigationcore-proxy.h"
+#include "genivi_signal_listener.h"
 #include <stdio.h>
+#include <vector>
 
 class Navicore :
   public org::genivi::navigationcore::Session_proxy,
@@ -21,120 +23,343 @@ public:
 	{
 	};
 
+	// Receiver of the signals
+	void AddListener(GeniviSignalListener* listener)
+	{
+		listeners_.push_back(listener);
+	};
+
+	// Asynchronous method calls
+	// Same marshalling as the generated proxies, but the reply is delivered
+	// later through the returned pending call instead of blocking the caller.
+	DBus::PendingCall GetAllSessionsAsync()
+	{
+		::DBus::CallMessage call;
+		call.member("GetAllSessions");
+		return Session_proxy::invoke_method_async(call);
+	}
+
+	DBus::PendingCall GetAllRoutesAsync()
+	{
+		::DBus::CallMessage call;
+		call.member("GetAllRoutes");
+		return Routing_proxy::invoke_method_async(call);
+	}
+
+	DBus::PendingCall CreateRouteAsync(const uint32_t& sessionHandle)
+	{
+		::DBus::CallMessage call;
+		::DBus::MessageIter wi = call.writer();
+
+		wi << sessionHandle;
+		call.member("CreateRoute");
+		return Routing_proxy::invoke_method_async(call);
+	}
+
+	DBus::PendingCall SetWaypointsAsync(const uint32_t& sessionHandle, const uint32_t& routeHandle, const bool& startFromCurrentPosition, const std::vector< std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > >& waypointsList)
+	{
+		::DBus::CallMessage call;
+		::DBus::MessageIter wi = call.writer();
+
+		wi << sessionHandle;
+		wi << routeHandle;
+		wi << startFromCurrentPosition;
+		wi << waypointsList;
+		call.member("SetWaypoints");
+		return Routing_proxy::invoke_method_async(call);
+	}
+
+	DBus::PendingCall CalculateRouteAsync(const uint32_t& sessionHandle, const uint32_t& routeHandle)
+	{
+		::DBus::CallMessage call;
+		::DBus::MessageIter wi = call.writer();
+
+		wi << sessionHandle;
+		wi << routeHandle;
+		call.member("CalculateRoute");
+		return Routing_proxy::invoke_method_async(call);
+	}
+
+	DBus::PendingCall CancelRouteCalculationAsync(const uint32_t& sessionHandle, const uint32_t& routeHandle)
+	{
+		::DBus::CallMessage call;
+		::DBus::MessageIter wi = call.writer();
+
+		wi << sessionHandle;
+		wi << routeHandle;
+		call.member("CancelRouteCalculation");
+		return Routing_proxy::invoke_method_async(call);
+	}
+
+	DBus::PendingCall SetSimulationModeAsync(const uint32_t& sessionHandle, const bool& activate)
+	{
+		::DBus::CallMessage call;
+		::DBus::MessageIter wi = call.writer();
+
+		wi << sessionHandle;
+		wi << activate;
+		call.member("SetSimulationMode");
+		return MapMatchedPosition_proxy::invoke_method_async(call);
+	}
+
+	DBus::PendingCall PauseSimulationAsync(const uint32_t& sessionHandle)
+	{
+		::DBus::CallMessage call;
+		::DBus::MessageIter wi = call.writer();
+
+		wi << sessionHandle;
+		call.member("PauseSimulation");
+		return MapMatchedPosition_proxy::invoke_method_async(call);
+	}
+
+	DBus::PendingCall SetPositionAsync(const uint32_t& sessionHandle, const std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > >& position)
+	{
+		::DBus::CallMessage call;
+		::DBus::MessageIter wi = call.writer();
+
+		wi << sessionHandle;
+		wi << position;
+		call.member("SetPosition");
+		return MapMatchedPosition_proxy::invoke_method_async(call);
+	}
+
+	DBus::PendingCall GetPositionAsync(const std::vector< int32_t >& valuesToReturn)
+	{
+		::DBus::CallMessage call;
+		::DBus::MessageIter wi = call.writer();
+
+		wi << valuesToReturn;
+		call.member("GetPosition");
+		return MapMatchedPosition_proxy::invoke_method_async(call);
+	}
+
+	DBus::PendingCall GetRouteSegmentsAsync(const uint32_t& routeHandle, const int16_t& detailLevel, const std::vector< int32_t >& valuesToReturn, const uint32_t& numberOfSegments, const uint32_t& offset)
+	{
+		::DBus::CallMessage call;
+		::DBus::MessageIter wi = call.writer();
+
+		wi << routeHandle;
+		wi << detailLevel;
+		wi << valuesToReturn;
+		wi << numberOfSegments;
+		wi << offset;
+		call.member("GetRouteSegments");
+		return Routing_proxy::invoke_method_async(call);
+	}
+
+	DBus::PendingCall GetRouteBoundingBoxAsync(const uint32_t& routeHandle)
+	{
+		::DBus::CallMessage call;
+		::DBus::MessageIter wi = call.writer();
+
+		wi << routeHandle;
+		call.member("GetRouteBoundingBox");
+		return Routing_proxy::invoke_method_async(call);
+	}
+
+	DBus::PendingCall GetWaypointsAsync(const uint32_t& routeHandle)
+	{
+		::DBus::CallMessage call;
+		::DBus::MessageIter wi = call.writer();
+
+		wi << routeHandle;
+		call.member("GetWaypoints");
+		return Routing_proxy::invoke_method_async(call);
+	}
+
+	DBus::PendingCall GetManeuversListAsync(const uint16_t& requestedNumberOfManeuvers, const uint32_t& maneuverOffset)
+	{
+		::DBus::CallMessage call;
+		::DBus::MessageIter wi = call.writer();
+
+		wi << requestedNumberOfManeuvers;
+		wi << maneuverOffset;
+		call.member("GetManeuversList");
+		return Guidance_proxy::invoke_method_async(call);
+	}
+
 	// Session
 	void SessionDeleted(const uint32_t& sessionHandle)
 	{
-		printf("NavicoreSession - Session %d deleted\n",sessionHandle);
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnSessionDeleted(sessionHandle);
+		}
 	};
 
 	// Routing
 	void RouteDeleted(const uint32_t& routeHandle)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnRouteDeleted(routeHandle);
+		}
 	};
 
 	void RouteCalculationCancelled(const uint32_t& routeHandle)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnRouteCalculationCancelled(routeHandle);
+		}
 	};
 
 	void RouteCalculationSuccessful(const uint32_t& routeHandle, const std::map< int32_t, int32_t >& unfullfilledPreferences)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnRouteCalculationSuccessful(routeHandle, unfullfilledPreferences);
+		}
 	};
 
 	void RouteCalculationFailed(const uint32_t& routeHandle, const int32_t& errorCode, const std::map< int32_t, int32_t >& unfullfilledPreferences)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnRouteCalculationFailed(routeHandle, errorCode, unfullfilledPreferences);
+		}
 	};
 
 	void RouteCalculationProgressUpdate(const uint32_t& routeHandle, const int32_t& status, const uint8_t& percentage)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnRouteCalculationProgressUpdate(routeHandle, status, percentage);
+		}
 	};
 
 	void AlternativeRoutesAvailable(const std::vector< uint32_t >& routeHandlesList)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnAlternativeRoutesAvailable(routeHandlesList);
+		}
 	};
 
 	// MapMatchedPosition
 	void SimulationStatusChanged(const int32_t& simulationStatus)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnSimulationStatusChanged(simulationStatus);
+		}
 	};
 
 	void SimulationSpeedChanged(const uint8_t& speedFactor)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnSimulationSpeedChanged(speedFactor);
+		}
 	};
 
 	void PositionUpdate(const std::vector< int32_t >& changedValues)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnPositionUpdate(changedValues);
+		}
 	};
 
 	void AddressUpdate(const std::vector< int32_t >& changedValues)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnAddressUpdate(changedValues);
+		}
 	};
 
 	void PositionOnSegmentUpdate(const std::vector< int32_t >& changedValues)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnPositionOnSegmentUpdate(changedValues);
+		}
 	};
 
 	void StatusUpdate(const std::vector< int32_t >& changedValues)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnStatusUpdate(changedValues);
+		}
 	};
 
 	void OffRoadPositionChanged(const uint32_t& distance, const int32_t& direction)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnOffRoadPositionChanged(distance, direction);
+		}
 	};
 
 	// Guidance
 	void VehicleLeftTheRoadNetwork()
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnVehicleLeftTheRoadNetwork();
+		}
 	};
 
 	void GuidanceStatusChanged(const int32_t& guidanceStatus, const uint32_t& routeHandle)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnGuidanceStatusChanged(guidanceStatus, routeHandle);
+		}
 	};
 
 	void WaypointReached(const bool& isDestination)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnWaypointReached(isDestination);
+		}
 	};
 
 	void ManeuverChanged(const int32_t& maneuver)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnManeuverChanged(maneuver);
+		}
 	};
 
 	void PositionOnRouteChanged(const uint32_t& offsetOnRoute)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnPositionOnRouteChanged(offsetOnRoute);
+		}
 	};
 
 	void VehicleLeftTheRoute()
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnVehicleLeftTheRoute();
+		}
 	};
 
 	void PositionToRouteChanged(const uint32_t& distance, const int32_t& direction)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnPositionToRouteChanged(distance, direction);
+		}
 	};
 
 	void ActiveRouteChanged(const int32_t& changeCause)
 	{
-		// TODO
+		for (size_t i = 0; i < listeners_.size(); i++)
+		{
+			listeners_[i]->OnActiveRouteChanged(changeCause);
+		}
 	};
-	
+
+private:
+	std::vector< GeniviSignalListener* > listeners_;
 };
 
 #endif
@@ -0,0 +1,72 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <stdint.h>
+
+#include "genivi_signal_listener.h"
+
+/**
+ *  @brief Bus name and object of Genivi navigation core
+ */
+#define GENIVI_SERVICE_NAME	"org.agl.naviapi"
+#define GENIVI_OBJECT_PATH	"/org/genivi/navicore"
+
+/**
+ *  @brief Delay before connecting again to the session bus (msec),
+ *         doubled after each failure up to the maximum
+ */
+#define GENIVI_RECONNECT_MIN_DELAY	100
+#define GENIVI_RECONNECT_MAX_DELAY	10000
+
+class Navicore;
+class GeniviBusWatcher;
+class SdEventDispatcher;
+struct sd_event;
+struct sd_event_source;
+
+/**
+ *  @brief Connection to Genivi navigation core.
+ *
+ *  Connects to the session bus at startup and follows the owner of the
+ *  Genivi bus name with NameOwnerChanged. The bus connection is restored in
+ *  the background with an exponential backoff, so that requests never wait
+ *  for a connection : they fail at once while Genivi is not available.
+ *  Replies and signals are dispatched from the sd-event loop of the binder.
+ */
+class GeniviConnection
+{
+public:
+	GeniviConnection();
+	~GeniviConnection();
+
+	bool Start( sd_event* loop );
+	std::shared_ptr< Navicore > GetNavicore();
+	bool IsAvailable() const;
+	void AddSignalListener( GeniviSignalListener* listener );
+
+private:
+	friend class GeniviBusWatcher;
+
+	SdEventDispatcher* dispatcher_;
+	sd_event_source* retryTimer_;
+	std::shared_ptr< Navicore > navicore_;	// NULL while the session bus is not connected
+	GeniviBusWatcher* watcher_;
+	std::vector< GeniviSignalListener* > signalListeners_;
+	std::mutex listenerMutex_;
+	std::atomic< bool > isAvailable_;
+	uint32_t retryDelay_;			// msec, before the next connection attempt
+
+	bool Connect();
+	void Disconnect();
+	void SetAvailable( bool isAvailable );
+	void OnDisconnected();
+	void ScheduleRetry( uint32_t delay );
+
+	static int OnRetryTimer( sd_event_source* source, uint64_t usec, void* userdata );
+};
@@ -4,34 +4,122 @@
 #pragma once
 
 #include <map>
+#include <list>
 #include <vector>
+#include <string>
+#include <tuple>
+#include <mutex>
+#include <functional>
 #include <stdint.h>
 
+#include "genivi_signal_listener.h"
+#include "genivi_connection.h"
+#include "navi_position.h"
+
 typedef std::tuple<double, double> Waypoint;
 
+/**
+ *  @brief Segment of a calculated route
+ */
+struct RouteSegment
+{
+	double startLatitude;
+	double startLongitude;
+	double endLatitude;
+	double endLongitude;
+	double distance;	// m
+	uint32_t time;		// sec
+};
+
+/**
+ *  @brief Rectangle enclosing a calculated route
+ */
+struct RouteBoundingBox
+{
+	double minLatitude;
+	double minLongitude;
+	double maxLatitude;
+	double maxLongitude;
+};
+
+/**
+ *  @brief Maneuver of the route under guidance
+ */
+struct RouteManeuver
+{
+	std::string roadName;		// after the maneuver
+	std::string roadNumber;
+	uint32_t offset;	// m from the start of the route
+	uint32_t travelTime;	// sec from the start of the route
+	int32_t direction;
+	int32_t maneuver;
+};
+
+class GeniviPendingCall;
+class SdEventQueue;
+
+namespace DBus {
+class Message;
+class PendingCall;
+}
+
 /**
  *  @brief Genivi API call.
  */
 class GeniviRequest
 {
 public:
+	/**
+	 *  @brief Completion callbacks of the asynchronous API.
+	 *         They are called from the event loop once Genivi has replied.
+	 */
+	typedef std::function< void( NaviPosition& position ) > GetPositionCallback;
+	typedef std::function< void( bool isSuccess, std::vector< uint32_t >& allRoutes ) > GetAllRoutesCallback;
+	typedef std::function< void( uint32_t routeHandle ) > CreateRouteCallback;
+	typedef std::function< void( bool isSuccess, std::map< uint32_t, std::string >& allSessions ) > GetAllSessionsCallback;
+	typedef std::function< void( bool isSuccess ) > ResultCallback;
+	typedef std::function< void( bool isSuccess, uint32_t totalNumberOfSegments, std::vector< RouteSegment >& segments ) > GetRouteSegmentsCallback;
+	typedef std::function< void( bool isSuccess, RouteBoundingBox& boundingBox ) > GetRouteBoundingBoxCallback;
+	typedef std::function< void( bool isSuccess, bool startFromCurrentPosition, std::vector< Waypoint >& waypointsList ) > GetWaypointsCallback;
+	typedef std::function< void( bool isSuccess, uint32_t numberOfManeuvers, std::vector< RouteManeuver >& maneuvers ) > GetManeuversListCallback;
+
+	GeniviRequest( SdEventQueue* loopQueue );
 	~GeniviRequest();
 
-	std::map< int32_t, double > NavicoreGetPosition( const std::vector< int32_t >& valuesToReturn );
-	std::vector< uint32_t >	 NavicoreGetAllRoutes();
-	uint32_t					NavicoreCreateRoute( const uint32_t& sessionHandle );
-	void						NavicorePauseSimulation( const uint32_t& sessionHandle );
-	void						NavicoreSetSimulationMode( const uint32_t& sessionHandle, const bool& activate );
-	void						NavicoreCancelRouteCalculation( const uint32_t& sessionHandle, const uint32_t& routeHandle );
-	void						NavicoreSetWaypoints( const uint32_t& sessionHandle, const uint32_t& routeHandle,
-										const bool& startFromCurrentPosition, const std::vector<Waypoint>& waypointsList );
-	void						NavicoreCalculateRoute( const uint32_t& sessionHandle, const uint32_t& routeHandle );
-	std::map<uint32_t, std::string> NavicoreGetAllSessions();
+	void NavicoreGetPositionAsync( const std::vector< int32_t >& valuesToReturn, GetPositionCallback callback );
+	void NavicoreSetPositionAsync( const uint32_t& sessionHandle, const NaviPosition& position, ResultCallback callback );
+	void NavicoreGetAllRoutesAsync( GetAllRoutesCallback callback );
+	void NavicoreCreateRouteAsync( const uint32_t& sessionHandle, CreateRouteCallback callback );
+	void NavicorePauseSimulationAsync( const uint32_t& sessionHandle, ResultCallback callback );
+	void NavicoreSetSimulationModeAsync( const uint32_t& sessionHandle, const bool& activate, ResultCallback callback );
+	void NavicoreCancelRouteCalculationAsync( const uint32_t& sessionHandle, const uint32_t& routeHandle, ResultCallback callback );
+	void NavicoreSetWaypointsAsync( const uint32_t& sessionHandle, const uint32_t& routeHandle,
+									const bool& startFromCurrentPosition, const std::vector<Waypoint>& waypointsList,
+									ResultCallback callback );
+	void NavicoreCalculateRouteAsync( const uint32_t& sessionHandle, const uint32_t& routeHandle, ResultCallback callback );
+	void NavicoreGetAllSessionsAsync( GetAllSessionsCallback callback );
+	void NavicoreGetRouteSegmentsAsync( const uint32_t& routeHandle, const uint32_t& numberOfSegments, const uint32_t& offset,
+										GetRouteSegmentsCallback callback );
+	void NavicoreGetRouteBoundingBoxAsync( const uint32_t& routeHandle, GetRouteBoundingBoxCallback callback );
+	void NavicoreGetWaypointsAsync( const uint32_t& routeHandle, GetWaypointsCallback callback );
+	void NavicoreGetManeuversListAsync( const uint16_t& requestedNumberOfManeuvers, const uint32_t& maneuverOffset,
+										GetManeuversListCallback callback );
+
+	bool Connect( sd_event* loop );
+	void AddSignalListener( GeniviSignalListener* listener );
 
 private:
-	void* navicore_;
+	friend class GeniviPendingCall;
 
-	void CreateDBusSession();
-	bool CheckSession();
-};
+	typedef std::function< DBus::PendingCall( Navicore& navicore ) > Sender;
+	typedef std::function< void( const DBus::Message* reply ) > ReplyHandler;
 
+	SdEventQueue* loopQueue_;	// calls are sent from the loop only
+	GeniviConnection connection_;
+	std::list< GeniviPendingCall* > pendingCalls_;
+	std::mutex pendingMutex_;
+
+	void Send( const Sender& send, const ReplyHandler& handler );
+	void AddPendingCall( const DBus::PendingCall& call, const std::function< void( const DBus::Message* reply ) >& handler );
+	void ReleasePendingCall( GeniviPendingCall* pending );
+};
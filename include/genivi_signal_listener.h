@@ -0,0 +1,51 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+/**
+ *  @brief Receive the signals of Genivi navigation core.
+ *         Handlers are called from the D-Bus dispatcher.
+ */
+class GeniviSignalListener
+{
+public:
+	virtual ~GeniviSignalListener() {}
+
+	// Genivi appeared on or left the session bus
+	virtual void OnServiceStatusChanged( bool isAvailable ) {}
+
+	// Session
+	virtual void OnSessionDeleted( uint32_t sessionHandle ) {}
+
+	// Routing
+	virtual void OnRouteDeleted( uint32_t routeHandle ) {}
+	virtual void OnRouteCalculationCancelled( uint32_t routeHandle ) {}
+	virtual void OnRouteCalculationSuccessful( uint32_t routeHandle, const std::map< int32_t, int32_t >& unfullfilledPreferences ) {}
+	virtual void OnRouteCalculationFailed( uint32_t routeHandle, int32_t errorCode, const std::map< int32_t, int32_t >& unfullfilledPreferences ) {}
+	virtual void OnRouteCalculationProgressUpdate( uint32_t routeHandle, int32_t status, uint8_t percentage ) {}
+	virtual void OnAlternativeRoutesAvailable( const std::vector< uint32_t >& routeHandlesList ) {}
+
+	// MapMatchedPosition
+	virtual void OnSimulationStatusChanged( int32_t simulationStatus ) {}
+	virtual void OnSimulationSpeedChanged( uint8_t speedFactor ) {}
+	virtual void OnPositionUpdate( const std::vector< int32_t >& changedValues ) {}
+	virtual void OnAddressUpdate( const std::vector< int32_t >& changedValues ) {}
+	virtual void OnPositionOnSegmentUpdate( const std::vector< int32_t >& changedValues ) {}
+	virtual void OnStatusUpdate( const std::vector< int32_t >& changedValues ) {}
+	virtual void OnOffRoadPositionChanged( uint32_t distance, int32_t direction ) {}
+
+	// Guidance
+	virtual void OnVehicleLeftTheRoadNetwork() {}
+	virtual void OnGuidanceStatusChanged( int32_t guidanceStatus, uint32_t routeHandle ) {}
+	virtual void OnWaypointReached( bool isDestination ) {}
+	virtual void OnManeuverChanged( int32_t maneuver ) {}
+	virtual void OnPositionOnRouteChanged( uint32_t offsetOnRoute ) {}
+	virtual void OnVehicleLeftTheRoute() {}
+	virtual void OnPositionToRouteChanged( uint32_t distance, int32_t direction ) {}
+	virtual void OnActiveRouteChanged( int32_t changeCause ) {}
+};
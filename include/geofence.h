@@ -0,0 +1,92 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <mutex>
+#include <stdint.h>
+#include <json-c/json.h>
+
+#include "binder_afb.h"
+#include "geofence_shape.h"
+#include "navi_position.h"
+#include "position_cache.h"
+
+class SdEventQueue;
+
+/**
+ *  @brief Size of a cell of the index in degree, about 1 km
+ */
+#define GEOFENCE_CELL_SIZE		0.01
+
+/**
+ *  @brief Fences overlapping more cells are tested against every position
+ */
+#define GEOFENCE_MAX_CELLS		64
+
+/**
+ *  @brief Test the vehicle position against the fences registered by the clients.
+ *
+ *  Each fence is listed in the cells of a fixed grid overlapped by its
+ *  bounding box, so a position is tested only against the fences of its
+ *  cell and the few fences spanning too many cells. The transitions are
+ *  pushed to the subscribers of the "geofence" event, with the fence id :
+ *  "enter", "exit", and "dwell" once the vehicle stayed inside long enough,
+ *  from a timer of the event loop as the position may not change meanwhile.
+ */
+class Geofence : public PositionCacheListener
+{
+public:
+	Geofence( PositionCache* positionCache, SdEventQueue* loopQueue );
+	~Geofence();
+
+	bool Start( sd_event* loop );
+
+	bool Add( const std::vector< GeofenceShape >& shapes, std::vector< uint32_t >& ids );
+	bool Remove( const std::vector< uint32_t >& ids );
+	bool Subscribe( afb_req req );
+	void Unsubscribe( afb_req req );
+
+	void OnPositionChanged( const NaviPosition& changedList );
+
+private:
+	/**
+	 *  @brief Registered fence and the state of the vehicle toward it
+	 */
+	struct Fence
+	{
+		GeofenceShape shape;
+		RouteBoundingBox box;
+		double scale;		// cos of the latitude, for the distances of a circle
+		bool isLarge;		// in large_ rather than in the cells
+		bool isInside;
+		bool isDwelling;	// dwell event pushed since the vehicle entered
+		uint64_t enterTime;	// msec, monotonic
+		uint32_t evaluation;	// last evaluation the position was inside
+	};
+
+	SdEventQueue* loopQueue_;
+	sd_event_source* timer_;
+	std::map< uint32_t, Fence > fences_;
+	std::map< uint64_t, std::vector< uint32_t > > cells_;	// fences by cell of the grid
+	std::vector< uint32_t > large_;
+	std::vector< uint32_t > inside_;	// fences the vehicle is inside
+	uint32_t nextId_;
+	uint32_t evaluation_;
+	NaviPosition current_;	// latest value of each field
+	afb_event event_;
+	bool isEventValid_;
+	std::mutex mutex_;
+
+	static int32_t Cell( double degree );
+	static uint64_t CellKey( int32_t row, int32_t column );
+	static bool Contains( const Fence& fence, double latitude, double longitude );
+	void Index( uint32_t id, const Fence& fence, bool isAdded );
+	void Test( const std::vector< uint32_t >& ids, uint64_t now );
+	void Push( uint32_t id, const char* transition );
+	void ArmTimer();
+
+	static int OnTimer( sd_event_source* source, uint64_t usec, void* userdata );
+};
@@ -0,0 +1,39 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include "genivi_request.h"
+
+/**
+ *  @brief Limits of the fences registered by the clients
+ */
+#define GEOFENCE_MAX_FENCES		10000
+#define GEOFENCE_MAX_POINTS		1000
+#define GEOFENCE_MAX_RADIUS		100000		// m
+#define GEOFENCE_MAX_DWELL		86400000	// msec
+
+/**
+ *  @brief Shape of a fence
+ */
+enum GeofenceType
+{
+	GEOFENCE_CIRCLE,
+	GEOFENCE_POLYGON
+};
+
+/**
+ *  @brief Area registered by a client
+ */
+struct GeofenceShape
+{
+	GeofenceType type;
+	double latitude;		// center of a circle
+	double longitude;
+	uint32_t radius;		// m, circle
+	std::vector< Waypoint > points;	// vertices of a polygon, implicitly closed
+	uint32_t dwell;			// msec inside before the dwell event (0 : no dwell event)
+};
@@ -0,0 +1,83 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <stdint.h>
+
+#include "binder_reply.h"
+#include "genivi_request.h"
+#include "genivi_signal_listener.h"
+#include "request_coalescer.h"
+
+class SdEventQueue;
+
+/**
+ *  @brief Time a loaded list is served without asking Genivi again (msec)
+ */
+#define HANDLE_LIST_CACHE_MAX_AGE	5000
+
+/**
+ *  @brief Session and route lists of Genivi, kept with their response.
+ *
+ *  A list is loaded once by GetAllSessions/GetAllRoutes. After that it is
+ *  updated by the SessionDeleted and RouteDeleted signals, by the routes
+ *  created through the binding, and by the routes that other clients
+ *  calculate. Genivi does not signal the sessions and routes that other
+ *  clients create, so a list is loaded again once it is older than
+ *  HANDLE_LIST_CACHE_MAX_AGE. A load started before a change is not kept.
+ *  The json object of a response is shared by the requests, so it is only
+ *  referenced and serialized from the event loop : json-c is not
+ *  thread-safe, even for reading.
+ */
+class HandleListCache : public GeniviSignalListener
+{
+public:
+	/**
+	 *  @brief Called once from the event loop with the shared response, NULL if Genivi could not be called
+	 */
+	typedef RequestCoalescer< std::shared_ptr< json_object > >::Callback ReplyCallback;
+
+	HandleListCache( GeniviRequest* geniviRequest, BinderReply* binderReply, SdEventQueue* loopQueue );
+
+	void GetAllSessions( const ReplyCallback& callback );
+	void GetAllRoutes( const ReplyCallback& callback );
+	void BeginCreateRoute();
+	void AddRoute( uint32_t routeHandle );
+
+	void OnServiceStatusChanged( bool isAvailable );
+	void OnSessionDeleted( uint32_t sessionHandle );
+	void OnRouteDeleted( uint32_t routeHandle );
+	void OnRouteCalculationSuccessful( uint32_t routeHandle, const std::map< int32_t, int32_t >& unfullfilledPreferences );
+	void OnAlternativeRoutesAvailable( const std::vector< uint32_t >& routeHandlesList );
+
+private:
+	/**
+	 *  @brief State of one list
+	 */
+	struct List
+	{
+		uint64_t loadTime;		// msec, monotonic
+		uint32_t generation;	// incremented by every change
+		std::shared_ptr< json_object > reply;	// NULL while not loaded
+		RequestCoalescer< std::shared_ptr< json_object > > loads;
+	};
+
+	GeniviRequest* geniviRequest_;
+	BinderReply* binderReply_;
+	SdEventQueue* loopQueue_;
+	std::map< uint32_t, std::string > sessions_;
+	std::vector< uint32_t > routes_;
+	List sessionList_;
+	List routeList_;
+	std::mutex mutex_;
+
+	bool Lookup( List& list, uint32_t& generation );
+	void Change( List& list );
+};
@@ -0,0 +1,43 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <math.h>
+
+#define NAVI_EARTH_RADIUS	6371000.0	// m
+#define NAVI_DEG_TO_RAD		(M_PI / 180.0)
+
+/**
+ *  @brief      Point reached by moving on a straight line, good for the short distances of a vehicle
+ *  @param[in]  latitude Latitude of the start point
+ *  @param[in]  longitude Longitude of the start point
+ *  @param[in]  heading Direction of the move, degree clockwise from north
+ *  @param[in]  distance Length of the move in m
+ *  @param[out] toLatitude Latitude of the point reached
+ *  @param[out] toLongitude Longitude of the point reached
+ */
+static inline void NaviGeoMove( double latitude, double longitude, double heading, double distance,
+								double& toLatitude, double& toLongitude )
+{
+	double angle = heading * NAVI_DEG_TO_RAD;
+	double dlat = distance * cos(angle) / NAVI_EARTH_RADIUS;
+	double dlon = distance * sin(angle) / (NAVI_EARTH_RADIUS * cos(latitude * NAVI_DEG_TO_RAD));
+	toLatitude = latitude + dlat / NAVI_DEG_TO_RAD;
+	toLongitude = longitude + dlon / NAVI_DEG_TO_RAD;
+}
+
+/**
+ *  @brief      Distance between two points, good for the short distances of a vehicle
+ *  @param[in]  latitude1 Latitude of the first point
+ *  @param[in]  longitude1 Longitude of the first point
+ *  @param[in]  latitude2 Latitude of the second point
+ *  @param[in]  longitude2 Longitude of the second point
+ *  @return     Distance in m
+ */
+static inline double NaviGeoDistance( double latitude1, double longitude1, double latitude2, double longitude2 )
+{
+	double dy = (latitude2 - latitude1) * NAVI_DEG_TO_RAD;
+	double dx = (longitude2 - longitude1) * NAVI_DEG_TO_RAD * cos((latitude1 + latitude2) / 2 * NAVI_DEG_TO_RAD);
+	return NAVI_EARTH_RADIUS * sqrt(dx * dx + dy * dy);
+}
@@ -0,0 +1,152 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include "genivi/genivi-navicore-constants.h"
+
+/**
+ *  @brief Position fields, in the order of their NAVICORE_* key.
+ *         Field f is present when bit (1 << f) of NaviPosition::mask is set.
+ */
+enum NaviPositionField
+{
+	NAVI_POSITION_TIMESTAMP,	// NAVICORE_TIMESTAMP
+	NAVI_POSITION_LATITUDE,		// NAVICORE_LATITUDE
+	NAVI_POSITION_LONGITUDE,	// NAVICORE_LONGITUDE
+	NAVI_POSITION_HEADING,		// NAVICORE_HEADING
+	NAVI_POSITION_SPEED,		// NAVICORE_SPEED
+	NAVI_POSITION_SIMULATION_MODE,	// NAVICORE_SIMULATION_MODE
+	NAVI_POSITION_FIELD_MAX
+};
+
+#define NAVI_POSITION_ALL	((1u << NAVI_POSITION_FIELD_MAX) - 1)
+
+/**
+ *  @brief Position information, with the type Genivi gives to each value
+ */
+struct NaviPosition
+{
+	uint32_t mask;		// fields present
+	uint32_t timestamp;	// msec
+	double latitude;
+	double longitude;
+	uint32_t heading;	// degree
+	int32_t speed;
+	bool simulationMode;
+};
+
+/**
+ *  @brief      NAVICORE_* key of a position field
+ *  @param[in]  field Position field
+ *  @return     Key
+ */
+static inline int32_t NaviPositionKey( int field )
+{
+	static const int32_t keys[NAVI_POSITION_FIELD_MAX] =
+	{
+		NAVICORE_TIMESTAMP,
+		NAVICORE_LATITUDE,
+		NAVICORE_LONGITUDE,
+		NAVICORE_HEADING,
+		NAVICORE_SPEED,
+		NAVICORE_SIMULATION_MODE
+	};
+	return keys[field];
+}
+
+/**
+ *  @brief      Position field of a NAVICORE_* key
+ *  @param[in]  key Key
+ *  @return     Field, -1 if the key is not a supported position key
+ */
+static inline int NaviPositionField( int32_t key )
+{
+	switch( key )
+	{
+	case NAVICORE_TIMESTAMP:		return NAVI_POSITION_TIMESTAMP;
+	case NAVICORE_LATITUDE:			return NAVI_POSITION_LATITUDE;
+	case NAVICORE_LONGITUDE:		return NAVI_POSITION_LONGITUDE;
+	case NAVICORE_HEADING:			return NAVI_POSITION_HEADING;
+	case NAVICORE_SPEED:			return NAVI_POSITION_SPEED;
+	case NAVICORE_SIMULATION_MODE:	return NAVI_POSITION_SIMULATION_MODE;
+	default:						return -1;
+	}
+}
+
+/**
+ *  @brief      Fields of NAVICORE_* keys
+ *  @param[in]  keys Keys, the unsupported ones are ignored
+ *  @return     Mask of the fields
+ */
+static inline uint32_t NaviPositionMask( const std::vector< int32_t >& keys )
+{
+	uint32_t mask = 0;
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		int field = NaviPositionField(keys[i]);
+		if( field >= 0 )
+		{
+			mask |= 1u << field;
+		}
+	}
+	return mask;
+}
+
+/**
+ *  @brief      NAVICORE_* keys of fields, to ask them to Genivi
+ *  @param[in]  mask Mask of the fields
+ *  @return     Keys, in the order of the fields
+ */
+static inline std::vector< int32_t > NaviPositionKeys( uint32_t mask )
+{
+	std::vector< int32_t > keys;
+	for (int field = 0; field < NAVI_POSITION_FIELD_MAX; field++)
+	{
+		if( mask & (1u << field) )
+		{
+			keys.push_back(NaviPositionKey(field));
+		}
+	}
+	return keys;
+}
+
+/**
+ *  @brief      Copy fields of a position
+ *  @param[in]  from Position holding the fields
+ *  @param[in]  mask Fields to copy, among the ones present in from
+ *  @param[out] to Position receiving the fields
+ */
+static inline void NaviPositionCopy( const NaviPosition& from, uint32_t mask, NaviPosition& to )
+{
+	mask &= from.mask;
+	if( mask & (1u << NAVI_POSITION_TIMESTAMP) )		to.timestamp = from.timestamp;
+	if( mask & (1u << NAVI_POSITION_LATITUDE) )			to.latitude = from.latitude;
+	if( mask & (1u << NAVI_POSITION_LONGITUDE) )		to.longitude = from.longitude;
+	if( mask & (1u << NAVI_POSITION_HEADING) )			to.heading = from.heading;
+	if( mask & (1u << NAVI_POSITION_SPEED) )			to.speed = from.speed;
+	if( mask & (1u << NAVI_POSITION_SIMULATION_MODE) )	to.simulationMode = from.simulationMode;
+	to.mask |= mask;
+}
+
+/**
+ *  @brief      Fields whose value differs between two positions
+ *  @param[in]  a First position
+ *  @param[in]  b Second position
+ *  @param[in]  mask Fields to compare, present in both positions
+ *  @return     Mask of the fields that differ
+ */
+static inline uint32_t NaviPositionDiff( const NaviPosition& a, const NaviPosition& b, uint32_t mask )
+{
+	uint32_t diff = 0;
+	if( a.timestamp != b.timestamp )			diff |= 1u << NAVI_POSITION_TIMESTAMP;
+	if( a.latitude != b.latitude )				diff |= 1u << NAVI_POSITION_LATITUDE;
+	if( a.longitude != b.longitude )			diff |= 1u << NAVI_POSITION_LONGITUDE;
+	if( a.heading != b.heading )				diff |= 1u << NAVI_POSITION_HEADING;
+	if( a.speed != b.speed )					diff |= 1u << NAVI_POSITION_SPEED;
+	if( a.simulationMode != b.simulationMode )	diff |= 1u << NAVI_POSITION_SIMULATION_MODE;
+	return diff & mask;
+}
@@ -0,0 +1,74 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <list>
+#include <vector>
+#include <mutex>
+#include <stdint.h>
+
+#include "binder_afb.h"
+#include "navi_position.h"
+#include "position_cache.h"
+#include "route_corridor.h"
+#include "route_progress.h"
+
+/**
+ *  @brief Thresholds of a subscription : distance to the route (m), difference with its direction (degree)
+ */
+#define OFF_ROUTE_DEFAULT_DISTANCE	30
+#define OFF_ROUTE_MAX_DISTANCE		1000
+#define OFF_ROUTE_DEFAULT_DIRECTION	60
+
+/**
+ *  @brief Consecutive positions over (or under) the thresholds before the state changes
+ */
+#define OFF_ROUTE_CONFIRMATIONS		2
+
+/**
+ *  @brief Slowest speed the heading is compared at (km/h), the heading of a stopped vehicle is noise
+ */
+#define OFF_ROUTE_MIN_SPEED			5
+
+/**
+ *  @brief Push "offroute" events when the vehicle drifts off the tracked route, before Genivi tells it left.
+ *
+ *  Each position is measured against the route polyline indexed by a
+ *  route corridor. The vehicle is drifting when it is farther than the
+ *  distance threshold from the route, or when it moves in a direction
+ *  differing from the nearest segment by more than the direction threshold.
+ *  Subscribers with the same thresholds share one AFB event, which is pushed
+ *  when the state changes, with "drifting" false when the vehicle is back.
+ */
+class OffRouteEvent : public PositionCacheListener, public RouteProgressListener
+{
+public:
+	OffRouteEvent( PositionCache* positionCache );
+
+	bool Subscribe( afb_req req, uint32_t distance, uint32_t direction );
+	void Unsubscribe( afb_req req );
+
+	void OnPositionChanged( const NaviPosition& changedList );
+	void OnRouteLoaded( uint32_t routeHandle, const std::vector< RouteSegment >& segments );
+
+private:
+	/**
+	 *  @brief Subscribers sharing the same thresholds
+	 */
+	struct Group
+	{
+		uint32_t distance;	// m
+		uint32_t direction;	// degree
+		bool isDrifting;
+		uint32_t confirmations;	// consecutive positions disagreeing with isDrifting
+		afb_event event;
+	};
+
+	RouteCorridor corridor_;
+	uint32_t route_;
+	NaviPosition current_;	// latest value of each field
+	std::list< Group > groups_;
+	uint32_t groupCount_;
+	std::mutex mutex_;
+};
@@ -0,0 +1,74 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <stdint.h>
+
+#include "genivi_request.h"
+#include "genivi_signal_listener.h"
+#include "navi_position.h"
+
+/**
+ *  @brief Default staleness bound of cached position values (msec)
+ */
+#define POSITION_CACHE_DEFAULT_MAX_AGE	1000
+
+/**
+ *  @brief Receive the position values changed in the cache
+ */
+class PositionCacheListener
+{
+public:
+	virtual ~PositionCacheListener() {}
+
+	// mask of changedList holds the changed fields only
+	virtual void OnPositionChanged( const NaviPosition& changedList ) = 0;
+};
+
+/**
+ *  @brief Position information of Genivi kept up to date by PositionUpdate signals.
+ *
+ *  PositionUpdate lists the keys whose value changed, so only those keys are
+ *  fetched again and the other ones are confirmed as unchanged at signal time.
+ */
+class PositionCache : public GeniviSignalListener
+{
+public:
+	PositionCache( GeniviRequest* geniviRequest );
+
+	bool Get( uint32_t mask, uint32_t maxAge, NaviPosition& position );
+	void Peek( uint32_t mask, NaviPosition& position );
+	uint32_t BeginFetch();
+	void Update( const NaviPosition& position, uint32_t generation );
+	void Track( uint32_t mask );
+	void Untrack( uint32_t mask );
+	void AddListener( PositionCacheListener* listener );
+
+	void OnPositionUpdate( const std::vector< int32_t >& changedValues );
+	void OnServiceStatusChanged( bool isAvailable );
+
+private:
+	/**
+	 *  @brief State of the cached value of one field
+	 */
+	struct Entry
+	{
+		uint64_t updateTime;	// msec, monotonic, 0 until received
+		uint32_t generation;	// generation of the last change notified for this field
+		bool pending;		// changed, new value not received yet
+	};
+
+	GeniviRequest* geniviRequest_;
+	std::vector< PositionCacheListener* > listeners_;
+	NaviPosition position_;		// values received, mask holds the received fields
+	Entry entries_[NAVI_POSITION_FIELD_MAX];
+	uint32_t tracked_;		// fields refreshed on PositionUpdate : asked_ and the fields of trackCount_
+	uint32_t asked_;		// fields asked for by a client, kept up to date
+	uint32_t trackCount_[NAVI_POSITION_FIELD_MAX];	// Track calls not released by Untrack
+	uint64_t signalTime_;		// time of the last PositionUpdate
+	uint32_t generation_;		// incremented by each PositionUpdate
+	std::mutex mutex_;
+};
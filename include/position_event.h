@@ -0,0 +1,68 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <functional>
+#include <stdint.h>
+
+#include "binder_afb.h"
+#include "binder_reply.h"
+#include "genivi_request.h"
+#include "position_cache.h"
+
+/**
+ *  @brief Push position changes to subscribed clients as "position" events.
+ *
+ *  Subscribers asking for the same fields and the same minimum interval share
+ *  one AFB event, so each change is converted to JSON once per group. A change
+ *  within the interval is pushed at its end, with the latest values.
+ *  The fields of a group are tracked by the position cache while it exists.
+ */
+class PositionEvent : public PositionCacheListener
+{
+public:
+	/**
+	 *  @brief Called once with the initial values of a new subscriber, no field if they cannot be fetched
+	 */
+	typedef std::function< void( NaviPosition& position ) > InitialCallback;
+
+	PositionEvent( GeniviRequest* geniviRequest, PositionCache* positionCache, BinderReply* binderReply );
+	~PositionEvent();
+
+	bool Start( sd_event* loop );
+
+	bool Subscribe( afb_req req, uint32_t mask, uint32_t minInterval, InitialCallback callback );
+	void Unsubscribe( afb_req req );
+
+	void OnPositionChanged( const NaviPosition& changedList );
+
+private:
+	/**
+	 *  @brief Subscribers sharing the same fields and interval
+	 */
+	struct Group
+	{
+		uint32_t mask;		// fields notified
+		uint32_t minInterval;	// msec
+		uint64_t pushTime;	// msec, monotonic
+		bool isDelayed;		// changed within the interval, pushed at its end
+		afb_event event;
+	};
+
+	GeniviRequest* geniviRequest_;
+	PositionCache* positionCache_;
+	BinderReply* binderReply_;
+	sd_event_source* timer_;
+	std::list< Group > groups_;
+	uint32_t groupCount_;
+	std::mutex mutex_;
+
+	bool Push( Group& group );
+	std::list< Group >::iterator Drop( std::list< Group >::iterator it );
+	void ArmTimer();
+
+	static int OnTimer( sd_event_source* source, uint64_t usec, void* userdata );
+};
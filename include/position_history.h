@@ -0,0 +1,66 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <stdint.h>
+
+#include "navi_position.h"
+#include "position_cache.h"
+
+/**
+ *  @brief Number of positions kept, the oldest one is overwritten
+ */
+#define POSITION_HISTORY_CAPACITY	3600
+
+/**
+ *  @brief Fewest points a downsampled history can be reduced to
+ */
+#define POSITION_HISTORY_MIN_POINTS	3
+
+/**
+ *  @brief Positions of the history, oldest first
+ */
+struct PositionSamples
+{
+	uint32_t total;		// samples in the requested window, before downsampling
+	std::vector< uint32_t > timestamp;	// msec, as given by Genivi
+	std::vector< double > latitude;
+	std::vector< double > longitude;
+	std::vector< uint32_t > heading;
+	std::vector< int32_t > speed;
+};
+
+/**
+ *  @brief Last positions of the vehicle, recorded from the position cache.
+ *
+ *  A sample is recorded each time the latitude or the longitude changes.
+ *  Each field is kept in its own array, so that the time window is found
+ *  and the trail is downsampled without reading the other fields.
+ */
+class PositionHistory : public PositionCacheListener
+{
+public:
+	PositionHistory( PositionCache* positionCache );
+
+	void Get( uint32_t count, uint32_t duration, uint32_t maxPoints, PositionSamples& samples );
+
+	void OnPositionChanged( const NaviPosition& changedList );
+
+private:
+	NaviPosition current_;		// latest value of each field
+	uint64_t time_[POSITION_HISTORY_CAPACITY];	// msec, monotonic, when the sample was recorded
+	uint32_t timestamp_[POSITION_HISTORY_CAPACITY];
+	double latitude_[POSITION_HISTORY_CAPACITY];
+	double longitude_[POSITION_HISTORY_CAPACITY];
+	uint32_t heading_[POSITION_HISTORY_CAPACITY];
+	int32_t speed_[POSITION_HISTORY_CAPACITY];
+	uint32_t next_;			// index of the next sample
+	uint32_t size_;			// samples recorded, up to the capacity
+	std::mutex mutex_;
+
+	uint32_t Index( uint32_t age ) const;
+	static void Downsample( uint32_t maxPoints, PositionSamples& samples );
+};
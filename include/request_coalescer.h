@@ -0,0 +1,93 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <stdint.h>
+
+/**
+ *  @brief Share one Genivi call between identical requests in flight.
+ *
+ *  The first request of a key starts the call, the requests of the same key
+ *  arriving before its reply wait for it instead of starting their own. Each
+ *  waiter receives its own copy of the result, so callbacks may modify it.
+ *  Forget() makes the next request start a new call, for a result that
+ *  must reflect a change made after the call in flight was sent.
+ */
+template< class T >
+class RequestCoalescer
+{
+public:
+	typedef std::function< void( T& value ) > Callback;
+	typedef std::vector< Callback > Waiters;
+
+	/**
+	 *  @brief      Wait for the call of a key
+	 *  @param[in]  key Normalized parameters of the request
+	 *  @param[in]  callback Called with the result of the call
+	 *  @param[out] waiters Requests waiting for the call, to pass to Complete()
+	 *  @return     true if the caller must start the call
+	 */
+	bool Join( uint64_t key, const Callback& callback, std::shared_ptr< Waiters >& waiters )
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+
+		std::shared_ptr< Waiters >& flight = flights_[key];
+		bool isFirst = !flight;
+		if( isFirst )
+		{
+			flight.reset(new Waiters());
+		}
+		flight->push_back(callback);
+
+		waiters = flight;
+		return isFirst;
+	}
+
+	/**
+	 *  @brief      End of a call : answer every request waiting for it
+	 *  @param[in]  key Normalized parameters of the request
+	 *  @param[in]  waiters Requests waiting for this call
+	 *  @param[in]  value Result of the call
+	 */
+	void Complete( uint64_t key, const std::shared_ptr< Waiters >& waiters, const T& value )
+	{
+		Waiters callbacks;
+		{
+			std::lock_guard< std::mutex > lock( mutex_ );
+
+			typename std::map< uint64_t, std::shared_ptr< Waiters > >::iterator it = flights_.find(key);
+			if( it != flights_.end() && it->second == waiters )
+			{
+				flights_.erase(it);
+			}
+
+			// No request can join the list once the call has ended
+			callbacks.swap(*waiters);
+		}
+
+		for (size_t i = 0; i < callbacks.size(); i++)
+		{
+			T copy = value;
+			callbacks[i]( copy );
+		}
+	}
+
+	/**
+	 *  @brief  Let the next requests start new calls, the calls in flight still answer their waiters
+	 */
+	void Forget()
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		flights_.clear();
+	}
+
+private:
+	std::map< uint64_t, std::shared_ptr< Waiters > > flights_;
+	std::mutex mutex_;
+};
@@ -0,0 +1,127 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <stdint.h>
+
+#include "genivi_request.h"
+#include "genivi_signal_listener.h"
+
+/**
+ *  @brief Number of routes whose data is kept, the least recently used is dropped
+ */
+#define ROUTE_CACHE_MAX_ROUTES		8
+
+/**
+ *  @brief Number of segments fetched from Genivi by one GetRouteSegments call
+ */
+#define ROUTE_CACHE_SEGMENTS_PAGE	2000
+
+/**
+ *  @brief Number of roads fetched from Genivi by one GetManeuversList call
+ */
+#define ROUTE_CACHE_MANEUVERS_PAGE	100
+
+/**
+ *  @brief Waypoints of a route
+ */
+struct RouteWaypoints
+{
+	bool startFromCurrentPosition;
+	std::vector< Waypoint > waypoints;
+};
+
+/**
+ *  @brief Data of calculated routes (segments, bounding box, waypoints, maneuvers), by route handle.
+ *
+ *  The data of a route is fetched from Genivi once, then shared by every
+ *  client : requests arriving during a fetch wait for it instead of starting
+ *  their own. It is prefetched when a calculation ends successfully and
+ *  dropped when the route is deleted, calculated again or the active route
+ *  changes. A fetch that ends after its route was dropped still answers its
+ *  requests, but its data is not kept.
+ *  Genivi only gives the maneuvers of the route under guidance : they are
+ *  fetched when the guidance starts and dropped whenever its status changes.
+ */
+class RouteCache : public GeniviSignalListener
+{
+public:
+	/**
+	 *  @brief Called once with the data, from the D-Bus dispatcher or at once if it is cached
+	 */
+	typedef std::function< void( bool isSuccess, const std::vector< RouteSegment >& segments ) > SegmentsCallback;
+	typedef std::function< void( bool isSuccess, const RouteBoundingBox& boundingBox ) > BoundingBoxCallback;
+	typedef std::function< void( bool isSuccess, const RouteWaypoints& waypoints ) > WaypointsCallback;
+	typedef std::function< void( bool isSuccess, const std::vector< RouteManeuver >& maneuvers ) > ManeuversCallback;
+
+	RouteCache( GeniviRequest* geniviRequest );
+
+	void GetSegments( uint32_t routeHandle, SegmentsCallback callback );
+	void GetBoundingBox( uint32_t routeHandle, BoundingBoxCallback callback );
+	void GetWaypoints( uint32_t routeHandle, WaypointsCallback callback );
+	void GetManeuvers( uint32_t routeHandle, ManeuversCallback callback );
+	void Prefetch( uint32_t routeHandle );
+	void Invalidate( uint32_t routeHandle );
+	void Clear();
+
+	void OnServiceStatusChanged( bool isAvailable );
+	void OnRouteDeleted( uint32_t routeHandle );
+	void OnRouteCalculationCancelled( uint32_t routeHandle );
+	void OnRouteCalculationSuccessful( uint32_t routeHandle, const std::map< int32_t, int32_t >& unfullfilledPreferences );
+	void OnRouteCalculationFailed( uint32_t routeHandle, int32_t errorCode, const std::map< int32_t, int32_t >& unfullfilledPreferences );
+	void OnGuidanceStatusChanged( int32_t guidanceStatus, uint32_t routeHandle );
+	void OnActiveRouteChanged( int32_t changeCause );
+
+private:
+	/**
+	 *  @brief One kind of data of a route : cached value, or requests waiting for the fetch in progress
+	 */
+	template< class T >
+	struct Slot
+	{
+		typedef std::function< void( bool isSuccess, const T& value ) > Callback;
+		typedef std::vector< Callback > Waiters;
+
+		std::shared_ptr< const T > value;	// NULL until fetched
+		std::shared_ptr< Waiters > waiters;	// NULL while no fetch is in progress
+	};
+
+	struct RouteData
+	{
+		uint32_t generation;	// of this entry, a fetch of an older one is not kept
+		uint64_t lastUse;
+		Slot< std::vector< RouteSegment > > segments;
+		Slot< RouteBoundingBox > boundingBox;
+		Slot< RouteWaypoints > waypoints;
+		Slot< std::vector< RouteManeuver > > maneuvers;	// route under guidance only
+	};
+
+	GeniviRequest* geniviRequest_;
+	std::map< uint32_t, RouteData > routes_;
+	uint32_t generation_;
+	uint64_t useCount_;
+	uint32_t guidedRoute_;	// route under guidance, 0 if none
+	std::mutex mutex_;
+
+	RouteData& Lookup( uint32_t routeHandle );
+
+	template< class T >
+	bool Join( uint32_t routeHandle, Slot< T > RouteData::*member, const typename Slot< T >::Callback& callback,
+			   std::shared_ptr< const T >& value, std::shared_ptr< typename Slot< T >::Waiters >& waiters, uint32_t& generation );
+
+	template< class T >
+	void Store( uint32_t routeHandle, uint32_t generation, Slot< T > RouteData::*member,
+				const std::shared_ptr< typename Slot< T >::Waiters >& waiters, bool isSuccess, const T& value );
+
+	void FetchSegments( uint32_t routeHandle, uint32_t generation, std::shared_ptr< Slot< std::vector< RouteSegment > >::Waiters > waiters,
+						std::shared_ptr< std::vector< RouteSegment > > segments );
+	void FetchManeuvers( uint32_t routeHandle, uint32_t generation, std::shared_ptr< Slot< std::vector< RouteManeuver > >::Waiters > waiters,
+						 std::shared_ptr< std::vector< RouteManeuver > > maneuvers, uint32_t offset );
+	void DropManeuvers( uint32_t routeHandle );
+};
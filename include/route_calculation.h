@@ -0,0 +1,89 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <map>
+#include <list>
+#include <mutex>
+#include <functional>
+#include <stdint.h>
+
+#include "genivi_request.h"
+#include "genivi_signal_listener.h"
+
+class SdEventQueue;
+
+/**
+ *  @brief Time a route calculation is waited for (msec)
+ */
+#define ROUTE_CALCULATION_DEFAULT_TIMEOUT	30000
+#define ROUTE_CALCULATION_MAX_TIMEOUT		300000
+
+/**
+ *  @brief End of a route calculation
+ */
+enum RouteCalculationResult
+{
+	ROUTE_CALCULATION_SUCCESSFUL,
+	ROUTE_CALCULATION_FAILED,
+	ROUTE_CALCULATION_CANCELLED,
+	ROUTE_CALCULATION_TIMEOUT,
+	ROUTE_CALCULATION_ERROR		// CalculateRoute failed, or Genivi left the bus
+};
+
+/**
+ *  @brief Calculate a route and wait for the end of the calculation.
+ *
+ *  The waiter is registered before CalculateRoute is sent, so that an end
+ *  signal received before the reply of the call is not missed. Every waiter
+ *  of a route is completed by the same signal.
+ */
+class RouteCalculation : public GeniviSignalListener
+{
+public:
+	/**
+	 *  @brief Called once, from the D-Bus dispatcher or the timeout timer
+	 */
+	typedef std::function< void( RouteCalculationResult result, int32_t errorCode,
+								 const std::map< int32_t, int32_t >& unfullfilledPreferences ) > CompletionCallback;
+
+	RouteCalculation( GeniviRequest* geniviRequest, SdEventQueue* loopQueue );
+	~RouteCalculation();
+
+	bool Start( sd_event* loop );
+	void Calculate( uint32_t sessionHandle, uint32_t routeHandle, uint32_t timeout, CompletionCallback callback );
+
+	void OnServiceStatusChanged( bool isAvailable );
+	void OnRouteDeleted( uint32_t routeHandle );
+	void OnRouteCalculationCancelled( uint32_t routeHandle );
+	void OnRouteCalculationSuccessful( uint32_t routeHandle, const std::map< int32_t, int32_t >& unfullfilledPreferences );
+	void OnRouteCalculationFailed( uint32_t routeHandle, int32_t errorCode, const std::map< int32_t, int32_t >& unfullfilledPreferences );
+
+private:
+	/**
+	 *  @brief Request waiting for the end of a calculation
+	 */
+	struct Waiter
+	{
+		uint32_t id;
+		uint32_t routeHandle;
+		uint64_t deadline;	// usec, monotonic
+		CompletionCallback callback;
+	};
+
+	GeniviRequest* geniviRequest_;
+	SdEventQueue* loopQueue_;
+	sd_event_source* timer_;
+	std::list< Waiter > waiters_;
+	uint32_t waiterCount_;
+	std::mutex mutex_;
+
+	void Complete( uint32_t routeHandle, RouteCalculationResult result, int32_t errorCode,
+				   const std::map< int32_t, int32_t >& unfullfilledPreferences );
+	void CompleteWaiter( uint32_t id, RouteCalculationResult result );
+	void ArmTimer();
+	void ArmTimerLocked();
+
+	static int OnTimer( sd_event_source* source, uint64_t usec, void* userdata );
+};
@@ -0,0 +1,49 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+#include "genivi_request.h"
+
+/**
+ *  @brief Size of a cell of the corridor index (m)
+ */
+#define ROUTE_CORRIDOR_CELL_SIZE	100.0
+
+/**
+ *  @brief Distance from a position to the polyline of a route.
+ *
+ *  The segments are projected on a plane tangent at the middle of the route
+ *  and listed in the cells of a grid they cross, and in the cells around
+ *  them. The segments within one cell of a position are then all in the
+ *  cell of the position, found by one lookup. A position farther from the
+ *  route is measured against every segment.
+ */
+class RouteCorridor
+{
+public:
+	RouteCorridor();
+
+	void Build( const std::vector< RouteSegment >& segments );
+	bool IsEmpty() const;
+	double Distance( double latitude, double longitude, double& bearing ) const;
+
+private:
+	double latitude0_;		// origin of the plane
+	double longitude0_;
+	double scale_;			// m per degree of longitude
+	std::vector< double > x0_;	// m, start and end of each segment
+	std::vector< double > y0_;
+	std::vector< double > x1_;
+	std::vector< double > y1_;
+	std::map< uint64_t, std::vector< uint32_t > > cells_;	// segments by cell
+
+	void Index( uint32_t segment );
+	static int32_t Cell( double meter );
+	static uint64_t CellKey( int32_t row, int32_t column );
+	double SegmentDistance( uint32_t segment, double x, double y ) const;
+};
@@ -0,0 +1,117 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <mutex>
+#include <functional>
+#include <stdint.h>
+
+#include "binder_afb.h"
+#include "genivi_request.h"
+#include "genivi_signal_listener.h"
+#include "route_cache.h"
+
+class BinderReply;
+
+/**
+ *  @brief Shortest interval between two "routeprogress" events (msec)
+ */
+#define ROUTE_PROGRESS_EVENT_INTERVAL	5000
+
+/**
+ *  @brief Progress of the vehicle along the tracked route
+ */
+struct RouteProgressInfo
+{
+	uint32_t route;
+	uint32_t offset;		// m from the start, as given by PositionOnRouteChanged
+	uint32_t remainingDistance;	// m to the destination
+	uint32_t remainingTime;		// sec to the destination
+	int32_t nextWaypoint;		// index in the waypoints of the route, -1 after the last one
+	uint32_t nextWaypointDistance;	// m
+};
+
+/**
+ *  @brief Receive the segments of the tracked route
+ */
+class RouteProgressListener
+{
+public:
+	virtual ~RouteProgressListener() {}
+
+	// segments is empty until the tracked route is loaded, routeHandle is 0 when no route is tracked
+	virtual void OnRouteLoaded( uint32_t routeHandle, const std::vector< RouteSegment >& segments ) = 0;
+};
+
+/**
+ *  @brief Remaining distance and time along the route under guidance.
+ *
+ *  The segments of the route are fetched once through the route cache and
+ *  summed into prefix arrays of distance and time, and the waypoints are
+ *  placed on them. Each offset notified by PositionOnRouteChanged is then
+ *  converted by a binary search, whatever the length of the route.
+ *  The tracked route is the one of the last GuidanceStatusChanged. Another
+ *  route asked for by a client is computed from its start, without being
+ *  tracked.
+ */
+class RouteProgress : public GeniviSignalListener
+{
+public:
+	/**
+	 *  @brief Called once with the progress, from the D-Bus dispatcher or at once if the route is loaded
+	 */
+	typedef std::function< void( bool isSuccess, const RouteProgressInfo& progress ) > ProgressCallback;
+
+	RouteProgress( RouteCache* routeCache, BinderReply* binderReply );
+
+	void Get( uint32_t routeHandle, const ProgressCallback& callback );
+	bool Subscribe( afb_req req );
+	void Unsubscribe( afb_req req );
+	void AddListener( RouteProgressListener* listener );
+
+	void OnServiceStatusChanged( bool isAvailable );
+	void OnRouteDeleted( uint32_t routeHandle );
+	void OnRouteCalculationSuccessful( uint32_t routeHandle, const std::map< int32_t, int32_t >& unfullfilledPreferences );
+	void OnGuidanceStatusChanged( int32_t guidanceStatus, uint32_t routeHandle );
+	void OnPositionOnRouteChanged( uint32_t offsetOnRoute );
+	void OnActiveRouteChanged( int32_t changeCause );
+
+private:
+	/**
+	 *  @brief Prefix sums of a loaded route
+	 */
+	struct Profile
+	{
+		std::vector< double > distance;		// m from the start to the start of each segment, then the length
+		std::vector< double > time;		// sec, same
+		std::vector< double > waypointOffset;	// m from the start, in the order of the waypoints
+	};
+
+	RouteCache* routeCache_;
+	BinderReply* binderReply_;
+	uint32_t route_;		// tracked route (0 : none)
+	uint32_t offset_;
+	uint32_t generation_;		// of the tracked route, a load of an older one is not kept
+	bool isLoaded_;
+	bool isLoading_;
+	Profile profile_;		// of the tracked route
+	std::vector< ProgressCallback > waiters_;	// requests waiting for the load
+	std::vector< RouteProgressListener* > listeners_;
+	uint64_t pushTime_;		// msec, monotonic
+	afb_event event_;
+	bool isEventValid_;
+	std::mutex mutex_;
+
+	void Track( uint32_t routeHandle );
+	void Load( uint32_t routeHandle, uint32_t generation );
+	void Loaded( uint32_t generation, bool isSuccess, const std::vector< RouteSegment >& segments, const RouteWaypoints& waypoints );
+	void GetUntracked( uint32_t routeHandle, const ProgressCallback& callback );
+	RouteProgressInfo Compute() const;
+
+	static void Build( const std::vector< RouteSegment >& segments, const RouteWaypoints& waypoints, Profile& profile );
+	static RouteProgressInfo Compute( const Profile& profile, uint32_t routeHandle, uint32_t offset );
+	void Push();
+};
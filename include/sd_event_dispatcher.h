@@ -0,0 +1,64 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <map>
+#include <list>
+#include <dbus-c++-1/dbus-c++/dbus.h>
+#include <systemd/sd-event.h>
+
+class SdEventWatch;
+class SdEventTimeout;
+
+/**
+ *  @brief D-Bus dispatcher running in an sd-event loop.
+ *
+ *  The watches and timeouts of the D-Bus connections become sources of the
+ *  loop, and the received messages are dispatched from the loop itself :
+ *  replies and signals are delivered without a thread of their own.
+ *  enter() and leave() do nothing, the loop belongs to its owner.
+ */
+class SdEventDispatcher : public DBus::Dispatcher
+{
+public:
+	SdEventDispatcher( sd_event* loop );
+	~SdEventDispatcher();
+
+	void enter();
+	void leave();
+
+	DBus::Timeout* add_timeout( DBus::Timeout::Internal* internal );
+	void rem_timeout( DBus::Timeout* timeout );
+
+	DBus::Watch* add_watch( DBus::Watch::Internal* internal );
+	void rem_watch( DBus::Watch* watch );
+
+	sd_event* Loop() const
+	{
+		return loop_;
+	}
+
+private:
+	friend class SdEventWatch;
+	friend class SdEventTimeout;
+
+	/**
+	 *  @brief Watches of one file descriptor (libdbus watches reading and
+	 *         writing separately, epoll accepts a descriptor once)
+	 */
+	struct IoSource
+	{
+		sd_event_source* source;
+		std::list< SdEventWatch* > watches;
+	};
+
+	sd_event* loop_;
+	sd_event_source* post_;
+	std::map< int, IoSource > ioSources_;
+
+	void UpdateIo( int fd );
+
+	static int OnIo( sd_event_source* source, int fd, uint32_t revents, void* userdata );
+	static int OnPost( sd_event_source* source, void* userdata );
+};
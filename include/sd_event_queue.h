@@ -0,0 +1,38 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <functional>
+
+struct sd_event;
+struct sd_event_source;
+
+/**
+ *  @brief Tasks run by the sd-event loop of the binder.
+ *
+ *  sd-event is not thread-safe, while verbs run on the worker threads of
+ *  the binder : D-Bus calls and changes of the timers of the loop are
+ *  posted here by those threads, and run by the loop in the posting order.
+ */
+class SdEventQueue
+{
+public:
+	typedef std::function< void() > Task;
+
+	SdEventQueue();
+	~SdEventQueue();
+
+	bool Start( sd_event* loop );
+	void Post( const Task& task );
+
+private:
+	int fd_;			// eventfd, readable while tasks are posted
+	sd_event_source* source_;
+	std::vector< Task > tasks_;
+	std::mutex mutex_;
+
+	static int OnIo( sd_event_source* source, int fd, uint32_t revents, void* userdata );
+};
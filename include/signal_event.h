@@ -0,0 +1,139 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <map>
+#include <list>
+#include <set>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <stdint.h>
+#include <json-c/json.h>
+
+#include "binder_afb.h"
+#include "genivi_signal_listener.h"
+
+/**
+ *  @brief Genivi signals forwarded as AFB events (event name = signal name in lower case)
+ */
+enum SignalEventType
+{
+	SIGNAL_EVENT_SESSIONDELETED,
+	SIGNAL_EVENT_ROUTEDELETED,
+	SIGNAL_EVENT_ROUTECALCULATIONCANCELLED,
+	SIGNAL_EVENT_ROUTECALCULATIONSUCCESSFUL,
+	SIGNAL_EVENT_ROUTECALCULATIONFAILED,
+	SIGNAL_EVENT_ROUTECALCULATIONPROGRESSUPDATE,
+	SIGNAL_EVENT_ALTERNATIVEROUTESAVAILABLE,
+	SIGNAL_EVENT_SIMULATIONSTATUSCHANGED,
+	SIGNAL_EVENT_SIMULATIONSPEEDCHANGED,
+	SIGNAL_EVENT_POSITIONUPDATE,
+	SIGNAL_EVENT_ADDRESSUPDATE,
+	SIGNAL_EVENT_POSITIONONSEGMENTUPDATE,
+	SIGNAL_EVENT_STATUSUPDATE,
+	SIGNAL_EVENT_OFFROADPOSITIONCHANGED,
+	SIGNAL_EVENT_VEHICLELEFTTHEROADNETWORK,
+	SIGNAL_EVENT_GUIDANCESTATUSCHANGED,
+	SIGNAL_EVENT_WAYPOINTREACHED,
+	SIGNAL_EVENT_MANEUVERCHANGED,
+	SIGNAL_EVENT_POSITIONONROUTECHANGED,
+	SIGNAL_EVENT_VEHICLELEFTTHEROUTE,
+	SIGNAL_EVENT_POSITIONTOROUTECHANGED,
+	SIGNAL_EVENT_ACTIVEROUTECHANGED,
+	SIGNAL_EVENT_MAX
+};
+
+/**
+ *  @brief Filter of a subscription, 0 matches any handle.
+ *         Signals without route (or session) handle are not filtered by it.
+ */
+struct SignalEventFilter
+{
+	uint32_t route;
+	uint32_t sessionHandle;
+};
+
+/**
+ *  @brief Forward Genivi signals to subscribed clients as AFB events.
+ *
+ *  Subscribers of the same signal with the same filter share one AFB event,
+ *  dropped when its last subscriber leaves it or closes its session.
+ *  The payload of a signal is built once and shared by every matching event,
+ *  so that it is serialized once whatever the number of subscribers.
+ */
+class SignalEvent : public GeniviSignalListener
+{
+public:
+	SignalEvent();
+
+	static bool GetType( const char* name, SignalEventType& type );
+
+	bool Subscribe( afb_req req, const std::vector< SignalEventType >& types, const SignalEventFilter& filter );
+	void Unsubscribe( afb_req req, const std::vector< SignalEventType >& types );
+
+	// Session
+	void OnSessionDeleted( uint32_t sessionHandle );
+
+	// Routing
+	void OnRouteDeleted( uint32_t routeHandle );
+	void OnRouteCalculationCancelled( uint32_t routeHandle );
+	void OnRouteCalculationSuccessful( uint32_t routeHandle, const std::map< int32_t, int32_t >& unfullfilledPreferences );
+	void OnRouteCalculationFailed( uint32_t routeHandle, int32_t errorCode, const std::map< int32_t, int32_t >& unfullfilledPreferences );
+	void OnRouteCalculationProgressUpdate( uint32_t routeHandle, int32_t status, uint8_t percentage );
+	void OnAlternativeRoutesAvailable( const std::vector< uint32_t >& routeHandlesList );
+
+	// MapMatchedPosition
+	void OnSimulationStatusChanged( int32_t simulationStatus );
+	void OnSimulationSpeedChanged( uint8_t speedFactor );
+	void OnPositionUpdate( const std::vector< int32_t >& changedValues );
+	void OnAddressUpdate( const std::vector< int32_t >& changedValues );
+	void OnPositionOnSegmentUpdate( const std::vector< int32_t >& changedValues );
+	void OnStatusUpdate( const std::vector< int32_t >& changedValues );
+	void OnOffRoadPositionChanged( uint32_t distance, int32_t direction );
+
+	// Guidance
+	void OnVehicleLeftTheRoadNetwork();
+	void OnGuidanceStatusChanged( int32_t guidanceStatus, uint32_t routeHandle );
+	void OnWaypointReached( bool isDestination );
+	void OnManeuverChanged( int32_t maneuver );
+	void OnPositionOnRouteChanged( uint32_t offsetOnRoute );
+	void OnVehicleLeftTheRoute();
+	void OnPositionToRouteChanged( uint32_t distance, int32_t direction );
+	void OnActiveRouteChanged( int32_t changeCause );
+
+private:
+	/**
+	 *  @brief Client, kept in the context of its session
+	 */
+	struct Subscriber
+	{
+		SignalEvent* owner;
+	};
+
+	/**
+	 *  @brief Subscribers of one signal with the same filter
+	 */
+	struct Group
+	{
+		SignalEventType type;
+		SignalEventFilter filter;
+		afb_event event;
+		std::set< Subscriber* > subscribers;
+	};
+
+	std::list< Group > groups_;
+	std::atomic< uint32_t > groupCount_[SIGNAL_EVENT_MAX];	// to skip signals nobody listens to
+	std::mutex mutex_;
+
+	Subscriber* GetSubscriber( afb_req req );
+	void Leave( afb_req req, Subscriber* subscriber, const std::vector< std::list< Group >::iterator >& joined );
+	std::list< Group >::iterator Drop( std::list< Group >::iterator it );
+	static void OnSessionClosed( void* context );
+	bool IsSubscribed( SignalEventType type ) const;
+	void Push( SignalEventType type, uint32_t route, uint32_t sessionHandle, json_object* payload );
+	void PushChangedValues( SignalEventType type, const std::vector< int32_t >& changedValues );
+	void PushDistance( SignalEventType type, uint32_t distance, int32_t direction );
+};
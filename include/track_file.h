@@ -0,0 +1,122 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "navi_position.h"
+
+/**
+ *  @brief Header of a track file : magic and format version
+ */
+#define TRACK_FILE_MAGIC		"NTRK"
+#define TRACK_FILE_VERSION		1
+#define TRACK_FILE_HEADER_SIZE	5
+
+/**
+ *  @brief Longest name of a track file given by a client : letters, digits, '_', '-' and '.' not first
+ */
+#define TRACK_FILE_MAX_NAME		64
+
+/**
+ *  @brief Directory of the track files in $HOME, unless NAVIAPI_TRACK_DIR is set
+ */
+#define TRACK_FILE_DEFAULT_DIR	".naviapi/tracks"
+
+/**
+ *  @brief Suffix of a track file while it is recorded
+ */
+#define TRACK_FILE_TEMP_SUFFIX	".tmp"
+
+/**
+ *  @brief Latitude and longitude are recorded in 1e-7 degree (about 1 cm)
+ */
+#define TRACK_FILE_COORDINATE_SCALE	10000000.0
+
+/**
+ *  @brief Largest record : delay, mask and 5 fields of 5 bytes each
+ */
+#define TRACK_FILE_MAX_RECORD	32
+
+/**
+ *  @brief Bit of the mask of a record holding the simulation mode
+ */
+#define TRACK_FILE_SIMULATION_MODE	0x80
+
+/**
+ *  @brief Position of a track, with the time elapsed since the previous one
+ */
+struct TrackRecord
+{
+	uint32_t delay;		// msec since the previous record
+	NaviPosition position;	// fields changed at that time, with their value
+};
+
+/**
+ *  @brief Last value of each field, as recorded
+ */
+struct TrackState
+{
+	uint32_t timestamp;
+	int32_t latitude;	// 1e-7 degree
+	int32_t longitude;
+	uint32_t heading;
+	int32_t speed;
+};
+
+/**
+ *  @brief Write positions at the end of a track file.
+ *
+ *  Each record is the delay since the previous record, the mask of the
+ *  changed fields, and the difference of each changed field with its
+ *  previous value, zigzag encoded as a varint. A position update of a
+ *  moving vehicle takes about 10 bytes. Records are only appended, so a
+ *  file cut by a crash is read up to its last complete record.
+ *  The file is written under a temporary name, created by this writer
+ *  only, and renamed to its own name when closed.
+ */
+class TrackWriter
+{
+public:
+	TrackWriter();
+	~TrackWriter();
+
+	bool Open( const char* path );
+	bool Write( uint32_t delay, const NaviPosition& position );
+	void Close();
+
+	static size_t Encode( uint32_t delay, const NaviPosition& position, TrackState& previous, uint8_t* record );
+	static bool MakeDirectory( const std::string& path );
+
+private:
+	FILE* file_;
+	std::string path_;	// name given once closed
+	TrackState previous_;
+};
+
+/**
+ *  @brief Read the records of a track file, mapped in memory.
+ */
+class TrackReader
+{
+public:
+	TrackReader();
+	~TrackReader();
+
+	bool Open( const char* path );
+	bool Read( TrackRecord& record );
+	void Rewind();
+	void Close();
+
+	static size_t Decode( const uint8_t* data, size_t size, TrackState& previous, TrackRecord& record );
+
+private:
+	const uint8_t* data_;
+	size_t size_;
+	size_t offset_;		// next record
+	TrackState previous_;
+};
@@ -0,0 +1,38 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <mutex>
+#include <stdint.h>
+
+#include "navi_position.h"
+#include "position_cache.h"
+#include "track_file.h"
+
+/**
+ *  @brief Record the positions received from Genivi in a track file.
+ *
+ *  The first record is the whole position known when the recording starts,
+ *  then each change of the position cache is appended with the time elapsed
+ *  since the previous one, so that a replay reproduces the same drive.
+ */
+class TrackRecorder : public PositionCacheListener
+{
+public:
+	TrackRecorder( PositionCache* positionCache );
+
+	bool Start( const char* path );
+	uint32_t Stop();
+
+	void OnPositionChanged( const NaviPosition& changedList );
+
+private:
+	PositionCache* positionCache_;
+	TrackWriter writer_;
+	bool isRecording_;
+	bool isTracking_;	// every field tracked in the position cache until Stop
+	uint64_t recordTime_;	// msec, monotonic, of the last record
+	uint32_t records_;	// records written since the start
+	std::mutex mutex_;
+};
@@ -0,0 +1,66 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#pragma once
+
+#include <mutex>
+#include <stdint.h>
+
+#include "genivi_request.h"
+#include "track_file.h"
+
+class SdEventQueue;
+
+/**
+ *  @brief Speed of a replay, times the recorded one
+ */
+#define TRACK_REPLAY_DEFAULT_SPEED	1
+#define TRACK_REPLAY_MAX_SPEED		100
+
+/**
+ *  @brief SetPosition calls waiting for their reply before the replay waits for Genivi
+ */
+#define TRACK_REPLAY_MAX_PENDING	64
+
+/**
+ *  @brief Positions sent by one expiry of the timer, when the replay is late
+ */
+#define TRACK_REPLAY_MAX_BURST		32
+
+/**
+ *  @brief Give the positions of a track file to Genivi with SetPosition.
+ *
+ *  The positions are sent at the recorded pace divided by the speed, from
+ *  a timer of the event loop of the binder. A late replay sends the
+ *  positions due in a burst, and slows down when Genivi does not keep up.
+ */
+class TrackReplay
+{
+public:
+	TrackReplay( GeniviRequest* geniviRequest, SdEventQueue* loopQueue );
+	~TrackReplay();
+
+	bool Start( sd_event* loop );
+	bool Play( const char* path, uint32_t sessionHandle, uint32_t speed, bool repeat );
+	void Stop();
+
+private:
+	GeniviRequest* geniviRequest_;
+	SdEventQueue* loopQueue_;
+	sd_event_source* timer_;
+	TrackReader reader_;
+	TrackRecord next_;		// next position to send
+	bool isPlaying_;
+	bool repeat_;			// start again at the end of the track
+	uint32_t sessionHandle_;
+	uint32_t speed_;
+	uint64_t due_;			// usec, monotonic, when next_ is sent
+	uint32_t pending_;		// SetPosition calls waiting for their reply
+	std::mutex mutex_;
+
+	bool ReadNext();
+	void ArmTimer( uint64_t now );
+	void PostArmTimer();
+
+	static int OnTimer( sd_event_source* source, uint64_t usec, void* userdata );
+};
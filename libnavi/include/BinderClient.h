@@ -26,6 +26,14 @@
 #define VERB_SETWAYPOINTS	"navicore_setwaypoints"
 #define VERB_CALCULATEROUTE	"navicore_calculateroute"
 #define VERB_GETALLSESSIONS	"navicore_getallsessions"
+#define VERB_SUBSCRIBE	"navicore_subscribe"
+#define VERB_UNSUBSCRIBE	"navicore_unsubscribe"
+#define VERB_BATCH	"navicore_batch"
+
+/**
+ *  @brief Event name
+ */
+#define EVENT_POSITION	API_NAME "/position"
 
 /**
  *  @brief Binder client class
@@ -46,9 +54,15 @@ public:
 	void NavicoreSetWaypoints(const uint32_t& sessionHandle, const uint32_t& routeHandle, const bool& startFromCurrentPosition, const std::vector<naviapi::Waypoint>& waypointsList);
 	void NavicoreCalculateRoute(const uint32_t& sessionHandle, const uint32_t& routeHandle);
 	void NavicoreGetAllSessions();
+	void NavicoreSubscribe(const std::vector< int32_t >& valuesToReturn, const uint32_t& minInterval);
+	void NavicoreUnsubscribe();
+	void NavicoreSetupRoute(const bool& startFromCurrentPosition, const std::vector<naviapi::Waypoint>& waypointsList);
 
 private:
 	void OnReply(struct json_object *reply);
+	void OnEvent(const char *event, struct json_object *data);
+	void DispatchReply(const char *verb, std::string& response_json);
+	void DispatchBatchReply(struct json_object *reply);
 
 private:
 	naviapi::NavicoreListener* navicoreListener;
@@ -25,5 +25,8 @@ public:
 						const bool* startFromCurrentPosition, const std::vector<naviapi::Waypoint>* waypointsList);
 	static std::string CreateRequestCalculateroute(const uint32_t* sessionHandle, const uint32_t* routeHandle);
 	static std::string CreateRequestGetAllSessions();
+	static std::string CreateRequestSubscribe(const std::vector< int32_t >& valuesToReturn, const uint32_t* minInterval);
+	static std::string CreateRequestUnsubscribe();
+	static std::string CreateRequestSetupRoute(const bool* startFromCurrentPosition, const std::vector<naviapi::Waypoint>* waypointsList);
 };
 
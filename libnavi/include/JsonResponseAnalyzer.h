@@ -17,9 +17,13 @@
 class JsonResponseAnalyzer
 {  
 public:
-	static std::map< int32_t, naviapi::variant > AnalyzeResponseGetPosition( std::string& res_json );
+	static naviapi::Position AnalyzeResponseGetPosition( std::string& res_json );
 	static std::vector< uint32_t > AnalyzeResponseGetAllRoutes( std::string& res_json );
 	static uint32_t AnalyzeResponseCreateRoute( std::string& res_json );
 	static std::map<uint32_t, std::string> AnalyzeResponseGetAllSessions( std::string& res_json );
+	static naviapi::Position AnalyzeEventPosition( std::string& event_json );
+
+private:
+	static void AnalyzePositionArray( struct json_object *json_map_ary, naviapi::Position& position );
 };
 
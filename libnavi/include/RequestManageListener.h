@@ -13,5 +13,6 @@ public:
 	}
 
 	virtual void OnReply(struct json_object *reply) = 0;
+	virtual void OnEvent(const char *event, struct json_object *data) = 0;
 };
 
@@ -18,13 +18,24 @@ static const uint32_t NAVICORE_HEADING = 0x00a3;
 static const uint32_t NAVICORE_SPEED = 0x00a4;
 static const uint32_t NAVICORE_SIMULATION_MODE = 0x00e3;
 
-typedef union
+// Bits of Position::mask, set for the fields present
+static const uint32_t POSITION_TIMESTAMP = 0x01;
+static const uint32_t POSITION_LATITUDE = 0x02;
+static const uint32_t POSITION_LONGITUDE = 0x04;
+static const uint32_t POSITION_HEADING = 0x08;
+static const uint32_t POSITION_SPEED = 0x10;
+static const uint32_t POSITION_SIMULATION_MODE = 0x20;
+
+typedef struct
 {
-	bool _bool;
-	int32_t _int32_t;
-	uint32_t _uint32_t;
-	double _double;
-} variant;
+	uint32_t mask;
+	uint32_t timestamp;
+	double latitude;
+	double longitude;
+	uint32_t heading;
+	int32_t speed;
+	bool simulationMode;
+} Position;
 
 typedef std::tuple<double, double> Waypoint;
 
@@ -35,9 +46,10 @@ public:
 	virtual ~NavicoreListener();
 
 	virtual void getAllSessions_reply(const std::map< uint32_t, std::string >& allSessions);
-	virtual void getPosition_reply(std::map< int32_t, variant > position);
+	virtual void getPosition_reply(const Position& position);
 	virtual void getAllRoutes_reply(std::vector< uint32_t > allRoutes);
 	virtual void createRoute_reply(uint32_t routeHandle);
+	virtual void position_event(const Position& position);
 }; // class NavicoreListener
 
 class Navicore
@@ -63,6 +75,11 @@ public:
 	void setWaypoints(uint32_t session, uint32_t routeHandle, bool flag, std::vector<Waypoint>);
 	void calculateRoute(uint32_t session, uint32_t routeHandle);
 
+	void subscribePosition(std::vector<int32_t> params, uint32_t minInterval);
+	void unsubscribePosition();
+
+	void setupRoute(bool flag, std::vector<Waypoint>);
+
 }; // class Navicore
 
 }; // namespace naviapi
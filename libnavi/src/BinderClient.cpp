@@ -258,6 +258,78 @@ void BinderClient::NavicoreGetAllSessions()
 	}
 }
 
+/**
+ *  @brief  Subscribe to position event
+ */
+void BinderClient::NavicoreSubscribe(const std::vector< int32_t >& valuesToReturn, const uint32_t& minInterval)
+{
+	// Check if it is connected
+	if( requestMng->IsConnect() )
+	{
+		// JSON request generation
+		std::string req_json = JsonRequestGenerator::CreateRequestSubscribe(valuesToReturn, &minInterval);
+
+		// Send request
+		if( requestMng->CallBinderAPI(API_NAME, VERB_SUBSCRIBE, req_json.c_str()) )
+		{
+			TRACE_DEBUG("navicore_subscribe success.\n");
+		}
+		else
+		{
+			TRACE_ERROR("navicore_subscribe failed.\n");
+		}
+	}
+}
+
+/**
+ *  @brief  Unsubscribe from position event
+ */
+void BinderClient::NavicoreUnsubscribe()
+{
+	// Check if it is connected
+	if( requestMng->IsConnect() )
+	{
+		// JSON request generation
+		std::string req_json = JsonRequestGenerator::CreateRequestUnsubscribe();
+
+		// Send request
+		if( requestMng->CallBinderAPI(API_NAME, VERB_UNSUBSCRIBE, req_json.c_str()) )
+		{
+			TRACE_DEBUG("navicore_unsubscribe success.\n");
+		}
+		else
+		{
+			TRACE_ERROR("navicore_unsubscribe failed.\n");
+		}
+	}
+}
+
+/**
+ *  @brief  Set up a route in one navicore_batch request
+ *          (getallsessions, createroute, setwaypoints, calculateroute)
+ *  @param  startFromCurrentPosition Whether to use the current position as the start point
+ *  @param  waypointsList Destination coordinates
+ */
+void BinderClient::NavicoreSetupRoute(const bool& startFromCurrentPosition, const std::vector<naviapi::Waypoint>& waypointsList)
+{
+	// Check if it is connected
+	if( requestMng->IsConnect() )
+	{
+		// JSON request generation
+		std::string req_json = JsonRequestGenerator::CreateRequestSetupRoute(&startFromCurrentPosition, &waypointsList);
+
+		// Send request
+		if( requestMng->CallBinderAPI(API_NAME, VERB_BATCH, req_json.c_str()) )
+		{
+			TRACE_DEBUG("navicore_batch success.\n");
+		}
+		else
+		{
+			TRACE_ERROR("navicore_batch failed.\n");
+		}
+	}
+}
+
 void BinderClient::OnReply(struct json_object* reply)
 {
 	struct json_object* requestObject = nullptr;
@@ -271,11 +343,66 @@ void BinderClient::OnReply(struct json_object* reply)
 	char tmpVerb[256];
 	strcpy(tmpVerb, info);
 
+	if (strcmp(VERB_BATCH, tmpVerb) == 0)
+	{
+		DispatchBatchReply(reply);
+		return;
+	}
+
 	// Create a new JSON response
 	const char* json_str = json_object_to_json_string_ext(reply, JSON_C_TO_STRING_PRETTY);
 	std::string response_json = std::string( json_str );
 
-	if (strcmp(VERB_GETALLSESSIONS, tmpVerb) == 0)
+	DispatchReply(tmpVerb, response_json);
+}
+
+/**
+ *  @brief  Notify each successful step of a navicore_batch reply
+ *          as if it had been requested alone
+ *  @param  reply Reply of navicore_batch
+ */
+void BinderClient::DispatchBatchReply(struct json_object* reply)
+{
+	struct json_object* results = nullptr;
+	if( !json_object_object_get_ex(reply, "response", &results) || !json_object_is_type(results, json_type_array) )
+	{
+		TRACE_WARN("navicore_batch response is not array.\n");
+		return;
+	}
+
+	for (int i = 0; i < json_object_array_length(results); ++i)
+	{
+		struct json_object* result = json_object_array_get_idx(results, i);
+
+		struct json_object* verbObject = nullptr;
+		struct json_object* statusObject = nullptr;
+		if( !json_object_object_get_ex(result, "verb", &verbObject) || !json_object_is_type(verbObject, json_type_string)
+		 || !json_object_object_get_ex(result, "status", &statusObject) || !json_object_is_type(statusObject, json_type_string) )
+		{
+			TRACE_WARN("navicore_batch result %d has no verb or status.\n", i);
+			continue;
+		}
+
+		if (strcmp("success", json_object_get_string(statusObject)) != 0)
+		{
+			TRACE_ERROR("navicore_batch %s %s.\n", json_object_get_string(verbObject), json_object_get_string(statusObject));
+			continue;
+		}
+
+		// Each result holds its "response" like a single reply
+		std::string response_json = std::string( json_object_to_json_string(result) );
+		DispatchReply(json_object_get_string(verbObject), response_json);
+	}
+}
+
+/**
+ *  @brief  Analyze the response of a verb and notify the listener
+ *  @param  verb Requested verb
+ *  @param  response_json JSON string holding the "response" key
+ */
+void BinderClient::DispatchReply(const char* verb, std::string& response_json)
+{
+	if (strcmp(VERB_GETALLSESSIONS, verb) == 0)
 	{
 		std::map<uint32_t, std::string> ret = JsonResponseAnalyzer::AnalyzeResponseGetAllSessions(response_json);
 
@@ -284,13 +411,13 @@ void BinderClient::OnReply(struct json_object* reply)
 
 		this->navicoreListener->getAllSessions_reply(ret);
 	}
-	else if (strcmp(VERB_GETPOSITION, tmpVerb) == 0)
+	else if (strcmp(VERB_GETPOSITION, verb) == 0)
 	{
-		std::map< int32_t, naviapi::variant > ret = JsonResponseAnalyzer::AnalyzeResponseGetPosition(response_json);
+		naviapi::Position ret = JsonResponseAnalyzer::AnalyzeResponseGetPosition(response_json);
 
 		this->navicoreListener->getPosition_reply(ret);
 	}
-	else if (strcmp(VERB_GETALLROUTES, tmpVerb) == 0)
+	else if (strcmp(VERB_GETALLROUTES, verb) == 0)
 	{
 		std::vector< uint32_t > ret = JsonResponseAnalyzer::AnalyzeResponseGetAllRoutes(response_json);
 
@@ -302,7 +429,17 @@ void BinderClient::OnReply(struct json_object* reply)
 
 		this->navicoreListener->getAllRoutes_reply(ret);
 	}
-	else if (strcmp(VERB_CREATEROUTE, tmpVerb) == 0)
+	else if (strcmp(VERB_SUBSCRIBE, verb) == 0)
+	{
+		// Initial values of the subscription, notified like a position event
+		naviapi::Position ret = JsonResponseAnalyzer::AnalyzeResponseGetPosition(response_json);
+
+		if (ret.mask != 0)
+		{
+			this->navicoreListener->position_event(ret);
+		}
+	}
+	else if (strcmp(VERB_CREATEROUTE, verb) == 0)
 	{
 		uint32_t ret = JsonResponseAnalyzer::AnalyzeResponseCreateRoute(response_json);
 
@@ -313,3 +450,16 @@ void BinderClient::OnReply(struct json_object* reply)
 	}
 }
 
+void BinderClient::OnEvent(const char* event, struct json_object* data)
+{
+	// Position events are named "naviapi/position/<group>"
+	if (strncmp(EVENT_POSITION, event, strlen(EVENT_POSITION)) == 0)
+	{
+		const char* json_str = json_object_to_json_string(data);
+		std::string event_json = std::string( json_str );
+
+		naviapi::Position ret = JsonResponseAnalyzer::AnalyzeEventPosition(event_json);
+
+		this->navicoreListener->position_event(ret);
+	}
+}
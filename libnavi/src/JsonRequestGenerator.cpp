@@ -25,7 +25,9 @@ std::string JsonRequestGenerator::CreateRequestGetPosition(const std::vector< in
 	json_object_object_add(request_json, "valuesToReturn", json_array);
 	TRACE_DEBUG("CreateRequestGetPosition request_json:\n%s\n", json_object_to_json_string(request_json));
     
-	return std::string( json_object_to_json_string( request_json ) );
+	std::string req_json = std::string( json_object_to_json_string( request_json ) );
+	json_object_put(request_json);
+	return req_json;
 }
 
 /**
@@ -38,7 +40,9 @@ std::string JsonRequestGenerator::CreateRequestGetAllRoutes()
 	struct json_object* request_json = json_object_new_object();
 	TRACE_DEBUG("CreateRequestGetAllRoutes request_json:\n%s\n", json_object_to_json_string(request_json));
 
-	return std::string( json_object_to_json_string( request_json ) );
+	std::string req_json = std::string( json_object_to_json_string( request_json ) );
+	json_object_put(request_json);
+	return req_json;
 }
 
 /**
@@ -52,7 +56,9 @@ std::string JsonRequestGenerator::CreateRequestCreateRoute(const uint32_t* sessi
 	json_object_object_add(request_json, "sessionHandle", json_object_new_int(*sessionHandle));
 	TRACE_DEBUG("CreateRequestCreateRoute request_json:\n%s\n", json_object_to_json_string(request_json));
 
-	return std::string( json_object_to_json_string( request_json ) );
+	std::string req_json = std::string( json_object_to_json_string( request_json ) );
+	json_object_put(request_json);
+	return req_json;
 }
 
 /**
@@ -67,7 +73,9 @@ std::string JsonRequestGenerator::CreateRequestPauseSimulation(const uint32_t* s
 	json_object_object_add(request_json, "sessionHandle", json_object_new_int(*sessionHandle));
 	TRACE_DEBUG("CreateRequestPauseSimulation request_json:\n%s\n", json_object_to_json_string(request_json));
 
-	return std::string( json_object_to_json_string( request_json ) );
+	std::string req_json = std::string( json_object_to_json_string( request_json ) );
+	json_object_put(request_json);
+	return req_json;
 }
 
 /**
@@ -87,7 +95,9 @@ std::string JsonRequestGenerator::CreateRequestSetSimulationMode(const uint32_t*
 	json_object_object_add(request_json, "simulationMode", json_object_new_boolean(*activate));
 	TRACE_DEBUG("CreateRequestSetSimulationMode request_json:\n%s\n", json_object_to_json_string(request_json));
 
-	return std::string( json_object_to_json_string( request_json ) );
+	std::string req_json = std::string( json_object_to_json_string( request_json ) );
+	json_object_put(request_json);
+	return req_json;
 }
 
 /**
@@ -107,7 +117,9 @@ std::string JsonRequestGenerator::CreateRequestCancelRouteCalculation(const uint
 	json_object_object_add(request_json, "route", json_object_new_int(*routeHandle));
 	TRACE_DEBUG("CreateRequestCancelRouteCalculation request_json:\n%s\n", json_object_to_json_string(request_json));
 
-	return std::string( json_object_to_json_string( request_json ) );
+	std::string req_json = std::string( json_object_to_json_string( request_json ) );
+	json_object_put(request_json);
+	return req_json;
 }
 
 /**
@@ -151,7 +163,9 @@ std::string JsonRequestGenerator::CreateRequestSetWaypoints(const uint32_t* sess
 	json_object_object_add(request_json, "", json_array);
 	TRACE_DEBUG("CreateRequestSetWaypoints request_json:\n%s\n", json_object_to_json_string(request_json));
 
-	return std::string( json_object_to_json_string( request_json ) );
+	std::string req_json = std::string( json_object_to_json_string( request_json ) );
+	json_object_put(request_json);
+	return req_json;
 }
 
 /**
@@ -170,7 +184,9 @@ std::string JsonRequestGenerator::CreateRequestCalculateroute(const uint32_t* se
 	json_object_object_add(request_json, "route", json_object_new_int(*routeHandle));
 	TRACE_DEBUG("CreateRequestCalculateroute request_json:\n%s\n", json_object_to_json_string(request_json));
 
-	return std::string( json_object_to_json_string( request_json ) );
+	std::string req_json = std::string( json_object_to_json_string( request_json ) );
+	json_object_put(request_json);
+	return req_json;
 }
 
 /**
@@ -183,6 +199,107 @@ std::string JsonRequestGenerator::CreateRequestGetAllSessions()
 	struct json_object* request_json = json_object_new_object();
 	TRACE_DEBUG("CreateRequestGetAllSessions request_json:\n%s\n", json_object_to_json_string(request_json));
 
-	return std::string( json_object_to_json_string( request_json ) );
+	std::string req_json = std::string( json_object_to_json_string( request_json ) );
+	json_object_put(request_json);
+	return req_json;
 }
 
+/**
+ *  @brief Generate request for navicore_subscribe
+ *  @param valuesToReturn Key information notified by position event
+ *  @param minInterval Minimum interval between two events in msec
+ *  @return json string
+ */
+std::string JsonRequestGenerator::CreateRequestSubscribe(const std::vector< int32_t >& valuesToReturn, const uint32_t* minInterval)
+{
+	std::vector< int32_t >::const_iterator itr;
+
+	struct json_object* request_json = json_object_new_object();
+	struct json_object* json_array = json_object_new_array();
+
+	// "event"
+	json_object_object_add(request_json, "event", json_object_new_string("position"));
+
+	// "valuesToReturn"
+	for (itr = valuesToReturn.begin(); itr != valuesToReturn.end(); itr++)
+	{
+		json_object_array_add(json_array, json_object_new_int(*itr));
+	}
+	json_object_object_add(request_json, "valuesToReturn", json_array);
+
+	// "minInterval"
+	json_object_object_add(request_json, "minInterval", json_object_new_int(*minInterval));
+	TRACE_DEBUG("CreateRequestSubscribe request_json:\n%s\n", json_object_to_json_string(request_json));
+
+	std::string req_json = std::string( json_object_to_json_string( request_json ) );
+	json_object_put(request_json);
+	return req_json;
+}
+
+/**
+ *  @brief Generate request for navicore_unsubscribe
+ *  @return json string
+ */
+std::string JsonRequestGenerator::CreateRequestUnsubscribe()
+{
+	// Request is empty and OK
+	struct json_object* request_json = json_object_new_object();
+	TRACE_DEBUG("CreateRequestUnsubscribe request_json:\n%s\n", json_object_to_json_string(request_json));
+
+	std::string req_json = std::string( json_object_to_json_string( request_json ) );
+	json_object_put(request_json);
+	return req_json;
+}
+
+/**
+ *  @brief Generate navicore_batch request to set up a route in one call:
+ *         getallsessions, createroute, setwaypoints and calculateroute
+ *  @param startFromCurrentPosition Whether to use the current position as the start point
+ *  @param waypointsList Destination coordinates
+ *  @return json string
+ */
+std::string JsonRequestGenerator::CreateRequestSetupRoute(const bool* startFromCurrentPosition, const std::vector<naviapi::Waypoint>* waypointsList)
+{
+	struct json_object* request_json = json_object_new_object();
+	struct json_object* requests = json_object_new_array();
+
+	// Step 0 : navicore_getallsessions
+	struct json_object* getallsessions = json_object_new_object();
+	json_object_object_add(getallsessions, "verb", json_object_new_string("navicore_getallsessions"));
+	json_object_array_add(requests, getallsessions);
+
+	// Step 1 : navicore_createroute on the first session
+	struct json_object* createroute = json_object_new_object();
+	struct json_object* createroute_args = json_object_new_object();
+	json_object_object_add(createroute_args, "sessionHandle", json_object_new_string("$0.0.sessionHandle"));
+	json_object_object_add(createroute, "verb", json_object_new_string("navicore_createroute"));
+	json_object_object_add(createroute, "args", createroute_args);
+	json_object_array_add(requests, createroute);
+
+	// Step 2 : navicore_setwaypoints on the new route
+	uint32_t dummy = 0;
+	struct json_object* setwaypoints = json_object_new_object();
+	struct json_object* setwaypoints_args = json_tokener_parse(
+		CreateRequestSetWaypoints(&dummy, &dummy, startFromCurrentPosition, waypointsList).c_str());
+	json_object_object_add(setwaypoints_args, "sessionHandle", json_object_new_string("$0.0.sessionHandle"));
+	json_object_object_add(setwaypoints_args, "route", json_object_new_string("$1.route"));
+	json_object_object_add(setwaypoints, "verb", json_object_new_string("navicore_setwaypoints"));
+	json_object_object_add(setwaypoints, "args", setwaypoints_args);
+	json_object_array_add(requests, setwaypoints);
+
+	// Step 3 : navicore_calculateroute
+	struct json_object* calculateroute = json_object_new_object();
+	struct json_object* calculateroute_args = json_object_new_object();
+	json_object_object_add(calculateroute_args, "sessionHandle", json_object_new_string("$0.0.sessionHandle"));
+	json_object_object_add(calculateroute_args, "route", json_object_new_string("$1.route"));
+	json_object_object_add(calculateroute, "verb", json_object_new_string("navicore_calculateroute"));
+	json_object_object_add(calculateroute, "args", calculateroute_args);
+	json_object_array_add(requests, calculateroute);
+
+	json_object_object_add(request_json, "requests", requests);
+	TRACE_DEBUG("CreateRequestSetupRoute request_json:\n%s\n", json_object_to_json_string(request_json));
+
+	std::string req_json = std::string( json_object_to_json_string( request_json ) );
+	json_object_put(request_json);
+	return req_json;
+}
@@ -8,11 +8,11 @@
 /**
  *  @brief Response analysis of navicore_getallroutes
  *  @param res_json JSON string of response
- *  @return Map information for the key sent in the request
+ *  @return Position with the fields of the keys sent in the request
  */
-std::map< int32_t, naviapi::variant > JsonResponseAnalyzer::AnalyzeResponseGetPosition( std::string& res_json )
+naviapi::Position JsonResponseAnalyzer::AnalyzeResponseGetPosition( std::string& res_json )
 {
-	std::map< int32_t, naviapi::variant > ret;
+	naviapi::Position ret = {0};
 
 	TRACE_DEBUG("AnalyzeResponseGetPosition json_obj:\n%s\n", json_object_to_json_string(json_obj));
 
@@ -23,69 +23,7 @@ std::map< int32_t, naviapi::variant > JsonResponseAnalyzer::AnalyzeResponseGetPo
 	struct json_object *json_map_ary = NULL;
 	if( json_object_object_get_ex(json_obj, "response", &json_map_ary) )
 	{
-		// Check if the response is array information
-		if( json_object_is_type(json_map_ary, json_type_array) )
-		{
-			for (int i = 0; i < json_object_array_length(json_map_ary); ++i) 
-			{
-				struct json_object* j_elem = json_object_array_get_idx(json_map_ary, i);
-                
-				if( json_object_is_type( j_elem, json_type_object) )
-				{
-					// Check key
-					struct json_object* key = NULL;
-					struct json_object* value = NULL;
-					if( json_object_object_get_ex(j_elem, "key", &key) 
-					    &&  json_object_object_get_ex(j_elem, "value", &value) )
-					{
-						if( json_object_is_type(key, json_type_int) )
-						{
-							uint32_t req_key = (uint32_t)json_object_get_int(key);
-
-							switch( req_key )
-							{
-							case naviapi::NAVICORE_LATITUDE:
-								ret[req_key]._double = json_object_get_double(value);
-								break;
-
-							case naviapi::NAVICORE_LONGITUDE:
-								ret[req_key]._double = json_object_get_double(value);
-								break;
-
-							case naviapi::NAVICORE_TIMESTAMP:
-								ret[req_key]._uint32_t = (uint32_t)json_object_get_int(value);
-								break;
-
-							case naviapi::NAVICORE_HEADING:
-								ret[req_key]._uint32_t = (uint32_t)json_object_get_int(value);
-								break;
-
-							case naviapi::NAVICORE_SPEED:
-								ret[req_key]._int32_t = json_object_get_int(value);
-								break;
-
-							case naviapi::NAVICORE_SIMULATION_MODE:
-								ret[req_key]._bool = json_object_get_boolean(value);
-								break;
-
-							default:
-								TRACE_WARN("unknown key type.\n");
-								break;
-							}
-						}
-					}
-				}
-				else
-				{
-					TRACE_WARN("element type is not object.\n");
-					break;
-				}
-			}
-		}
-		else
-		{
-			TRACE_WARN("response type is not array.\n");
-		}
+		AnalyzePositionArray(json_map_ary, ret);
 	}
 
 	json_object_put(json_obj);
@@ -252,3 +190,103 @@ std::map<uint32_t, std::string> JsonResponseAnalyzer::AnalyzeResponseGetAllSessi
 	return session_map;
 }
 
+/**
+ *  @brief Event analysis of position event
+ *  @param event_json JSON string of event
+ *  @return Position with the fields of the keys notified by the event
+ */
+naviapi::Position JsonResponseAnalyzer::AnalyzeEventPosition( std::string& event_json )
+{
+	naviapi::Position ret = {0};
+
+	// convert to Json Object
+	struct json_object *json_obj = json_tokener_parse( event_json.c_str() );
+
+	// Check key
+	struct json_object *json_map_ary = NULL;
+	if( json_object_object_get_ex(json_obj, "data", &json_map_ary) )
+	{
+		AnalyzePositionArray(json_map_ary, ret);
+	}
+
+	json_object_put(json_obj);
+	return ret;
+}
+
+/**
+ *  @brief Analysis of position key and value array
+ *  @param json_map_ary JSON array of key and value
+ *  @param position Position receiving the fields of the keys in the array
+ */
+void JsonResponseAnalyzer::AnalyzePositionArray( struct json_object *json_map_ary, naviapi::Position& position )
+{
+	// Check if the response is array information
+	if( json_object_is_type(json_map_ary, json_type_array) )
+	{
+		for (int i = 0; i < json_object_array_length(json_map_ary); ++i) 
+		{
+			struct json_object* j_elem = json_object_array_get_idx(json_map_ary, i);
+                
+			if( json_object_is_type( j_elem, json_type_object) )
+			{
+				// Check key
+				struct json_object* key = NULL;
+				struct json_object* value = NULL;
+				if( json_object_object_get_ex(j_elem, "key", &key) 
+				    &&  json_object_object_get_ex(j_elem, "value", &value) )
+				{
+					if( json_object_is_type(key, json_type_int) )
+					{
+						uint32_t req_key = (uint32_t)json_object_get_int(key);
+
+						switch( req_key )
+						{
+						case naviapi::NAVICORE_LATITUDE:
+							position.latitude = json_object_get_double(value);
+							position.mask |= naviapi::POSITION_LATITUDE;
+							break;
+
+						case naviapi::NAVICORE_LONGITUDE:
+							position.longitude = json_object_get_double(value);
+							position.mask |= naviapi::POSITION_LONGITUDE;
+							break;
+
+						case naviapi::NAVICORE_TIMESTAMP:
+							position.timestamp = (uint32_t)json_object_get_int64(value);
+							position.mask |= naviapi::POSITION_TIMESTAMP;
+							break;
+
+						case naviapi::NAVICORE_HEADING:
+							position.heading = (uint32_t)json_object_get_int(value);
+							position.mask |= naviapi::POSITION_HEADING;
+							break;
+
+						case naviapi::NAVICORE_SPEED:
+							position.speed = json_object_get_int(value);
+							position.mask |= naviapi::POSITION_SPEED;
+							break;
+
+						case naviapi::NAVICORE_SIMULATION_MODE:
+							position.simulationMode = json_object_get_boolean(value);
+							position.mask |= naviapi::POSITION_SIMULATION_MODE;
+							break;
+
+						default:
+							TRACE_WARN("unknown key type.\n");
+							break;
+						}
+					}
+				}
+			}
+			else
+			{
+				TRACE_WARN("element type is not object.\n");
+				break;
+			}
+		}
+	}
+	else
+	{
+		TRACE_WARN("response type is not array.\n");
+	}
+}
@@ -43,7 +43,7 @@ void* RequestManage::BinderThread(void* param)
 		return nullptr;
 	}
 
-	instance->wsj1 = afb_ws_client_connect_wsj1(loop, instance->requestURL->c_str(), &instance->wsj1_itf, nullptr);
+	instance->wsj1 = afb_ws_client_connect_wsj1(loop, instance->requestURL->c_str(), &instance->wsj1_itf, instance);
 	if (instance->wsj1 == nullptr)
 	{
 		TRACE_ERROR("connection to %s failed: %m\n", api_url);
@@ -169,6 +169,9 @@ void RequestManage::OnCallStatic(const char *api, const char *verb, struct afb_w
 
 void RequestManage::OnEventStatic(const char *event, struct afb_wsj1_msg *msg)
 {
+	struct json_object * json = afb_wsj1_msg_object_j(msg);
+
+	this->listener->OnEvent(event, json);
 }
 
 
@@ -196,9 +199,12 @@ void RequestManage::OnCallStatic(void *closure, const char *api, const char *ver
 	fflush(stdout);
 }
 
+/**
+ *  @brief  Event notification from service
+ */
 void RequestManage::OnEventStatic(void *closure, const char *event, struct afb_wsj1_msg *msg)
 {
-	printf("DEBUG:%s:%d (%p,%s,%p)\n", __func__, __LINE__, closure, event, msg);
-	fflush(stdout);
+	RequestManage* instance = (RequestManage *)closure;
+	instance->OnEventStatic(event, msg);
 }
 
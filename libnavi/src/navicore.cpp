@@ -79,3 +79,17 @@ void naviapi::Navicore::calculateRoute(uint32_t session, uint32_t routeHandle)
 	mBinderClient.NavicoreCalculateRoute(session, routeHandle);
 }
 
+void naviapi::Navicore::subscribePosition(std::vector<int32_t> params, uint32_t minInterval)
+{
+	mBinderClient.NavicoreSubscribe(params, minInterval);
+}
+
+void naviapi::Navicore::unsubscribePosition()
+{
+	mBinderClient.NavicoreUnsubscribe();
+}
+
+void naviapi::Navicore::setupRoute(bool flag, std::vector<Waypoint> waypoints)
+{
+	mBinderClient.NavicoreSetupRoute(flag, waypoints);
+}
@@ -14,7 +14,7 @@ void naviapi::NavicoreListener::getAllSessions_reply(const std::map< uint32_t, s
 {
 }
 
-void naviapi::NavicoreListener::getPosition_reply(std::map< int32_t, variant > position)
+void naviapi::NavicoreListener::getPosition_reply(const Position& position)
 {
 }
 
@@ -26,3 +26,7 @@ void naviapi::NavicoreListener::createRoute_reply(uint32_t routeHandle)
 {
 }
 
+void naviapi::NavicoreListener::position_event(const Position& position)
+{
+}
+
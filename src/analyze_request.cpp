@@ -3,6 +3,12 @@
 
 #include "genivi/genivi-navicore-constants.h"
 #include "analyze_request.h"
+#include "batch_request.h"
+#include "route_calculation.h"
+#include "dead_reckoning.h"
+#include "off_route_event.h"
+#include "track_replay.h"
+#include "binder_log.h"
 #include <stdio.h>
 #include <string.h>
 #include <json-c/json.h>
@@ -11,97 +17,241 @@
 
 /**
  *  @brief	Create arguments to pass to Genivi API GetPosition.
- *  @param[in]	req_json_str JSON request from BinderClient
- *  @param[out]	Params An array of key information you want to obtain
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	mask Position fields you want to obtain
+ *  @param[out]	maxAge Acceptable age of cached information in msec (optional key "maxAge")
+ *  @param[out]	horizon Longest prediction after the last fix in msec, 0 if not requested
+ *  			(optional keys "extrapolate" and "horizon")
  *  @return	Success or failure of processing
  */
-bool AnalyzeRequest::CreateParamsGetPosition( const char* req_json_str, std::vector< int32_t >& Params)
+bool AnalyzeRequest::CreateParamsGetPosition( json_object* req_json, uint32_t& mask, uint32_t& maxAge, uint32_t& horizon )
 {
-	struct json_object *req_json = json_tokener_parse(req_json_str);
-	struct json_object* jValuesToReturn = NULL;
-	if( json_object_object_get_ex(req_json, "valuesToReturn", &jValuesToReturn) )
+	horizon = 0;
+	struct json_object* jExtrapolate = NULL;
+	if( json_object_object_get_ex(req_json, "extrapolate", &jExtrapolate) )
 	{
-		if( json_object_is_type(jValuesToReturn, json_type_array) )
+		if( !json_object_is_type(jExtrapolate, json_type_boolean) )
 		{
-			for (int i = 0; i < json_object_array_length(jValuesToReturn); ++i) 
+			BINDER_NOTICE("key extrapolate is not bool type.");
+			return false;
+		}
+		if( json_object_get_boolean(jExtrapolate) )
+		{
+			horizon = DEAD_RECKONING_DEFAULT_HORIZON;
+			if( !JsonObjectGetOptionalInt(req_json, "horizon", 1, DEAD_RECKONING_MAX_HORIZON, horizon) )
 			{
-				struct json_object* j_elem = json_object_array_get_idx(jValuesToReturn, i);
-
-				// JSON type acquisition
-				if( json_object_is_type(j_elem, json_type_int ) )
-				{
-					int32_t req_key = json_object_get_int (j_elem);
-
-					// no supported.
-					if ((NAVICORE_TIMESTAMP == req_key) || (NAVICORE_SPEED == req_key))
-					{
-						continue;
-					}
-					Params.push_back(req_key);
-				}
-				else
-				{
-					fprintf(stdout, "key is not integer type.\n");
-					return false;
-				}
+				return false;
 			}
 		}
-		else
+	}
+
+	struct json_object* jMaxAge = NULL;
+	if( json_object_object_get_ex(req_json, "maxAge", &jMaxAge) )
+	{
+		if( !json_object_is_type(jMaxAge, json_type_int) || json_object_get_int(jMaxAge) < 0 )
 		{
-			fprintf(stdout, "request is not array type.\n");
+			BINDER_NOTICE("key maxAge is not positive integer type.");
 			return false;
 		}
+		maxAge = json_object_get_int(jMaxAge);
 	}
-	else
+
+	struct json_object* jValuesToReturn = NULL;
+	if( !json_object_object_get_ex(req_json, "valuesToReturn", &jValuesToReturn) )
 	{
-		fprintf(stdout, "key valuesToReturn not found.\n");
+		BINDER_NOTICE("key valuesToReturn not found.");
 		return false;
 	}
 
+	return JsonObjectGetValuesToReturn(jValuesToReturn, mask);
+}
+
+
+/**
+ *  @brief	Create arguments to get the progress along a route
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	routeHdl Route to track (optional key "route", 0 : the route under guidance)
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsGetRouteProgress( json_object* req_json, uint32_t& routeHdl )
+{
+	return JsonObjectGetOptionalInt(req_json, "route", 1, UINT32_MAX, routeHdl);
+}
+
+
+/**
+ *  @brief	Create arguments to get the position history
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	count Number of last samples (optional key "count")
+ *  @param[out]	duration Age of the oldest sample in msec (optional key "duration")
+ *  @param[out]	maxPoints Number of samples after downsampling (optional key "maxPoints")
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsGetPositionHistory( json_object* req_json, uint32_t& count, uint32_t& duration, uint32_t& maxPoints )
+{
+	return JsonObjectGetOptionalInt(req_json, "count", 1, POSITION_HISTORY_CAPACITY, count)
+		&& JsonObjectGetOptionalInt(req_json, "duration", 1, UINT32_MAX, duration)
+		&& JsonObjectGetOptionalInt(req_json, "maxPoints", POSITION_HISTORY_MIN_POINTS, POSITION_HISTORY_CAPACITY, maxPoints);
+}
+
+
+/**
+ *  @brief	Create arguments to subscribe to position event
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	mask Position fields notified by the event (optional key "valuesToReturn")
+ *  @param[out]	minInterval Minimum interval between two events in msec (optional key "minInterval")
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsSubscribe( json_object* req_json, uint32_t& mask, uint32_t& minInterval )
+{
+	struct json_object* jEvent = NULL;
+	if( json_object_object_get_ex(req_json, "event", &jEvent) )
+	{
+		if( !json_object_is_type(jEvent, json_type_string) || strcmp(json_object_get_string(jEvent), "position") != 0 )
+		{
+			BINDER_NOTICE("unknown event.");
+			return false;
+		}
+	}
+
+	struct json_object* jMinInterval = NULL;
+	if( json_object_object_get_ex(req_json, "minInterval", &jMinInterval) )
+	{
+		if( !json_object_is_type(jMinInterval, json_type_int) || json_object_get_int(jMinInterval) < 0 )
+		{
+			BINDER_NOTICE("key minInterval is not positive integer type.");
+			return false;
+		}
+		minInterval = json_object_get_int(jMinInterval);
+	}
+
+	struct json_object* jValuesToReturn = NULL;
+	if( json_object_object_get_ex(req_json, "valuesToReturn", &jValuesToReturn) )
+	{
+		return JsonObjectGetValuesToReturn(jValuesToReturn, mask);
+	}
+
+	// All supported keys by default
+	mask = NAVI_POSITION_ALL;
+
 	return true;
 }
 
 
+/**
+ *  @brief	Create arguments to subscribe to offroute event
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	distance Distance to the route in m (optional key "distance")
+ *  @param[out]	direction Difference with the direction of the route in degree (optional key "direction")
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsSubscribeOffRoute( json_object* req_json, uint32_t& distance, uint32_t& direction )
+{
+	return JsonObjectGetOptionalInt(req_json, "distance", 1, OFF_ROUTE_MAX_DISTANCE, distance)
+		&& JsonObjectGetOptionalInt(req_json, "direction", 1, 180, direction);
+}
+
+
+/**
+ *  @brief	Create arguments to subscribe to Genivi signal events
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	events Event names (key "events")
+ *  @param[out]	routeHdl Route the events are restricted to (optional key "route", 0 : any)
+ *  @param[out]	sessionHdl Session the events are restricted to (optional key "sessionHandle", 0 : any)
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsSubscribeEvents( json_object* req_json, std::vector< std::string >& events, uint32_t& routeHdl, uint32_t& sessionHdl )
+{
+	struct json_object* jEvents = NULL;
+	if( !json_object_object_get_ex(req_json, "events", &jEvents) )
+	{
+		BINDER_NOTICE("key events not found.");
+		return false;
+	}
+
+	struct json_object* jRoute = NULL;
+	if( json_object_object_get_ex(req_json, "route", &jRoute) )
+	{
+		if( !json_object_is_type(jRoute, json_type_int) )
+		{
+			BINDER_NOTICE("key route is not integer type.");
+			return false;
+		}
+		routeHdl = json_object_get_int(jRoute);
+	}
+
+	struct json_object* jSession = NULL;
+	if( json_object_object_get_ex(req_json, "sessionHandle", &jSession) )
+	{
+		if( !json_object_is_type(jSession, json_type_int) )
+		{
+			BINDER_NOTICE("key sessionHandle is not integer type.");
+			return false;
+		}
+		sessionHdl = json_object_get_int(jSession);
+	}
+
+	return JsonObjectGetEvents(jEvents, events);
+}
+
+
+/**
+ *  @brief	Create arguments to unsubscribe from Genivi signal events
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	events Event names (optional key "events", all events if absent)
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsUnsubscribeEvents( json_object* req_json, std::vector< std::string >& events )
+{
+	struct json_object* jEvents = NULL;
+	if( !json_object_object_get_ex(req_json, "events", &jEvents) )
+	{
+		return true;
+	}
+
+	return JsonObjectGetEvents(jEvents, events);
+}
+
+
 /**
  *  @brief	Create arguments to pass to Genivi API CreateRoute
- *  @param[in]	req_json_str JSON request from BinderClient
+ *  @param[in]	req_json JSON request from BinderClient
  *  @param[out]	sessionHdl Session handle
  *  @return	Success or failure of processing
  */
-bool AnalyzeRequest::CreateParamsCreateRoute( const char* req_json_str, uint32_t& sessionHdl )
+bool AnalyzeRequest::CreateParamsCreateRoute( json_object* req_json, uint32_t& sessionHdl )
 {
 	// Get sessionHandle information
-	return JsonObjectGetSessionHdl(req_json_str, sessionHdl);
+	return JsonObjectGetSessionHdl(req_json, sessionHdl);
 }
 
 
 /**
  *  @brief	Create arguments to pass to Genivi API PauseSimulation
- *  @param[in]	req_json_str JSON request from BinderClient
+ *  @param[in]	req_json JSON request from BinderClient
  *  @param[out]	sessionHdl Session handle
  *  @return	Success or failure of processing
  */
-bool AnalyzeRequest::CreateParamsPauseSimulation( const char* req_json_str, uint32_t& sessionHdl )
+bool AnalyzeRequest::CreateParamsPauseSimulation( json_object* req_json, uint32_t& sessionHdl )
 {
 	// Get sessionHandle information
-	return JsonObjectGetSessionHdl(req_json_str, sessionHdl);
+	return JsonObjectGetSessionHdl(req_json, sessionHdl);
 }
 
 
 /**
  *  @brief	Create arguments to pass to Genivi API CreateRoute
- *  @param[in]	req_json_str JSON request from BinderClient
+ *  @param[in]	req_json JSON request from BinderClient
  *  @param[out]	sessionHdl Session handle
  *  @param[out]	simuMode Simulation mode
  *  @return	Success or failure of processing
  */
-bool AnalyzeRequest::CreateParamsSetSimulationMode( const char* req_json_str, uint32_t& sessionHdl, bool& simuMode )
+bool AnalyzeRequest::CreateParamsSetSimulationMode( json_object* req_json, uint32_t& sessionHdl, bool& simuMode )
 {
 	bool		ret = false;
 	struct json_object *sess  = NULL;
 	struct json_object *simu  = NULL;
 
-	struct json_object *req_json = json_tokener_parse(req_json_str);
 	if ((json_object_object_get_ex(req_json, "sessionHandle", &sess)) &&
 		(json_object_object_get_ex(req_json, "simulationMode", &simu)))
 	{
@@ -114,12 +264,12 @@ bool AnalyzeRequest::CreateParamsSetSimulationMode( const char* req_json_str, ui
 		}
 		else
 		{
-			fprintf(stdout, "key is invalid type.\n");
+			BINDER_NOTICE("key is invalid type.");
 		}
 	}
 	else
 	{
-		fprintf(stdout, "key sessionHandle or simulationMode not found.\n");
+		BINDER_NOTICE("key sessionHandle or simulationMode not found.");
 	}
 
 	return ret;
@@ -128,28 +278,28 @@ bool AnalyzeRequest::CreateParamsSetSimulationMode( const char* req_json_str, ui
 
 /**
  *  @brief	Create arguments to pass to Genivi API CancelRouteCalculation
- *  @param[in]	req_json_str JSON request from BinderClient
+ *  @param[in]	req_json JSON request from BinderClient
  *  @param[out]	sessionHdl Session handle
  *  @param[out]	routeHdl Route handle
  *  @return	Success or failure of processing
  */
-bool AnalyzeRequest::CreateParamsCancelRouteCalculation( const char* req_json_str, uint32_t& sessionHdl, uint32_t& routeHdl )
+bool AnalyzeRequest::CreateParamsCancelRouteCalculation( json_object* req_json, uint32_t& sessionHdl, uint32_t& routeHdl )
 {
 	// Get sessionHandle, RouteHandle
-	return JsonObjectGetSessionHdlRouteHdl(req_json_str, sessionHdl, routeHdl);
+	return JsonObjectGetSessionHdlRouteHdl(req_json, sessionHdl, routeHdl);
 }
 
 
 /**
  *  @brief	Create arguments to pass to Genivi API SetWaypoints
- *  @param[in]	req_json_str JSON request from BinderClient
+ *  @param[in]	req_json JSON request from BinderClient
  *  @param[out]	sessionHdl Session handle
  *  @param[out]	routeHdl Route handle
  *  @param[out]	currentPos Whether or not to draw a route from the position of the vehicle
  *  @param[out]	waypointsList Destination coordinates
  *  @return	Success or failure of processing
  */
-bool AnalyzeRequest::CreateParamsSetWaypoints( const char* req_json_str, uint32_t& sessionHdl, uint32_t& routeHdl,
+bool AnalyzeRequest::CreateParamsSetWaypoints( json_object* req_json, uint32_t& sessionHdl, uint32_t& routeHdl,
 											   bool& currentPos, std::vector<Waypoint>& waypointsList )
 {
 	bool		ret = false;
@@ -158,7 +308,6 @@ bool AnalyzeRequest::CreateParamsSetWaypoints( const char* req_json_str, uint32_
 	struct json_object *current  = NULL;
 	struct json_object *wpl  = NULL;
 
-	struct json_object *req_json = json_tokener_parse(req_json_str);
 	if ((json_object_object_get_ex(req_json, "sessionHandle", &sess)) &&
 		(json_object_object_get_ex(req_json, "route", &rou))		  &&
 		(json_object_object_get_ex(req_json, "startFromCurrentPosition", &current)) &&
@@ -191,18 +340,18 @@ bool AnalyzeRequest::CreateParamsSetWaypoints( const char* req_json_str, uint32_
 				}
 				else
 				{
-					fprintf(stdout, "key latitude or longitude not found.\n");
+					BINDER_NOTICE("key latitude or longitude not found.");
 				}
 		   }
 		}
 		else
 		{
-			fprintf(stdout, "key is invalid type.\n");
+			BINDER_NOTICE("key is invalid type.");
 		}
 	}
 	else
 	{
-		fprintf(stdout, "key valuesToReturn not found.\n");
+		BINDER_NOTICE("key valuesToReturn not found.");
 	}
 
 	return ret;
@@ -211,31 +360,368 @@ bool AnalyzeRequest::CreateParamsSetWaypoints( const char* req_json_str, uint32_
 
 /**
  *  @brief	Create arguments to pass to Genivi API CalculateRoute
- *  @param[in]	req_json_str JSON request from BinderClient
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	sessionHdl Session handle
+ *  @param[out]	routeHdl Route handle
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsCalculateRoute( json_object* req_json, uint32_t& sessionHdl, uint32_t& routeHdl )
+{
+	// Get sessionHandle, RouteHandle
+	return JsonObjectGetSessionHdlRouteHdl(req_json, sessionHdl, routeHdl);
+}
+
+
+/**
+ *  @brief	Create arguments to calculate a route and wait for the end of the calculation
+ *  @param[in]	req_json JSON request from BinderClient
  *  @param[out]	sessionHdl Session handle
  *  @param[out]	routeHdl Route handle
+ *  @param[out]	timeout Time to wait for the end of the calculation in msec (optional key "timeout")
  *  @return	Success or failure of processing
  */
-bool AnalyzeRequest::CreateParamsCalculateRoute( const char* req_json_str, uint32_t& sessionHdl, uint32_t& routeHdl )
+bool AnalyzeRequest::CreateParamsCalculateRouteWait( json_object* req_json, uint32_t& sessionHdl, uint32_t& routeHdl, uint32_t& timeout )
 {
+	struct json_object* jTimeout = NULL;
+	if( json_object_object_get_ex(req_json, "timeout", &jTimeout) )
+	{
+		if( !json_object_is_type(jTimeout, json_type_int) || json_object_get_int(jTimeout) <= 0
+		 || json_object_get_int(jTimeout) > ROUTE_CALCULATION_MAX_TIMEOUT )
+		{
+			BINDER_NOTICE("key timeout is out of range.");
+			return false;
+		}
+		timeout = json_object_get_int(jTimeout);
+	}
+
 	// Get sessionHandle, RouteHandle
-	return JsonObjectGetSessionHdlRouteHdl(req_json_str, sessionHdl, routeHdl);
+	return JsonObjectGetSessionHdlRouteHdl(req_json, sessionHdl, routeHdl);
+}
+
+
+/**
+ *  @brief	Create arguments to pass to Genivi API GetRouteSegments
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	routeHdl Route handle
+ *  @param[out]	offset Index of the first segment (optional key "offset")
+ *  @param[out]	limit Maximum number of segments (optional key "limit")
+ *  @param[out]	encoding How the segments are returned (optional key "encoding", "json" or "polyline")
+ *  @param[out]	precision Decimal digits of the encoded polyline (optional key "precision")
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsGetRouteSegments( json_object* req_json, uint32_t& routeHdl, uint32_t& offset, uint32_t& limit,
+												   RouteSegmentsEncoding& encoding, uint32_t& precision )
+{
+	struct json_object* jEncoding = NULL;
+	if( json_object_object_get_ex(req_json, "encoding", &jEncoding) )
+	{
+		const char* name = json_object_is_type(jEncoding, json_type_string) ? json_object_get_string(jEncoding) : "";
+		if( strcmp(name, "json") == 0 )
+		{
+			encoding = ROUTE_SEGMENTS_ENCODING_JSON;
+		}
+		else if( strcmp(name, "polyline") == 0 )
+		{
+			encoding = ROUTE_SEGMENTS_ENCODING_POLYLINE;
+		}
+		else
+		{
+			BINDER_NOTICE("unknown encoding.");
+			return false;
+		}
+	}
+
+	return JsonObjectGetRouteHdl(req_json, routeHdl)
+		&& JsonObjectGetOptionalInt(req_json, "offset", 0, UINT32_MAX, offset)
+		&& JsonObjectGetOptionalInt(req_json, "limit", 1, ROUTE_SEGMENTS_MAX_LIMIT, limit)
+		&& JsonObjectGetOptionalInt(req_json, "precision", 1, ROUTE_SEGMENTS_MAX_PRECISION, precision);
+}
+
+
+/**
+ *  @brief	Create arguments to pass to Genivi API GetRouteBoundingBox
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	routeHdl Route handle
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsGetRouteBoundingBox( json_object* req_json, uint32_t& routeHdl )
+{
+	return JsonObjectGetRouteHdl(req_json, routeHdl);
+}
+
+
+/**
+ *  @brief	Create arguments to pass to Genivi API GetWaypoints
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	routeHdl Route handle
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsGetWaypoints( json_object* req_json, uint32_t& routeHdl )
+{
+	return JsonObjectGetRouteHdl(req_json, routeHdl);
+}
+
+
+/**
+ *  @brief	Create arguments to pass to Genivi API GetManeuversList
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	routeHdl Route handle, must be the route under guidance
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsGetManeuvers( json_object* req_json, uint32_t& routeHdl )
+{
+	return JsonObjectGetRouteHdl(req_json, routeHdl);
+}
+
+
+/**
+ *  @brief	Check the sub-requests of navicore_batch
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	requests Array of {"verb": name, "args": object} (borrowed from req_json)
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsBatch( json_object* req_json, json_object*& requests )
+{
+	if( !json_object_object_get_ex(req_json, "requests", &requests)
+	 || !json_object_is_type(requests, json_type_array) )
+	{
+		BINDER_NOTICE("key requests is not found or not array type.");
+		return false;
+	}
+
+	int count = json_object_array_length(requests);
+	if( count == 0 || count > BATCH_MAX_REQUESTS )
+	{
+		BINDER_NOTICE("requests count %d is out of range.", count);
+		return false;
+	}
+
+	for (int i = 0; i < count; ++i)
+	{
+		json_object* request = json_object_array_get_idx(requests, i);
+		json_object* verb = NULL;
+		json_object* args = NULL;
+
+		if( !json_object_object_get_ex(request, "verb", &verb) || !json_object_is_type(verb, json_type_string) )
+		{
+			BINDER_NOTICE("requests[%d] key verb is not found or not string type.", i);
+			return false;
+		}
+
+		if( json_object_object_get_ex(request, "args", &args) && !json_object_is_type(args, json_type_object) )
+		{
+			BINDER_NOTICE("requests[%d] key args is not object type.", i);
+			return false;
+		}
+	}
+
+	return true;
 }
 
 
+/**
+ *  @brief	Check the options of navicore_stats
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	reset Whether to clear the metrics after returning them (optional key "reset")
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsStats( json_object* req_json, bool& reset )
+{
+	struct json_object* jReset = NULL;
+	if( json_object_object_get_ex(req_json, "reset", &jReset) )
+	{
+		if( !json_object_is_type(jReset, json_type_boolean) )
+		{
+			BINDER_NOTICE("key reset is not bool type.");
+			return false;
+		}
+		reset = json_object_get_boolean(jReset);
+	}
+
+	return true;
+}
+
+
+/**
+ *  @brief	Create the fences to register
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	shapes Areas (key "fences" : array of circles and polygons)
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsAddGeofence( json_object* req_json, std::vector< GeofenceShape >& shapes )
+{
+	struct json_object* jFences = NULL;
+	if( !json_object_object_get_ex(req_json, "fences", &jFences) || !json_object_is_type(jFences, json_type_array) )
+	{
+		BINDER_NOTICE("key fences not found or not array type.");
+		return false;
+	}
+
+	int len = json_object_array_length(jFences);
+	if( len == 0 || len > GEOFENCE_MAX_FENCES )
+	{
+		BINDER_NOTICE("key fences is empty or too long.");
+		return false;
+	}
+
+	for (int i = 0; i < len; i++)
+	{
+		struct json_object* jFence = json_object_array_get_idx(jFences, i);
+		struct json_object* jType = NULL;
+		if( !json_object_object_get_ex(jFence, "type", &jType) || !json_object_is_type(jType, json_type_string) )
+		{
+			BINDER_NOTICE("key type not found or not string type.");
+			return false;
+		}
+
+		GeofenceShape shape;
+		shape.latitude = 0;
+		shape.longitude = 0;
+		shape.radius = 0;
+		shape.dwell = 0;
+		if( !JsonObjectGetOptionalInt(jFence, "dwell", 1, GEOFENCE_MAX_DWELL, shape.dwell) )
+		{
+			return false;
+		}
+
+		const char* type = json_object_get_string(jType);
+		if( strcmp(type, "circle") == 0 )
+		{
+			shape.type = GEOFENCE_CIRCLE;
+			if( !JsonObjectGetCoordinate(jFence, shape.latitude, shape.longitude) )
+			{
+				return false;
+			}
+			if( !JsonObjectGetOptionalInt(jFence, "radius", 1, GEOFENCE_MAX_RADIUS, shape.radius) || shape.radius == 0 )
+			{
+				BINDER_NOTICE("key radius not found.");
+				return false;
+			}
+		}
+		else if( strcmp(type, "polygon") == 0 )
+		{
+			shape.type = GEOFENCE_POLYGON;
+			struct json_object* jPoints = NULL;
+			if( !json_object_object_get_ex(jFence, "points", &jPoints) || !json_object_is_type(jPoints, json_type_array)
+			 || json_object_array_length(jPoints) < 3 || json_object_array_length(jPoints) > GEOFENCE_MAX_POINTS )
+			{
+				BINDER_NOTICE("key points not found or not array of 3 to %d points.", GEOFENCE_MAX_POINTS);
+				return false;
+			}
+
+			int count = json_object_array_length(jPoints);
+			shape.points.reserve(count);
+			for (int j = 0; j < count; j++)
+			{
+				double latitude;
+				double longitude;
+				if( !JsonObjectGetCoordinate(json_object_array_get_idx(jPoints, j), latitude, longitude) )
+				{
+					return false;
+				}
+				shape.points.push_back(Waypoint(latitude, longitude));
+			}
+		}
+		else
+		{
+			BINDER_NOTICE("unknown fence type.");
+			return false;
+		}
+
+		shapes.push_back(shape);
+	}
+
+	return true;
+}
+
+
+/**
+ *  @brief	Get the fences to unregister
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	ids Fence ids (key "fences")
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsRemoveGeofence( json_object* req_json, std::vector< uint32_t >& ids )
+{
+	struct json_object* jFences = NULL;
+	if( !json_object_object_get_ex(req_json, "fences", &jFences) || !json_object_is_type(jFences, json_type_array) )
+	{
+		BINDER_NOTICE("key fences not found or not array type.");
+		return false;
+	}
+
+	int len = json_object_array_length(jFences);
+	for (int i = 0; i < len; i++)
+	{
+		struct json_object* jId = json_object_array_get_idx(jFences, i);
+		if( !json_object_is_type(jId, json_type_int) || json_object_get_int64(jId) <= 0 || json_object_get_int64(jId) > UINT32_MAX )
+		{
+			BINDER_NOTICE("fence id is not positive integer type.");
+			return false;
+		}
+		ids.push_back(json_object_get_int64(jId));
+	}
+
+	return true;
+}
+
+
+/**
+ *  @brief	Create arguments to record the positions in a track file
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	name Name of the track file (key "file")
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsStartRecording( json_object* req_json, std::string& name )
+{
+	return JsonObjectGetTrackName(req_json, name);
+}
+
+
+/**
+ *  @brief	Create arguments to replay a track file
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	name Name of the track file (key "file")
+ *  @param[out]	sessionHdl Session handle given to SetPosition
+ *  @param[out]	speed Times the recorded speed (optional key "speed")
+ *  @param[out]	repeat Start again at the end of the track (optional key "repeat")
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::CreateParamsStartReplay( json_object* req_json, std::string& name, uint32_t& sessionHdl, uint32_t& speed, bool& repeat )
+{
+	if( !JsonObjectGetTrackName(req_json, name)
+	 || !JsonObjectGetSessionHdl(req_json, sessionHdl)
+	 || !JsonObjectGetOptionalInt(req_json, "speed", 1, TRACK_REPLAY_MAX_SPEED, speed) )
+	{
+		return false;
+	}
+
+	struct json_object* jRepeat = NULL;
+	if( json_object_object_get_ex(req_json, "repeat", &jRepeat) )
+	{
+		if( !json_object_is_type(jRepeat, json_type_boolean) )
+		{
+			BINDER_NOTICE("key repeat is not bool type.");
+			return false;
+		}
+		repeat = json_object_get_boolean(jRepeat);
+	}
+
+	return true;
+}
+
 /**
  *  @brief	Get session handle and route handle information from JSON
- *  @param[in]	req_json_str JSON request from BinderClient
+ *  @param[in]	req_json JSON request from BinderClient
  *  @param[out]	Session handle value
  *  @return	Success or failure of processing
  */
 
-bool AnalyzeRequest::JsonObjectGetSessionHdl( const char* req_json_str, uint32_t& sessionHdl)
+bool AnalyzeRequest::JsonObjectGetSessionHdl( json_object* req_json, uint32_t& sessionHdl)
 {
 	bool		ret = false;
 	struct json_object *sess  = NULL;
 
-	struct json_object *req_json = json_tokener_parse(req_json_str);
 	if (json_object_object_get_ex(req_json, "sessionHandle", &sess))
 	{
 		if (json_object_is_type(sess, json_type_int))
@@ -245,12 +731,12 @@ bool AnalyzeRequest::JsonObjectGetSessionHdl( const char* req_json_str, uint32_t
 		}
 		else
 		{
-			fprintf(stdout, "key is not integer type.\n");
+			BINDER_NOTICE("key is not integer type.");
 		}
 	}
 	else
 	{
-		fprintf(stdout, "key sessionHandle not found.\n");
+		BINDER_NOTICE("key sessionHandle not found.");
 	}
 
 	return ret;
@@ -259,19 +745,18 @@ bool AnalyzeRequest::JsonObjectGetSessionHdl( const char* req_json_str, uint32_t
 
 /**
  *  @brief	Get session handle and route handle information from JSON
- *  @param[in]	req_json_str JSON request from BinderClient
+ *  @param[in]	req_json JSON request from BinderClient
  *  @param[out]	Session handle value
  *  @param[out]	Route handle value
  *  @return	Success or failure of processing
  */
 
-bool AnalyzeRequest::JsonObjectGetSessionHdlRouteHdl( const char* req_json_str, uint32_t& sessionHdl, uint32_t& routeHdl)
+bool AnalyzeRequest::JsonObjectGetSessionHdlRouteHdl( json_object* req_json, uint32_t& sessionHdl, uint32_t& routeHdl)
 {
 	bool		ret = false;
 	struct json_object *sess  = NULL;
 	struct json_object *rou  = NULL;
 
-	struct json_object *req_json = json_tokener_parse(req_json_str);
 	if ((json_object_object_get_ex(req_json, "sessionHandle", &sess)) &&
 		(json_object_object_get_ex(req_json, "route", &rou)))
 	{
@@ -284,13 +769,207 @@ bool AnalyzeRequest::JsonObjectGetSessionHdlRouteHdl( const char* req_json_str,
 		}
 		else
 		{
-			fprintf(stdout, "key is not integer type.\n");
+			BINDER_NOTICE("key is not integer type.");
 		}
 	}
 	else
 	{
-		fprintf(stdout, "key sessionHandle or route not found.\n");
+		BINDER_NOTICE("key sessionHandle or route not found.");
 	}
 
 	return ret;
 }
+
+
+/**
+ *  @brief	Get route handle
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	routeHdl Route handle
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::JsonObjectGetRouteHdl( json_object* req_json, uint32_t& routeHdl )
+{
+	struct json_object* rou = NULL;
+	if( !json_object_object_get_ex(req_json, "route", &rou) )
+	{
+		BINDER_NOTICE("key route not found.");
+		return false;
+	}
+
+	if( !json_object_is_type(rou, json_type_int) )
+	{
+		BINDER_NOTICE("key route is not integer type.");
+		return false;
+	}
+
+	routeHdl = json_object_get_int(rou);
+	return true;
+}
+
+
+/**
+ *  @brief	Get an optional integer in a range, left unchanged if the key is absent
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[in]	key Key of the integer
+ *  @param[in]	min Minimum value
+ *  @param[in]	max Maximum value
+ *  @param[out]	value Integer
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::JsonObjectGetOptionalInt( json_object* req_json, const char* key, uint32_t min, uint32_t max, uint32_t& value )
+{
+	struct json_object* jValue = NULL;
+	if( !json_object_object_get_ex(req_json, key, &jValue) )
+	{
+		return true;
+	}
+
+	int64_t number = json_object_get_int64(jValue);
+	if( !json_object_is_type(jValue, json_type_int) || number < min || number > max )
+	{
+		BINDER_NOTICE("key %s is out of range.", key);
+		return false;
+	}
+
+	value = (uint32_t)number;
+	return true;
+}
+
+
+/**
+ *  @brief	Get key information array of position
+ *  @param[in]	jValuesToReturn JSON array of keys
+ *  @param[out]	mask Position fields of the supported keys
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::JsonObjectGetValuesToReturn( json_object* jValuesToReturn, uint32_t& mask )
+{
+	mask = 0;
+
+	if( !json_object_is_type(jValuesToReturn, json_type_array) )
+	{
+		BINDER_NOTICE("request is not array type.");
+		return false;
+	}
+
+	for (int i = 0; i < json_object_array_length(jValuesToReturn); ++i) 
+	{
+		struct json_object* j_elem = json_object_array_get_idx(jValuesToReturn, i);
+
+		// JSON type acquisition
+		if( json_object_is_type(j_elem, json_type_int ) )
+		{
+			int field = NaviPositionField(json_object_get_int (j_elem));
+
+			// no supported.
+			if( field < 0 )
+			{
+				continue;
+			}
+			mask |= 1u << field;
+		}
+		else
+		{
+			BINDER_NOTICE("key is not integer type.");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ *  @brief	Get event names from JSON
+ *  @param[in]	jEvents JSON array of event names
+ *  @param[out]	events Event names
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::JsonObjectGetEvents( json_object* jEvents, std::vector< std::string >& events )
+{
+	if( !json_object_is_type(jEvents, json_type_array) )
+	{
+		BINDER_NOTICE("key events is not array type.");
+		return false;
+	}
+
+	int len = json_object_array_length(jEvents);
+	for (int i = 0; i < len; i++)
+	{
+		struct json_object* jEvent = json_object_array_get_idx(jEvents, i);
+		if( !json_object_is_type(jEvent, json_type_string) )
+		{
+			BINDER_NOTICE("event name is not string type.");
+			return false;
+		}
+		events.push_back(json_object_get_string(jEvent));
+	}
+
+	return true;
+}
+
+
+/**
+ *  @brief	Get the coordinates of a point
+ *  @param[in]	jPoint Object with the keys "latitude" and "longitude"
+ *  @param[out]	latitude Latitude in degree
+ *  @param[out]	longitude Longitude in degree
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::JsonObjectGetCoordinate( json_object* jPoint, double& latitude, double& longitude )
+{
+	struct json_object* jLatitude = NULL;
+	struct json_object* jLongitude = NULL;
+	if( !json_object_object_get_ex(jPoint, "latitude", &jLatitude)
+	 || !json_object_object_get_ex(jPoint, "longitude", &jLongitude) )
+	{
+		BINDER_NOTICE("key latitude or longitude not found.");
+		return false;
+	}
+
+	if( !(json_object_is_type(jLatitude, json_type_double) || json_object_is_type(jLatitude, json_type_int))
+	 || !(json_object_is_type(jLongitude, json_type_double) || json_object_is_type(jLongitude, json_type_int)) )
+	{
+		BINDER_NOTICE("key latitude or longitude is not number type.");
+		return false;
+	}
+
+	latitude = json_object_get_double(jLatitude);
+	longitude = json_object_get_double(jLongitude);
+	if( latitude < -90.0 || latitude > 90.0 || longitude < -180.0 || longitude > 180.0 )
+	{
+		BINDER_NOTICE("key latitude or longitude out of range.");
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ *  @brief	Get the name of a track file, a name only so that no other file is reached
+ *  @param[in]	req_json JSON request from BinderClient
+ *  @param[out]	name Name of the file (key "file")
+ *  @return	Success or failure of processing
+ */
+bool AnalyzeRequest::JsonObjectGetTrackName( json_object* req_json, std::string& name )
+{
+	struct json_object* jFile = NULL;
+	if( !json_object_object_get_ex(req_json, "file", &jFile) || !json_object_is_type(jFile, json_type_string) )
+	{
+		BINDER_NOTICE("key file not found or not string type.");
+		return false;
+	}
+
+	const char* file = json_object_get_string(jFile);
+	size_t len = strlen(file);
+	if( len == 0 || len > TRACK_FILE_MAX_NAME || file[0] == '.' || strspn(file,
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_-.") != len )
+	{
+		BINDER_NOTICE("key file is not a valid file name.");
+		return false;
+	}
+
+	name = file;
+	return true;
+}
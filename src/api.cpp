@@ -2,387 +2,1738 @@
 // Copyright 2017 AISIN AW CO.,LTD
 
 #include <string.h>
+#include <stdlib.h>
 
 #include "binder_reply.h"
+#include "sd_event_queue.h"
 #include "genivi_request.h"
 #include "analyze_request.h"
+#include "position_cache.h"
+#include "position_event.h"
+#include "position_history.h"
+#include "dead_reckoning.h"
+#include "geofence.h"
+#include "signal_event.h"
+#include "route_calculation.h"
+#include "route_cache.h"
+#include "route_progress.h"
+#include "off_route_event.h"
+#include "track_recorder.h"
+#include "track_replay.h"
+#include "request_coalescer.h"
+#include "handle_list_cache.h"
+#include "batch_request.h"
+#include "binder_metrics.h"
 #include "genivi/genivi-navicore-constants.h"
 
-#define AFB_BINDING_VERSION 2
+#include "binder_afb.h"
+#include "binder_log.h"
 
-extern "C" {
-	#include <afb/afb-binding.h>
+/**
+ *  Variable declaration
+ */
+SdEventQueue* loopQueue;	// Tasks of the worker threads run by the event loop
+GeniviRequest* geniviRequest;	// Send request to Genivi
+BinderReply* binderReply;	// Convert Genivi response result to json format
+AnalyzeRequest* analyzeRequest;	// Analyze BinderClient's request and create arguments to pass to GeniviAPI
+PositionCache* positionCache;	// Position information notified by Genivi
+PositionEvent* positionEvent;	// Push position changes to subscribed clients
+PositionHistory* positionHistory;	// Last positions of the vehicle
+DeadReckoning* deadReckoning;	// Position predicted between two fixes
+Geofence* geofence;	// Areas whose entry and exit are pushed to clients
+SignalEvent* signalEvent;	// Forward Genivi signals to subscribed clients
+RouteCalculation* routeCalculation;	// Route calculations waited for by clients
+RouteCache* routeCache;	// Data of calculated routes shared by clients
+RouteProgress* routeProgress;	// Remaining distance and time along the route under guidance
+OffRouteEvent* offRouteEvent;	// Push drifts off the route under guidance to subscribed clients
+RequestCoalescer< NaviPosition >* positionRequests;	// GetPosition calls in flight, by generation and fields
+HandleListCache* handleListCache;	// Session and route lists answered without Genivi
+BatchRequest* batchRequest;	// Execute several verbs in one request
+BinderMetrics* binderMetrics;	// Count and latency of each verb
+TrackRecorder* trackRecorder;	// Record the positions in a track file
+TrackReplay* trackReplay;	// Give the positions of a track file to Genivi
+std::string trackDirectory;	// Directory of the track files
+
+/**
+ *  @brief Verbs of the API measured by BinderMetrics
+ */
+enum ApiVerb
+{
+	API_VERB_GETPOSITION,
+	API_VERB_GETALLROUTES,
+	API_VERB_CREATEROUTE,
+	API_VERB_PAUSESIMULATION,
+	API_VERB_SETSIMULATIONMODE,
+	API_VERB_CANCELROUTECALCULATION,
+	API_VERB_SETWAYPOINTS,
+	API_VERB_CALCULATEROUTE,
+	API_VERB_CALCULATEROUTE_WAIT,
+	API_VERB_GETALLSESSIONS,
+	API_VERB_GETROUTESEGMENTS,
+	API_VERB_GETROUTEBOUNDINGBOX,
+	API_VERB_GETWAYPOINTS,
+	API_VERB_GETMANEUVERS,
+	API_VERB_GETPOSITIONHISTORY,
+	API_VERB_SUBSCRIBE,
+	API_VERB_UNSUBSCRIBE,
+	API_VERB_SUBSCRIBEEVENTS,
+	API_VERB_UNSUBSCRIBEEVENTS,
+	API_VERB_GETROUTEPROGRESS,
+	API_VERB_SUBSCRIBEROUTEPROGRESS,
+	API_VERB_UNSUBSCRIBEROUTEPROGRESS,
+	API_VERB_SUBSCRIBEOFFROUTE,
+	API_VERB_UNSUBSCRIBEOFFROUTE,
+	API_VERB_ADDGEOFENCE,
+	API_VERB_REMOVEGEOFENCE,
+	API_VERB_SUBSCRIBEGEOFENCE,
+	API_VERB_UNSUBSCRIBEGEOFENCE,
+	API_VERB_STARTRECORDING,
+	API_VERB_STOPRECORDING,
+	API_VERB_STARTREPLAY,
+	API_VERB_STOPREPLAY,
+	API_VERB_BATCH,
+	API_VERB_STATS,
+	API_VERB_MAX
+};
+
+/**
+ *  @brief Name of each verb
+ */
+static const char* apiVerbNames[API_VERB_MAX] =
+{
+	"navicore_getposition",
+	"navicore_getallroutes",
+	"navicore_createroute",
+	"navicore_pausesimulation",
+	"navicore_setsimulationmode",
+	"navicore_cancelroutecalculation",
+	"navicore_setwaypoints",
+	"navicore_calculateroute",
+	"navicore_calculateroute_wait",
+	"navicore_getallsessions",
+	"navicore_getroutesegments",
+	"navicore_getrouteboundingbox",
+	"navicore_getwaypoints",
+	"navicore_getmaneuvers",
+	"navicore_getpositionhistory",
+	"navicore_subscribe",
+	"navicore_unsubscribe",
+	"navicore_subscribeevents",
+	"navicore_unsubscribeevents",
+	"navicore_getrouteprogress",
+	"navicore_subscriberouteprogress",
+	"navicore_unsubscriberouteprogress",
+	"navicore_subscribeoffroute",
+	"navicore_unsubscribeoffroute",
+	"navicore_addgeofence",
+	"navicore_removegeofence",
+	"navicore_subscribegeofence",
+	"navicore_unsubscribegeofence",
+	"navicore_startrecording",
+	"navicore_stoprecording",
+	"navicore_startreplay",
+	"navicore_stopreplay",
+	"navicore_batch",
+	"navicore_stats",
+};
+
+/**
+ *  @brief Metrics of each verb, resolved by Init
+ */
+static VerbMetrics* apiVerbMetrics[API_VERB_MAX];
+
+/**
+ *  @brief      Return the response converted to json format to BinderClient
+ *  @param[in]  req Request from client
+ *  @param[in]  response Response information
+ *  @param[in]  verb Requested verb
+ *  @param[in]  sampled Whether the response is traced
+ */
+static void SendResponse(afb_req req, APIResponse& response, const char* verb, bool sampled)
+{
+	// On success
+	if(response.isSuccess)
+	{
+		BINDER_REQ_NOTICE_JSON(req, sampled, "res_json_str", response.json_data);
+		// Return success to BinderClient
+		afb_req_success(req, response.json_data, verb);
+	}
+	else
+	{
+		AFB_REQ_ERROR(req, "%s - %s:%d", response.errMessage.c_str(), __FILE__, __LINE__);
+		afb_req_fail_f(req, "failed", "%s %s", verb, response.errMessage.c_str());
+	}
+
+	// json object release
+	json_object_put(response.json_data);
+}
+
+/**
+ *  @brief      Create the response of a request that cannot be analyzed
+ *  @return     Response information
+ */
+static APIResponse BadRequest()
+{
+	APIResponse response = {false, "Bad Request", NULL};
+	return response;
+}
+
+/**
+ *  @brief      Create the response of Genivi API without return value
+ *  @param[in]  isSuccess Success or failure of Genivi API call
+ *  @return     Response information
+ */
+static APIResponse Result(bool isSuccess)
+{
+	APIResponse response = {isSuccess, isSuccess ? "" : "Genivi call failed", NULL};
+	return response;
+}
+
+/**
+ *  @brief      Execute a verb and return its response to BinderClient
+ *  @param[in]  req Request from client
+ *  @param[in]  verb Requested verb
+ *  @param[in]  executor Processing of the verb
+ */
+static void ExecuteVerb(afb_req req, ApiVerb verb, VerbExecutor executor)
+{
+	const char* name = apiVerbNames[verb];
+
+	// Request of Json format request
+	json_object* req_json = afb_req_json(req);
+	bool sampled = BINDER_LOG_SAMPLE();
+	BINDER_REQ_NOTICE_JSON(req, sampled, "req_json_str", req_json);
+
+	// Keep the request until Genivi replies
+	afb_req_addref(req);
+
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[verb] );
+	executor( req_json, sample, [req, name, sample, sampled]( APIResponse& response )
+	{
+		bool isSuccess = response.isSuccess;
+		SendResponse( req, response, name, sampled );
+		sample->Done( isSuccess );
+		afb_req_unref(req);
+	});
+}
+
+/**
+ *  @brief navicore_getposition processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreGetPosition(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis and create arguments to pass to Genivi
+	uint32_t mask = 0;
+	uint32_t maxAge = POSITION_CACHE_DEFAULT_MAX_AGE;
+	uint32_t horizon = 0;
+	if( !analyzeRequest->CreateParamsGetPosition( req_json, mask, maxAge, horizon ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	NaviPosition cached;
+	cached.mask = 0;
+
+	// Predicted from the last fix, the fields not notified are taken from the cache
+	uint32_t extrapolated = 0;
+	if( horizon != 0 && deadReckoning->Get( mask, horizon, cached, extrapolated ) )
+	{
+		uint32_t rest = mask & ~cached.mask;
+		if( rest == 0 || positionCache->Get( rest, maxAge, cached ))
+		{
+			APIResponse response = binderReply->ReplyNavicoreGetPosition( cached, extrapolated );
+			reply( response );
+			return;
+		}
+		cached.mask = 0;
+	}
+
+	// Answer from the position notified by Genivi when it is recent enough
+	if( positionCache->Get( mask, maxAge, cached ))
+	{
+		APIResponse response = binderReply->ReplyNavicoreGetPosition( cached, 0 );
+		reply( response );
+		return;
+	}
+
+	// GENIVI API call, shared by the requests of the same fields until the next PositionUpdate
+	sample->Parsed();
+	uint32_t generation = positionCache->BeginFetch();
+	uint64_t key = ((uint64_t)generation << 32) | mask;
+	std::shared_ptr< RequestCoalescer< NaviPosition >::Waiters > waiters;
+	if( !positionRequests->Join( key, [reply, sample]( NaviPosition& position )
+		{
+			sample->Called();
+
+			// Convert to json style response
+			APIResponse response = binderReply->ReplyNavicoreGetPosition( position, 0 );
+			reply( response );
+		}, waiters ))
+	{
+		return;
+	}
+
+	geniviRequest->NavicoreGetPositionAsync( NaviPositionKeys(mask), [generation, key, waiters]( NaviPosition& position )
+	{
+		positionCache->Update( position, generation );
+		positionRequests->Complete( key, waiters, position );
+	});
+}
+
+/**
+ *  @brief navicore_getallroutes processing
+ *  @param[in] req_json Request in json format (unused)
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreGetAllRoutes(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Answered from the route list kept up to date by the signals
+	sample->Parsed();
+	handleListCache->GetAllRoutes( [reply, sample]( std::shared_ptr< json_object >& shared )
+	{
+		sample->Called();
+
+		// No route while Genivi is not available
+		std::vector< uint32_t > allRoutes;
+		APIResponse response = shared ? binderReply->ReplyShared( shared ) : binderReply->ReplyNavicoreGetAllRoutes( allRoutes );
+		reply( response );
+	});
+}
+
+/**
+ *  @brief navicore_createroute processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreCreateRoute(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis and create arguments to pass to Genivi
+	uint32_t sessionHdl = 0;
+	if( !analyzeRequest->CreateParamsCreateRoute( req_json, sessionHdl ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// GetAllRoutes sent before CreateRoute would miss the new route
+	handleListCache->BeginCreateRoute();
+
+	// GENEVI API call
+	sample->Parsed();
+	geniviRequest->NavicoreCreateRouteAsync( sessionHdl, [reply, sample]( uint32_t routeHdl )
+	{
+		sample->Called();
+
+		if( routeHdl != 0 )
+		{
+			handleListCache->AddRoute( routeHdl );
+		}
+
+		// Convert to json style response
+		APIResponse response = binderReply->ReplyNavicoreCreateRoute( routeHdl );
+		reply( response );
+	});
+}
+
+/**
+ *  @brief navicore_pausesimulation processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicorePauseSimulation(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis and create arguments to pass to Genivi
+	uint32_t sessionHdl = 0;
+	if( !analyzeRequest->CreateParamsPauseSimulation( req_json, sessionHdl ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// GENEVI API call
+	sample->Parsed();
+	geniviRequest->NavicorePauseSimulationAsync( sessionHdl, [reply, sample]( bool isSuccess )
+	{
+		sample->Called();
+
+		APIResponse response = Result( isSuccess );
+		reply( response );
+	});
+}
+
+/**
+ *  @brief navicore_setsimulationmode processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreSetSimulationMode(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis and create arguments to pass to Genivi
+	uint32_t sessionHdl = 0;
+	bool simuMode = false;
+	if( !analyzeRequest->CreateParamsSetSimulationMode( req_json, sessionHdl, simuMode ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// GENEVI API call
+	sample->Parsed();
+	geniviRequest->NavicoreSetSimulationModeAsync( sessionHdl, simuMode, [reply, sample]( bool isSuccess )
+	{
+		sample->Called();
+
+		APIResponse response = Result( isSuccess );
+		reply( response );
+	});
+}
+
+/**
+ *  @brief navicore_cancelroutecalculation processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreCancelRouteCalculation(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis and create arguments to pass to Genivi
+	uint32_t sessionHdl = 0;
+	uint32_t routeHdl = 0;
+	if( !analyzeRequest->CreateParamsCancelRouteCalculation( req_json, sessionHdl, routeHdl ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// GENEVI API call
+	sample->Parsed();
+	geniviRequest->NavicoreCancelRouteCalculationAsync( sessionHdl, routeHdl, [reply, sample]( bool isSuccess )
+	{
+		sample->Called();
+
+		APIResponse response = Result( isSuccess );
+		reply( response );
+	});
+}
+
+/**
+ *  @brief navicore_setwaypoints processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreWaypoints(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis and create arguments to pass to Genivi
+	uint32_t sessionHdl = 0;
+	uint32_t routeHdl = 0;
+	bool currentPos = false;
+	std::vector<Waypoint> waypointsList;
+	if( !analyzeRequest->CreateParamsSetWaypoints( req_json, sessionHdl, routeHdl, currentPos, waypointsList ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// GENEVI API call
+	sample->Parsed();
+	geniviRequest->NavicoreSetWaypointsAsync( sessionHdl, routeHdl, currentPos, waypointsList, [reply, sample, routeHdl]( bool isSuccess )
+	{
+		sample->Called();
+
+		// The cached waypoints of the route are not the ones of Genivi anymore
+		if( isSuccess )
+		{
+			routeCache->Invalidate( routeHdl );
+		}
+
+		APIResponse response = Result( isSuccess );
+		reply( response );
+	});
+}
+
+/**
+ *  @brief navicore_calculateroute processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreCalculateRoute(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis and create arguments to pass to Genivi
+	uint32_t sessionHdl = 0;
+	uint32_t routeHdl = 0;
+	if( !analyzeRequest->CreateParamsCalculateRoute( req_json, sessionHdl, routeHdl ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// GENEVI API call
+	sample->Parsed();
+	geniviRequest->NavicoreCalculateRouteAsync( sessionHdl, routeHdl, [reply, sample]( bool isSuccess )
+	{
+		sample->Called();
+
+		APIResponse response = Result( isSuccess );
+		reply( response );
+	});
+}
+
+/**
+ *  @brief navicore_calculateroute_wait processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response, once the calculation has ended
+ */
+static void ExecuteNavicoreCalculateRouteWait(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis and create arguments to pass to Genivi
+	uint32_t sessionHdl = 0;
+	uint32_t routeHdl = 0;
+	uint32_t timeout = ROUTE_CALCULATION_DEFAULT_TIMEOUT;
+	if( !analyzeRequest->CreateParamsCalculateRouteWait( req_json, sessionHdl, routeHdl, timeout ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// GENEVI API call, answered on the end signal of the route
+	sample->Parsed();
+	routeCalculation->Calculate( sessionHdl, routeHdl, timeout, [reply, sample, routeHdl]( RouteCalculationResult result,
+		int32_t errorCode, const std::map< int32_t, int32_t >& unfullfilledPreferences )
+	{
+		sample->Called();
+
+		APIResponse response = binderReply->ReplyNavicoreCalculateRouteWait( routeHdl, result, errorCode, unfullfilledPreferences );
+		reply( response );
+	});
+}
+
+/**
+ *  @brief navicore_getroutesegments processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreGetRouteSegments(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis and create arguments to pass to Genivi
+	uint32_t routeHdl = 0;
+	uint32_t offset = 0;
+	uint32_t limit = ROUTE_SEGMENTS_DEFAULT_LIMIT;
+	RouteSegmentsEncoding encoding = ROUTE_SEGMENTS_ENCODING_JSON;
+	uint32_t precision = ROUTE_SEGMENTS_DEFAULT_PRECISION;
+	if( !analyzeRequest->CreateParamsGetRouteSegments( req_json, routeHdl, offset, limit, encoding, precision ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// Page of the segments shared by every client
+	sample->Parsed();
+	routeCache->GetSegments( routeHdl,
+		[reply, sample, routeHdl, offset, limit, encoding, precision]( bool isSuccess, const std::vector< RouteSegment >& segments )
+	{
+		sample->Called();
+
+		if( !isSuccess )
+		{
+			APIResponse response = Result( false );
+			reply( response );
+			return;
+		}
+
+		uint32_t total = segments.size();
+		uint32_t begin = offset < total ? offset : total;
+		uint32_t end = total - begin > limit ? begin + limit : total;
+		std::vector< RouteSegment > page( segments.begin() + begin, segments.begin() + end );
+
+		// Convert to json style response
+		APIResponse response = binderReply->ReplyNavicoreGetRouteSegments( routeHdl, total, offset, page, encoding, precision );
+		reply( response );
+	});
+}
+
+/**
+ *  @brief navicore_getrouteboundingbox processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreGetRouteBoundingBox(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis and create arguments to pass to Genivi
+	uint32_t routeHdl = 0;
+	if( !analyzeRequest->CreateParamsGetRouteBoundingBox( req_json, routeHdl ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// Bounding box shared by every client
+	sample->Parsed();
+	routeCache->GetBoundingBox( routeHdl, [reply, sample, routeHdl]( bool isSuccess, const RouteBoundingBox& boundingBox )
+	{
+		sample->Called();
+
+		if( !isSuccess )
+		{
+			APIResponse response = Result( false );
+			reply( response );
+			return;
+		}
+
+		// Convert to json style response
+		APIResponse response = binderReply->ReplyNavicoreGetRouteBoundingBox( routeHdl, boundingBox );
+		reply( response );
+	});
+}
+
+/**
+ *  @brief navicore_getwaypoints processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreGetWaypoints(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis and create arguments to pass to Genivi
+	uint32_t routeHdl = 0;
+	if( !analyzeRequest->CreateParamsGetWaypoints( req_json, routeHdl ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// Waypoints shared by every client
+	sample->Parsed();
+	routeCache->GetWaypoints( routeHdl, [reply, sample, routeHdl]( bool isSuccess, const RouteWaypoints& waypoints )
+	{
+		sample->Called();
+
+		if( !isSuccess )
+		{
+			APIResponse response = Result( false );
+			reply( response );
+			return;
+		}
+
+		// Convert to json style response
+		APIResponse response = binderReply->ReplyNavicoreGetWaypoints( routeHdl, waypoints.startFromCurrentPosition, waypoints.waypoints );
+		reply( response );
+	});
+}
+
+/**
+ *  @brief navicore_getmaneuvers processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreGetManeuvers(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis and create arguments to pass to Genivi
+	uint32_t routeHdl = 0;
+	if( !analyzeRequest->CreateParamsGetManeuvers( req_json, routeHdl ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// Maneuvers of the route under guidance, shared by every client
+	sample->Parsed();
+	routeCache->GetManeuvers( routeHdl, [reply, sample, routeHdl]( bool isSuccess, const std::vector< RouteManeuver >& maneuvers )
+	{
+		sample->Called();
+
+		if( !isSuccess )
+		{
+			APIResponse response = Result( false );
+			reply( response );
+			return;
+		}
+
+		// Convert to json style response
+		APIResponse response = binderReply->ReplyNavicoreGetManeuvers( routeHdl, maneuvers );
+		reply( response );
+	});
+}
+
+/**
+ *  @brief navicore_getpositionhistory processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreGetPositionHistory(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis
+	uint32_t count = 0;
+	uint32_t duration = 0;
+	uint32_t maxPoints = 0;
+	if( !analyzeRequest->CreateParamsGetPositionHistory( req_json, count, duration, maxPoints ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// Answered from the positions recorded by the binding
+	sample->Parsed();
+	PositionSamples samples;
+	positionHistory->Get( count, duration, maxPoints, samples );
+	sample->Called();
+
+	APIResponse response = binderReply->ReplyNavicoreGetPositionHistory( samples );
+	reply( response );
+}
+
+/**
+ *  @brief navicore_getrouteprogress processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreGetRouteProgress(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis
+	uint32_t routeHdl = 0;
+	if( !analyzeRequest->CreateParamsGetRouteProgress( req_json, routeHdl ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// Answered from the route segments once loaded
+	sample->Parsed();
+	routeProgress->Get( routeHdl, [reply, sample]( bool isSuccess, const RouteProgressInfo& progress )
+	{
+		sample->Called();
+
+		if( !isSuccess )
+		{
+			APIResponse response = {false, "No route under guidance", NULL};
+			reply( response );
+			return;
+		}
+
+		APIResponse response = binderReply->ReplyNavicoreGetRouteProgress( progress );
+		reply( response );
+	});
+}
+
+/**
+ *  @brief navicore_addgeofence processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreAddGeofence(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis
+	std::vector< GeofenceShape > shapes;
+	if( !analyzeRequest->CreateParamsAddGeofence( req_json, shapes ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	// Fences are kept by the binding
+	sample->Parsed();
+	std::vector< uint32_t > ids;
+	bool isAdded = geofence->Add( shapes, ids );
+	sample->Called();
+
+	if( !isAdded )
+	{
+		APIResponse response = {false, "Too many fences", NULL};
+		reply( response );
+		return;
+	}
+
+	APIResponse response = binderReply->ReplyNavicoreAddGeofence( ids );
+	reply( response );
+}
+
+/**
+ *  @brief navicore_removegeofence processing
+ *  @param[in] req_json Request in json format
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreRemoveGeofence(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Request analysis
+	std::vector< uint32_t > ids;
+	if( !analyzeRequest->CreateParamsRemoveGeofence( req_json, ids ))
+	{
+		APIResponse response = BadRequest();
+		reply( response );
+		return;
+	}
+
+	sample->Parsed();
+	bool isFound = geofence->Remove( ids );
+	sample->Called();
+
+	APIResponse response = {isFound, isFound ? "" : "Unknown fence", NULL};
+	reply( response );
+}
+
+/**
+ *  @brief navicore_getallsessions processing
+ *  @param[in] req_json Request in json format (unused)
+ *  @param[in] sample Timing of the request
+ *  @param[in] reply Called with the response
+ */
+static void ExecuteNavicoreGetAllSessions(json_object* req_json, VerbSamplePtr sample, VerbReply reply)
+{
+	// Answered from the session list kept up to date by the signals
+	sample->Parsed();
+	handleListCache->GetAllSessions( [reply, sample]( std::shared_ptr< json_object >& shared )
+	{
+		sample->Called();
+
+		// No session while Genivi is not available
+		std::map<uint32_t, std::string> allSessions;
+		APIResponse response = shared ? binderReply->ReplyShared( shared ) : binderReply->ReplyNavicoreGetAllSessions( allSessions );
+		reply( response );
+	});
+}
+
+
+/**
+ *  @brief navicore_getposition request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreGetPosition(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_getposition");
+
+	ExecuteVerb( req, API_VERB_GETPOSITION, ExecuteNavicoreGetPosition );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_getallroutes request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreGetAllRoutes(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_getallroutes");
+
+	ExecuteVerb( req, API_VERB_GETALLROUTES, ExecuteNavicoreGetAllRoutes );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_createroute request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreCreateRoute(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s ", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_createroute");
+
+	ExecuteVerb( req, API_VERB_CREATEROUTE, ExecuteNavicoreCreateRoute );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_pausesimulation request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicorePauseSimulation(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_pausesimulation");
+
+	ExecuteVerb( req, API_VERB_PAUSESIMULATION, ExecuteNavicorePauseSimulation );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_setsimulationmode request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreSetSimulationMode(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_setsimulationmode");
+
+	ExecuteVerb( req, API_VERB_SETSIMULATIONMODE, ExecuteNavicoreSetSimulationMode );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_cancelroutecalculation request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreCancelRouteCalculation(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_cancelroutecalculation");
+
+	ExecuteVerb( req, API_VERB_CANCELROUTECALCULATION, ExecuteNavicoreCancelRouteCalculation );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_setwaypoints request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreWaypoints(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_setwaypoints");
+
+	ExecuteVerb( req, API_VERB_SETWAYPOINTS, ExecuteNavicoreWaypoints );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_calculateroute request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreCalculateRoute(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_calculateroute");
+
+	ExecuteVerb( req, API_VERB_CALCULATEROUTE, ExecuteNavicoreCalculateRoute );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_calculateroute_wait request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreCalculateRouteWait(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_calculateroute_wait");
+
+	ExecuteVerb( req, API_VERB_CALCULATEROUTE_WAIT, ExecuteNavicoreCalculateRouteWait );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_getroutesegments request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreGetRouteSegments(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_getroutesegments");
+
+	ExecuteVerb( req, API_VERB_GETROUTESEGMENTS, ExecuteNavicoreGetRouteSegments );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_getrouteboundingbox request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreGetRouteBoundingBox(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_getrouteboundingbox");
+
+	ExecuteVerb( req, API_VERB_GETROUTEBOUNDINGBOX, ExecuteNavicoreGetRouteBoundingBox );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_getwaypoints request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreGetWaypoints(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_getwaypoints");
+
+	ExecuteVerb( req, API_VERB_GETWAYPOINTS, ExecuteNavicoreGetWaypoints );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_getmaneuvers request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreGetManeuvers(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_getmaneuvers");
+
+	ExecuteVerb( req, API_VERB_GETMANEUVERS, ExecuteNavicoreGetManeuvers );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_getpositionhistory request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreGetPositionHistory(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_getpositionhistory");
+
+	ExecuteVerb( req, API_VERB_GETPOSITIONHISTORY, ExecuteNavicoreGetPositionHistory );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
 }
 
+
 /**
- *  Variable declaration
+ *  @brief navicore_getrouteprogress request callback
+ *  @param[in] req Request from client
  */
-GeniviRequest* geniviRequest;	// Send request to Genivi
-BinderReply* binderReply;	// Convert Genivi response result to json format
-AnalyzeRequest* analyzeRequest;	// Analyze BinderClient's request and create arguments to pass to GeniviAPI
+void OnRequestNavicoreGetRouteProgress(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_getrouteprogress");
+
+	ExecuteVerb( req, API_VERB_GETROUTEPROGRESS, ExecuteNavicoreGetRouteProgress );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
 
 /**
- *  @brief navicore_getposition request callback
+ *  @brief navicore_addgeofence request callback
  *  @param[in] req Request from client
  */
-void OnRequestNavicoreGetPosition(afb_req req)
+void OnRequestNavicoreAddGeofence(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_addgeofence");
+
+	ExecuteVerb( req, API_VERB_ADDGEOFENCE, ExecuteNavicoreAddGeofence );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_removegeofence request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreRemoveGeofence(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_removegeofence");
+
+	ExecuteVerb( req, API_VERB_REMOVEGEOFENCE, ExecuteNavicoreRemoveGeofence );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_getallsessions request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreGetAllSessions(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_getallsessions");
+
+	ExecuteVerb( req, API_VERB_GETALLSESSIONS, ExecuteNavicoreGetAllSessions );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_batch request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreBatch(afb_req req)
 {
-	AFB_REQ_NOTICE(req, "--> Start %s()", __func__);
-	AFB_REQ_DEBUG(req, "request navicore_getposition");
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_batch");
 
 	// Request of Json format request
 	json_object* req_json = afb_req_json(req);
-	const char* req_json_str = json_object_to_json_string(req_json);
-	AFB_REQ_NOTICE(req, "req_json_str = %s", req_json_str);
+	bool sampled = BINDER_LOG_SAMPLE();
+	BINDER_REQ_NOTICE_JSON(req, sampled, "req_json_str", req_json);
 
-	// Request analysis and create arguments to pass to Genivi
-	std::vector< int32_t > Params;
-	if( !analyzeRequest->CreateParamsGetPosition( req_json_str, Params ))
+	// Request analysis
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_BATCH] );
+	json_object* requests = NULL;
+	if( !analyzeRequest->CreateParamsBatch( req_json, requests ))
 	{
-		afb_req_fail(req, "failed", "navicore_getposition Bad Request");
+		afb_req_fail(req, "failed", "navicore_batch Bad Request");
+		sample->Done( false );
 		return;
 	}
 
-	// GENIVI API call
-	std::map< int32_t, double > posList = geniviRequest->NavicoreGetPosition( Params );
+	// Keep the request until every step is done
+	afb_req_addref(req);
 
-	// Convert to json style response
-	APIResponse response = binderReply->ReplyNavicoreGetPosition( posList );
+	batchRequest->Execute( requests, [req, sample, sampled]( json_object* results )
+	{
+		BINDER_REQ_NOTICE_JSON(req, sampled, "res_json_str", results);
+		afb_req_success(req, results, "navicore_batch");
+		sample->Done( true );
+		afb_req_unref(req);
+	});
 
-	// On success
-	if(response.isSuccess)
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_subscribe request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreSubscribe(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_subscribe");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_SUBSCRIBE] );
+
+	// Request of Json format request
+	json_object* req_json = afb_req_json(req);
+	BINDER_REQ_NOTICE_JSON(req, BINDER_LOG_SAMPLE(), "req_json_str", req_json);
+
+	// Request analysis
+	uint32_t mask = 0;
+	uint32_t minInterval = 0;
+	if( !analyzeRequest->CreateParamsSubscribe( req_json, mask, minInterval ))
 	{
-		AFB_REQ_NOTICE(req, "res_json_str = %s", json_object_to_json_string(response.json_data));
-		// Return success to BinderClient
-		afb_req_success(req, response.json_data, "navicore_getposition");
+		afb_req_fail(req, "failed", "navicore_subscribe Bad Request");
+		sample->Done( false );
+		return;
 	}
-	else
+
+	// Keep the request until the initial values are known
+	afb_req_addref(req);
+
+	if( !positionEvent->Subscribe( req, mask, minInterval, [req, sample]( NaviPosition& position )
+		{
+			// Return success to BinderClient, with the initial values when Genivi gave them
+			APIResponse response = binderReply->ReplyNavicoreGetPosition( position, 0 );
+			afb_req_success(req, response.isSuccess ? response.json_data : NULL, "navicore_subscribe");
+			sample->Done( true );
+			if( !response.isSuccess )
+			{
+				json_object_put(response.json_data);
+			}
+			afb_req_unref(req);
+		}))
 	{
-		AFB_REQ_ERROR(req, "%s - %s:%d", response.errMessage.c_str(), __FILE__, __LINE__);
-		afb_req_fail(req, "failed", "navicore_getposition Bad Request");
+		afb_req_fail(req, "failed", "navicore_subscribe cannot subscribe");
+		sample->Done( false );
+		afb_req_unref(req);
+		return;
 	}
 
-	// Json object release
-	json_object_put(response.json_data);
-
-	AFB_REQ_NOTICE(req, "<-- End %s()", __func__);
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
 }
 
 
 /**
- *  @brief navicore_getallroutes request callback
+ *  @brief navicore_unsubscribe request callback
  *  @param[in] req Request from client
  */
-void OnRequestNavicoreGetAllRoutes(afb_req req)
+void OnRequestNavicoreUnsubscribe(afb_req req)
 {
-	AFB_REQ_NOTICE(req, "--> Start %s()", __func__);
-	AFB_REQ_DEBUG(req, "request navicore_getallroutes");
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_unsubscribe");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_UNSUBSCRIBE] );
 
-	// No request information in json format
-	AFB_REQ_NOTICE(req, "req_json_str = none");
+	positionEvent->Unsubscribe( req );
 
-	// GENEVI API call
-	std::vector< uint32_t > allRoutes = geniviRequest->NavicoreGetAllRoutes();
+	// Return success to BinderClient
+	afb_req_success(req, NULL, "navicore_unsubscribe");
+	sample->Done( true );
 
-	// Convert to json style response
-	APIResponse response = binderReply->ReplyNavicoreGetAllRoutes( allRoutes );
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
 
-	// On success
-	if(response.isSuccess)
-	{
-		AFB_REQ_NOTICE(req, "res_json_str = %s", json_object_to_json_string(response.json_data));
-		// Return success to BinderClient
-		afb_req_success(req, response.json_data, "navicore_getallroutes");
-	}
-	else
+
+/**
+ *  @brief      Convert event names of a request
+ *  @param[in]  names Event names
+ *  @param[out] types Signals
+ *  @return     false if a name is unknown
+ */
+static bool GetSignalEventTypes( const std::vector< std::string >& names, std::vector< SignalEventType >& types )
+{
+	for (size_t i = 0; i < names.size(); i++)
 	{
-		AFB_REQ_ERROR(req, "%s - %s:%d", response.errMessage.c_str(), __FILE__, __LINE__);
-		afb_req_fail(req, "failed", "navicore_getallroutes Bad Request");
+		SignalEventType type;
+		if( !SignalEvent::GetType( names[i].c_str(), type ))
+		{
+			return false;
+		}
+		types.push_back( type );
 	}
-
-	// json object release
-	json_object_put(response.json_data);
-
-	AFB_REQ_NOTICE(req, "<-- End %s()", __func__);
+	return true;
 }
 
 
 /**
- *  @brief navicore_createroute request callback
+ *  @brief navicore_subscribeevents request callback
  *  @param[in] req Request from client
  */
-void OnRequestNavicoreCreateRoute(afb_req req)
+void OnRequestNavicoreSubscribeEvents(afb_req req)
 {
-	AFB_REQ_NOTICE(req, "--> Start %s ", __func__);
-	AFB_REQ_DEBUG(req, "request navicore_createroute");
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_subscribeevents");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_SUBSCRIBEEVENTS] );
 
-	// Request of json format request
+	// Request of Json format request
 	json_object* req_json = afb_req_json(req);
-	const char* req_json_str = json_object_to_json_string(req_json);
-	AFB_REQ_NOTICE(req, "req_json_str = %s", req_json_str);
+	BINDER_REQ_NOTICE_JSON(req, BINDER_LOG_SAMPLE(), "req_json_str", req_json);
+
+	// Request analysis
+	std::vector< std::string > names;
+	std::vector< SignalEventType > types;
+	SignalEventFilter filter = { 0, 0 };
+	if( !analyzeRequest->CreateParamsSubscribeEvents( req_json, names, filter.route, filter.sessionHandle )
+	 || names.empty() || !GetSignalEventTypes( names, types ))
+	{
+		afb_req_fail(req, "failed", "navicore_subscribeevents Bad Request");
+		sample->Done( false );
+		return;
+	}
 
-	// Request analysis and create arguments to pass to Genivi
-	uint32_t sessionHdl = 0;
-	if( !analyzeRequest->CreateParamsCreateRoute( req_json_str, sessionHdl ))
+	if( !signalEvent->Subscribe( req, types, filter ))
 	{
-		afb_req_fail(req, "failed", "navicore_createroute Bad Request");
+		afb_req_fail(req, "failed", "navicore_subscribeevents cannot subscribe");
+		sample->Done( false );
 		return;
 	}
 
-	// GENEVI API call
-	uint32_t routeHdl = geniviRequest->NavicoreCreateRoute( sessionHdl );
+	// Return success to BinderClient
+	afb_req_success(req, NULL, "navicore_subscribeevents");
+	sample->Done( true );
 
-	// Convert to json style response
-	APIResponse response = binderReply->ReplyNavicoreCreateRoute( routeHdl );
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
 
-	// On success
-	if(response.isSuccess)
-	{
-		AFB_REQ_NOTICE(req, "res_json_str = %s", json_object_to_json_string(response.json_data));
-		// Return success to BinderClient
-		afb_req_success(req, response.json_data, "navicore_createroute");
-	}
-	else
+
+/**
+ *  @brief navicore_unsubscribeevents request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreUnsubscribeEvents(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_unsubscribeevents");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_UNSUBSCRIBEEVENTS] );
+
+	// Request of Json format request
+	json_object* req_json = afb_req_json(req);
+
+	// Request analysis
+	std::vector< std::string > names;
+	std::vector< SignalEventType > types;
+	if( !analyzeRequest->CreateParamsUnsubscribeEvents( req_json, names ) || !GetSignalEventTypes( names, types ))
 	{
-		AFB_REQ_ERROR(req, "%s - %s:%d", response.errMessage.c_str(), __FILE__, __LINE__);
-		afb_req_fail(req, "failed", "navicore_createroute Bad Request");
+		afb_req_fail(req, "failed", "navicore_unsubscribeevents Bad Request");
+		sample->Done( false );
+		return;
 	}
 
-	// json object release
-	json_object_put(response.json_data);
+	signalEvent->Unsubscribe( req, types );
+
+	// Return success to BinderClient
+	afb_req_success(req, NULL, "navicore_unsubscribeevents");
+	sample->Done( true );
 
-	AFB_REQ_NOTICE(req, "<-- End %s()", __func__);
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
 }
 
 
 /**
- *  @brief navicore_pausesimulation request callback
+ *  @brief navicore_subscriberouteprogress request callback
  *  @param[in] req Request from client
  */
-void OnRequestNavicorePauseSimulation(afb_req req)
+void OnRequestNavicoreSubscribeRouteProgress(afb_req req)
 {
-	AFB_REQ_NOTICE(req, "--> Start %s()", __func__);
-	AFB_REQ_DEBUG(req, "request navicore_pausesimulation");
-
-	// Request of json format request
-	json_object* req_json = afb_req_json(req);
-	const char* req_json_str = json_object_to_json_string(req_json);
-	AFB_REQ_NOTICE(req, "req_json_str = %s", req_json_str);
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_subscriberouteprogress");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_SUBSCRIBEROUTEPROGRESS] );
 
-	// Request analysis and create arguments to pass to Genivi
-	uint32_t sessionHdl = 0;
-	if( !analyzeRequest->CreateParamsPauseSimulation( req_json_str, sessionHdl ))
+	if( !routeProgress->Subscribe( req ))
 	{
-		afb_req_fail(req, "failed", "navicore_pausesimulation Bad Request");
+		afb_req_fail(req, "failed", "navicore_subscriberouteprogress cannot subscribe");
+		sample->Done( false );
 		return;
 	}
 
-	// GENEVI API call
-	geniviRequest->NavicorePauseSimulation( sessionHdl );
+	// Return success to BinderClient
+	afb_req_success(req, NULL, "navicore_subscriberouteprogress");
+	sample->Done( true );
 
-	// No reply unnecessary API for conversion to json format response is unnecessary
-	AFB_REQ_NOTICE(req, "res_json_str = none");
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_unsubscriberouteprogress request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreUnsubscribeRouteProgress(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_unsubscriberouteprogress");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_UNSUBSCRIBEROUTEPROGRESS] );
+
+	routeProgress->Unsubscribe( req );
 
 	// Return success to BinderClient
-	afb_req_success(req, NULL, "navicore_pausesimulation");
+	afb_req_success(req, NULL, "navicore_unsubscriberouteprogress");
+	sample->Done( true );
 
-	AFB_REQ_NOTICE(req, "<-- End %s()", __func__);
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
 }
 
 
 /**
- *  @brief navicore_setsimulationmode request callback
+ *  @brief navicore_subscribeoffroute request callback
  *  @param[in] req Request from client
  */
-void OnRequestNavicoreSetSimulationMode(afb_req req)
+void OnRequestNavicoreSubscribeOffRoute(afb_req req)
 {
-	AFB_REQ_NOTICE(req, "--> Start %s()", __func__);
-	AFB_REQ_DEBUG(req, "request navicore_setsimulationmode");
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_subscribeoffroute");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_SUBSCRIBEOFFROUTE] );
 
-	// Request of json format request
+	// Request of Json format request
 	json_object* req_json = afb_req_json(req);
-	const char* req_json_str = json_object_to_json_string(req_json);
-	AFB_REQ_NOTICE(req, "req_json_str = %s", req_json_str);
+	BINDER_REQ_NOTICE_JSON(req, BINDER_LOG_SAMPLE(), "req_json_str", req_json);
 
-	// Request analysis and create arguments to pass to Genivi
-	uint32_t sessionHdl = 0;
-	bool simuMode = false;
-	if( !analyzeRequest->CreateParamsSetSimulationMode( req_json_str, sessionHdl, simuMode ))
+	// Request analysis
+	uint32_t distance = OFF_ROUTE_DEFAULT_DISTANCE;
+	uint32_t direction = OFF_ROUTE_DEFAULT_DIRECTION;
+	if( !analyzeRequest->CreateParamsSubscribeOffRoute( req_json, distance, direction ))
 	{
-		afb_req_fail(req, "failed", "navicore_setsimulationmode Bad Request");
+		afb_req_fail(req, "failed", "navicore_subscribeoffroute Bad Request");
+		sample->Done( false );
 		return;
 	}
 
-	// GENEVI API call
-	geniviRequest->NavicoreSetSimulationMode( sessionHdl, simuMode );
-
-	// No reply unnecessary API for conversion to json format response is unnecessary
-	AFB_REQ_NOTICE(req, "res_json_str = none");
+	if( !offRouteEvent->Subscribe( req, distance, direction ))
+	{
+		afb_req_fail(req, "failed", "navicore_subscribeoffroute cannot subscribe");
+		sample->Done( false );
+		return;
+	}
 
 	// Return success to BinderClient
-	afb_req_success(req, NULL, "navicore_setsimulationmode");
+	afb_req_success(req, NULL, "navicore_subscribeoffroute");
+	sample->Done( true );
 
-	AFB_REQ_NOTICE(req, "<-- End %s()", __func__);
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
 }
 
 
 /**
- *  @brief navicore_cancelroutecalculation request callback
+ *  @brief navicore_unsubscribeoffroute request callback
  *  @param[in] req Request from client
  */
-void OnRequestNavicoreCancelRouteCalculation(afb_req req)
+void OnRequestNavicoreUnsubscribeOffRoute(afb_req req)
 {
-	AFB_REQ_NOTICE(req, "--> Start %s()", __func__);
-	AFB_REQ_DEBUG(req, "request navicore_cancelroutecalculation");
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_unsubscribeoffroute");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_UNSUBSCRIBEOFFROUTE] );
 
-	// Request of Json format request
-	json_object* req_json = afb_req_json(req);
-	const char* req_json_str = json_object_to_json_string(req_json);
-	AFB_REQ_NOTICE(req, "req_json_str = %s", req_json_str);
+	offRouteEvent->Unsubscribe( req );
 
-	// Request analysis and create arguments to pass to Genivi
-	uint32_t sessionHdl = 0;
-	uint32_t routeHdl = 0;
-	if( !analyzeRequest->CreateParamsCancelRouteCalculation( req_json_str, sessionHdl, routeHdl ))
+	// Return success to BinderClient
+	afb_req_success(req, NULL, "navicore_unsubscribeoffroute");
+	sample->Done( true );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
+
+/**
+ *  @brief navicore_subscribegeofence request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreSubscribeGeofence(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_subscribegeofence");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_SUBSCRIBEGEOFENCE] );
+
+	if( !geofence->Subscribe( req ))
 	{
-		afb_req_fail(req, "failed", "navicore_cancelroutecalculation Bad Request");
+		afb_req_fail(req, "failed", "navicore_subscribegeofence cannot subscribe");
+		sample->Done( false );
 		return;
 	}
 
-	// GENEVI API call
-	geniviRequest->NavicoreCancelRouteCalculation( sessionHdl, routeHdl );
+	// Return success to BinderClient
+	afb_req_success(req, NULL, "navicore_subscribegeofence");
+	sample->Done( true );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
 
-	// No reply unnecessary API for conversion to json format response is unnecessary
-	AFB_REQ_NOTICE(req, "res_json_str = none");
+
+/**
+ *  @brief navicore_unsubscribegeofence request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreUnsubscribeGeofence(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_unsubscribegeofence");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_UNSUBSCRIBEGEOFENCE] );
+
+	geofence->Unsubscribe( req );
 
 	// Return success to BinderClient
-	afb_req_success(req, NULL, "navicore_cancelroutecalculation");
+	afb_req_success(req, NULL, "navicore_unsubscribegeofence");
+	sample->Done( true );
 
-	AFB_REQ_NOTICE(req, "<-- End %s()", __func__);
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
 }
 
 
 /**
- *  @brief navicore_setwaypoints request callback
+ *  @brief navicore_stats request callback
  *  @param[in] req Request from client
  */
-void OnRequestNavicoreWaypoints(afb_req req)
+void OnRequestNavicoreStats(afb_req req)
 {
-	AFB_REQ_NOTICE(req, "--> Start %s()", __func__);
-	AFB_REQ_DEBUG(req, "request navicore_setwaypoints");
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_stats");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_STATS] );
 
 	// Request of Json format request
 	json_object* req_json = afb_req_json(req);
-	const char* req_json_str = json_object_to_json_string(req_json);
-	AFB_REQ_NOTICE(req, "req_json_str = %s", req_json_str);
+	BINDER_REQ_NOTICE_JSON(req, BINDER_LOG_SAMPLE(), "req_json_str", req_json);
 
-	// Request analysis and create arguments to pass to Genivi
-	uint32_t sessionHdl = 0;
-	uint32_t routeHdl = 0;
-	bool currentPos = false;
-	std::vector<Waypoint> waypointsList;
-	if( !analyzeRequest->CreateParamsSetWaypoints( req_json_str, sessionHdl, routeHdl, currentPos, waypointsList ))
+	// Request analysis
+	bool reset = false;
+	if( !analyzeRequest->CreateParamsStats( req_json, reset ))
 	{
-		afb_req_fail(req, "failed", "navicore_setwaypoints Bad Request");
+		afb_req_fail(req, "failed", "navicore_stats Bad Request");
+		sample->Done( false );
 		return;
 	}
 
-	// GENEVI API call
-	geniviRequest->NavicoreSetWaypoints( sessionHdl, routeHdl, currentPos, waypointsList );
-
-	// No reply unnecessary API for conversion to json format response is unnecessary
-	AFB_REQ_NOTICE(req, "res_json_str = none");
+	// Metrics until now, then start a new period if requested
+	json_object* stats = binderMetrics->ToJson();
+	if( reset )
+	{
+		binderMetrics->Reset();
+	}
 
-	// Return success to BinderClient
-	afb_req_success(req, NULL, "navicore_setwaypoints");
+	afb_req_success(req, stats, "navicore_stats");
+	sample->Done( true );
 
-	AFB_REQ_NOTICE(req, "<-- End %s()", __func__);
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
 }
 
 
 /**
- *  @brief navicore_calculateroute request callback
+ *  @brief navicore_startrecording request callback
  *  @param[in] req Request from client
  */
-void OnRequestNavicoreCalculateRoute(afb_req req)
+void OnRequestNavicoreStartRecording(afb_req req)
 {
-	AFB_REQ_NOTICE(req, "--> Start %s()", __func__);
-	AFB_REQ_DEBUG(req, "request navicore_calculateroute");
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_startrecording");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_STARTRECORDING] );
 
 	// Request of Json format request
 	json_object* req_json = afb_req_json(req);
-	const char* req_json_str = json_object_to_json_string(req_json);
-	AFB_REQ_NOTICE(req, "req_json_str = %s", req_json_str);
+	BINDER_REQ_NOTICE_JSON(req, BINDER_LOG_SAMPLE(), "req_json_str", req_json);
 
-	// Request analysis and create arguments to pass to Genivi
-	uint32_t sessionHdl = 0;
-	uint32_t routeHdl = 0;
-	if( !analyzeRequest->CreateParamsCalculateRoute( req_json_str, sessionHdl, routeHdl ))
+	// Request analysis
+	std::string name;
+	if( !analyzeRequest->CreateParamsStartRecording( req_json, name ))
 	{
-		afb_req_fail(req, "failed", "navicore_calculateroute Bad Request");
+		afb_req_fail(req, "failed", "navicore_startrecording Bad Request");
+		sample->Done( false );
 		return;
 	}
 
-	// GENEVI API call
-	geniviRequest->NavicoreCalculateRoute( sessionHdl, routeHdl );
+	if( trackDirectory.empty() )
+	{
+		afb_req_fail(req, "failed", "navicore_startrecording no track directory");
+		sample->Done( false );
+		return;
+	}
 
-	// No reply unnecessary API for conversion to json format response is unnecessary
-	AFB_REQ_NOTICE(req, "res_json_str = none");
+	std::string path = trackDirectory + "/" + name;
+	if( !trackRecorder->Start( path.c_str() ))
+	{
+		afb_req_fail(req, "failed", "navicore_startrecording cannot create file");
+		sample->Done( false );
+		return;
+	}
 
 	// Return success to BinderClient
-	afb_req_success(req, NULL, "navicore_calculateroute");
+	afb_req_success(req, NULL, "navicore_startrecording");
+	sample->Done( true );
 
-	AFB_REQ_NOTICE(req, "<-- End %s()", __func__);
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
 }
 
 
 /**
- *  @brief navicore_getallsessions request callback
+ *  @brief navicore_stoprecording request callback
  *  @param[in] req Request from client
  */
-void OnRequestNavicoreGetAllSessions(afb_req req)
+void OnRequestNavicoreStopRecording(afb_req req)
 {
-	AFB_REQ_NOTICE(req, "--> Start %s()", __func__);
-	AFB_REQ_DEBUG(req, "request navicore_getallsessions");
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_stoprecording");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_STOPRECORDING] );
 
-	// No request information in Json format
-	AFB_REQ_NOTICE(req, "req_json_str = none");
+	uint32_t records = trackRecorder->Stop();
 
-	// GENEVI API call
-	std::map<uint32_t, std::string> allSessions = geniviRequest->NavicoreGetAllSessions();
+	// Number of positions in the file
+	json_object* response = json_object_new_object();
+	json_object_object_add(response, "records", json_object_new_int64(records));
+	afb_req_success(req, response, "navicore_stoprecording");
+	sample->Done( true );
 
-	// Convert to json style response
-	APIResponse response = binderReply->ReplyNavicoreGetAllSessions( allSessions );
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
 
-	// On success
-	if(response.isSuccess)
+
+/**
+ *  @brief navicore_startreplay request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreStartReplay(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_startreplay");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_STARTREPLAY] );
+
+	// Request of Json format request
+	json_object* req_json = afb_req_json(req);
+	BINDER_REQ_NOTICE_JSON(req, BINDER_LOG_SAMPLE(), "req_json_str", req_json);
+
+	// Request analysis
+	std::string name;
+	uint32_t sessionHdl = 0;
+	uint32_t speed = TRACK_REPLAY_DEFAULT_SPEED;
+	bool repeat = false;
+	if( !analyzeRequest->CreateParamsStartReplay( req_json, name, sessionHdl, speed, repeat ))
 	{
-		AFB_REQ_NOTICE(req, "res_json_str = %s", json_object_to_json_string(response.json_data));
-		// Return success to BinderClient
-		afb_req_success(req, response.json_data, "navicore_getallsessions");
+		afb_req_fail(req, "failed", "navicore_startreplay Bad Request");
+		sample->Done( false );
+		return;
 	}
-	else
+
+	if( trackDirectory.empty() )
 	{
-		AFB_REQ_ERROR(req, "%s - %s:%d", response.errMessage.c_str(), __FILE__, __LINE__);
-		afb_req_fail(req, "failed", "navicore_getallsessions Bad Request");
+		afb_req_fail(req, "failed", "navicore_startreplay no track directory");
+		sample->Done( false );
+		return;
 	}
 
-	// json object release
-	json_object_put(response.json_data);
+	std::string path = trackDirectory + "/" + name;
+	if( !trackReplay->Play( path.c_str(), sessionHdl, speed, repeat ))
+	{
+		afb_req_fail(req, "failed", "navicore_startreplay cannot read file");
+		sample->Done( false );
+		return;
+	}
+
+	// Return success to BinderClient
+	afb_req_success(req, NULL, "navicore_startreplay");
+	sample->Done( true );
 
-	AFB_REQ_NOTICE(req, "<-- End %s()", __func__);
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
 }
 
 
+/**
+ *  @brief navicore_stopreplay request callback
+ *  @param[in] req Request from client
+ */
+void OnRequestNavicoreStopReplay(afb_req req)
+{
+	BINDER_REQ_NOTICE(req, "--> Start %s()", __func__);
+	BINDER_REQ_DEBUG(req, "request navicore_stopreplay");
+	VerbSamplePtr sample = binderMetrics->Start( apiVerbMetrics[API_VERB_STOPREPLAY] );
+
+	trackReplay->Stop();
+
+	// Return success to BinderClient
+	afb_req_success(req, NULL, "navicore_stopreplay");
+	sample->Done( true );
+
+	BINDER_REQ_NOTICE(req, "<-- End %s()", __func__);
+}
+
 /**
  *  @brief Callback called at service startup
  */
 int Init()
 {
+	// Dump 1 request in N, e.g. NAVIAPI_LOG_SAMPLE_RATE=100 in production
+	const char* sampleRate = getenv("NAVIAPI_LOG_SAMPLE_RATE");
+	if( sampleRate != NULL )
+	{
+		BinderLogSetSampleRate( strtoul(sampleRate, NULL, 10) );
+	}
+
 	// Create instance
-	geniviRequest   = new GeniviRequest();
+	loopQueue       = new SdEventQueue();
+	geniviRequest   = new GeniviRequest( loopQueue );
 	binderReply	 = new BinderReply();
 	analyzeRequest  = new AnalyzeRequest();
+	positionCache   = new PositionCache( geniviRequest );
+	positionEvent   = new PositionEvent( geniviRequest, positionCache, binderReply );
+	positionHistory = new PositionHistory( positionCache );
+	deadReckoning   = new DeadReckoning( positionCache );
+	geofence        = new Geofence( positionCache, loopQueue );
+	signalEvent     = new SignalEvent();
+	routeCalculation = new RouteCalculation( geniviRequest, loopQueue );
+	routeCache      = new RouteCache( geniviRequest );
+	routeProgress   = new RouteProgress( routeCache, binderReply );
+	offRouteEvent   = new OffRouteEvent( positionCache );
+	positionRequests = new RequestCoalescer< NaviPosition >();
+	handleListCache = new HandleListCache( geniviRequest, binderReply, loopQueue );
+	trackRecorder   = new TrackRecorder( positionCache );
+	trackReplay     = new TrackReplay( geniviRequest, loopQueue );
+
+	// Track files recorded and replayed, e.g. NAVIAPI_TRACK_DIR=/var/lib/naviapi/tracks.
+	// Recording and replay fail while the directory is not private to the service.
+	const char* trackDir = getenv("NAVIAPI_TRACK_DIR");
+	const char* home = getenv("HOME");
+	if( trackDir != NULL )
+	{
+		trackDirectory = trackDir;
+	}
+	else if( home != NULL )
+	{
+		trackDirectory = std::string(home) + "/" TRACK_FILE_DEFAULT_DIR;
+	}
+	if( trackDirectory.empty() || !TrackWriter::MakeDirectory( trackDirectory ) )
+	{
+		trackDirectory.clear();
+	}
+
+	// Position responses written as text, for clients connected through websocket only
+	const char* replyMode = getenv("NAVIAPI_REPLY_MODE");
+	if( replyMode != NULL && strcmp(replyMode, "template") == 0 )
+	{
+		binderReply->SetMode( BINDER_REPLY_MODE_TEMPLATE );
+	}
+
+	geniviRequest->AddSignalListener( positionCache );
+	geniviRequest->AddSignalListener( signalEvent );
+	// Prefetch of a calculated route starts before its waiters are answered
+	geniviRequest->AddSignalListener( routeCache );
+	// Reloads a changed route after the cache dropped it
+	geniviRequest->AddSignalListener( routeProgress );
+	geniviRequest->AddSignalListener( routeCalculation );
+	geniviRequest->AddSignalListener( handleListCache );
+	geniviRequest->AddSignalListener( deadReckoning );
+	positionCache->AddListener( positionEvent );
+	positionCache->AddListener( positionHistory );
+	positionCache->AddListener( deadReckoning );
+	positionCache->AddListener( geofence );
+	positionCache->AddListener( offRouteEvent );
+	positionCache->AddListener( trackRecorder );
+	routeProgress->AddListener( offRouteEvent );
+
+	// Connect now, verbs fail at once while Genivi is not available.
+	// Replies and signals are received in the event loop of the binder.
+	if( !loopQueue->Start( afb_daemon_get_event_loop() )
+	 || !geniviRequest->Connect( afb_daemon_get_event_loop() )
+	 || !positionEvent->Start( afb_daemon_get_event_loop() )
+	 || !geofence->Start( afb_daemon_get_event_loop() )
+	 || !routeCalculation->Start( afb_daemon_get_event_loop() )
+	 || !trackReplay->Start( afb_daemon_get_event_loop() ) )
+	{
+		return -1;
+	}
+
+	// Verbs that can be chained by navicore_batch
+	std::map< std::string, VerbExecutor > executors;
+	executors["navicore_getposition"]            = ExecuteNavicoreGetPosition;
+	executors["navicore_getallroutes"]           = ExecuteNavicoreGetAllRoutes;
+	executors["navicore_createroute"]            = ExecuteNavicoreCreateRoute;
+	executors["navicore_pausesimulation"]        = ExecuteNavicorePauseSimulation;
+	executors["navicore_setsimulationmode"]      = ExecuteNavicoreSetSimulationMode;
+	executors["navicore_cancelroutecalculation"] = ExecuteNavicoreCancelRouteCalculation;
+	executors["navicore_setwaypoints"]           = ExecuteNavicoreWaypoints;
+	executors["navicore_calculateroute"]         = ExecuteNavicoreCalculateRoute;
+	executors["navicore_calculateroute_wait"]    = ExecuteNavicoreCalculateRouteWait;
+	executors["navicore_getallsessions"]         = ExecuteNavicoreGetAllSessions;
+	executors["navicore_getroutesegments"]       = ExecuteNavicoreGetRouteSegments;
+	executors["navicore_getrouteboundingbox"]    = ExecuteNavicoreGetRouteBoundingBox;
+	executors["navicore_getwaypoints"]           = ExecuteNavicoreGetWaypoints;
+	executors["navicore_getmaneuvers"]           = ExecuteNavicoreGetManeuvers;
+	executors["navicore_getpositionhistory"]     = ExecuteNavicoreGetPositionHistory;
+	executors["navicore_getrouteprogress"]       = ExecuteNavicoreGetRouteProgress;
+	executors["navicore_addgeofence"]            = ExecuteNavicoreAddGeofence;
+	executors["navicore_removegeofence"]         = ExecuteNavicoreRemoveGeofence;
+	// Every verb of the API, executed through ExecuteVerb or directly
+	binderMetrics   = new BinderMetrics();
+	for (int i = 0; i < API_VERB_MAX; i++)
+	{
+		apiVerbMetrics[i] = binderMetrics->AddVerb( apiVerbNames[i] );
+	}
+
+	batchRequest    = new BatchRequest( executors, binderMetrics );
 	
 	return 0;
 }
@@ -400,7 +1751,32 @@ const afb_verb_v2 verbs[] =
 	 { verb : "navicore_cancelroutecalculation", callback : OnRequestNavicoreCancelRouteCalculation },
 	 { verb : "navicore_setwaypoints",		   callback : OnRequestNavicoreWaypoints },
 	 { verb : "navicore_calculateroute",		 callback : OnRequestNavicoreCalculateRoute },
+	 { verb : "navicore_calculateroute_wait",	callback : OnRequestNavicoreCalculateRouteWait },
 	 { verb : "navicore_getallsessions",		 callback : OnRequestNavicoreGetAllSessions },
+	 { verb : "navicore_getroutesegments",	   callback : OnRequestNavicoreGetRouteSegments },
+	 { verb : "navicore_getrouteboundingbox",	callback : OnRequestNavicoreGetRouteBoundingBox },
+	 { verb : "navicore_getwaypoints",		   callback : OnRequestNavicoreGetWaypoints },
+	 { verb : "navicore_getmaneuvers",		   callback : OnRequestNavicoreGetManeuvers },
+	 { verb : "navicore_getpositionhistory",	 callback : OnRequestNavicoreGetPositionHistory },
+	 { verb : "navicore_subscribe",			  callback : OnRequestNavicoreSubscribe },
+	 { verb : "navicore_unsubscribe",			callback : OnRequestNavicoreUnsubscribe },
+	 { verb : "navicore_subscribeevents",		callback : OnRequestNavicoreSubscribeEvents },
+	 { verb : "navicore_unsubscribeevents",	  callback : OnRequestNavicoreUnsubscribeEvents },
+	 { verb : "navicore_getrouteprogress",	   callback : OnRequestNavicoreGetRouteProgress },
+	 { verb : "navicore_subscriberouteprogress", callback : OnRequestNavicoreSubscribeRouteProgress },
+	 { verb : "navicore_unsubscriberouteprogress", callback : OnRequestNavicoreUnsubscribeRouteProgress },
+	 { verb : "navicore_subscribeoffroute",	  callback : OnRequestNavicoreSubscribeOffRoute },
+	 { verb : "navicore_unsubscribeoffroute",	callback : OnRequestNavicoreUnsubscribeOffRoute },
+	 { verb : "navicore_addgeofence",			callback : OnRequestNavicoreAddGeofence },
+	 { verb : "navicore_removegeofence",		 callback : OnRequestNavicoreRemoveGeofence },
+	 { verb : "navicore_subscribegeofence",	  callback : OnRequestNavicoreSubscribeGeofence },
+	 { verb : "navicore_unsubscribegeofence",	callback : OnRequestNavicoreUnsubscribeGeofence },
+	 { verb : "navicore_startrecording",		 callback : OnRequestNavicoreStartRecording },
+	 { verb : "navicore_stoprecording",		  callback : OnRequestNavicoreStopRecording },
+	 { verb : "navicore_startreplay",			callback : OnRequestNavicoreStartReplay },
+	 { verb : "navicore_stopreplay",			 callback : OnRequestNavicoreStopReplay },
+	 { verb : "navicore_batch",				  callback : OnRequestNavicoreBatch },
+	 { verb : "navicore_stats",				  callback : OnRequestNavicoreStats },
 	 { verb : NULL }
 };
 
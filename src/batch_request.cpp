@@ -0,0 +1,224 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "batch_request.h"
+#include <stdlib.h>
+#include <string.h>
+#include <memory>
+
+/**
+ *  @brief Progress of one navicore_batch request
+ */
+struct BatchRequest::Batch
+{
+	json_object* requests;	// sub-requests (reference held)
+	json_object* results;	// result of each executed step
+	int index;		// next step to execute
+	BatchCallback callback;
+};
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  executors Processing of each verb allowed in a batch
+ *  @param[in]  metrics Metrics where each step is counted as its own verb
+ */
+BatchRequest::BatchRequest( const std::map< std::string, VerbExecutor >& executors, BinderMetrics* metrics )
+	: metrics_(metrics)
+{
+	std::map< std::string, VerbExecutor >::const_iterator it;
+	for (it = executors.begin(); it != executors.end(); ++it)
+	{
+		Step& step = steps_[it->first];
+		step.executor = it->second;
+		step.metrics = metrics->AddVerb( it->first.c_str() );
+	}
+}
+
+/**
+ *  @brief      Execute the sub-requests in order
+ *  @param[in]  requests Array of {"verb": name, "args": object} (checked by AnalyzeRequest)
+ *  @param[in]  callback Called with the array of results once every step is done
+ */
+void BatchRequest::Execute( json_object* requests, BatchCallback callback )
+{
+	std::shared_ptr< Batch > batch = std::make_shared< Batch >();
+	batch->requests = json_object_get(requests);
+	batch->results = json_object_new_array();
+	batch->index = 0;
+	batch->callback = callback;
+
+	ExecuteStep( batch );
+}
+
+/**
+ *  @brief      Execute the next step, and the following ones from its reply
+ *  @param[in]  batch Progress of the request
+ */
+void BatchRequest::ExecuteStep( std::shared_ptr< Batch > batch )
+{
+	int count = json_object_array_length(batch->requests);
+
+	// Last step done, or previous step failed
+	if( batch->index >= count )
+	{
+		for (int i = json_object_array_length(batch->results); i < count; ++i)
+		{
+			json_object* verb = NULL;
+			json_object_object_get_ex(json_object_array_get_idx(batch->requests, i), "verb", &verb);
+
+			json_object* skipped = json_object_new_object();
+			json_object_object_add(skipped, "verb", json_object_get(verb));
+			json_object_object_add(skipped, "status", json_object_new_string("skipped"));
+			json_object_array_add(batch->results, skipped);
+		}
+
+		json_object_put(batch->requests);
+		batch->callback( batch->results );
+		return;
+	}
+
+	json_object* request = json_object_array_get_idx(batch->requests, batch->index);
+	json_object* verb = NULL;
+	json_object* args = NULL;
+	json_object_object_get_ex(request, "verb", &verb);
+	json_object_object_get_ex(request, "args", &args);
+
+	json_object* result = json_object_new_object();
+	json_object_object_add(result, "verb", json_object_get(verb));
+	json_object_array_add(batch->results, result);
+
+	std::map< std::string, Step >::iterator step = steps_.find(json_object_get_string(verb));
+	if( step == steps_.end() )
+	{
+		json_object_object_add(result, "status", json_object_new_string("failed"));
+		json_object_object_add(result, "info", json_object_new_string("verb not allowed in batch"));
+		batch->index = count;
+		ExecuteStep( batch );
+		return;
+	}
+
+	json_object* req_json = ResolveArgs(args, batch->results);
+	batch->index++;
+
+	VerbSamplePtr sample = metrics_->Start( step->second.metrics );
+	step->second.executor( req_json, sample, [this, batch, result, count, sample]( APIResponse& response )
+	{
+		sample->Done( response.isSuccess );
+
+		if( response.isSuccess )
+		{
+			json_object_object_add(result, "status", json_object_new_string("success"));
+			json_object_object_add(result, "response", response.json_data);
+		}
+		else
+		{
+			json_object_object_add(result, "status", json_object_new_string("failed"));
+			json_object_object_add(result, "info", json_object_new_string(response.errMessage.c_str()));
+			json_object_put(response.json_data);
+
+			// Later steps usually depend on this one
+			batch->index = count;
+		}
+
+		ExecuteStep( batch );
+	});
+
+	json_object_put(req_json);
+}
+
+/**
+ *  @brief      Replace references to previous results in the arguments
+ *  @param[in]  args Arguments of the step (may be NULL)
+ *  @param[in]  results Results of the previous steps
+ *  @return     New reference on the resolved arguments
+ */
+json_object* BatchRequest::ResolveArgs( json_object* args, json_object* results )
+{
+	if( json_object_is_type(args, json_type_string) )
+	{
+		const char* str = json_object_get_string(args);
+		if( str[0] == '$' )
+		{
+			return ResolveReference(str + 1, results);
+		}
+		return json_object_get(args);
+	}
+
+	if( json_object_is_type(args, json_type_array) )
+	{
+		json_object* resolved = json_object_new_array();
+		for (int i = 0; i < json_object_array_length(args); ++i)
+		{
+			json_object_array_add(resolved, ResolveArgs(json_object_array_get_idx(args, i), results));
+		}
+		return resolved;
+	}
+
+	if( json_object_is_type(args, json_type_object) )
+	{
+		json_object* resolved = json_object_new_object();
+		json_object_object_foreach(args, key, value)
+		{
+			json_object_object_add(resolved, key, ResolveArgs(value, results));
+		}
+		return resolved;
+	}
+
+	if( args == NULL )
+	{
+		return json_object_new_object();
+	}
+
+	return json_object_get(args);
+}
+
+/**
+ *  @brief      Get a value from the response of a previous step
+ *  @param[in]  reference "<step>[.<key>|.<index>...]"
+ *  @param[in]  results Results of the previous steps
+ *  @return     New reference on the value, NULL if not found
+ */
+json_object* BatchRequest::ResolveReference( const char* reference, json_object* results )
+{
+	char* end = NULL;
+	long step = strtol(reference, &end, 10);
+	if( end == reference || step < 0 || step >= (long)json_object_array_length(results) )
+	{
+		return NULL;
+	}
+
+	json_object* value = NULL;
+	if( !json_object_object_get_ex(json_object_array_get_idx(results, step), "response", &value) )
+	{
+		return NULL;
+	}
+
+	// Response built from templates in template mode (see BinderReply) : read its elements from its text
+	json_object* parsed = NULL;
+	if( *end == '.' && json_object_is_type(value, json_type_array) && json_object_array_length(value) == 0 )
+	{
+		parsed = json_tokener_parse(json_object_to_json_string(value));
+		value = parsed;
+	}
+
+	// Follow the path
+	while( *end == '.' && value != NULL )
+	{
+		const char* name = end + 1;
+		end = (char*)strchrnul(name, '.');
+		std::string key(name, end - name);
+
+		if( json_object_is_type(value, json_type_array) )
+		{
+			value = json_object_array_get_idx(value, atoi(key.c_str()));
+		}
+		else if( !json_object_object_get_ex(value, key.c_str(), &value) )
+		{
+			value = NULL;
+		}
+	}
+
+	value = json_object_get(value);
+	json_object_put(parsed);
+	return value;
+}
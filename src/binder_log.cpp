@@ -0,0 +1,32 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "binder_log.h"
+#include <atomic>
+
+static std::atomic< uint32_t > sampleRate( BINDER_LOG_DEFAULT_SAMPLE_RATE );	// 1 request in N is dumped
+static std::atomic< uint32_t > sampleCount( 0 );
+
+/**
+ *  @brief      Set the sampling of the request dumps
+ *  @param[in]  rate Dump 1 request in rate (0 is taken as 1)
+ */
+void BinderLogSetSampleRate( uint32_t rate )
+{
+	sampleRate.store(rate == 0 ? 1 : rate, std::memory_order_relaxed);
+}
+
+/**
+ *  @brief  Draw the next request of the sampling
+ *  @return true if this request is dumped
+ */
+bool BinderLogSample()
+{
+	uint32_t rate = sampleRate.load(std::memory_order_relaxed);
+	if( rate <= 1 )
+	{
+		return true;
+	}
+
+	return (sampleCount.fetch_add(1, std::memory_order_relaxed) % rate) == 0;
+}
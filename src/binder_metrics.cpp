@@ -0,0 +1,426 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "binder_metrics.h"
+#include "binder_time.h"
+#include <utility>
+
+/**
+ *  @brief  Constructor
+ */
+LatencyHistogram::LatencyHistogram()
+{
+	Reset();
+}
+
+/**
+ *  @brief      Add one latency
+ *  @param[in]  usec Latency in usec
+ */
+void LatencyHistogram::Record( uint64_t usec )
+{
+	buckets_[BucketIndex(usec)].fetch_add(1, std::memory_order_relaxed);
+	count_.fetch_add(1, std::memory_order_relaxed);
+	sum_.fetch_add(usec, std::memory_order_relaxed);
+
+	uint64_t max = max_.load(std::memory_order_relaxed);
+	while( usec > max && !max_.compare_exchange_weak(max, usec, std::memory_order_relaxed) )
+	{
+	}
+}
+
+/**
+ *  @brief  Clear all latencies
+ */
+void LatencyHistogram::Reset()
+{
+	for (int i = 0; i < LATENCY_BUCKETS; ++i)
+	{
+		buckets_[i].store(0, std::memory_order_relaxed);
+	}
+	count_.store(0, std::memory_order_relaxed);
+	sum_.store(0, std::memory_order_relaxed);
+	max_.store(0, std::memory_order_relaxed);
+}
+
+/**
+ *  @brief  Summary of the distribution (usec)
+ *  @return {"count", "mean", "p50", "p90", "p99", "max"}
+ */
+json_object* LatencyHistogram::ToJson() const
+{
+	// Snapshot, so that percentiles are computed on a consistent count
+	std::vector< uint64_t > buckets(LATENCY_BUCKETS);
+	uint64_t count = 0;
+	for (int i = 0; i < LATENCY_BUCKETS; ++i)
+	{
+		buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+		count += buckets[i];
+	}
+	uint64_t sum = sum_.load(std::memory_order_relaxed);
+
+	json_object* obj = json_object_new_object();
+	json_object_object_add(obj, "count", json_object_new_int64(count));
+	json_object_object_add(obj, "mean", json_object_new_int64(count > 0 ? sum / count : 0));
+	json_object_object_add(obj, "p50", json_object_new_int64(Percentile(buckets, count, 0.50)));
+	json_object_object_add(obj, "p90", json_object_new_int64(Percentile(buckets, count, 0.90)));
+	json_object_object_add(obj, "p99", json_object_new_int64(Percentile(buckets, count, 0.99)));
+	json_object_object_add(obj, "max", json_object_new_int64(max_.load(std::memory_order_relaxed)));
+	return obj;
+}
+
+/**
+ *  @brief      Bucket of a latency
+ *  @param[in]  usec Latency in usec
+ *  @return     Bucket index
+ */
+int LatencyHistogram::BucketIndex( uint64_t usec )
+{
+	if( usec < LATENCY_LINEAR_BUCKETS )
+	{
+		return (int)usec;
+	}
+
+	int exponent = 63 - __builtin_clzll(usec);
+	if( exponent > LATENCY_MAX_EXPONENT )
+	{
+		return LATENCY_BUCKETS - 1;
+	}
+
+	int sub = (int)(usec >> (exponent - 3)) & (LATENCY_SUB_BUCKETS - 1);
+	return LATENCY_LINEAR_BUCKETS + (exponent - 4) * LATENCY_SUB_BUCKETS + sub;
+}
+
+/**
+ *  @brief      Largest latency counted in a bucket
+ *  @param[in]  index Bucket index
+ *  @return     Latency in usec
+ */
+uint64_t LatencyHistogram::BucketUpperBound( int index )
+{
+	if( index < LATENCY_LINEAR_BUCKETS )
+	{
+		return (uint64_t)index;
+	}
+
+	int exponent = 4 + (index - LATENCY_LINEAR_BUCKETS) / LATENCY_SUB_BUCKETS;
+	int sub = (index - LATENCY_LINEAR_BUCKETS) % LATENCY_SUB_BUCKETS;
+	return ((uint64_t)(LATENCY_SUB_BUCKETS + sub + 1) << (exponent - 3)) - 1;
+}
+
+/**
+ *  @brief      Latency below which the given ratio of samples are
+ *  @param[in]  buckets Snapshot of the buckets
+ *  @param[in]  count Number of samples in the snapshot
+ *  @param[in]  ratio 0.0 - 1.0
+ *  @return     Latency in usec (bucket upper bound, bounded by the maximum)
+ */
+uint64_t LatencyHistogram::Percentile( const std::vector< uint64_t >& buckets, uint64_t count, double ratio ) const
+{
+	if( count == 0 )
+	{
+		return 0;
+	}
+
+	uint64_t rank = (uint64_t)(ratio * count + 0.5);
+	if( rank == 0 )
+	{
+		rank = 1;
+	}
+
+	uint64_t seen = 0;
+	for (int i = 0; i < LATENCY_BUCKETS; ++i)
+	{
+		seen += buckets[i];
+		if( seen >= rank )
+		{
+			uint64_t bound = BucketUpperBound(i);
+			uint64_t max = max_.load(std::memory_order_relaxed);
+			return bound < max ? bound : max;
+		}
+	}
+
+	return max_.load(std::memory_order_relaxed);
+}
+
+
+/**
+ *  @brief  Constructor
+ */
+VerbMetrics::VerbMetrics()
+	: count_(0), errors_(0)
+{
+}
+
+/**
+ *  @brief      Add one request
+ *  @param[in]  isSuccess Success or failure of the request
+ *  @param[in]  phases Duration of each phase in usec
+ *  @param[in]  calledGenivi Whether Genivi was called (no D-Bus phase otherwise)
+ */
+void VerbMetrics::Record( bool isSuccess, const uint64_t phases[VERB_PHASE_MAX], bool calledGenivi )
+{
+	count_.fetch_add(1, std::memory_order_relaxed);
+	if( !isSuccess )
+	{
+		errors_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	for (int i = 0; i < VERB_PHASE_MAX; ++i)
+	{
+		if( i == VERB_PHASE_DBUS && !calledGenivi )
+		{
+			continue;
+		}
+		latency_[i].Record(phases[i]);
+	}
+}
+
+/**
+ *  @brief  Clear all counters
+ */
+void VerbMetrics::Reset()
+{
+	count_.store(0, std::memory_order_relaxed);
+	errors_.store(0, std::memory_order_relaxed);
+	for (int i = 0; i < VERB_PHASE_MAX; ++i)
+	{
+		latency_[i].Reset();
+	}
+}
+
+/**
+ *  @brief  Counters in json format
+ *  @return {"count", "errors", "latency": {"parse", "dbus", "reply", "total"}}
+ */
+json_object* VerbMetrics::ToJson() const
+{
+	static const char* phaseNames[VERB_PHASE_MAX] = { "parse", "dbus", "reply", "total" };
+
+	json_object* latency = json_object_new_object();
+	for (int i = 0; i < VERB_PHASE_MAX; ++i)
+	{
+		json_object_object_add(latency, phaseNames[i], latency_[i].ToJson());
+	}
+
+	json_object* obj = json_object_new_object();
+	json_object_object_add(obj, "count", json_object_new_int64(count_.load(std::memory_order_relaxed)));
+	json_object_object_add(obj, "errors", json_object_new_int64(errors_.load(std::memory_order_relaxed)));
+	json_object_object_add(obj, "latency", latency);
+	return obj;
+}
+
+
+/**
+ *  @brief  The request is analyzed, Genivi is being called
+ */
+void VerbSample::Parsed()
+{
+	parsed_ = GetTimeUsec();
+}
+
+/**
+ *  @brief  Genivi replied
+ */
+void VerbSample::Called()
+{
+	called_ = GetTimeUsec();
+}
+
+/**
+ *  @brief      The response is returned to BinderClient
+ *  @param[in]  isSuccess Success or failure of the request
+ */
+void VerbSample::Done( bool isSuccess )
+{
+	if( metrics_ == NULL )
+	{
+		return;
+	}
+
+	uint64_t done = GetTimeUsec();
+	bool calledGenivi = (parsed_ != 0 && called_ != 0);
+
+	// Without Genivi call (bad request, cached answer), all the work is parse
+	uint64_t parsed = (parsed_ != 0) ? parsed_ : done;
+	uint64_t called = calledGenivi ? called_ : parsed;
+
+	uint64_t phases[VERB_PHASE_MAX];
+	phases[VERB_PHASE_PARSE] = parsed - start_;
+	phases[VERB_PHASE_DBUS]  = called - parsed;
+	phases[VERB_PHASE_REPLY] = done - called;
+	phases[VERB_PHASE_TOTAL] = done - start_;
+
+	metrics_->Record(isSuccess, phases, calledGenivi);
+}
+
+
+/**
+ *  @brief      Take a reference on a new sample
+ *  @param[in]  sample Sample whose reference count is 1
+ */
+VerbSamplePtr::VerbSamplePtr( VerbSample* sample )
+	: sample_(sample)
+{
+}
+
+/**
+ *  @brief      Take one more reference on a sample
+ *  @param[in]  other Reference to copy
+ */
+VerbSamplePtr::VerbSamplePtr( const VerbSamplePtr& other )
+	: sample_(other.sample_)
+{
+	sample_->refCount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ *  @brief      Take the reference of another pointer
+ *  @param[in]  other Reference to move, left empty
+ */
+VerbSamplePtr::VerbSamplePtr( VerbSamplePtr&& other )
+	: sample_(other.sample_)
+{
+	other.sample_ = NULL;
+}
+
+/**
+ *  @brief  Release the reference, the last one gives the sample back to its pool
+ */
+VerbSamplePtr::~VerbSamplePtr()
+{
+	if( sample_ != NULL && sample_->refCount_.fetch_sub(1, std::memory_order_acq_rel) == 1 )
+	{
+		sample_->owner_->Release(sample_);
+	}
+}
+
+/**
+ *  @brief      Refer to the sample of another pointer
+ *  @param[in]  other Reference to copy
+ *  @return     This pointer
+ */
+VerbSamplePtr& VerbSamplePtr::operator=( VerbSamplePtr other )
+{
+	std::swap(sample_, other.sample_);
+	return *this;
+}
+
+
+/**
+ *  @brief  Constructor
+ */
+BinderMetrics::BinderMetrics()
+	: resetTime_(GetTimeMsec())
+{
+}
+
+/**
+ *  @brief  Destructor
+ */
+BinderMetrics::~BinderMetrics()
+{
+	std::map< std::string, VerbMetrics* >::iterator it;
+	for (it = verbs_.begin(); it != verbs_.end(); ++it)
+	{
+		delete it->second;
+	}
+	for (size_t i = 0; i < pool_.size(); ++i)
+	{
+		delete pool_[i];
+	}
+}
+
+/**
+ *  @brief      Register a verb to measure (at startup only)
+ *  @param[in]  verb Verb name
+ *  @return     Metrics of the verb, given to Start by each request
+ */
+VerbMetrics* BinderMetrics::AddVerb( const char* verb )
+{
+	VerbMetrics*& metrics = verbs_[verb];
+	if( metrics == NULL )
+	{
+		metrics = new VerbMetrics();
+	}
+	return metrics;
+}
+
+/**
+ *  @brief      Start measuring a request
+ *  @param[in]  metrics Metrics of its verb, from AddVerb (NULL : not measured)
+ *  @return     Timing of the request
+ */
+VerbSamplePtr BinderMetrics::Start( VerbMetrics* metrics )
+{
+	VerbSample* sample = NULL;
+	{
+		std::lock_guard< std::mutex > lock( poolMutex_ );
+		if( !pool_.empty() )
+		{
+			sample = pool_.back();
+			pool_.pop_back();
+		}
+	}
+	if( sample == NULL )
+	{
+		sample = new VerbSample();
+		sample->owner_ = this;
+	}
+
+	sample->metrics_ = metrics;
+	sample->start_ = GetTimeUsec();
+	sample->parsed_ = 0;
+	sample->called_ = 0;
+	sample->refCount_.store(1, std::memory_order_relaxed);
+	return VerbSamplePtr( sample );
+}
+
+/**
+ *  @brief      Request done, keep its sample for the next one
+ *  @param[in]  sample Sample without reference
+ */
+void BinderMetrics::Release( VerbSample* sample )
+{
+	{
+		std::lock_guard< std::mutex > lock( poolMutex_ );
+		if( pool_.size() < BINDER_METRICS_SAMPLE_POOL )
+		{
+			pool_.push_back(sample);
+			return;
+		}
+	}
+	delete sample;
+}
+
+/**
+ *  @brief  Clear the metrics of all verbs
+ */
+void BinderMetrics::Reset()
+{
+	std::map< std::string, VerbMetrics* >::iterator it;
+	for (it = verbs_.begin(); it != verbs_.end(); ++it)
+	{
+		it->second->Reset();
+	}
+	resetTime_.store(GetTimeMsec());
+}
+
+/**
+ *  @brief  Metrics in json format
+ *  @return {"period": msec since reset, "verbs": {verb: counters}}
+ */
+json_object* BinderMetrics::ToJson() const
+{
+	json_object* verbs = json_object_new_object();
+	std::map< std::string, VerbMetrics* >::const_iterator it;
+	for (it = verbs_.begin(); it != verbs_.end(); ++it)
+	{
+		json_object_object_add(verbs, it->first.c_str(), it->second->ToJson());
+	}
+
+	json_object* obj = json_object_new_object();
+	json_object_object_add(obj, "period", json_object_new_int64(GetTimeMsec() - resetTime_.load()));
+	json_object_object_add(obj, "verbs", verbs);
+	return obj;
+}
@@ -3,22 +3,89 @@
 
 #include "binder_reply.h"
 #include "genivi/genivi-navicore-constants.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/**
+ *  @brief Beginning of the response element of a position field,
+ *         up to the value : { "key": <key>, "value":
+ */
+struct PositionTemplate
+{
+	int length;
+	char text[32];
+};
+
+/**
+ *  @brief      Create the template of a position field
+ *  @param[in]  field Position field
+ *  @return     Template of the field
+ */
+static PositionTemplate CreatePositionTemplate( int field )
+{
+	PositionTemplate tmpl;
+	tmpl.length = snprintf(tmpl.text, sizeof(tmpl.text), "{ \"key\": %d, \"value\": ", NaviPositionKey(field));
+	return tmpl;
+}
+
+/**
+ *  @brief      Template of a position field
+ *  @param[in]  field Position field
+ *  @return     Template of the field
+ */
+static const PositionTemplate* GetPositionTemplate( int field )
+{
+	// Built once, read only afterwards
+	static const PositionTemplate templates[NAVI_POSITION_FIELD_MAX] =
+	{
+		CreatePositionTemplate(NAVI_POSITION_TIMESTAMP),
+		CreatePositionTemplate(NAVI_POSITION_LATITUDE),
+		CreatePositionTemplate(NAVI_POSITION_LONGITUDE),
+		CreatePositionTemplate(NAVI_POSITION_HEADING),
+		CreatePositionTemplate(NAVI_POSITION_SPEED),
+		CreatePositionTemplate(NAVI_POSITION_SIMULATION_MODE),
+	};
+
+	return &templates[field];
+}
+
+/**
+ *  @brief  Constructor
+ */
+BinderReply::BinderReply() : mode_(BINDER_REPLY_MODE_TREE)
+{
+}
+
+/**
+ *  @brief      Select how fixed-shape responses are built
+ *  @param[in]  mode Tree of json objects or prebuilt text
+ */
+void BinderReply::SetMode( BinderReplyMode mode )
+{
+	mode_ = mode;
+}
 
 /**
  *  @brief      GeniviAPI GetPosition call
- *  @param[in]  posList Map information on key and value of information acquired from Genivi
+ *  @param[in]  position Position information acquired from Genivi
+ *  @param[in]  extrapolated Fields predicted by the binding, flagged in the response
  *  @return     Response information
  */
-APIResponse BinderReply::ReplyNavicoreGetPosition( std::map<int32_t, double>& posList )
+APIResponse BinderReply::ReplyNavicoreGetPosition( const NaviPosition& position, uint32_t extrapolated )
 {
+	if( mode_ == BINDER_REPLY_MODE_TEMPLATE )
+	{
+		return ReplyNavicoreGetPositionTemplate( position, extrapolated );
+	}
+
 	APIResponse response = {0};
 
 	// Json information to return as a response
 	struct json_object* response_json = json_object_new_array();
-	std::map<int32_t, double>::iterator it;
-    
-	// If the argument map is empty return
-	if(posList.empty())
+
+	// If the position holds no field return
+	if( (position.mask & NAVI_POSITION_ALL) == 0 )
 	{
 		response.isSuccess  = false;
 		response.errMessage = "posList is empty";
@@ -26,64 +93,262 @@ APIResponse BinderReply::ReplyNavicoreGetPosition( std::map<int32_t, double>& po
 		return response;
 	}
 
-	// Make the passed Genivi response json format
-	for (it = posList.begin(); it != posList.end(); it++)
+	// Make the passed Genivi response json format, in the order of the keys
+	for (int field = 0; field < NAVI_POSITION_FIELD_MAX; field++)
 	{
+		if( !(position.mask & (1u << field)) )
+		{
+			continue;
+		}
+
 		struct json_object* obj = json_object_new_object();
+		json_object_object_add(obj, "key", json_object_new_int(NaviPositionKey(field)));
 
-		switch(it->first)
+		switch(field)
 		{
-		case NAVICORE_LATITUDE:
-			json_object_object_add(obj, "key", json_object_new_int(NAVICORE_LATITUDE));
-			json_object_object_add(obj, "value", json_object_new_double(it->second) );
-			json_object_array_add(response_json, obj);
+		case NAVI_POSITION_TIMESTAMP:
+			json_object_object_add(obj, "value", json_object_new_int64(position.timestamp));
 			break;
 
-		case NAVICORE_LONGITUDE:
-			json_object_object_add(obj, "key", json_object_new_int(NAVICORE_LONGITUDE));
-			json_object_object_add(obj, "value", json_object_new_double(it->second));
-			json_object_array_add(response_json, obj);
+		case NAVI_POSITION_LATITUDE:
+			json_object_object_add(obj, "value", json_object_new_double(position.latitude));
 			break;
 
-		case NAVICORE_HEADING:
-			json_object_object_add(obj, "key", json_object_new_int(NAVICORE_HEADING));
-			json_object_object_add(obj, "value", json_object_new_boolean (it->second));
-			json_object_array_add(response_json, obj);
+		case NAVI_POSITION_LONGITUDE:
+			json_object_object_add(obj, "value", json_object_new_double(position.longitude));
 			break;
-#if 0
-		// no support
-		case NAVICORE_TIMESTAMP:
-			json_object_object_add(obj, "key", json_object_new_int(NAVICORE_TIMESTAMP));
-			json_object_object_add(obj, "value", json_object_new_int(it->second));
-			json_object_array_add(response_json, obj);
+
+		case NAVI_POSITION_HEADING:
+			json_object_object_add(obj, "value", json_object_new_int(position.heading));
 			break;
 
-		// no support
-		case NAVICORE_SPEED:
-			json_object_object_add(obj, "key", json_object_new_int(NAVICORE_SPEED));
-			json_object_object_add(obj, "value", json_object_new_int(it->second));
-			json_object_array_add(response_json, obj);
+		case NAVI_POSITION_SPEED:
+			json_object_object_add(obj, "value", json_object_new_int(position.speed));
 			break;
-#endif
 
-		case NAVICORE_SIMULATION_MODE:
-			json_object_object_add(obj, "key", json_object_new_int(NAVICORE_SIMULATION_MODE));
-			json_object_object_add(obj, "value", json_object_new_boolean (it->second));
-			json_object_array_add(response_json, obj);
+		case NAVI_POSITION_SIMULATION_MODE:
+			json_object_object_add(obj, "value", json_object_new_boolean(position.simulationMode));
 			break;
+		}
 
-		default:
-			fprintf(stderr, "Unknown key.");
-			json_object_put(obj);
+		if( extrapolated & (1u << field) )
+		{
+			json_object_object_add(obj, "extrapolated", json_object_new_boolean(1));
+		}
+
+		json_object_array_add(response_json, obj);
+	}
+
+	response.json_data = response_json;
+	response.isSuccess = true;
+	return response;
+}
+
+/**
+ *  @brief      GeniviAPI GetPosition call, response text written from the field templates
+ *  @param[in]  position Position information acquired from Genivi
+ *  @param[in]  extrapolated Fields predicted by the binding, flagged in the response
+ *  @return     Response information (empty array serialized as the written text)
+ */
+APIResponse BinderReply::ReplyNavicoreGetPositionTemplate( const NaviPosition& position, uint32_t extrapolated )
+{
+	APIResponse response = {0};
+
+	// Json information to return as a response
+	struct json_object* response_json = json_object_new_array();
+
+	// If the position holds no field return
+	if( (position.mask & NAVI_POSITION_ALL) == 0 )
+	{
+		response.isSuccess  = false;
+		response.errMessage = "posList is empty";
+		response.json_data  = response_json;
+		return response;
+	}
+
+	// Same text as the json object tree, written in one buffer
+	char* text = (char*)malloc(BINDER_REPLY_POSITION_TEXT_SIZE);
+	int length = 0;
+	text[length++] = '[';
+
+	for (int field = 0; field < NAVI_POSITION_FIELD_MAX; field++)
+	{
+		if( !(position.mask & (1u << field)) )
+		{
+			continue;
+		}
+
+		// Each element fits in 80 characters
+		if( length + 80 >= BINDER_REPLY_POSITION_TEXT_SIZE )
+		{
+			break;
+		}
+
+		const PositionTemplate* tmpl = GetPositionTemplate(field);
+		const char* end = (extrapolated & (1u << field)) ? ", \"extrapolated\": true }" : " }";
+		text[length++] = ' ';
+		memcpy(text + length, tmpl->text, tmpl->length);
+		length += tmpl->length;
+
+		switch(field)
+		{
+		case NAVI_POSITION_TIMESTAMP:
+			length += snprintf(text + length, BINDER_REPLY_POSITION_TEXT_SIZE - length, "%u%s", position.timestamp, end);
+			break;
+
+		case NAVI_POSITION_LATITUDE:
+			length += snprintf(text + length, BINDER_REPLY_POSITION_TEXT_SIZE - length, "%.17g%s", position.latitude, end);
+			break;
+
+		case NAVI_POSITION_LONGITUDE:
+			length += snprintf(text + length, BINDER_REPLY_POSITION_TEXT_SIZE - length, "%.17g%s", position.longitude, end);
+			break;
+
+		case NAVI_POSITION_HEADING:
+			length += snprintf(text + length, BINDER_REPLY_POSITION_TEXT_SIZE - length, "%u%s", position.heading, end);
+			break;
+
+		case NAVI_POSITION_SPEED:
+			length += snprintf(text + length, BINDER_REPLY_POSITION_TEXT_SIZE - length, "%d%s", position.speed, end);
+			break;
+
+		case NAVI_POSITION_SIMULATION_MODE:
+			length += snprintf(text + length, BINDER_REPLY_POSITION_TEXT_SIZE - length, "%s%s", position.simulationMode ? "true" : "false", end);
 			break;
 		}
+
+		text[length++] = ',';
+	}
+
+	// Replace the last separator
+	if( text[length - 1] == ',' )
+	{
+		length--;
 	}
+	memcpy(text + length, " ]", 3);
+
+	// Released with the response
+	json_object_set_serializer(response_json, json_object_userdata_to_json_string, text, json_object_free_userdata);
 
 	response.json_data = response_json;
 	response.isSuccess = true;
 	return response;
 }
 
+/**
+ *  @brief      Position history
+ *  @param[in]  samples Positions, oldest first
+ *  @return     Response information
+ */
+APIResponse BinderReply::ReplyNavicoreGetPositionHistory( const PositionSamples& samples )
+{
+	APIResponse response = {0};
+
+	// Json information to return as a response
+	struct json_object* response_json = json_object_new_object();
+	json_object_object_add(response_json, "total", json_object_new_int64(samples.total));
+
+	struct json_object* samples_json = json_object_new_array();
+	for (size_t i = 0; i < samples.latitude.size(); i++)
+	{
+		struct json_object* obj = json_object_new_object();
+		json_object_object_add(obj, "timestamp", json_object_new_int64(samples.timestamp[i]));
+		json_object_object_add(obj, "latitude", json_object_new_double(samples.latitude[i]));
+		json_object_object_add(obj, "longitude", json_object_new_double(samples.longitude[i]));
+		json_object_object_add(obj, "heading", json_object_new_int64(samples.heading[i]));
+		json_object_object_add(obj, "speed", json_object_new_int(samples.speed[i]));
+		json_object_array_add(samples_json, obj);
+	}
+	json_object_object_add(response_json, "samples", samples_json);
+
+	response.json_data = response_json;
+	response.isSuccess = true;
+	return response;
+}
+
+/**
+ *  @brief      Fences registered by navicore_addgeofence
+ *  @param[in]  ids Id of each fence, in the order of the request
+ *  @return     Response information
+ */
+APIResponse BinderReply::ReplyNavicoreAddGeofence( const std::vector< uint32_t >& ids )
+{
+	APIResponse response;
+
+	json_object* fences = json_object_new_array();
+	for (size_t i = 0; i < ids.size(); i++)
+	{
+		json_object_array_add(fences, json_object_new_int64(ids[i]));
+	}
+
+	// Json information to return as a response
+	struct json_object* response_json = json_object_new_object();
+	json_object_object_add(response_json, "fences", fences);
+
+	response.json_data = response_json;
+	response.isSuccess = true;
+	return response;
+}
+
+/**
+ *  @brief      Progress along the tracked route
+ *  @param[in]  progress Remaining distance and time
+ *  @return     Response information
+ */
+APIResponse BinderReply::ReplyNavicoreGetRouteProgress( const RouteProgressInfo& progress )
+{
+	APIResponse response;
+
+	// Json information to return as a response
+	struct json_object* response_json = json_object_new_object();
+	json_object_object_add(response_json, "route", json_object_new_int64(progress.route));
+	json_object_object_add(response_json, "offset", json_object_new_int64(progress.offset));
+	json_object_object_add(response_json, "remainingDistance", json_object_new_int64(progress.remainingDistance));
+	json_object_object_add(response_json, "remainingTime", json_object_new_int64(progress.remainingTime));
+	if( progress.nextWaypoint >= 0 )
+	{
+		json_object_object_add(response_json, "nextWaypoint", json_object_new_int(progress.nextWaypoint));
+		json_object_object_add(response_json, "nextWaypointDistance", json_object_new_int64(progress.nextWaypointDistance));
+	}
+
+	response.json_data = response_json;
+	response.isSuccess = true;
+	return response;
+}
+
+/**
+ *  @brief      Response built once, shared by several requests
+ *  @param[in]  shared Response made by Share()
+ *  @return     Response information, a new reference on the shared json object
+ */
+APIResponse BinderReply::ReplyShared( const std::shared_ptr< json_object >& shared )
+{
+	APIResponse response = {0};
+	response.json_data = json_object_get(shared.get());
+	response.isSuccess = true;
+	return response;
+}
+
+/**
+ *  @brief      Keep a successful response to return it to several requests
+ *  @param[in]  response Response information, released
+ *  @return     json tree of the response, or its text attached to an empty array in template mode
+ */
+std::shared_ptr< json_object > BinderReply::Share( APIResponse response )
+{
+	json_object* shared = response.json_data;
+	if( mode_ == BINDER_REPLY_MODE_TEMPLATE )
+	{
+		// Serialized once for every request
+		shared = json_object_new_array();
+		json_object_set_serializer(shared, json_object_userdata_to_json_string,
+								   strdup(json_object_to_json_string(response.json_data)), json_object_free_userdata);
+		json_object_put(response.json_data);
+	}
+
+	return std::shared_ptr< json_object >( shared, json_object_put );
+}
+
 /**
  *  @brief      GeniviAPI GetAllRoutes call
  *  @param[in]  allRoutes Route handle information
@@ -131,6 +396,205 @@ APIResponse BinderReply::ReplyNavicoreCreateRoute( uint32_t route )
 	return response;
 }
 
+/**
+ *  @brief      Append a coordinate to an encoded polyline
+ *  @param[in]  value Coordinate in units of the precision
+ *  @param[in]  previous Previous coordinate of the same axis
+ *  @param[out] text Encoded polyline
+ */
+static void AppendPolylineValue( int64_t value, int64_t previous, std::string& text )
+{
+	// Delta to the previous point, zigzag so that small negative deltas stay short
+	int64_t delta = value - previous;
+	uint64_t bits = delta < 0 ? ~((uint64_t)delta << 1) : (uint64_t)delta << 1;
+
+	// 5 bits per printable character, 0x20 when more follow
+	while( bits >= 0x20 )
+	{
+		text += (char)((0x20 | (bits & 0x1f)) + 63);
+		bits >>= 5;
+	}
+	text += (char)(bits + 63);
+}
+
+/**
+ *  @brief      Encode the points of route segments as an encoded polyline
+ *  @param[in]  segments Route segments, each one starting where the previous one ends
+ *  @param[in]  precision Decimal digits kept
+ *  @return     Start point of each segment, then end point of the last one
+ */
+static std::string EncodePolyline( const std::vector< RouteSegment >& segments, uint32_t precision )
+{
+	std::string text;
+	if( segments.empty() )
+	{
+		return text;
+	}
+
+	double factor = 1;
+	for (uint32_t i = 0; i < precision; i++)
+	{
+		factor *= 10;
+	}
+
+	// Mostly 2 to 4 characters per coordinate
+	text.reserve((segments.size() + 1) * 8);
+
+	int64_t latitude = 0;
+	int64_t longitude = 0;
+	for (size_t i = 0; i <= segments.size(); i++)
+	{
+		double lat = i < segments.size() ? segments[i].startLatitude : segments[i - 1].endLatitude;
+		double lon = i < segments.size() ? segments[i].startLongitude : segments[i - 1].endLongitude;
+		int64_t nextLatitude = llround(lat * factor);
+		int64_t nextLongitude = llround(lon * factor);
+
+		AppendPolylineValue(nextLatitude, latitude, text);
+		AppendPolylineValue(nextLongitude, longitude, text);
+		latitude = nextLatitude;
+		longitude = nextLongitude;
+	}
+
+	return text;
+}
+
+/**
+ *  @brief      GeniviAPI GetRouteSegments call
+ *  @param[in]  route Route handle
+ *  @param[in]  total Number of segments of the route
+ *  @param[in]  offset Index of the first segment returned
+ *  @param[in]  segments Segments returned
+ *  @param[in]  encoding How the segments are returned
+ *  @param[in]  precision Decimal digits of the encoded polyline
+ *  @return     Response information
+ */
+APIResponse BinderReply::ReplyNavicoreGetRouteSegments( uint32_t route, uint32_t total, uint32_t offset, const std::vector< RouteSegment >& segments,
+														RouteSegmentsEncoding encoding, uint32_t precision )
+{
+	APIResponse response = {0};
+
+	// Json information to return as a response
+	struct json_object* response_json = json_object_new_object();
+	json_object_object_add(response_json, "route", json_object_new_int64(route));
+	json_object_object_add(response_json, "total", json_object_new_int64(total));
+	json_object_object_add(response_json, "offset", json_object_new_int64(offset));
+	json_object_object_add(response_json, "count", json_object_new_int64(segments.size()));
+
+	if( encoding == ROUTE_SEGMENTS_ENCODING_POLYLINE )
+	{
+		std::string points = EncodePolyline(segments, precision);
+		json_object_object_add(response_json, "precision", json_object_new_int(precision));
+		json_object_object_add(response_json, "points", json_object_new_string_len(points.c_str(), points.size()));
+	}
+	else
+	{
+		struct json_object* array = json_object_new_array();
+		for (size_t i = 0; i < segments.size(); i++)
+		{
+			struct json_object* obj = json_object_new_object();
+			json_object_object_add(obj, "startLatitude", json_object_new_double(segments[i].startLatitude));
+			json_object_object_add(obj, "startLongitude", json_object_new_double(segments[i].startLongitude));
+			json_object_object_add(obj, "endLatitude", json_object_new_double(segments[i].endLatitude));
+			json_object_object_add(obj, "endLongitude", json_object_new_double(segments[i].endLongitude));
+			json_object_object_add(obj, "distance", json_object_new_double(segments[i].distance));
+			json_object_object_add(obj, "time", json_object_new_int64(segments[i].time));
+			json_object_array_add(array, obj);
+		}
+		json_object_object_add(response_json, "segments", array);
+	}
+
+	response.json_data = response_json;
+	response.isSuccess = true;
+	return response;
+}
+
+/**
+ *  @brief      GeniviAPI GetRouteBoundingBox call
+ *  @param[in]  route Route handle
+ *  @param[in]  boundingBox Rectangle enclosing the route
+ *  @return     Response information
+ */
+APIResponse BinderReply::ReplyNavicoreGetRouteBoundingBox( uint32_t route, const RouteBoundingBox& boundingBox )
+{
+	APIResponse response = {0};
+
+	// Json information to return as a response
+	struct json_object* response_json = json_object_new_object();
+	json_object_object_add(response_json, "route", json_object_new_int64(route));
+	json_object_object_add(response_json, "minLatitude", json_object_new_double(boundingBox.minLatitude));
+	json_object_object_add(response_json, "minLongitude", json_object_new_double(boundingBox.minLongitude));
+	json_object_object_add(response_json, "maxLatitude", json_object_new_double(boundingBox.maxLatitude));
+	json_object_object_add(response_json, "maxLongitude", json_object_new_double(boundingBox.maxLongitude));
+
+	response.json_data = response_json;
+	response.isSuccess = true;
+	return response;
+}
+
+/**
+ *  @brief      GeniviAPI GetWaypoints call
+ *  @param[in]  route Route handle
+ *  @param[in]  startFromCurrentPosition Whether the route starts from the current position
+ *  @param[in]  waypointsList Coordinates of the waypoints
+ *  @return     Response information
+ */
+APIResponse BinderReply::ReplyNavicoreGetWaypoints( uint32_t route, bool startFromCurrentPosition, const std::vector< Waypoint >& waypointsList )
+{
+	APIResponse response = {0};
+
+	// Json information to return as a response
+	struct json_object* response_json = json_object_new_object();
+	json_object_object_add(response_json, "route", json_object_new_int64(route));
+	json_object_object_add(response_json, "startFromCurrentPosition", json_object_new_boolean(startFromCurrentPosition));
+
+	struct json_object* array = json_object_new_array();
+	for (size_t i = 0; i < waypointsList.size(); i++)
+	{
+		struct json_object* obj = json_object_new_object();
+		json_object_object_add(obj, "latitude", json_object_new_double(std::get<0>(waypointsList[i])));
+		json_object_object_add(obj, "longitude", json_object_new_double(std::get<1>(waypointsList[i])));
+		json_object_array_add(array, obj);
+	}
+	json_object_object_add(response_json, "waypoints", array);
+
+	response.json_data = response_json;
+	response.isSuccess = true;
+	return response;
+}
+
+/**
+ *  @brief      GeniviAPI GetManeuversList call
+ *  @param[in]  route Route handle
+ *  @param[in]  maneuvers Maneuvers along the route
+ *  @return     Response information
+ */
+APIResponse BinderReply::ReplyNavicoreGetManeuvers( uint32_t route, const std::vector< RouteManeuver >& maneuvers )
+{
+	APIResponse response = {0};
+
+	// Json information to return as a response
+	struct json_object* response_json = json_object_new_object();
+	json_object_object_add(response_json, "route", json_object_new_int64(route));
+
+	struct json_object* array = json_object_new_array();
+	for (size_t i = 0; i < maneuvers.size(); i++)
+	{
+		struct json_object* obj = json_object_new_object();
+		json_object_object_add(obj, "offset", json_object_new_int64(maneuvers[i].offset));
+		json_object_object_add(obj, "travelTime", json_object_new_int64(maneuvers[i].travelTime));
+		json_object_object_add(obj, "direction", json_object_new_int(maneuvers[i].direction));
+		json_object_object_add(obj, "maneuver", json_object_new_int(maneuvers[i].maneuver));
+		json_object_object_add(obj, "roadName", json_object_new_string(maneuvers[i].roadName.c_str()));
+		json_object_object_add(obj, "roadNumber", json_object_new_string(maneuvers[i].roadNumber.c_str()));
+		json_object_array_add(array, obj);
+	}
+	json_object_object_add(response_json, "maneuvers", array);
+
+	response.json_data = response_json;
+	response.isSuccess = true;
+	return response;
+}
+
 /**
  *  @brief      GeniviAPI GetAllSessions call
  *  @param[in]  allSessions Map information on key and value of information acquired from Genivi
@@ -166,3 +630,63 @@ APIResponse BinderReply::ReplyNavicoreGetAllSessions( std::map<uint32_t, std::st
 	return response;
 }
 
+
+/**
+ *  @brief      End of a route calculation waited for
+ *  @param[in]  route Route handle
+ *  @param[in]  result End of the calculation
+ *  @param[in]  errorCode Error of a failed calculation
+ *  @param[in]  unfullfilledPreferences Preferences the route does not satisfy
+ *  @return     Response information, failure if the calculation did not end
+ */
+APIResponse BinderReply::ReplyNavicoreCalculateRouteWait( uint32_t route, RouteCalculationResult result, int32_t errorCode,
+														  const std::map< int32_t, int32_t >& unfullfilledPreferences )
+{
+	APIResponse response = {0};
+
+	const char* status;
+	switch( result )
+	{
+	case ROUTE_CALCULATION_SUCCESSFUL:
+		status = "successful";
+		break;
+	case ROUTE_CALCULATION_FAILED:
+		status = "failed";
+		break;
+	case ROUTE_CALCULATION_CANCELLED:
+		status = "cancelled";
+		break;
+	case ROUTE_CALCULATION_TIMEOUT:
+		response.isSuccess = false;
+		response.errMessage = "Timeout";
+		return response;
+	default:
+		response.isSuccess = false;
+		response.errMessage = "Genivi call failed";
+		return response;
+	}
+
+	// Json information to return as a response
+	struct json_object* response_json = json_object_new_object();
+	json_object_object_add(response_json, "route", json_object_new_int64(route));
+	json_object_object_add(response_json, "status", json_object_new_string(status));
+	if( result == ROUTE_CALCULATION_FAILED )
+	{
+		json_object_object_add(response_json, "errorCode", json_object_new_int(errorCode));
+	}
+
+	struct json_object* preferences = json_object_new_array();
+	std::map< int32_t, int32_t >::const_iterator it;
+	for (it = unfullfilledPreferences.begin(); it != unfullfilledPreferences.end(); ++it)
+	{
+		struct json_object* obj = json_object_new_object();
+		json_object_object_add(obj, "key", json_object_new_int(it->first));
+		json_object_object_add(obj, "value", json_object_new_int(it->second));
+		json_object_array_add(preferences, obj);
+	}
+	json_object_object_add(response_json, "unfullfilledPreferences", preferences);
+
+	response.json_data = response_json;
+	response.isSuccess = true;
+	return response;
+}
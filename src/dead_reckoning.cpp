@@ -0,0 +1,100 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "dead_reckoning.h"
+#include "binder_time.h"
+#include "navi_geo.h"
+#include <string.h>
+
+#define DEAD_RECKONING_COORDINATES	((1u << NAVI_POSITION_LATITUDE) | (1u << NAVI_POSITION_LONGITUDE))
+#define DEAD_RECKONING_MOTION		((1u << NAVI_POSITION_HEADING) | (1u << NAVI_POSITION_SPEED))
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  positionCache Position information notified by Genivi
+ */
+DeadReckoning::DeadReckoning( PositionCache* positionCache )
+	: fixTime_(0), isValid_(false)
+{
+	memset(&fix_, 0, sizeof(fix_));
+	positionCache->Track((1u << NAVI_POSITION_TIMESTAMP) | DEAD_RECKONING_COORDINATES | DEAD_RECKONING_MOTION);
+}
+
+/**
+ *  @brief      Position predicted for now
+ *  @param[in]  mask Fields to acquire
+ *  @param[in]  horizon Longest time predicted after the fix in msec
+ *  @param[out] position Fields of mask known from the fixes
+ *  @param[out] extrapolated Fields of position that are predicted
+ *  @return     false if no fix was received since Genivi is available
+ */
+bool DeadReckoning::Get( uint32_t mask, uint32_t horizon, NaviPosition& position, uint32_t& extrapolated )
+{
+	extrapolated = 0;
+
+	std::lock_guard< std::mutex > lock( mutex_ );
+	if( !isValid_ || (fix_.mask & DEAD_RECKONING_COORDINATES) != DEAD_RECKONING_COORDINATES )
+	{
+		return false;
+	}
+
+	NaviPositionCopy(fix_, mask, position);
+
+	uint64_t elapsed = GetTimeUsec() - fixTime_;
+	if( elapsed > (uint64_t)horizon * 1000 )
+	{
+		elapsed = (uint64_t)horizon * 1000;
+	}
+	if( elapsed == 0 )
+	{
+		return true;
+	}
+
+	// Constant heading and speed since the fix
+	if( (mask & DEAD_RECKONING_COORDINATES) && (fix_.mask & DEAD_RECKONING_MOTION) == DEAD_RECKONING_MOTION )
+	{
+		double distance = fix_.speed / 3.6 * elapsed / 1000000.0;
+		double latitude;
+		double longitude;
+		NaviGeoMove(fix_.latitude, fix_.longitude, fix_.heading, distance, latitude, longitude);
+
+		position.latitude = latitude;
+		position.longitude = longitude;
+		extrapolated |= mask & DEAD_RECKONING_COORDINATES;
+	}
+
+	if( (mask & fix_.mask) & (1u << NAVI_POSITION_TIMESTAMP) )
+	{
+		position.timestamp = fix_.timestamp + (uint32_t)(elapsed / 1000);
+		extrapolated |= 1u << NAVI_POSITION_TIMESTAMP;
+	}
+
+	return true;
+}
+
+/**
+ *  @brief      Values changed in the position cache : new fix when the coordinates changed
+ *  @param[in]  changedList Changed fields
+ */
+void DeadReckoning::OnPositionChanged( const NaviPosition& changedList )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	NaviPositionCopy(changedList, changedList.mask, fix_);
+	if( changedList.mask & DEAD_RECKONING_COORDINATES )
+	{
+		fixTime_ = GetTimeUsec();
+		isValid_ = true;
+	}
+}
+
+/**
+ *  @brief      The last fix of a stopped or restarted Genivi is not predicted from anymore
+ *  @param[in]  isAvailable true if Genivi is available again
+ */
+void DeadReckoning::OnServiceStatusChanged( bool isAvailable )
+{
+	// The other fields are kept : the cache notifies the changed values only
+	std::lock_guard< std::mutex > lock( mutex_ );
+	isValid_ = false;
+}
@@ -0,0 +1,301 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "genivi/navicore.h"
+#include "genivi_connection.h"
+#include "sd_event_dispatcher.h"
+#include "binder_log.h"
+#include <stdio.h>
+#include <exception>
+#include <dbus-c++-1/dbus-c++/dbus.h>
+
+/**
+ *  @brief Owner changes of the Genivi bus name, from the bus daemon
+ */
+class GeniviBusWatcher :
+	public DBus::InterfaceProxy,
+	public DBus::ObjectProxy
+{
+public:
+	GeniviBusWatcher( DBus::Connection& connection, GeniviConnection* owner )
+		: DBus::InterfaceProxy("org.freedesktop.DBus"),
+		  DBus::ObjectProxy(connection, "/org/freedesktop/DBus", "org.freedesktop.DBus"),
+		  owner_(owner)
+	{
+		connect_signal(GeniviBusWatcher, NameOwnerChanged, _NameOwnerChanged_stub);
+
+		filter_ = new DBus::Callback< GeniviBusWatcher, bool, const DBus::Message& >( this, &GeniviBusWatcher::OnMessage );
+		conn().add_filter(filter_);
+	}
+
+	~GeniviBusWatcher()
+	{
+		conn().remove_filter(filter_);
+	}
+
+	bool NameHasOwner( const std::string& name )
+	{
+		::DBus::CallMessage call;
+		::DBus::MessageIter wi = call.writer();
+
+		wi << name;
+		call.member("NameHasOwner");
+		::DBus::Message ret = invoke_method(call);
+		::DBus::MessageIter ri = ret.reader();
+
+		bool hasOwner;
+		ri >> hasOwner;
+		return hasOwner;
+	}
+
+private:
+	GeniviConnection* owner_;
+	DBus::MessageSlot filter_;
+
+	/**
+	 *  @brief  Every message received on the connection, to see it close
+	 */
+	bool OnMessage( const DBus::Message& msg )
+	{
+		if( msg.is_signal("org.freedesktop.DBus.Local", "Disconnected") )
+		{
+			owner_->OnDisconnected();
+		}
+		return false;
+	}
+
+	void _NameOwnerChanged_stub( const ::DBus::SignalMessage& sig )
+	{
+		::DBus::MessageIter ri = sig.reader();
+
+		std::string name; ri >> name;
+		std::string oldOwner; ri >> oldOwner;
+		std::string newOwner; ri >> newOwner;
+
+		if( name == GENIVI_SERVICE_NAME )
+		{
+			owner_->SetAvailable( !newOwner.empty() );
+		}
+	}
+};
+
+/**
+ *  @brief Constructor
+ */
+GeniviConnection::GeniviConnection()
+	: dispatcher_(NULL), retryTimer_(NULL), watcher_(NULL), isAvailable_(false),
+	  retryDelay_(GENIVI_RECONNECT_MIN_DELAY)
+{
+}
+
+/**
+ *  @brief Destructor
+ */
+GeniviConnection::~GeniviConnection()
+{
+	Disconnect();
+	sd_event_source_unref(retryTimer_);
+}
+
+/**
+ *  @brief      Connect to Genivi, then keep the connection up in the background
+ *  @param[in]  loop Event loop of the binder, where replies and signals are received
+ *  @return     false if the connection cannot be dispatched
+ */
+bool GeniviConnection::Start( sd_event* loop )
+{
+	if( dispatcher_ != NULL )
+	{
+		return true;
+	}
+
+	if( loop == NULL )
+	{
+		fprintf(stderr, "Error:no event loop to dispatch D-Bus\n");
+		return false;
+	}
+
+	// Calls are sent from the loop (GeniviRequest::Send) : the watches and
+	// timeouts of libdbus are sources of the loop, which is not thread-safe.
+	// The connection is still shared with the worker threads of the verbs.
+	DBus::_init_threading();
+	dispatcher_ = new SdEventDispatcher(loop);
+	DBus::default_dispatcher = dispatcher_;
+
+	if( sd_event_add_time(loop, &retryTimer_, CLOCK_MONOTONIC, 0, 1000, GeniviConnection::OnRetryTimer, this) < 0 )
+	{
+		fprintf(stderr, "Error:cannot add D-Bus reconnection timer\n");
+		retryTimer_ = NULL;
+	}
+	else
+	{
+		sd_event_source_set_enabled(retryTimer_, SD_EVENT_OFF);
+	}
+
+	if( !Connect() )
+	{
+		ScheduleRetry( retryDelay_ );
+	}
+
+	return true;
+}
+
+/**
+ *  @brief  Connect to the session bus and look for the Genivi bus name
+ *  @return false if the session bus could not be reached
+ */
+bool GeniviConnection::Connect()
+{
+	try
+	{
+		DBus::Connection conn = DBus::Connection::SessionBus();
+
+		// A lost bus is reconnected, the binder must not exit
+		conn.exit_on_disconnect(false);
+
+		std::shared_ptr< Navicore > navicore( new Navicore(conn, GENIVI_OBJECT_PATH, GENIVI_SERVICE_NAME) );
+		{
+			std::lock_guard< std::mutex > lock( listenerMutex_ );
+			for (size_t i = 0; i < signalListeners_.size(); i++)
+			{
+				navicore->AddListener(signalListeners_[i]);
+			}
+		}
+
+		// Watch before asking, not to miss an owner change in between
+		watcher_ = new GeniviBusWatcher(conn, this);
+		std::atomic_store( &navicore_, navicore );
+		retryDelay_ = GENIVI_RECONNECT_MIN_DELAY;
+
+		SetAvailable( watcher_->NameHasOwner(GENIVI_SERVICE_NAME) );
+		return true;
+	}
+	catch(const std::exception& e)
+	{
+		fprintf(stderr, "Error:%s\n", e.what());
+		Disconnect();
+		return false;
+	}
+}
+
+/**
+ *  @brief  Release the bus connection (calls in progress fail with it)
+ */
+void GeniviConnection::Disconnect()
+{
+	SetAvailable( false );
+	std::atomic_store( &navicore_, std::shared_ptr< Navicore >() );
+	delete watcher_;
+	watcher_ = NULL;
+}
+
+/**
+ *  @brief      Follow the availability of Genivi
+ *  @param[in]  isAvailable true if the Genivi bus name has an owner
+ */
+void GeniviConnection::SetAvailable( bool isAvailable )
+{
+	if( isAvailable_.exchange(isAvailable) == isAvailable )
+	{
+		return;
+	}
+
+	BINDER_NOTICE("Genivi navigation core %s", isAvailable ? "available" : "not available");
+
+	std::vector< GeniviSignalListener* > listeners;
+	{
+		std::lock_guard< std::mutex > lock( listenerMutex_ );
+		listeners = signalListeners_;
+	}
+	for (size_t i = 0; i < listeners.size(); i++)
+	{
+		listeners[i]->OnServiceStatusChanged( isAvailable );
+	}
+}
+
+/**
+ *  @brief  The session bus closed the connection
+ */
+void GeniviConnection::OnDisconnected()
+{
+	fprintf(stderr, "Error:session bus connection lost\n");
+
+	// The connection is released from the timer, not from its own dispatch
+	SetAvailable( false );
+	ScheduleRetry( 0 );
+}
+
+/**
+ *  @brief      Connect again after a delay
+ *  @param[in]  delay Delay in msec
+ */
+void GeniviConnection::ScheduleRetry( uint32_t delay )
+{
+	if( retryTimer_ == NULL )
+	{
+		return;
+	}
+
+	uint64_t now;
+	sd_event_now(sd_event_source_get_event(retryTimer_), CLOCK_MONOTONIC, &now);
+	sd_event_source_set_time(retryTimer_, now + (uint64_t)delay * 1000);
+	sd_event_source_set_enabled(retryTimer_, SD_EVENT_ONESHOT);
+}
+
+/**
+ *  @brief  Time to connect again to the session bus
+ */
+int GeniviConnection::OnRetryTimer( sd_event_source* source, uint64_t usec, void* userdata )
+{
+	GeniviConnection* connection = (GeniviConnection*)userdata;
+
+	connection->Disconnect();
+	if( !connection->Connect() )
+	{
+		uint32_t delay = connection->retryDelay_;
+		connection->retryDelay_ = delay * 2 > GENIVI_RECONNECT_MAX_DELAY ? GENIVI_RECONNECT_MAX_DELAY : delay * 2;
+		connection->ScheduleRetry( delay );
+	}
+	return 0;
+}
+
+/**
+ *  @brief  Genivi proxy to call, if Genivi is available
+ *  @return Proxy, or NULL while Genivi is not available
+ */
+std::shared_ptr< Navicore > GeniviConnection::GetNavicore()
+{
+	if( !isAvailable_.load(std::memory_order_acquire) )
+	{
+		return std::shared_ptr< Navicore >();
+	}
+
+	return std::atomic_load( &navicore_ );
+}
+
+/**
+ *  @brief  Availability of Genivi
+ *  @return true if the bus is connected and the Genivi bus name has an owner
+ */
+bool GeniviConnection::IsAvailable() const
+{
+	return isAvailable_.load(std::memory_order_acquire);
+}
+
+/**
+ *  @brief      Register a receiver of Genivi signals, kept across reconnections
+ *  @param[in]  listener Receiver of the signals
+ */
+void GeniviConnection::AddSignalListener( GeniviSignalListener* listener )
+{
+	{
+		std::lock_guard< std::mutex > lock( listenerMutex_ );
+		signalListeners_.push_back(listener);
+	}
+
+	std::shared_ptr< Navicore > navicore = std::atomic_load( &navicore_ );
+	if( navicore )
+	{
+		navicore->AddListener(listener);
+	}
+}
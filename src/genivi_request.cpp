@@ -4,266 +4,332 @@
 #include "genivi/navicore.h"
 #include "genivi/genivi-navicore-constants.h"
 #include "genivi_request.h"
+#include "sd_event_queue.h"
+#include "binder_log.h"
 #include <stdio.h>
 #include <exception>
+#include <algorithm>
 #include <dbus-c++-1/dbus-c++/dbus.h>
 
 /**
- *  @brief Destructor
+ *  @brief Asynchronous Genivi call waiting for its reply
  */
-GeniviRequest::~GeniviRequest()
+class GeniviPendingCall
 {
-	delete (Navicore*)navicore_;
-	navicore_ = NULL;
-}
+public:
+	typedef std::function< void( const DBus::Message* reply ) > ReplyHandler;
 
-/**
- *  @brief  DBus session creation
- */
-void GeniviRequest::CreateDBusSession( )
-{
-	try
+	GeniviPendingCall( GeniviRequest* owner, const DBus::PendingCall& call, const ReplyHandler& handler )
+		: owner_(owner), call_(call), handler_(handler), isNotified_(false)
 	{
-		static DBus::BusDispatcher dispatcher;
-		DBus::default_dispatcher = &dispatcher;
-		DBus::Connection conn = DBus::Connection::SessionBus();
-
-		navicore_ = new Navicore(conn, "/org/genivi/navicore", "org.agl.naviapi");
+		call_.slot() = new DBus::Callback< GeniviPendingCall, void, DBus::PendingCall& >( this, &GeniviPendingCall::OnNotify );
 	}
-	catch(const std::exception& e)
+
+	/**
+	 *  @brief  Reply received before the slot was set : libdbus has not called it, do it now
+	 */
+	void NotifyIfCompleted()
 	{
-		fprintf(stderr, "Error:%s\n", e.what());
+		if( call_.completed() )
+		{
+			OnNotify( call_ );
+		}
 	}
-}
 
-/**
- *  @brief      Check connection status
- *  @return     Presence / absence of connection
- */
-bool GeniviRequest::CheckSession()
-{
-	if(this->navicore_ == NULL)
+	/**
+	 *  @brief  No reply will be received, complete the handler without one
+	 */
+	void Abandon()
 	{
-		this->CreateDBusSession();
+		if( isNotified_ )
+		{
+			return;
+		}
+		isNotified_ = true;
+		call_.cancel();
+
+		try
+		{
+			handler_( NULL );
+		}
+		catch(const std::exception& e)
+		{
+			fprintf(stderr, "Error:%s\n", e.what());
+		}
 	}
 
-	try
+private:
+	GeniviRequest* owner_;
+	DBus::PendingCall call_;
+	ReplyHandler handler_;
+	bool isNotified_;	// the handler has been called, calls and replies are handled in the loop only
+
+	/**
+	 *  @brief      Reply (or error) received from Genivi
+	 *  @param[in]  call Completed pending call
+	 */
+	void OnNotify( DBus::PendingCall& call )
 	{
-		// Get connection status
-		DBus::Connection conn = ((Navicore*)navicore_)->conn();
-		bool isConnect = conn.connected();
+		if( isNotified_ )
+		{
+			return;
+		}
+		isNotified_ = true;
+
+		DBus::Message reply = call.steal_reply();
 
-		// If it is not connected, it issues an error
-		if(!isConnect)
+		try
 		{
-			fprintf(stderr, "Service has no session.\n");
+			// An error reply is reported as no reply
+			handler_( reply.is_error() ? NULL : &reply );
+		}
+		catch(const std::exception& e)
+		{
+			fprintf(stderr, "Error:%s\n", e.what());
 		}
 
-		return isConnect;
+		owner_->ReleasePendingCall( this );
 	}
-	catch(const std::exception& e)
-	{
-		fprintf(stderr, "Error:%s\n", e.what());
-		return false;
-	}
-}
+};
 
 /**
- *  @brief      Call GeniviAPI GetPosition to get information
- *  @param[in]  valuesToReturn Key arrangement of information acquired from Genivi
- *  @return     Map information on key and value of information acquired from Genivi
+ *  @brief      Convert GetPosition result of Genivi
+ *  @param[in]  PosList Key and variant value acquired from Genivi
+ *  @return     Position, with the fields returned by Genivi
  */
-std::map< int32_t, double > GeniviRequest::NavicoreGetPosition( const std::vector< int32_t >& valuesToReturn )
+static NaviPosition ConvertPosition( std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > >& PosList )
 {
-	std::map< int32_t, double > ret;
+	NaviPosition ret = {0};
+	std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > >::iterator it;
 
-	if( !CheckSession() )
+	for (it = PosList.begin(); it != PosList.end(); it++)
 	{
-		return ret;
-	}
-
-	try
-	{
-		std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > >::iterator it;
-		std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > PosList =
-		    ((Navicore*)navicore_)->GetPosition(valuesToReturn);
-		for (it = PosList.begin(); it != PosList.end(); it++)
+		int field = NaviPositionField(it->first);
+		switch( field )
 		{
-			if (it->first == NAVICORE_LATITUDE || it->second._1 == NAVICORE_LATITUDE)
-			{
-				ret[it->first] = it->second._2.reader().get_double();
-			}
-			else if (it->first == NAVICORE_LONGITUDE || it->second._1 == NAVICORE_LONGITUDE)
-			{
-				ret[it->first] = it->second._2.reader().get_double();
-			}
-			else if (it->first == NAVICORE_HEADING || it->second._1 == NAVICORE_HEADING)
-			{
-				ret[it->first] = it->second._2.reader().get_uint32();
-			}
-#if 0 // no supported
-			else if (it->first == NAVICORE_TIMESTAMP || it->second._1 == NAVICORE_TIMESTAMP)
-			{
-				ret[it->first] = it->second._2.reader().get_uint32();
-			}
-			else if (it->first == NAVICORE_SPEED || it->second._1 == NAVICORE_SPEED)
-			{
-				ret[it->first] = it->second._2.reader().get_int32();
-			}
-#endif
-			else if (it->first == NAVICORE_SIMULATION_MODE || it->second._1 == NAVICORE_SIMULATION_MODE)
-			{
-				ret[it->first] = it->second._2.reader().get_bool();
-			}
+		case NAVI_POSITION_TIMESTAMP:
+			ret.timestamp = it->second._2.reader().get_uint32();
+			break;
+		case NAVI_POSITION_LATITUDE:
+			ret.latitude = it->second._2.reader().get_double();
+			break;
+		case NAVI_POSITION_LONGITUDE:
+			ret.longitude = it->second._2.reader().get_double();
+			break;
+		case NAVI_POSITION_HEADING:
+			ret.heading = it->second._2.reader().get_uint32();
+			break;
+		case NAVI_POSITION_SPEED:
+			ret.speed = it->second._2.reader().get_int32();
+			break;
+		case NAVI_POSITION_SIMULATION_MODE:
+			ret.simulationMode = it->second._2.reader().get_bool();
+			break;
+		default:
+			continue;
 		}
-	}
-	catch(const std::exception& e)
-	{
-		fprintf(stderr, "Error:%s\n", e.what());
+		ret.mask |= 1u << field;
 	}
 
 	return ret;
 }
 
 /**
- *  @brief  Call GeniviAPI GetPosition to get information
- *  @return Route handle acquired from Genivi
+ *  @brief      Convert a position to the argument of SetPosition of Genivi
+ *  @param[in]  position Position, the simulation mode is not a value Genivi can be given
+ *  @return     Key and variant value of each field of the position
  */
-std::vector< uint32_t > GeniviRequest::NavicoreGetAllRoutes( void )
+static std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > ConvertPositionList( const NaviPosition& position )
 {
-	if( !CheckSession() )
-	{
-		std::vector< uint32_t > no_route;
-		return no_route;
-	}
+	std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > PosList;
 
-	std::vector< uint32_t > allRoutes;
-	try
+	for (int field = 0; field < NAVI_POSITION_SIMULATION_MODE; field++)
 	{
-		allRoutes = ((Navicore*)navicore_)->GetAllRoutes();
-	}
-	catch(const std::exception& e)
-	{
-		fprintf(stderr, "Error:%s\n", e.what());
+		if( !(position.mask & (1u << field)) )
+		{
+			continue;
+		}
+
+		::DBus::Struct< uint8_t, ::DBus::Variant >& value = PosList[NaviPositionKey(field)];
+		value._1 = NaviPositionKey(field);
+		::DBus::MessageIter wi = value._2.writer();
+		switch( field )
+		{
+		case NAVI_POSITION_TIMESTAMP:
+			wi.append_uint32(position.timestamp);
+			break;
+		case NAVI_POSITION_LATITUDE:
+			wi.append_double(position.latitude);
+			break;
+		case NAVI_POSITION_LONGITUDE:
+			wi.append_double(position.longitude);
+			break;
+		case NAVI_POSITION_HEADING:
+			wi.append_uint32(position.heading);
+			break;
+		case NAVI_POSITION_SPEED:
+			wi.append_int32(position.speed);
+			break;
+		}
 	}
 
-	return allRoutes;
+	return PosList;
 }
 
-
 /**
- *  @brief      Call GeniviAPI GetPosition to get information
- *  @param[in]  sessionHandle Session handle
- *  @return     Route handle acquired from Genivi
+ *  @brief      Convert GetAllSessions result of Genivi
+ *  @param[in]  ncAllSessions Session handle and client name acquired from Genivi
+ *  @return     Map information on session handle and client name
  */
-uint32_t GeniviRequest::NavicoreCreateRoute( const uint32_t& sessionHandle )
+static std::map<uint32_t, std::string> ConvertSessions( std::vector< ::DBus::Struct< uint32_t, std::string > >& ncAllSessions )
 {
-	if( !CheckSession() )
-	{
-		return 0;
-	}
+	std::map<uint32_t, std::string> ret;
+	std::vector< ::DBus::Struct< uint32_t, std::string > >::iterator it;
 
-	uint32_t routeHandle = 0;
-	try
-	{
-		routeHandle = ((Navicore*)navicore_)->CreateRoute(sessionHandle);
-	}
-	catch(const std::exception& e)
+	for (it = ncAllSessions.begin(); it != ncAllSessions.end(); it++)
 	{
-		fprintf(stderr, "Error:%s\n", e.what());
+		ret[it->_1] = it->_2;
 	}
 
-	return routeHandle;
+	return ret;
 }
 
 /**
- *  @brief      Call GeniviAPI PauseSimulation
- *  @param[in]  sessionHandle Session handle
+ *  @brief      Values of a route segment asked to Genivi
+ *  @return     Keys of GetRouteSegments
  */
-void GeniviRequest::NavicorePauseSimulation( const uint32_t& sessionHandle )
+static const std::vector< int32_t >& RouteSegmentKeys()
 {
-	if( !CheckSession() )
-	{
-		return;
-	}
+	static const int32_t keys[] =
+	{
+		NAVICORE_START_LATITUDE, NAVICORE_START_LONGITUDE,
+		NAVICORE_END_LATITUDE, NAVICORE_END_LONGITUDE,
+		NAVICORE_DISTANCE, NAVICORE_TIME
+	};
+	static const std::vector< int32_t > valuesToReturn(keys, keys + sizeof(keys) / sizeof(keys[0]));
+	return valuesToReturn;
+}
 
-	try
-	{
-		((Navicore*)navicore_)->PauseSimulation(sessionHandle);
-	}
-	catch(const std::exception& e)
+/**
+ *  @brief      Convert GetRouteSegments result of Genivi
+ *  @param[in]  ncSegments Key and variant value of each segment acquired from Genivi
+ *  @return     Route segments, values not returned by Genivi are 0
+ */
+static std::vector< RouteSegment > ConvertRouteSegments( std::vector< std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > >& ncSegments )
+{
+	std::vector< RouteSegment > ret;
+	ret.reserve(ncSegments.size());
+
+	for (size_t i = 0; i < ncSegments.size(); i++)
 	{
-		fprintf(stderr, "Error:%s\n", e.what());
+		RouteSegment segment = {0};
+		std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > >::iterator it;
+
+		for (it = ncSegments[i].begin(); it != ncSegments[i].end(); it++)
+		{
+			switch( it->first )
+			{
+			case NAVICORE_START_LATITUDE:
+				segment.startLatitude = it->second._2.reader().get_double();
+				break;
+			case NAVICORE_START_LONGITUDE:
+				segment.startLongitude = it->second._2.reader().get_double();
+				break;
+			case NAVICORE_END_LATITUDE:
+				segment.endLatitude = it->second._2.reader().get_double();
+				break;
+			case NAVICORE_END_LONGITUDE:
+				segment.endLongitude = it->second._2.reader().get_double();
+				break;
+			case NAVICORE_DISTANCE:
+				segment.distance = it->second._2.reader().get_double();
+				break;
+			case NAVICORE_TIME:
+				segment.time = it->second._2.reader().get_uint32();
+				break;
+			default:
+				break;
+			}
+		}
+
+		ret.push_back(segment);
 	}
-}
 
+	return ret;
+}
 
 /**
- *  @brief      Call GeniviAPI SetSimulationMode
- *  @param[in]  sessionHandle Session handle
- *  @param[in]  activate Simulation mode enabled / disabled
+ *  @brief      Convert GetWaypoints result of Genivi
+ *  @param[in]  ncWaypoints Key and variant value of each waypoint acquired from Genivi
+ *  @return     Coordinates of the waypoints
  */
-void GeniviRequest::NavicoreSetSimulationMode( const uint32_t& sessionHandle, const bool& activate )
+static std::vector< Waypoint > ConvertWaypointsList( std::vector< std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > >& ncWaypoints )
 {
-	if( !CheckSession() )
-	{
-		return;
-	}
+	std::vector< Waypoint > ret;
+	ret.reserve(ncWaypoints.size());
 
-	try
+	for (size_t i = 0; i < ncWaypoints.size(); i++)
 	{
-		((Navicore*)navicore_)->SetSimulationMode(sessionHandle, activate);
-	}
-	catch(const std::exception& e)
-	{
-		fprintf(stderr, "Error:%s\n", e.what());
+		double latitude = 0;
+		double longitude = 0;
+		std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > >::iterator it;
+
+		it = ncWaypoints[i].find(NAVICORE_LATITUDE);
+		if( it != ncWaypoints[i].end() )
+		{
+			latitude = it->second._2.reader().get_double();
+		}
+		it = ncWaypoints[i].find(NAVICORE_LONGITUDE);
+		if( it != ncWaypoints[i].end() )
+		{
+			longitude = it->second._2.reader().get_double();
+		}
+
+		ret.push_back(Waypoint(latitude, longitude));
 	}
-}
 
+	return ret;
+}
 
 /**
- *  @brief      Call GeniviAPI SetSimulationMode
- *  @param[in]  sessionHandle Session handle
- *  @param[in]  routeHandle Route handle
+ *  @brief      Convert GetManeuversList result of Genivi
+ *  @param[in]  ncManeuvers Road after each maneuver, with its maneuver items, acquired from Genivi
+ *  @return     One maneuver per item, in the order of the route
  */
-void GeniviRequest::NavicoreCancelRouteCalculation( const uint32_t& sessionHandle, const uint32_t& routeHandle )
+static std::vector< RouteManeuver > ConvertManeuversList( std::vector< ::DBus::Struct< std::string, std::string, uint16_t, int32_t, uint32_t,
+	std::vector< ::DBus::Struct< uint32_t, uint32_t, int32_t, int32_t, std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > > > > >& ncManeuvers )
 {
-	if( !CheckSession() )
-	{ 
-		return;
-	}
+	std::vector< RouteManeuver > ret;
+	ret.reserve(ncManeuvers.size());
 
-	try
+	for (size_t i = 0; i < ncManeuvers.size(); i++)
 	{
-		((Navicore*)navicore_)->CancelRouteCalculation(sessionHandle, routeHandle);
-	}
-	catch(const std::exception& e)
-	{
-		fprintf(stderr, "Error:%s\n", e.what());
+		for (size_t j = 0; j < ncManeuvers[i]._6.size(); j++)
+		{
+			RouteManeuver maneuver;
+			maneuver.roadName = ncManeuvers[i]._1;
+			maneuver.roadNumber = ncManeuvers[i]._2;
+			maneuver.offset = ncManeuvers[i]._6[j]._1;
+			maneuver.travelTime = ncManeuvers[i]._6[j]._2;
+			maneuver.direction = ncManeuvers[i]._6[j]._3;
+			maneuver.maneuver = ncManeuvers[i]._6[j]._4;
+			ret.push_back(maneuver);
+		}
 	}
+
+	return ret;
 }
 
 /**
- *  @brief      Call GeniviAPI SetWaypoints
- *  @param[in]  sessionHandle Session handle
- *  @param[in]  routeHandle Route handle
- *  @param[in]  startFromCurrentPosition Whether or not to draw a route from the position of the vehicle
+ *  @brief      Convert destination coordinates to the Genivi waypoint format
  *  @param[in]  waypointsList Destination coordinates
+ *  @return     Waypoint list passed to Genivi SetWaypoints
  */
-void GeniviRequest::NavicoreSetWaypoints( const uint32_t& sessionHandle, const uint32_t& routeHandle,
-                    const bool& startFromCurrentPosition, const std::vector<Waypoint>& waypointsList )
+static std::vector< std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > > ConvertWaypoints( const std::vector<Waypoint>& waypointsList )
 {
-	if( !CheckSession() )
-	{
-		return;
-	}
-
 	std::vector<Waypoint>::const_iterator it;
 	std::vector< std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > > wpl;
 
-	fprintf(stdout, "session: %d, route: %d, startFromCurrentPosition: %d\n",
-	    sessionHandle, routeHandle, startFromCurrentPosition);
-
 	for (it = waypointsList.begin(); it != waypointsList.end(); it++)
 	{
 		std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > Point;
@@ -271,11 +337,11 @@ void GeniviRequest::NavicoreSetWaypoints( const uint32_t& sessionHandle, const u
 
 		VarLat._1 = NAVICORE_LATITUDE;
 		VarLat._2.writer().append_double(std::get<0>(*it));
-		fprintf(stdout, "VarLat._1 : %x, VarLat._2 : %lf\n", VarLat._1, VarLat._2.reader().get_double());
 
 		VarLon._1 = NAVICORE_LONGITUDE;
 		VarLon._2.writer().append_double(std::get<1>(*it));
-		fprintf(stdout, "VarLon._1 : %x, VarLon._2 : %lf\n", VarLon._1, VarLon._2.reader().get_double());
+
+		BINDER_DEBUG("waypoint latitude : %lf, longitude : %lf", std::get<0>(*it), std::get<1>(*it));
 
 		Point[NAVICORE_LATITUDE] = VarLat;
 		Point[NAVICORE_LONGITUDE] = VarLon;
@@ -283,68 +349,483 @@ void GeniviRequest::NavicoreSetWaypoints( const uint32_t& sessionHandle, const u
 		wpl.push_back(Point);
 	}
 
-	try
+	return wpl;
+}
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  loopQueue Tasks run by the event loop
+ */
+GeniviRequest::GeniviRequest( SdEventQueue* loopQueue )
+	: loopQueue_(loopQueue)
+{
+}
+
+/**
+ *  @brief Destructor
+ */
+GeniviRequest::~GeniviRequest()
+{
+	std::list< GeniviPendingCall* > pendingCalls;
 	{
-		((Navicore*)navicore_)->SetWaypoints(sessionHandle, routeHandle, startFromCurrentPosition, wpl);
+		std::lock_guard< std::mutex > lock( pendingMutex_ );
+		pendingCalls.swap(pendingCalls_);
 	}
-	catch(const std::exception& e)
+
+	// Answer the requests still waiting for Genivi
+	std::list< GeniviPendingCall* >::iterator it;
+	for (it = pendingCalls.begin(); it != pendingCalls.end(); it++)
 	{
-		fprintf(stderr, "Error:%s\n", e.what());
+		(*it)->Abandon();
+		delete *it;
 	}
 }
 
 /**
- *  @brief      Call GeniviAPI CalculateRoute
- *  @param[in]  sessionHandle Session handle
- *  @param[in]  routeHandle Route handle
+ *  @brief      Connect to Genivi, at service startup
+ *  @param[in]  loop Event loop of the binder, where replies and signals are received
+ *  @return     false if Genivi cannot be used
+ */
+bool GeniviRequest::Connect( sd_event* loop )
+{
+	return connection_.Start( loop );
+}
+
+/**
+ *  @brief      Register a receiver of Genivi signals
+ *  @param[in]  listener Receiver of the signals
  */
-void GeniviRequest::NavicoreCalculateRoute( const uint32_t& sessionHandle, const uint32_t& routeHandle )
+void GeniviRequest::AddSignalListener( GeniviSignalListener* listener )
 {
-	if( !CheckSession() )
+	connection_.AddSignalListener(listener);
+}
+
+/**
+ *  @brief      Send an asynchronous call from the event loop.
+ *
+ *  libdbus adds a timeout for each call and toggles the watches of the
+ *  connection, which are sources of the loop : calls from the worker
+ *  threads of the verbs are posted to the loop, and sent there.
+ *
+ *  @param[in]  send Sends the call through the proxy
+ *  @param[in]  handler Reply handler, given NULL if the call fails
+ */
+void GeniviRequest::Send( const Sender& send, const ReplyHandler& handler )
+{
+	loopQueue_->Post( [this, send, handler]()
 	{
-		return;
-	}
+		std::shared_ptr< Navicore > navicore = connection_.GetNavicore();
+		if( !navicore )
+		{
+			handler( NULL );
+			return;
+		}
 
-	try
+		try
+		{
+			AddPendingCall( send(*navicore), handler );
+		}
+		catch(const std::exception& e)
+		{
+			fprintf(stderr, "Error:%s\n", e.what());
+			handler( NULL );
+		}
+	});
+}
+
+/**
+ *  @brief      Register an asynchronous call until its reply is received
+ *  @param[in]  call Pending call returned by Genivi proxy
+ *  @param[in]  handler Reply handler
+ */
+void GeniviRequest::AddPendingCall( const DBus::PendingCall& call, const std::function< void( const DBus::Message* reply ) >& handler )
+{
+	GeniviPendingCall* pending = new GeniviPendingCall( this, call, handler );
 	{
-		((Navicore*)navicore_)->CalculateRoute(sessionHandle, routeHandle);
+		std::lock_guard< std::mutex > lock( pendingMutex_ );
+		pendingCalls_.push_back( pending );
 	}
-	catch(const std::exception& e)
+
+	// The reply may have been received while the call was sent, before the slot was set
+	pending->NotifyIfCompleted();
+}
+
+/**
+ *  @brief      Release a completed asynchronous call
+ *  @param[in]  pending Completed call
+ */
+void GeniviRequest::ReleasePendingCall( GeniviPendingCall* pending )
+{
+	std::lock_guard< std::mutex > lock( pendingMutex_ );
+	pendingCalls_.remove( pending );
+	delete pending;
+}
+
+/**
+ *  @brief      Reply handler of Genivi API without return value
+ *  @param[in]  callback Called with the success or failure of the call
+ *  @return     Reply handler
+ */
+static std::function< void( const DBus::Message* reply ) > ResultHandler( GeniviRequest::ResultCallback callback )
+{
+	return [callback]( const DBus::Message* reply )
 	{
-		fprintf(stderr, "Error:%s\n", e.what());
-	}
+		callback( reply != NULL );
+	};
 }
 
+/**
+ *  @brief      Call GeniviAPI GetPosition without waiting for the reply
+ *  @param[in]  valuesToReturn Key arrangement of information acquired from Genivi
+ *  @param[in]  callback Called with the position acquired from Genivi (no field on failure)
+ */
+void GeniviRequest::NavicoreGetPositionAsync( const std::vector< int32_t >& valuesToReturn, GetPositionCallback callback )
+{
+	Send( [valuesToReturn]( Navicore& navicore ) { return navicore.GetPositionAsync(valuesToReturn); },
+		[callback]( const DBus::Message* reply )
+		{
+			NaviPosition ret = {0};
+			try
+			{
+				if( reply != NULL )
+				{
+					std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > PosList;
+					::DBus::MessageIter ri = reply->reader();
+					ri >> PosList;
+					ret = ConvertPosition(PosList);
+				}
+			}
+			catch(const std::exception& e)
+			{
+				fprintf(stderr, "Error:%s\n", e.what());
+			}
+			callback( ret );
+		});
+}
 
 /**
- *  @brief  Call GeniviAPI CalculateRoute
- *  @return Map information on key and value of information acquired from Genivi
+ *  @brief      Call GeniviAPI SetPosition without waiting for the reply
+ *  @param[in]  sessionHandle Session handle
+ *  @param[in]  position Position given to Genivi
+ *  @param[in]  callback Called with the success or failure of the call
  */
-std::map<uint32_t, std::string> GeniviRequest::NavicoreGetAllSessions()
+void GeniviRequest::NavicoreSetPositionAsync( const uint32_t& sessionHandle, const NaviPosition& position, ResultCallback callback )
 {
-	std::map<uint32_t, std::string> ret;
+	Send( [sessionHandle, position]( Navicore& navicore )
+		{
+			return navicore.SetPositionAsync(sessionHandle, ConvertPositionList(position));
+		},
+		ResultHandler(callback) );
+}
 
-	if( !CheckSession() )
-	{
-		return ret;
-	}
+/**
+ *  @brief      Call GeniviAPI GetAllRoutes without waiting for the reply
+ *  @param[in]  callback Called with the success of the call and the route handles acquired from Genivi
+ */
+void GeniviRequest::NavicoreGetAllRoutesAsync( GetAllRoutesCallback callback )
+{
+	Send( []( Navicore& navicore ) { return navicore.GetAllRoutesAsync(); },
+		[callback]( const DBus::Message* reply )
+		{
+			bool isSuccess = false;
+			std::vector< uint32_t > allRoutes;
+			try
+			{
+				if( reply != NULL )
+				{
+					::DBus::MessageIter ri = reply->reader();
+					ri >> allRoutes;
+					isSuccess = true;
+				}
+			}
+			catch(const std::exception& e)
+			{
+				fprintf(stderr, "Error:%s\n", e.what());
+			}
+			callback( isSuccess, allRoutes );
+		});
+}
 
-	std::vector< ::DBus::Struct< uint32_t, std::string > > ncAllSessions;
-	std::vector< ::DBus::Struct< uint32_t, std::string > >::iterator it;
+/**
+ *  @brief      Call GeniviAPI CreateRoute without waiting for the reply
+ *  @param[in]  sessionHandle Session handle
+ *  @param[in]  callback Called with the route handle acquired from Genivi (0 on failure)
+ */
+void GeniviRequest::NavicoreCreateRouteAsync( const uint32_t& sessionHandle, CreateRouteCallback callback )
+{
+	Send( [sessionHandle]( Navicore& navicore ) { return navicore.CreateRouteAsync(sessionHandle); },
+		[callback]( const DBus::Message* reply )
+		{
+			uint32_t routeHandle = 0;
+			try
+			{
+				if( reply != NULL )
+				{
+					::DBus::MessageIter ri = reply->reader();
+					ri >> routeHandle;
+				}
+			}
+			catch(const std::exception& e)
+			{
+				fprintf(stderr, "Error:%s\n", e.what());
+			}
+			callback( routeHandle );
+		});
+}
 
-	try
-	{
-		ncAllSessions = ((Navicore*)navicore_)->GetAllSessions();
-		for (it = ncAllSessions.begin(); it != ncAllSessions.end(); it++)
+/**
+ *  @brief      Call GeniviAPI PauseSimulation without waiting for the reply
+ *  @param[in]  sessionHandle Session handle
+ *  @param[in]  callback Called with the success or failure of the call
+ */
+void GeniviRequest::NavicorePauseSimulationAsync( const uint32_t& sessionHandle, ResultCallback callback )
+{
+	Send( [sessionHandle]( Navicore& navicore ) { return navicore.PauseSimulationAsync(sessionHandle); },
+		ResultHandler(callback) );
+}
+
+/**
+ *  @brief      Call GeniviAPI SetSimulationMode without waiting for the reply
+ *  @param[in]  sessionHandle Session handle
+ *  @param[in]  activate Simulation mode enabled / disabled
+ *  @param[in]  callback Called with the success or failure of the call
+ */
+void GeniviRequest::NavicoreSetSimulationModeAsync( const uint32_t& sessionHandle, const bool& activate, ResultCallback callback )
+{
+	Send( [sessionHandle, activate]( Navicore& navicore )
 		{
-			ret[it->_1] = it->_2;
-		}
-	}
-	catch(const std::exception& e)
-	{
-		fprintf(stderr, "Error:%s\n", e.what());
-	}
+			return navicore.SetSimulationModeAsync(sessionHandle, activate);
+		},
+		ResultHandler(callback) );
+}
 
-	return ret;
+/**
+ *  @brief      Call GeniviAPI CancelRouteCalculation without waiting for the reply
+ *  @param[in]  sessionHandle Session handle
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  callback Called with the success or failure of the call
+ */
+void GeniviRequest::NavicoreCancelRouteCalculationAsync( const uint32_t& sessionHandle, const uint32_t& routeHandle, ResultCallback callback )
+{
+	Send( [sessionHandle, routeHandle]( Navicore& navicore )
+		{
+			return navicore.CancelRouteCalculationAsync(sessionHandle, routeHandle);
+		},
+		ResultHandler(callback) );
+}
+
+/**
+ *  @brief      Call GeniviAPI SetWaypoints without waiting for the reply
+ *  @param[in]  sessionHandle Session handle
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  startFromCurrentPosition Whether or not to draw a route from the position of the vehicle
+ *  @param[in]  waypointsList Destination coordinates
+ *  @param[in]  callback Called with the success or failure of the call
+ */
+void GeniviRequest::NavicoreSetWaypointsAsync( const uint32_t& sessionHandle, const uint32_t& routeHandle,
+                    const bool& startFromCurrentPosition, const std::vector<Waypoint>& waypointsList,
+                    ResultCallback callback )
+{
+	BINDER_NOTICE("session: %d, route: %d, startFromCurrentPosition: %d",
+	    sessionHandle, routeHandle, startFromCurrentPosition);
+
+	std::vector< std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > > wpl = ConvertWaypoints(waypointsList);
+
+	Send( [sessionHandle, routeHandle, startFromCurrentPosition, wpl]( Navicore& navicore )
+		{
+			return navicore.SetWaypointsAsync(sessionHandle, routeHandle, startFromCurrentPosition, wpl);
+		},
+		ResultHandler(callback) );
+}
+
+/**
+ *  @brief      Call GeniviAPI CalculateRoute without waiting for the reply
+ *  @param[in]  sessionHandle Session handle
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  callback Called with the success or failure of the call
+ */
+void GeniviRequest::NavicoreCalculateRouteAsync( const uint32_t& sessionHandle, const uint32_t& routeHandle, ResultCallback callback )
+{
+	Send( [sessionHandle, routeHandle]( Navicore& navicore )
+		{
+			return navicore.CalculateRouteAsync(sessionHandle, routeHandle);
+		},
+		ResultHandler(callback) );
+}
+
+/**
+ *  @brief      Call GeniviAPI GetAllSessions without waiting for the reply
+ *  @param[in]  callback Called with the success of the call and the session information acquired from Genivi
+ */
+void GeniviRequest::NavicoreGetAllSessionsAsync( GetAllSessionsCallback callback )
+{
+	Send( []( Navicore& navicore ) { return navicore.GetAllSessionsAsync(); },
+		[callback]( const DBus::Message* reply )
+		{
+			bool isSuccess = false;
+			std::map<uint32_t, std::string> ret;
+			try
+			{
+				if( reply != NULL )
+				{
+					std::vector< ::DBus::Struct< uint32_t, std::string > > ncAllSessions;
+					::DBus::MessageIter ri = reply->reader();
+					ri >> ncAllSessions;
+					ret = ConvertSessions(ncAllSessions);
+					isSuccess = true;
+				}
+			}
+			catch(const std::exception& e)
+			{
+				fprintf(stderr, "Error:%s\n", e.what());
+			}
+			callback( isSuccess, ret );
+		});
+}
+
+/**
+ *  @brief      Call GeniviAPI GetRouteSegments without waiting for the reply
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  numberOfSegments Maximum number of segments returned
+ *  @param[in]  offset Index of the first segment returned
+ *  @param[in]  callback Called with the total number of segments of the route and the segments returned
+ */
+void GeniviRequest::NavicoreGetRouteSegmentsAsync( const uint32_t& routeHandle, const uint32_t& numberOfSegments, const uint32_t& offset,
+												   GetRouteSegmentsCallback callback )
+{
+	Send( [routeHandle, numberOfSegments, offset]( Navicore& navicore )
+		{
+			return navicore.GetRouteSegmentsAsync(routeHandle, 0, RouteSegmentKeys(), numberOfSegments, offset);
+		},
+		[callback]( const DBus::Message* reply )
+		{
+			bool isSuccess = false;
+			uint32_t totalNumberOfSegments = 0;
+			std::vector< RouteSegment > segments;
+			try
+			{
+				if( reply != NULL )
+				{
+					std::vector< std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > > ncSegments;
+					::DBus::MessageIter ri = reply->reader();
+					ri >> totalNumberOfSegments;
+					ri >> ncSegments;
+					segments = ConvertRouteSegments(ncSegments);
+					isSuccess = true;
+				}
+			}
+			catch(const std::exception& e)
+			{
+				fprintf(stderr, "Error:%s\n", e.what());
+			}
+			callback( isSuccess, totalNumberOfSegments, segments );
+		});
+}
+
+/**
+ *  @brief      Call GeniviAPI GetRouteBoundingBox without waiting for the reply
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  callback Called with the rectangle enclosing the route
+ */
+void GeniviRequest::NavicoreGetRouteBoundingBoxAsync( const uint32_t& routeHandle, GetRouteBoundingBoxCallback callback )
+{
+	Send( [routeHandle]( Navicore& navicore ) { return navicore.GetRouteBoundingBoxAsync(routeHandle); },
+		[callback]( const DBus::Message* reply )
+		{
+			bool isSuccess = false;
+			RouteBoundingBox box = {0};
+			try
+			{
+				if( reply != NULL )
+				{
+					::DBus::Struct< ::DBus::Struct< double, double >, ::DBus::Struct< double, double > > ncBox;
+					::DBus::MessageIter ri = reply->reader();
+					ri >> ncBox;
+
+					// Corners in any order
+					box.minLatitude = std::min(ncBox._1._1, ncBox._2._1);
+					box.minLongitude = std::min(ncBox._1._2, ncBox._2._2);
+					box.maxLatitude = std::max(ncBox._1._1, ncBox._2._1);
+					box.maxLongitude = std::max(ncBox._1._2, ncBox._2._2);
+					isSuccess = true;
+				}
+			}
+			catch(const std::exception& e)
+			{
+				fprintf(stderr, "Error:%s\n", e.what());
+			}
+			callback( isSuccess, box );
+		});
+}
+
+/**
+ *  @brief      Call GeniviAPI GetWaypoints without waiting for the reply
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  callback Called with the waypoints of the route
+ */
+void GeniviRequest::NavicoreGetWaypointsAsync( const uint32_t& routeHandle, GetWaypointsCallback callback )
+{
+	Send( [routeHandle]( Navicore& navicore ) { return navicore.GetWaypointsAsync(routeHandle); },
+		[callback]( const DBus::Message* reply )
+		{
+			bool isSuccess = false;
+			bool startFromCurrentPosition = false;
+			std::vector< Waypoint > waypointsList;
+			try
+			{
+				if( reply != NULL )
+				{
+					std::vector< std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > > ncWaypoints;
+					::DBus::MessageIter ri = reply->reader();
+					ri >> startFromCurrentPosition;
+					ri >> ncWaypoints;
+					waypointsList = ConvertWaypointsList(ncWaypoints);
+					isSuccess = true;
+				}
+			}
+			catch(const std::exception& e)
+			{
+				fprintf(stderr, "Error:%s\n", e.what());
+			}
+			callback( isSuccess, startFromCurrentPosition, waypointsList );
+		});
 }
 
+/**
+ *  @brief      Call GeniviAPI GetManeuversList without waiting for the reply
+ *  @param[in]  requestedNumberOfManeuvers Maximum number of roads returned
+ *  @param[in]  maneuverOffset Index of the first road returned
+ *  @param[in]  callback Called with the number of roads returned and the maneuvers along them
+ */
+void GeniviRequest::NavicoreGetManeuversListAsync( const uint16_t& requestedNumberOfManeuvers, const uint32_t& maneuverOffset,
+												   GetManeuversListCallback callback )
+{
+	Send( [requestedNumberOfManeuvers, maneuverOffset]( Navicore& navicore )
+		{
+			return navicore.GetManeuversListAsync(requestedNumberOfManeuvers, maneuverOffset);
+		},
+		[callback]( const DBus::Message* reply )
+		{
+			bool isSuccess = false;
+			uint16_t numberOfManeuvers = 0;
+			std::vector< RouteManeuver > maneuvers;
+			try
+			{
+				if( reply != NULL )
+				{
+					std::vector< ::DBus::Struct< std::string, std::string, uint16_t, int32_t, uint32_t,
+						std::vector< ::DBus::Struct< uint32_t, uint32_t, int32_t, int32_t, std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > > > > > ncManeuvers;
+					::DBus::MessageIter ri = reply->reader();
+					ri >> numberOfManeuvers;
+					ri >> ncManeuvers;
+					maneuvers = ConvertManeuversList(ncManeuvers);
+					isSuccess = true;
+				}
+			}
+			catch(const std::exception& e)
+			{
+				fprintf(stderr, "Error:%s\n", e.what());
+			}
+			callback( isSuccess, numberOfManeuvers, maneuvers );
+		});
+}
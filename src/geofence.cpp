@@ -0,0 +1,448 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "geofence.h"
+#include "sd_event_queue.h"
+#include "binder_time.h"
+#include "navi_geo.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <systemd/sd-event.h>
+
+#define GEOFENCE_COORDINATES	((1u << NAVI_POSITION_LATITUDE) | (1u << NAVI_POSITION_LONGITUDE))
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  positionCache Position information notified by Genivi
+ *  @param[in]  loopQueue Runs the changes of the timer in the event loop
+ */
+Geofence::Geofence( PositionCache* positionCache, SdEventQueue* loopQueue )
+	: loopQueue_(loopQueue), timer_(NULL), nextId_(1), evaluation_(0), isEventValid_(false)
+{
+	memset(&current_, 0, sizeof(current_));
+	positionCache->Track((1u << NAVI_POSITION_TIMESTAMP) | GEOFENCE_COORDINATES);
+}
+
+/**
+ *  @brief Destructor
+ */
+Geofence::~Geofence()
+{
+	sd_event_source_unref(timer_);
+}
+
+/**
+ *  @brief      Create the timer of the dwell events
+ *  @param[in]  loop Event loop of the binder
+ *  @return     false if the timer cannot be added to the loop
+ */
+bool Geofence::Start( sd_event* loop )
+{
+	if( sd_event_add_time(loop, &timer_, CLOCK_MONOTONIC, 0, 1000, Geofence::OnTimer, this) < 0 )
+	{
+		fprintf(stderr, "Error:cannot add geofence timer\n");
+		timer_ = NULL;
+		return false;
+	}
+
+	sd_event_source_set_enabled(timer_, SD_EVENT_OFF);
+	return true;
+}
+
+/**
+ *  @brief      Register fences, none of them if the limit would be exceeded
+ *  @param[in]  shapes Areas to watch
+ *  @param[out] ids Id of each fence, in the order of shapes
+ *  @return     false if too many fences are registered
+ */
+bool Geofence::Add( const std::vector< GeofenceShape >& shapes, std::vector< uint32_t >& ids )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	if( fences_.size() + shapes.size() > GEOFENCE_MAX_FENCES )
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < shapes.size(); i++)
+	{
+		Fence fence;
+		fence.shape = shapes[i];
+		fence.isInside = false;
+		fence.isDwelling = false;
+		fence.enterTime = 0;
+		fence.evaluation = 0;
+
+		if( fence.shape.type == GEOFENCE_CIRCLE )
+		{
+			fence.scale = cos(fence.shape.latitude * NAVI_DEG_TO_RAD);
+			double dlat = fence.shape.radius / NAVI_EARTH_RADIUS / NAVI_DEG_TO_RAD;
+			double dlon = fence.scale > dlat / 180.0 ? dlat / fence.scale : 180.0;
+			fence.box.minLatitude = fence.shape.latitude - dlat;
+			fence.box.maxLatitude = fence.shape.latitude + dlat;
+			fence.box.minLongitude = fence.shape.longitude - dlon;
+			fence.box.maxLongitude = fence.shape.longitude + dlon;
+		}
+		else
+		{
+			fence.scale = 1.0;
+			fence.box.minLatitude = fence.box.maxLatitude = std::get<0>(fence.shape.points[0]);
+			fence.box.minLongitude = fence.box.maxLongitude = std::get<1>(fence.shape.points[0]);
+			for (size_t j = 1; j < fence.shape.points.size(); j++)
+			{
+				fence.box.minLatitude = std::min(fence.box.minLatitude, std::get<0>(fence.shape.points[j]));
+				fence.box.maxLatitude = std::max(fence.box.maxLatitude, std::get<0>(fence.shape.points[j]));
+				fence.box.minLongitude = std::min(fence.box.minLongitude, std::get<1>(fence.shape.points[j]));
+				fence.box.maxLongitude = std::max(fence.box.maxLongitude, std::get<1>(fence.shape.points[j]));
+			}
+		}
+
+		uint32_t id = nextId_++;
+		double rows = floor(fence.box.maxLatitude / GEOFENCE_CELL_SIZE) - floor(fence.box.minLatitude / GEOFENCE_CELL_SIZE) + 1;
+		double columns = floor(fence.box.maxLongitude / GEOFENCE_CELL_SIZE) - floor(fence.box.minLongitude / GEOFENCE_CELL_SIZE) + 1;
+		fence.isLarge = (rows * columns > GEOFENCE_MAX_CELLS);
+
+		Index( id, fence, true );
+		fences_[id] = fence;
+		ids.push_back( id );
+	}
+
+	return true;
+}
+
+/**
+ *  @brief      Unregister fences, no event is pushed for them anymore
+ *  @param[in]  ids Fences to remove
+ *  @return     false if an id is unknown, the known ones are removed
+ */
+bool Geofence::Remove( const std::vector< uint32_t >& ids )
+{
+	bool isFound = true;
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+
+		for (size_t i = 0; i < ids.size(); i++)
+		{
+			std::map< uint32_t, Fence >::iterator it = fences_.find(ids[i]);
+			if( it == fences_.end() )
+			{
+				isFound = false;
+				continue;
+			}
+
+			Index( it->first, it->second, false );
+			if( it->second.isInside )
+			{
+				inside_.erase(std::find(inside_.begin(), inside_.end(), it->first));
+			}
+			fences_.erase(it);
+		}
+	}
+
+	// Called from a worker thread, the timer is a source of the loop
+	loopQueue_->Post( [this]()
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		ArmTimer();
+	});
+	return isFound;
+}
+
+/**
+ *  @brief      Subscribe the client to geofence event
+ *  @param[in]  req Request from client
+ *  @return     Success or failure of processing
+ */
+bool Geofence::Subscribe( afb_req req )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	if( !isEventValid_ )
+	{
+		event_ = afb_daemon_make_event("geofence");
+		if( !afb_event_is_valid(event_) )
+		{
+			return false;
+		}
+		isEventValid_ = true;
+	}
+
+	return (afb_req_subscribe(req, event_) >= 0);
+}
+
+/**
+ *  @brief      Unsubscribe the client from geofence event
+ *  @param[in]  req Request from client
+ */
+void Geofence::Unsubscribe( afb_req req )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	if( isEventValid_ )
+	{
+		afb_req_unsubscribe(req, event_);
+	}
+}
+
+/**
+ *  @brief      Values changed in the position cache : test the new position, from the event loop
+ *  @param[in]  changedList Changed fields
+ */
+void Geofence::OnPositionChanged( const NaviPosition& changedList )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	NaviPositionCopy(changedList, changedList.mask, current_);
+	if( !(changedList.mask & GEOFENCE_COORDINATES)
+	 || (current_.mask & GEOFENCE_COORDINATES) != GEOFENCE_COORDINATES )
+	{
+		return;
+	}
+
+	uint64_t now = GetTimeMsec();
+	evaluation_++;
+
+	// Only the fences of the cell of the position can contain it
+	std::map< uint64_t, std::vector< uint32_t > >::const_iterator cell
+		= cells_.find(CellKey(Cell(current_.latitude), Cell(current_.longitude)));
+	if( cell != cells_.end() )
+	{
+		Test( cell->second, now );
+	}
+	Test( large_, now );
+
+	// Fences not found containing the position anymore
+	size_t i = 0;
+	while( i < inside_.size() )
+	{
+		uint32_t id = inside_[i];
+		Fence& fence = fences_[id];
+		if( fence.evaluation == evaluation_ )
+		{
+			i++;
+			continue;
+		}
+
+		fence.isInside = false;
+		inside_[i] = inside_.back();
+		inside_.pop_back();
+		Push( id, "exit" );
+	}
+
+	ArmTimer();
+}
+
+/**
+ *  @brief      Row or column of the grid
+ *  @param[in]  degree Latitude or longitude
+ *  @return     Cell index on the axis
+ */
+int32_t Geofence::Cell( double degree )
+{
+	return (int32_t)floor(degree / GEOFENCE_CELL_SIZE);
+}
+
+/**
+ *  @brief      Key of a cell in cells_
+ *  @param[in]  row Latitude index
+ *  @param[in]  column Longitude index
+ *  @return     Key
+ */
+uint64_t Geofence::CellKey( int32_t row, int32_t column )
+{
+	return ((uint64_t)(uint32_t)row << 32) | (uint32_t)column;
+}
+
+/**
+ *  @brief      Whether a position is inside a fence
+ *  @param[in]  fence Fence
+ *  @param[in]  latitude Latitude of the position
+ *  @param[in]  longitude Longitude of the position
+ *  @return     true if inside
+ */
+bool Geofence::Contains( const Fence& fence, double latitude, double longitude )
+{
+	if( latitude < fence.box.minLatitude || latitude > fence.box.maxLatitude
+	 || longitude < fence.box.minLongitude || longitude > fence.box.maxLongitude )
+	{
+		return false;
+	}
+
+	if( fence.shape.type == GEOFENCE_CIRCLE )
+	{
+		// Flat around the center, good for the radius allowed
+		double dy = (latitude - fence.shape.latitude) * NAVI_DEG_TO_RAD * NAVI_EARTH_RADIUS;
+		double dx = (longitude - fence.shape.longitude) * NAVI_DEG_TO_RAD * NAVI_EARTH_RADIUS * fence.scale;
+		return (dx * dx + dy * dy <= (double)fence.shape.radius * fence.shape.radius);
+	}
+
+	// Crossings of a ray toward the east, odd when inside
+	const std::vector< Waypoint >& points = fence.shape.points;
+	bool isInside = false;
+	for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++)
+	{
+		double latI = std::get<0>(points[i]);
+		double lonI = std::get<1>(points[i]);
+		double latJ = std::get<0>(points[j]);
+		double lonJ = std::get<1>(points[j]);
+		if( (latI > latitude) != (latJ > latitude)
+		 && longitude < lonI + (latitude - latI) * (lonJ - lonI) / (latJ - latI) )
+		{
+			isInside = !isInside;
+		}
+	}
+	return isInside;
+}
+
+/**
+ *  @brief      Add a fence to the cells of its bounding box, or remove it from them
+ *  @param[in]  id Fence id
+ *  @param[in]  fence Fence
+ *  @param[in]  isAdded true to add, false to remove
+ */
+void Geofence::Index( uint32_t id, const Fence& fence, bool isAdded )
+{
+	if( fence.isLarge )
+	{
+		if( isAdded )
+		{
+			large_.push_back(id);
+		}
+		else
+		{
+			large_.erase(std::find(large_.begin(), large_.end(), id));
+		}
+		return;
+	}
+
+	int32_t maxRow = Cell(fence.box.maxLatitude);
+	int32_t maxColumn = Cell(fence.box.maxLongitude);
+	for (int32_t row = Cell(fence.box.minLatitude); row <= maxRow; row++)
+	{
+		for (int32_t column = Cell(fence.box.minLongitude); column <= maxColumn; column++)
+		{
+			uint64_t key = CellKey(row, column);
+			if( isAdded )
+			{
+				cells_[key].push_back(id);
+				continue;
+			}
+
+			std::vector< uint32_t >& ids = cells_[key];
+			ids.erase(std::find(ids.begin(), ids.end(), id));
+			if( ids.empty() )
+			{
+				cells_.erase(key);
+			}
+		}
+	}
+}
+
+/**
+ *  @brief      Test the current position against fences, push enter events
+ *  @param[in]  ids Fences to test
+ *  @param[in]  now Current time in msec
+ */
+void Geofence::Test( const std::vector< uint32_t >& ids, uint64_t now )
+{
+	for (size_t i = 0; i < ids.size(); i++)
+	{
+		Fence& fence = fences_[ids[i]];
+		if( !Contains(fence, current_.latitude, current_.longitude) )
+		{
+			continue;
+		}
+
+		fence.evaluation = evaluation_;
+		if( !fence.isInside )
+		{
+			fence.isInside = true;
+			fence.isDwelling = false;
+			fence.enterTime = now;
+			inside_.push_back(ids[i]);
+			Push( ids[i], "enter" );
+		}
+	}
+}
+
+/**
+ *  @brief      Push a transition to the subscribers
+ *  @param[in]  id Fence id
+ *  @param[in]  transition "enter", "exit" or "dwell"
+ */
+void Geofence::Push( uint32_t id, const char* transition )
+{
+	if( !isEventValid_ )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "fence", json_object_new_int64(id));
+	json_object_object_add(payload, "transition", json_object_new_string(transition));
+	json_object_object_add(payload, "latitude", json_object_new_double(current_.latitude));
+	json_object_object_add(payload, "longitude", json_object_new_double(current_.longitude));
+	if( current_.mask & (1u << NAVI_POSITION_TIMESTAMP) )
+	{
+		json_object_object_add(payload, "timestamp", json_object_new_int64(current_.timestamp));
+	}
+
+	afb_event_push(event_, payload);
+}
+
+/**
+ *  @brief  Expire when the vehicle has stayed long enough in a fence, mutex_ must be locked
+ */
+void Geofence::ArmTimer()
+{
+	if( timer_ == NULL )
+	{
+		return;
+	}
+
+	uint64_t due = 0;
+	for (size_t i = 0; i < inside_.size(); i++)
+	{
+		const Fence& fence = fences_[inside_[i]];
+		uint64_t end = fence.enterTime + fence.shape.dwell;
+		if( fence.shape.dwell != 0 && !fence.isDwelling && (due == 0 || end < due) )
+		{
+			due = end;
+		}
+	}
+
+	if( due == 0 )
+	{
+		sd_event_source_set_enabled(timer_, SD_EVENT_OFF);
+		return;
+	}
+
+	sd_event_source_set_time(timer_, due * 1000);
+	sd_event_source_set_enabled(timer_, SD_EVENT_ONESHOT);
+}
+
+/**
+ *  @brief  Dwell time reached : push dwell events
+ */
+int Geofence::OnTimer( sd_event_source* source, uint64_t usec, void* userdata )
+{
+	Geofence* geofence = (Geofence*)userdata;
+	std::lock_guard< std::mutex > lock( geofence->mutex_ );
+
+	uint64_t now = GetTimeMsec();
+	for (size_t i = 0; i < geofence->inside_.size(); i++)
+	{
+		uint32_t id = geofence->inside_[i];
+		Fence& fence = geofence->fences_[id];
+		if( fence.shape.dwell != 0 && !fence.isDwelling && now - fence.enterTime >= fence.shape.dwell )
+		{
+			fence.isDwelling = true;
+			geofence->Push( id, "dwell" );
+		}
+	}
+
+	geofence->ArmTimer();
+	return 0;
+}
@@ -0,0 +1,239 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "handle_list_cache.h"
+#include "sd_event_queue.h"
+#include "binder_time.h"
+#include <algorithm>
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  geniviRequest Used to load the lists
+ *  @param[in]  binderReply Used to convert the lists to json format
+ *  @param[in]  loopQueue Runs the replies of the loaded lists in the event loop
+ */
+HandleListCache::HandleListCache( GeniviRequest* geniviRequest, BinderReply* binderReply, SdEventQueue* loopQueue )
+	: geniviRequest_(geniviRequest), binderReply_(binderReply), loopQueue_(loopQueue)
+{
+	sessionList_.loadTime = 0;
+	sessionList_.generation = 0;
+	routeList_.loadTime = 0;
+	routeList_.generation = 0;
+}
+
+/**
+ *  @brief      Response of navicore_getallsessions
+ *  @param[in]  callback Called with the session list
+ */
+void HandleListCache::GetAllSessions( const ReplyCallback& callback )
+{
+	uint32_t generation = 0;
+	if( Lookup( sessionList_, generation ) )
+	{
+		loopQueue_->Post( [this, callback]()
+		{
+			std::shared_ptr< json_object > reply;
+			{
+				std::lock_guard< std::mutex > lock( mutex_ );
+				reply = sessionList_.reply;
+			}
+			callback( reply );
+		});
+		return;
+	}
+
+	// Requests arriving before the reply wait for the same load
+	std::shared_ptr< RequestCoalescer< std::shared_ptr< json_object > >::Waiters > waiters;
+	if( !sessionList_.loads.Join( 0, callback, waiters ) )
+	{
+		return;
+	}
+
+	geniviRequest_->NavicoreGetAllSessionsAsync( [this, generation, waiters]( bool isSuccess, std::map< uint32_t, std::string >& allSessions )
+	{
+		std::shared_ptr< json_object > reply;
+		if( isSuccess )
+		{
+			reply = binderReply_->Share( binderReply_->ReplyNavicoreGetAllSessions( allSessions ) );
+
+			std::lock_guard< std::mutex > lock( mutex_ );
+			if( sessionList_.generation == generation )
+			{
+				sessions_.swap(allSessions);
+				sessionList_.reply = reply;
+				sessionList_.loadTime = GetTimeMsec();
+			}
+		}
+		sessionList_.loads.Complete( 0, waiters, reply );
+	});
+}
+
+/**
+ *  @brief      Response of navicore_getallroutes
+ *  @param[in]  callback Called with the route list
+ */
+void HandleListCache::GetAllRoutes( const ReplyCallback& callback )
+{
+	uint32_t generation = 0;
+	if( Lookup( routeList_, generation ) )
+	{
+		loopQueue_->Post( [this, callback]()
+		{
+			std::shared_ptr< json_object > reply;
+			{
+				std::lock_guard< std::mutex > lock( mutex_ );
+				reply = routeList_.reply;
+			}
+			callback( reply );
+		});
+		return;
+	}
+
+	// Requests arriving before the reply wait for the same load
+	std::shared_ptr< RequestCoalescer< std::shared_ptr< json_object > >::Waiters > waiters;
+	if( !routeList_.loads.Join( 0, callback, waiters ) )
+	{
+		return;
+	}
+
+	geniviRequest_->NavicoreGetAllRoutesAsync( [this, generation, waiters]( bool isSuccess, std::vector< uint32_t >& allRoutes )
+	{
+		std::shared_ptr< json_object > reply;
+		if( isSuccess )
+		{
+			reply = binderReply_->Share( binderReply_->ReplyNavicoreGetAllRoutes( allRoutes ) );
+
+			std::lock_guard< std::mutex > lock( mutex_ );
+			if( routeList_.generation == generation )
+			{
+				routes_.swap(allRoutes);
+				routeList_.reply = reply;
+				routeList_.loadTime = GetTimeMsec();
+			}
+		}
+		routeList_.loads.Complete( 0, waiters, reply );
+	});
+}
+
+/**
+ *  @brief  CreateRoute is about to be sent : a GetAllRoutes sent before it would miss the new route
+ */
+void HandleListCache::BeginCreateRoute()
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+	Change( routeList_ );
+}
+
+/**
+ *  @brief      Route created through the binding or discovered by a signal
+ *  @param[in]  routeHandle Route handle
+ */
+void HandleListCache::AddRoute( uint32_t routeHandle )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+	if( std::find(routes_.begin(), routes_.end(), routeHandle) != routes_.end() )
+	{
+		return;
+	}
+
+	Change( routeList_ );
+	if( routeList_.reply )
+	{
+		routes_.push_back(routeHandle);
+		routeList_.reply = binderReply_->Share( binderReply_->ReplyNavicoreGetAllRoutes( routes_ ) );
+	}
+}
+
+/**
+ *  @brief      Lists of a stopped or restarted Genivi are not served anymore
+ *  @param[in]  isAvailable true if Genivi is available again
+ */
+void HandleListCache::OnServiceStatusChanged( bool isAvailable )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	Change( sessionList_ );
+	sessions_.clear();
+	sessionList_.reply.reset();
+
+	Change( routeList_ );
+	routes_.clear();
+	routeList_.reply.reset();
+}
+
+void HandleListCache::OnSessionDeleted( uint32_t sessionHandle )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	// Routes of the session are deleted with their own signal
+	Change( sessionList_ );
+	if( sessionList_.reply && sessions_.erase(sessionHandle) > 0 )
+	{
+		sessionList_.reply = binderReply_->Share( binderReply_->ReplyNavicoreGetAllSessions( sessions_ ) );
+	}
+}
+
+void HandleListCache::OnRouteDeleted( uint32_t routeHandle )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	Change( routeList_ );
+	std::vector< uint32_t >::iterator it = std::find(routes_.begin(), routes_.end(), routeHandle);
+	if( routeList_.reply && it != routes_.end() )
+	{
+		routes_.erase(it);
+		routeList_.reply = binderReply_->Share( binderReply_->ReplyNavicoreGetAllRoutes( routes_ ) );
+	}
+}
+
+/**
+ *  @brief      A route of another client is known once it is calculated
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  unfullfilledPreferences Preferences the route does not satisfy (unused)
+ */
+void HandleListCache::OnRouteCalculationSuccessful( uint32_t routeHandle, const std::map< int32_t, int32_t >& unfullfilledPreferences )
+{
+	AddRoute( routeHandle );
+}
+
+/**
+ *  @brief      Alternative routes are created by Genivi
+ *  @param[in]  routeHandlesList Route handles
+ */
+void HandleListCache::OnAlternativeRoutesAvailable( const std::vector< uint32_t >& routeHandlesList )
+{
+	for (size_t i = 0; i < routeHandlesList.size(); i++)
+	{
+		AddRoute( routeHandlesList[i] );
+	}
+}
+
+/**
+ *  @brief      Whether the response of a list is recent enough
+ *  @param[in]  list List
+ *  @param[out] generation Generation a load started now belongs to
+ *  @return     true if the list can be answered without Genivi
+ */
+bool HandleListCache::Lookup( List& list, uint32_t& generation )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	if( list.reply && GetTimeMsec() - list.loadTime <= HANDLE_LIST_CACHE_MAX_AGE )
+	{
+		return true;
+	}
+
+	generation = list.generation;
+	return false;
+}
+
+/**
+ *  @brief      A list changes, mutex_ must be locked : the loads in progress are not kept
+ *              and the next requests do not wait for them
+ *  @param[in]  list List
+ */
+void HandleListCache::Change( List& list )
+{
+	list.generation++;
+	list.loads.Forget();
+}
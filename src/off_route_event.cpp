@@ -0,0 +1,162 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "off_route_event.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define OFF_ROUTE_COORDINATES	((1u << NAVI_POSITION_LATITUDE) | (1u << NAVI_POSITION_LONGITUDE))
+#define OFF_ROUTE_MOTION		((1u << NAVI_POSITION_HEADING) | (1u << NAVI_POSITION_SPEED))
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  positionCache Position information notified by Genivi
+ */
+OffRouteEvent::OffRouteEvent( PositionCache* positionCache )
+	: route_(0), groupCount_(0)
+{
+	memset(&current_, 0, sizeof(current_));
+	positionCache->Track(OFF_ROUTE_COORDINATES | OFF_ROUTE_MOTION);
+}
+
+/**
+ *  @brief      Subscribe the client to offroute event
+ *  @param[in]  req Request from client
+ *  @param[in]  distance Distance to the route in m
+ *  @param[in]  direction Difference with the direction of the route in degree
+ *  @return     Success or failure of processing
+ */
+bool OffRouteEvent::Subscribe( afb_req req, uint32_t distance, uint32_t direction )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	// Join the group of the same thresholds
+	std::list< Group >::iterator it;
+	for (it = groups_.begin(); it != groups_.end(); it++)
+	{
+		if( it->distance == distance && it->direction == direction )
+		{
+			break;
+		}
+	}
+
+	if( it == groups_.end() )
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "offroute/%u", groupCount_++);
+
+		Group group;
+		group.distance = distance;
+		group.direction = direction;
+		group.isDrifting = false;
+		group.confirmations = 0;
+		group.event = afb_daemon_make_event(name);
+		if( !afb_event_is_valid(group.event) )
+		{
+			return false;
+		}
+		it = groups_.insert(groups_.end(), group);
+	}
+
+	return (afb_req_subscribe(req, it->event) >= 0);
+}
+
+/**
+ *  @brief      Unsubscribe the client from offroute event
+ *  @param[in]  req Request from client
+ */
+void OffRouteEvent::Unsubscribe( afb_req req )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	std::list< Group >::iterator it;
+	for (it = groups_.begin(); it != groups_.end(); it++)
+	{
+		afb_req_unsubscribe(req, it->event);
+	}
+}
+
+/**
+ *  @brief      Values changed in the position cache : measure the new position against the route
+ *  @param[in]  changedList Changed fields
+ */
+void OffRouteEvent::OnPositionChanged( const NaviPosition& changedList )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	NaviPositionCopy(changedList, changedList.mask, current_);
+	if( !(changedList.mask & OFF_ROUTE_COORDINATES)
+	 || (current_.mask & OFF_ROUTE_COORDINATES) != OFF_ROUTE_COORDINATES
+	 || groups_.empty() || corridor_.IsEmpty() )
+	{
+		return;
+	}
+
+	double bearing;
+	double distance = corridor_.Distance(current_.latitude, current_.longitude, bearing);
+
+	// 0 to 180 degree between the heading and the route
+	double direction = 0;
+	if( (current_.mask & OFF_ROUTE_MOTION) == OFF_ROUTE_MOTION && current_.speed >= OFF_ROUTE_MIN_SPEED )
+	{
+		direction = fabs(fmod(current_.heading - bearing + 540.0, 360.0) - 180.0);
+	}
+
+	std::list< Group >::iterator it = groups_.begin();
+	while( it != groups_.end() )
+	{
+		bool isDrifting = (distance > it->distance || direction > it->direction);
+		if( isDrifting == it->isDrifting )
+		{
+			it->confirmations = 0;
+			it++;
+			continue;
+		}
+		if( ++it->confirmations < OFF_ROUTE_CONFIRMATIONS )
+		{
+			it++;
+			continue;
+		}
+
+		it->isDrifting = isDrifting;
+		it->confirmations = 0;
+
+		json_object* payload = json_object_new_object();
+		json_object_object_add(payload, "route", json_object_new_int64(route_));
+		json_object_object_add(payload, "drifting", json_object_new_boolean(isDrifting));
+		json_object_object_add(payload, "distance", json_object_new_int64((int64_t)(distance + 0.5)));
+		json_object_object_add(payload, "direction", json_object_new_int((int32_t)(direction + 0.5)));
+		if( afb_event_push(it->event, payload) <= 0 )
+		{
+			// No subscriber anymore
+			afb_event_drop(it->event);
+			it = groups_.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+}
+
+/**
+ *  @brief      Segments of the tracked route, indexed for the next positions
+ *  @param[in]  routeHandle Route handle (0 : no route)
+ *  @param[in]  segments Segments of the route (empty : not loaded yet)
+ */
+void OffRouteEvent::OnRouteLoaded( uint32_t routeHandle, const std::vector< RouteSegment >& segments )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	route_ = routeHandle;
+	corridor_.Build(segments);
+
+	// A new route starts on the route
+	std::list< Group >::iterator it;
+	for (it = groups_.begin(); it != groups_.end(); it++)
+	{
+		it->isDrifting = false;
+		it->confirmations = 0;
+	}
+}
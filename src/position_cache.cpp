@@ -0,0 +1,259 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "position_cache.h"
+#include "binder_time.h"
+#include <string.h>
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  geniviRequest Used to fetch the values notified as changed
+ */
+PositionCache::PositionCache( GeniviRequest* geniviRequest )
+	: geniviRequest_(geniviRequest), tracked_(0), asked_(0), signalTime_(0), generation_(0)
+{
+	memset(&position_, 0, sizeof(position_));
+	memset(entries_, 0, sizeof(entries_));
+	memset(trackCount_, 0, sizeof(trackCount_));
+}
+
+/**
+ *  @brief      Get position information from the cache
+ *  @param[in]  mask Fields to acquire
+ *  @param[in]  maxAge Staleness bound in msec (0 disables the cache)
+ *  @param[out] position Fields of mask, set only if every one could be answered
+ *  @return     true if every field could be answered from the cache
+ */
+bool PositionCache::Get( uint32_t mask, uint32_t maxAge, NaviPosition& position )
+{
+	if( maxAge == 0 || mask == 0 )
+	{
+		return false;
+	}
+
+	std::lock_guard< std::mutex > lock( mutex_ );
+	uint64_t now = GetTimeMsec();
+
+	if( (position_.mask & mask) != mask )
+	{
+		return false;
+	}
+
+	for (int field = 0; field < NAVI_POSITION_FIELD_MAX; field++)
+	{
+		if( !(mask & (1u << field)) )
+		{
+			continue;
+		}
+
+		const Entry& entry = entries_[field];
+		if( entry.pending )
+		{
+			return false;
+		}
+
+		// Unchanged fields are confirmed by every PositionUpdate
+		uint64_t confirmTime = entry.updateTime > signalTime_ ? entry.updateTime : signalTime_;
+		if( now - confirmTime > maxAge )
+		{
+			return false;
+		}
+	}
+
+	NaviPositionCopy(position_, mask, position);
+	return true;
+}
+
+/**
+ *  @brief      Get the last known values regardless of their age
+ *  @param[in]  mask Fields to acquire
+ *  @param[out] position Fields of mask already received
+ */
+void PositionCache::Peek( uint32_t mask, NaviPosition& position )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+	NaviPositionCopy(position_, mask, position);
+}
+
+/**
+ *  @brief  Start fetching position information from Genivi
+ *  @return Generation to pass to Update() with the fetched values
+ */
+uint32_t PositionCache::BeginFetch()
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+	return generation_;
+}
+
+/**
+ *  @brief      Store position information acquired from Genivi
+ *  @param[in]  position Fields acquired
+ *  @param[in]  generation Value of BeginFetch() when the fetch was issued
+ */
+void PositionCache::Update( const NaviPosition& position, uint32_t generation )
+{
+	NaviPosition changedList;
+	changedList.mask = 0;
+
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		uint64_t now = GetTimeMsec();
+
+		uint32_t mask = 0;
+		for (int field = 0; field < NAVI_POSITION_FIELD_MAX; field++)
+		{
+			// Changed again after this fetch was issued, keep waiting for the newer value
+			if( !(position.mask & (1u << field)) || entries_[field].generation > generation )
+			{
+				continue;
+			}
+
+			mask |= 1u << field;
+			entries_[field].updateTime = now;
+			entries_[field].generation = generation;
+			entries_[field].pending = false;
+		}
+
+		// New fields and fields whose value differs are notified
+		uint32_t changed = (mask & ~position_.mask) | NaviPositionDiff(position_, position, mask & position_.mask);
+		NaviPositionCopy(position, mask, position_);
+		NaviPositionCopy(position, changed, changedList);
+
+		// Fields asked for once are kept up to date, those of Track until released
+		asked_ |= mask & ~tracked_;
+		tracked_ |= mask;
+	}
+
+	if( changedList.mask == 0 )
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < listeners_.size(); i++)
+	{
+		listeners_[i]->OnPositionChanged( changedList );
+	}
+}
+
+/**
+ *  @brief      Keep fields up to date even if no client requested them yet
+ *  @param[in]  mask Fields refreshed on PositionUpdate, until released by Untrack
+ */
+void PositionCache::Track( uint32_t mask )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	for (int field = 0; field < NAVI_POSITION_FIELD_MAX; field++)
+	{
+		if( !(mask & (1u << field)) )
+		{
+			continue;
+		}
+		if( !(tracked_ & (1u << field)) )
+		{
+			entries_[field].pending = true;
+		}
+		trackCount_[field]++;
+	}
+	tracked_ |= mask;
+}
+
+/**
+ *  @brief      Release fields of Track, they are not refreshed anymore unless tracked again or asked for
+ *  @param[in]  mask Fields given to Track
+ */
+void PositionCache::Untrack( uint32_t mask )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	uint32_t before = tracked_;
+	tracked_ = asked_;
+	for (int field = 0; field < NAVI_POSITION_FIELD_MAX; field++)
+	{
+		if( (mask & (1u << field)) && trackCount_[field] > 0 )
+		{
+			trackCount_[field]--;
+		}
+		if( trackCount_[field] > 0 )
+		{
+			tracked_ |= 1u << field;
+		}
+	}
+
+	// Values not refreshed anymore would be confirmed by the next PositionUpdate
+	position_.mask &= ~(before & ~tracked_);
+}
+
+/**
+ *  @brief      Add a receiver of changed values, at service startup
+ *  @param[in]  listener Receiver of changed values
+ */
+void PositionCache::AddListener( PositionCacheListener* listener )
+{
+	listeners_.push_back(listener);
+}
+
+/**
+ *  @brief      Genivi MapMatchedPosition PositionUpdate signal
+ *  @param[in]  changedValues Keys whose value changed
+ */
+void PositionCache::OnPositionUpdate( const std::vector< int32_t >& changedValues )
+{
+	uint32_t generation;
+	uint32_t fetchMask;
+
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		generation = ++generation_;
+		signalTime_ = GetTimeMsec();
+
+		// Only refresh the fields clients asked for
+		fetchMask = NaviPositionMask(changedValues) & tracked_;
+		for (int field = 0; field < NAVI_POSITION_FIELD_MAX; field++)
+		{
+			if( fetchMask & (1u << field) )
+			{
+				entries_[field].pending = true;
+				entries_[field].generation = generation;
+			}
+		}
+	}
+
+	if( fetchMask == 0 )
+	{
+		return;
+	}
+
+	geniviRequest_->NavicoreGetPositionAsync( NaviPositionKeys(fetchMask), [this, generation]( NaviPosition& position )
+	{
+		Update( position, generation );
+	});
+}
+
+/**
+ *  @brief      Genivi appeared on or left the session bus
+ *  @param[in]  isAvailable true if Genivi can be called
+ */
+void PositionCache::OnServiceStatusChanged( bool isAvailable )
+{
+	uint32_t mask;
+
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		mask = tracked_;
+		for (int field = 0; field < NAVI_POSITION_FIELD_MAX; field++)
+		{
+			// Values of a stopped or restarted Genivi are not served anymore
+			if( mask & (1u << field) )
+			{
+				entries_[field].pending = true;
+			}
+		}
+	}
+
+	// Fetch every tracked field again, as if they all changed
+	if( isAvailable && mask != 0 )
+	{
+		OnPositionUpdate( NaviPositionKeys(mask) );
+	}
+}
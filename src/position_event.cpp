@@ -0,0 +1,265 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "position_event.h"
+#include "binder_time.h"
+#include <stdio.h>
+#include <systemd/sd-event.h>
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  geniviRequest Used to fetch the initial values
+ *  @param[in]  positionCache Position information notified by Genivi
+ *  @param[in]  binderReply Used to convert the values to json format
+ */
+PositionEvent::PositionEvent( GeniviRequest* geniviRequest, PositionCache* positionCache, BinderReply* binderReply )
+	: geniviRequest_(geniviRequest), positionCache_(positionCache), binderReply_(binderReply), timer_(NULL), groupCount_(0)
+{
+}
+
+/**
+ *  @brief Destructor
+ */
+PositionEvent::~PositionEvent()
+{
+	sd_event_source_unref(timer_);
+}
+
+/**
+ *  @brief      Create the timer of the changes delayed by the interval
+ *  @param[in]  loop Event loop of the binder
+ *  @return     false if the timer cannot be added to the loop
+ */
+bool PositionEvent::Start( sd_event* loop )
+{
+	if( sd_event_add_time(loop, &timer_, CLOCK_MONOTONIC, 0, 1000, PositionEvent::OnTimer, this) < 0 )
+	{
+		fprintf(stderr, "Error:cannot add position event timer\n");
+		timer_ = NULL;
+		return false;
+	}
+
+	sd_event_source_set_enabled(timer_, SD_EVENT_OFF);
+	return true;
+}
+
+/**
+ *  @brief      Subscribe the client to position event
+ *  @param[in]  req Request from client
+ *  @param[in]  mask Fields notified by the event
+ *  @param[in]  minInterval Minimum interval between two events in msec
+ *  @param[in]  callback Called with the initial values, for the new subscriber only
+ *  @return     Success or failure of processing
+ */
+bool PositionEvent::Subscribe( afb_req req, uint32_t mask, uint32_t minInterval, InitialCallback callback )
+{
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+
+		// Join the group of the same fields and interval
+		bool isCreated = false;
+		std::list< Group >::iterator it;
+		for (it = groups_.begin(); it != groups_.end(); it++)
+		{
+			if( it->mask == mask && it->minInterval == minInterval )
+			{
+				break;
+			}
+		}
+
+		if( it == groups_.end() )
+		{
+			char name[32];
+			snprintf(name, sizeof(name), "position/%u", groupCount_++);
+
+			Group group;
+			group.mask = mask;
+			group.minInterval = minInterval;
+			group.pushTime = 0;
+			group.isDelayed = false;
+			group.event = afb_daemon_make_event(name);
+			if( !afb_event_is_valid(group.event) )
+			{
+				return false;
+			}
+			it = groups_.insert(groups_.end(), group);
+
+			// Kept up to date by Genivi signals while the group exists
+			positionCache_->Track(mask);
+			isCreated = true;
+		}
+
+		if( afb_req_subscribe(req, it->event) < 0 )
+		{
+			if( isCreated )
+			{
+				Drop( it );
+			}
+			return false;
+		}
+	}
+
+	// Initial values, given to the new subscriber only : the other members
+	// of the group already have them
+	NaviPosition position;
+	position.mask = 0;
+	positionCache_->Peek(mask, position);
+	if( position.mask == mask )
+	{
+		callback( position );
+		return true;
+	}
+
+	uint32_t generation = positionCache_->BeginFetch();
+	PositionCache* positionCache = positionCache_;
+	geniviRequest_->NavicoreGetPositionAsync( NaviPositionKeys(mask), [positionCache, generation, callback]( NaviPosition& position )
+	{
+		positionCache->Update( position, generation );
+		callback( position );
+	});
+	return true;
+}
+
+/**
+ *  @brief      Unsubscribe the client from position event
+ *  @param[in]  req Request from client
+ */
+void PositionEvent::Unsubscribe( afb_req req )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	std::list< Group >::iterator it;
+	for (it = groups_.begin(); it != groups_.end(); it++)
+	{
+		afb_req_unsubscribe(req, it->event);
+	}
+}
+
+/**
+ *  @brief      Values changed in the position cache, from the event loop
+ *  @param[in]  changedList Changed fields
+ */
+void PositionEvent::OnPositionChanged( const NaviPosition& changedList )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	std::list< Group >::iterator it = groups_.begin();
+	while( it != groups_.end() )
+	{
+		bool isChanged = (it->mask & changedList.mask) != 0;
+		if( isChanged && !Push(*it) )
+		{
+			// No subscriber anymore
+			it = Drop( it );
+		}
+		else
+		{
+			it++;
+		}
+	}
+
+	ArmTimer();
+}
+
+/**
+ *  @brief      Push the current values of the group fields
+ *  @param[in]  group Group to notify
+ *  @return     false if the group has no subscriber
+ */
+bool PositionEvent::Push( Group& group )
+{
+	uint64_t now = GetTimeMsec();
+
+	// Rate limit, the latest values are pushed at the end of the interval
+	if( group.pushTime != 0 && now - group.pushTime < group.minInterval )
+	{
+		group.isDelayed = true;
+		return true;
+	}
+	group.isDelayed = false;
+
+	NaviPosition position;
+	position.mask = 0;
+	positionCache_->Peek(group.mask, position);
+
+	APIResponse response = binderReply_->ReplyNavicoreGetPosition( position, 0 );
+	if( !response.isSuccess )
+	{
+		json_object_put(response.json_data);
+		return true;
+	}
+
+	group.pushTime = now;
+	return (afb_event_push(group.event, response.json_data) > 0);
+}
+
+/**
+ *  @brief      Drop a group and stop tracking its fields, mutex_ must be locked
+ *  @param[in]  it Group
+ *  @return     Next group
+ */
+std::list< PositionEvent::Group >::iterator PositionEvent::Drop( std::list< Group >::iterator it )
+{
+	afb_event_drop(it->event);
+	positionCache_->Untrack(it->mask);
+	return groups_.erase(it);
+}
+
+/**
+ *  @brief  Expire at the end of the earliest interval delaying a change, mutex_ must be locked
+ */
+void PositionEvent::ArmTimer()
+{
+	if( timer_ == NULL )
+	{
+		return;
+	}
+
+	uint64_t due = 0;
+	std::list< Group >::iterator it;
+	for (it = groups_.begin(); it != groups_.end(); it++)
+	{
+		uint64_t end = it->pushTime + it->minInterval;
+		if( it->isDelayed && (due == 0 || end < due) )
+		{
+			due = end;
+		}
+	}
+
+	if( due == 0 )
+	{
+		sd_event_source_set_enabled(timer_, SD_EVENT_OFF);
+		return;
+	}
+
+	sd_event_source_set_time(timer_, due * 1000);
+	sd_event_source_set_enabled(timer_, SD_EVENT_ONESHOT);
+}
+
+/**
+ *  @brief  End of an interval : push the changes it delayed
+ */
+int PositionEvent::OnTimer( sd_event_source* source, uint64_t usec, void* userdata )
+{
+	PositionEvent* positionEvent = (PositionEvent*)userdata;
+	std::lock_guard< std::mutex > lock( positionEvent->mutex_ );
+
+	uint64_t now = GetTimeMsec();
+	std::list< Group >::iterator it = positionEvent->groups_.begin();
+	while( it != positionEvent->groups_.end() )
+	{
+		bool isDue = it->isDelayed && it->pushTime + it->minInterval <= now;
+		if( isDue && !positionEvent->Push(*it) )
+		{
+			// No subscriber anymore
+			it = positionEvent->Drop( it );
+		}
+		else
+		{
+			it++;
+		}
+	}
+
+	positionEvent->ArmTimer();
+	return 0;
+}
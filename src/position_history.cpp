@@ -0,0 +1,210 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "position_history.h"
+#include "binder_time.h"
+#include <string.h>
+#include <math.h>
+
+/**
+ *  @brief Fields of a sample, refreshed by the position cache even without client
+ */
+#define POSITION_HISTORY_FIELDS	((1u << NAVI_POSITION_TIMESTAMP) | (1u << NAVI_POSITION_LATITUDE) | (1u << NAVI_POSITION_LONGITUDE) \
+								| (1u << NAVI_POSITION_HEADING) | (1u << NAVI_POSITION_SPEED))
+
+#define POSITION_HISTORY_COORDINATES	((1u << NAVI_POSITION_LATITUDE) | (1u << NAVI_POSITION_LONGITUDE))
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  positionCache Position information notified by Genivi
+ */
+PositionHistory::PositionHistory( PositionCache* positionCache )
+	: next_(0), size_(0)
+{
+	memset(&current_, 0, sizeof(current_));
+	positionCache->Track(POSITION_HISTORY_FIELDS);
+}
+
+/**
+ *  @brief      Last positions
+ *  @param[in]  count Number of samples (0 : no limit)
+ *  @param[in]  duration Age of the oldest sample in msec (0 : no limit)
+ *  @param[in]  maxPoints Number of samples after downsampling (0 : every sample)
+ *  @param[out] samples Positions, oldest first
+ */
+void PositionHistory::Get( uint32_t count, uint32_t duration, uint32_t maxPoints, PositionSamples& samples )
+{
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+
+		uint32_t n = size_;
+		if( count != 0 && count < n )
+		{
+			n = count;
+		}
+
+		// Recording times only grow : the window ends at the first sample too old
+		if( duration != 0 )
+		{
+			uint64_t now = GetTimeMsec();
+			uint32_t low = 0;
+			uint32_t high = n;
+			while( low < high )
+			{
+				uint32_t mid = (low + high) / 2;
+				if( now - time_[Index(mid)] <= duration )
+				{
+					low = mid + 1;
+				}
+				else
+				{
+					high = mid;
+				}
+			}
+			n = low;
+		}
+
+		samples.total = n;
+		samples.timestamp.resize(n);
+		samples.latitude.resize(n);
+		samples.longitude.resize(n);
+		samples.heading.resize(n);
+		samples.speed.resize(n);
+		for (uint32_t i = 0; i < n; i++)
+		{
+			uint32_t index = Index(n - 1 - i);
+			samples.timestamp[i] = timestamp_[index];
+			samples.latitude[i] = latitude_[index];
+			samples.longitude[i] = longitude_[index];
+			samples.heading[i] = heading_[index];
+			samples.speed[i] = speed_[index];
+		}
+	}
+
+	if( maxPoints != 0 && samples.total > maxPoints )
+	{
+		Downsample( maxPoints, samples );
+	}
+}
+
+/**
+ *  @brief      Values changed in the position cache : record a sample when the vehicle moved
+ *  @param[in]  changedList Changed fields
+ */
+void PositionHistory::OnPositionChanged( const NaviPosition& changedList )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	NaviPositionCopy(changedList, changedList.mask, current_);
+	if( !(changedList.mask & POSITION_HISTORY_COORDINATES)
+	 || (current_.mask & POSITION_HISTORY_COORDINATES) != POSITION_HISTORY_COORDINATES )
+	{
+		return;
+	}
+
+	time_[next_] = GetTimeMsec();
+	timestamp_[next_] = current_.timestamp;
+	latitude_[next_] = current_.latitude;
+	longitude_[next_] = current_.longitude;
+	heading_[next_] = current_.heading;
+	speed_[next_] = current_.speed;
+
+	next_ = (next_ + 1) % POSITION_HISTORY_CAPACITY;
+	if( size_ < POSITION_HISTORY_CAPACITY )
+	{
+		size_++;
+	}
+}
+
+/**
+ *  @brief      Index of a sample, mutex_ must be locked
+ *  @param[in]  age 0 for the newest sample, 1 for the one before...
+ *  @return     Index in the arrays
+ */
+uint32_t PositionHistory::Index( uint32_t age ) const
+{
+	return (next_ + POSITION_HISTORY_CAPACITY - 1 - age) % POSITION_HISTORY_CAPACITY;
+}
+
+/**
+ *  @brief      Keep the samples that shape the trail most (Largest Triangle Three Buckets)
+ *
+ *  The first and last samples are kept. The others are split in maxPoints - 2
+ *  buckets, and the sample of each bucket forming the largest triangle with
+ *  the sample kept before and the average of the next bucket is kept.
+ *  The triangles are measured on the map, not against time.
+ *
+ *  @param[in]     maxPoints Number of samples to keep, at least 3
+ *  @param[in,out] samples Positions, oldest first
+ */
+void PositionHistory::Downsample( uint32_t maxPoints, PositionSamples& samples )
+{
+	uint32_t n = samples.latitude.size();
+	if( maxPoints < POSITION_HISTORY_MIN_POINTS || n <= maxPoints )
+	{
+		return;
+	}
+
+	// Same scale for both axes around the trail
+	double scale = cos(samples.latitude[n - 1] * M_PI / 180.0);
+	const std::vector< double >& y = samples.latitude;
+	const std::vector< double >& x = samples.longitude;
+
+	std::vector< uint32_t > kept;
+	kept.reserve(maxPoints);
+	kept.push_back(0);
+
+	double bucketSize = (double)(n - 2) / (maxPoints - 2);
+	uint32_t a = 0;
+	for (uint32_t bucket = 0; bucket < maxPoints - 2; bucket++)
+	{
+		// Average of the next bucket, the last sample for the last bucket
+		uint32_t nextStart = (uint32_t)((bucket + 1) * bucketSize) + 1;
+		uint32_t nextEnd = (uint32_t)((bucket + 2) * bucketSize) + 1;
+		if( nextEnd > n )
+		{
+			nextEnd = n;
+		}
+		double averageX = 0;
+		double averageY = 0;
+		for (uint32_t i = nextStart; i < nextEnd; i++)
+		{
+			averageX += x[i];
+			averageY += y[i];
+		}
+		averageX = averageX * scale / (nextEnd - nextStart);
+		averageY /= (nextEnd - nextStart);
+
+		uint32_t start = (uint32_t)(bucket * bucketSize) + 1;
+		uint32_t end = (uint32_t)((bucket + 1) * bucketSize) + 1;
+		double ax = x[a] * scale;
+		double ay = y[a];
+		double maxArea = -1;
+		for (uint32_t i = start; i < end; i++)
+		{
+			double area = fabs((ax - averageX) * (y[i] - ay) - (ax - x[i] * scale) * (averageY - ay));
+			if( area > maxArea )
+			{
+				maxArea = area;
+				a = i;
+			}
+		}
+		kept.push_back(a);
+	}
+	kept.push_back(n - 1);
+
+	// Indexes only grow, samples are moved toward the front
+	for (uint32_t i = 0; i < kept.size(); i++)
+	{
+		samples.timestamp[i] = samples.timestamp[kept[i]];
+		samples.latitude[i] = samples.latitude[kept[i]];
+		samples.longitude[i] = samples.longitude[kept[i]];
+		samples.heading[i] = samples.heading[kept[i]];
+		samples.speed[i] = samples.speed[kept[i]];
+	}
+	samples.timestamp.resize(kept.size());
+	samples.latitude.resize(kept.size());
+	samples.longitude.resize(kept.size());
+	samples.heading.resize(kept.size());
+	samples.speed.resize(kept.size());
+}
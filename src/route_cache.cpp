@@ -0,0 +1,394 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "route_cache.h"
+#include "genivi/genivi-navicore-constants.h"
+#include <stdio.h>
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  geniviRequest Used to fetch the data of the routes
+ */
+RouteCache::RouteCache( GeniviRequest* geniviRequest )
+	: geniviRequest_(geniviRequest), generation_(0), useCount_(0), guidedRoute_(0)
+{
+}
+
+/**
+ *  @brief      Entry of a route, created if needed, mutex_ must be locked
+ *  @param[in]  routeHandle Route handle
+ *  @return     Entry of the route
+ */
+RouteCache::RouteData& RouteCache::Lookup( uint32_t routeHandle )
+{
+	std::map< uint32_t, RouteData >::iterator it = routes_.find(routeHandle);
+	if( it == routes_.end() )
+	{
+		// Make room by dropping the least recently used route
+		if( routes_.size() >= ROUTE_CACHE_MAX_ROUTES )
+		{
+			std::map< uint32_t, RouteData >::iterator oldest = routes_.begin();
+			for (it = routes_.begin(); it != routes_.end(); ++it)
+			{
+				if( it->second.lastUse < oldest->second.lastUse )
+				{
+					oldest = it;
+				}
+			}
+			routes_.erase(oldest);
+		}
+
+		it = routes_.insert(std::make_pair(routeHandle, RouteData())).first;
+		it->second.generation = ++generation_;
+	}
+
+	it->second.lastUse = ++useCount_;
+	return it->second;
+}
+
+/**
+ *  @brief      Take the cached value of a route, or wait for its fetch
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  member Kind of data
+ *  @param[in]  callback Called with the value once fetched
+ *  @param[out] value Cached value, NULL if the caller waits
+ *  @param[out] waiters Requests waiting for the fetch to start, NULL if a fetch is already in progress
+ *  @param[out] generation Entry the fetch to start belongs to
+ *  @return     true if the caller must start the fetch
+ */
+template< class T >
+bool RouteCache::Join( uint32_t routeHandle, Slot< T > RouteData::*member, const typename Slot< T >::Callback& callback,
+					   std::shared_ptr< const T >& value, std::shared_ptr< typename Slot< T >::Waiters >& waiters, uint32_t& generation )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	RouteData& route = Lookup(routeHandle);
+	Slot< T >& slot = route.*member;
+	if( slot.value )
+	{
+		value = slot.value;
+		return false;
+	}
+
+	bool isFirst = !slot.waiters;
+	if( isFirst )
+	{
+		slot.waiters.reset(new typename Slot< T >::Waiters());
+	}
+	slot.waiters->push_back(callback);
+
+	waiters = slot.waiters;
+	generation = route.generation;
+	return isFirst;
+}
+
+/**
+ *  @brief      End of a fetch : keep the value if the route was not dropped meanwhile, then answer the requests
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  generation Entry the fetch belongs to
+ *  @param[in]  member Kind of data
+ *  @param[in]  waiters Requests waiting for this fetch
+ *  @param[in]  isSuccess Success or failure of the fetch
+ *  @param[in]  value Value fetched
+ */
+template< class T >
+void RouteCache::Store( uint32_t routeHandle, uint32_t generation, Slot< T > RouteData::*member,
+						const std::shared_ptr< typename Slot< T >::Waiters >& waiters, bool isSuccess, const T& value )
+{
+	typename Slot< T >::Waiters callbacks;
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+
+		std::map< uint32_t, RouteData >::iterator it = routes_.find(routeHandle);
+		if( it != routes_.end() && it->second.generation == generation && (it->second.*member).waiters == waiters )
+		{
+			Slot< T >& slot = it->second.*member;
+			if( isSuccess )
+			{
+				slot.value.reset(new T(value));
+			}
+			slot.waiters.reset();
+		}
+
+		// No request can join the list once the fetch has ended
+		callbacks.swap(*waiters);
+	}
+
+	for (size_t i = 0; i < callbacks.size(); i++)
+	{
+		callbacks[i]( isSuccess, value );
+	}
+}
+
+/**
+ *  @brief      Segments of a route
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  callback Called with every segment of the route
+ */
+void RouteCache::GetSegments( uint32_t routeHandle, SegmentsCallback callback )
+{
+	std::shared_ptr< const std::vector< RouteSegment > > value;
+	std::shared_ptr< Slot< std::vector< RouteSegment > >::Waiters > waiters;
+	uint32_t generation = 0;
+	if( Join( routeHandle, &RouteData::segments, callback, value, waiters, generation ) )
+	{
+		FetchSegments( routeHandle, generation, waiters, std::make_shared< std::vector< RouteSegment > >() );
+	}
+	else if( value )
+	{
+		callback( true, *value );
+	}
+}
+
+/**
+ *  @brief      Fetch the segments of a route, one page after the other
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  generation Entry the fetch belongs to
+ *  @param[in]  waiters Requests waiting for this fetch
+ *  @param[in]  segments Segments already fetched
+ */
+void RouteCache::FetchSegments( uint32_t routeHandle, uint32_t generation, std::shared_ptr< Slot< std::vector< RouteSegment > >::Waiters > waiters,
+								std::shared_ptr< std::vector< RouteSegment > > segments )
+{
+	uint32_t offset = segments->size();
+	geniviRequest_->NavicoreGetRouteSegmentsAsync( routeHandle, ROUTE_CACHE_SEGMENTS_PAGE, offset,
+		[this, routeHandle, generation, waiters, segments]( bool isSuccess, uint32_t total, std::vector< RouteSegment >& page )
+	{
+		if( isSuccess )
+		{
+			segments->insert(segments->end(), page.begin(), page.end());
+			if( !page.empty() && segments->size() < total )
+			{
+				FetchSegments( routeHandle, generation, waiters, segments );
+				return;
+			}
+		}
+		Store( routeHandle, generation, &RouteData::segments, waiters, isSuccess, *segments );
+	});
+}
+
+/**
+ *  @brief      Bounding box of a route
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  callback Called with the rectangle enclosing the route
+ */
+void RouteCache::GetBoundingBox( uint32_t routeHandle, BoundingBoxCallback callback )
+{
+	std::shared_ptr< const RouteBoundingBox > value;
+	std::shared_ptr< Slot< RouteBoundingBox >::Waiters > waiters;
+	uint32_t generation = 0;
+	if( Join( routeHandle, &RouteData::boundingBox, callback, value, waiters, generation ) )
+	{
+		geniviRequest_->NavicoreGetRouteBoundingBoxAsync( routeHandle,
+			[this, routeHandle, generation, waiters]( bool isSuccess, RouteBoundingBox& boundingBox )
+		{
+			Store( routeHandle, generation, &RouteData::boundingBox, waiters, isSuccess, boundingBox );
+		});
+	}
+	else if( value )
+	{
+		callback( true, *value );
+	}
+}
+
+/**
+ *  @brief      Waypoints of a route
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  callback Called with the waypoints of the route
+ */
+void RouteCache::GetWaypoints( uint32_t routeHandle, WaypointsCallback callback )
+{
+	std::shared_ptr< const RouteWaypoints > value;
+	std::shared_ptr< Slot< RouteWaypoints >::Waiters > waiters;
+	uint32_t generation = 0;
+	if( Join( routeHandle, &RouteData::waypoints, callback, value, waiters, generation ) )
+	{
+		geniviRequest_->NavicoreGetWaypointsAsync( routeHandle,
+			[this, routeHandle, generation, waiters]( bool isSuccess, bool startFromCurrentPosition, std::vector< Waypoint >& waypointsList )
+		{
+			RouteWaypoints waypoints;
+			waypoints.startFromCurrentPosition = startFromCurrentPosition;
+			waypoints.waypoints.swap(waypointsList);
+			Store( routeHandle, generation, &RouteData::waypoints, waiters, isSuccess, waypoints );
+		});
+	}
+	else if( value )
+	{
+		callback( true, *value );
+	}
+}
+
+/**
+ *  @brief      Maneuvers of the route under guidance
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  callback Called with the maneuvers of the route, fails if it is not under guidance
+ */
+void RouteCache::GetManeuvers( uint32_t routeHandle, ManeuversCallback callback )
+{
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		if( routeHandle == 0 || routeHandle != guidedRoute_ )
+		{
+			std::vector< RouteManeuver > none;
+			callback( false, none );
+			return;
+		}
+	}
+
+	std::shared_ptr< const std::vector< RouteManeuver > > value;
+	std::shared_ptr< Slot< std::vector< RouteManeuver > >::Waiters > waiters;
+	uint32_t generation = 0;
+	if( Join( routeHandle, &RouteData::maneuvers, callback, value, waiters, generation ) )
+	{
+		FetchManeuvers( routeHandle, generation, waiters, std::make_shared< std::vector< RouteManeuver > >(), 0 );
+	}
+	else if( value )
+	{
+		callback( true, *value );
+	}
+}
+
+/**
+ *  @brief      Fetch the maneuvers of the route under guidance, one page of roads after the other
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  generation Entry the fetch belongs to
+ *  @param[in]  waiters Requests waiting for this fetch
+ *  @param[in]  maneuvers Maneuvers already fetched
+ *  @param[in]  offset Roads already fetched
+ */
+void RouteCache::FetchManeuvers( uint32_t routeHandle, uint32_t generation, std::shared_ptr< Slot< std::vector< RouteManeuver > >::Waiters > waiters,
+								 std::shared_ptr< std::vector< RouteManeuver > > maneuvers, uint32_t offset )
+{
+	geniviRequest_->NavicoreGetManeuversListAsync( ROUTE_CACHE_MANEUVERS_PAGE, offset,
+		[this, routeHandle, generation, waiters, maneuvers, offset]( bool isSuccess, uint32_t numberOfManeuvers, std::vector< RouteManeuver >& page )
+	{
+		if( isSuccess )
+		{
+			maneuvers->insert(maneuvers->end(), page.begin(), page.end());
+			if( numberOfManeuvers >= ROUTE_CACHE_MANEUVERS_PAGE )
+			{
+				FetchManeuvers( routeHandle, generation, waiters, maneuvers, offset + numberOfManeuvers );
+				return;
+			}
+		}
+		Store( routeHandle, generation, &RouteData::maneuvers, waiters, isSuccess, *maneuvers );
+	});
+}
+
+/**
+ *  @brief      Drop the maneuvers of a route, a fetch in progress is not kept, mutex_ must be locked
+ *  @param[in]  routeHandle Route handle
+ */
+void RouteCache::DropManeuvers( uint32_t routeHandle )
+{
+	std::map< uint32_t, RouteData >::iterator it = routes_.find(routeHandle);
+	if( it != routes_.end() )
+	{
+		it->second.maneuvers.value.reset();
+		it->second.maneuvers.waiters.reset();
+	}
+}
+
+/**
+ *  @brief      Fetch every data of a route before it is asked for
+ *  @param[in]  routeHandle Route handle
+ */
+void RouteCache::Prefetch( uint32_t routeHandle )
+{
+	GetSegments( routeHandle, []( bool isSuccess, const std::vector< RouteSegment >& segments ) {} );
+	GetBoundingBox( routeHandle, []( bool isSuccess, const RouteBoundingBox& boundingBox ) {} );
+	GetWaypoints( routeHandle, []( bool isSuccess, const RouteWaypoints& waypoints ) {} );
+}
+
+/**
+ *  @brief      Drop the data of a route
+ *  @param[in]  routeHandle Route handle
+ */
+void RouteCache::Invalidate( uint32_t routeHandle )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+	routes_.erase(routeHandle);
+}
+
+/**
+ *  @brief  Drop the data of every route
+ */
+void RouteCache::Clear()
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+	routes_.clear();
+}
+
+/**
+ *  @brief      Route handles are not kept across a restart of Genivi
+ *  @param[in]  isAvailable true if Genivi is available again
+ */
+void RouteCache::OnServiceStatusChanged( bool isAvailable )
+{
+	Clear();
+}
+
+void RouteCache::OnRouteDeleted( uint32_t routeHandle )
+{
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		if( guidedRoute_ == routeHandle )
+		{
+			guidedRoute_ = 0;
+		}
+	}
+	Invalidate( routeHandle );
+}
+
+void RouteCache::OnRouteCalculationCancelled( uint32_t routeHandle )
+{
+	Invalidate( routeHandle );
+}
+
+/**
+ *  @brief      New route calculated : drop the previous one, then fetch it before the clients ask for it
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  unfullfilledPreferences Preferences the route does not satisfy (unused)
+ */
+void RouteCache::OnRouteCalculationSuccessful( uint32_t routeHandle, const std::map< int32_t, int32_t >& unfullfilledPreferences )
+{
+	Invalidate( routeHandle );
+	Prefetch( routeHandle );
+}
+
+void RouteCache::OnRouteCalculationFailed( uint32_t routeHandle, int32_t errorCode, const std::map< int32_t, int32_t >& unfullfilledPreferences )
+{
+	Invalidate( routeHandle );
+}
+
+/**
+ *  @brief      Guidance started, stopped or moved to another route : its maneuvers are fetched again
+ *  @param[in]  guidanceStatus NAVICORE_ACTIVE or NAVICORE_INACTIVE
+ *  @param[in]  routeHandle Route under guidance
+ */
+void RouteCache::OnGuidanceStatusChanged( int32_t guidanceStatus, uint32_t routeHandle )
+{
+	uint32_t guided = (guidanceStatus == NAVICORE_ACTIVE) ? routeHandle : 0;
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+
+		// Maneuvers fetched while another route was under guidance are not the ones of this route
+		DropManeuvers( guidedRoute_ );
+		DropManeuvers( guided );
+		guidedRoute_ = guided;
+	}
+
+	if( guided != 0 )
+	{
+		GetManeuvers( guided, []( bool isSuccess, const std::vector< RouteManeuver >& maneuvers ) {} );
+	}
+}
+
+/**
+ *  @brief      The active route was replaced (traffic, off route...), which route is not told
+ *  @param[in]  changeCause Cause of the change (unused)
+ */
+void RouteCache::OnActiveRouteChanged( int32_t changeCause )
+{
+	Clear();
+}
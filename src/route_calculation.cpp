@@ -0,0 +1,276 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "route_calculation.h"
+#include "sd_event_queue.h"
+#include "binder_time.h"
+#include <stdio.h>
+#include <vector>
+#include <systemd/sd-event.h>
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  geniviRequest Used to start the calculations
+ *  @param[in]  loopQueue Runs the changes of the timer in the event loop
+ */
+RouteCalculation::RouteCalculation( GeniviRequest* geniviRequest, SdEventQueue* loopQueue )
+	: geniviRequest_(geniviRequest), loopQueue_(loopQueue), timer_(NULL), waiterCount_(0)
+{
+}
+
+/**
+ *  @brief Destructor
+ */
+RouteCalculation::~RouteCalculation()
+{
+	sd_event_source_unref(timer_);
+}
+
+/**
+ *  @brief      Create the timer of the waiters
+ *  @param[in]  loop Event loop of the binder
+ *  @return     false if the timer cannot be added to the loop
+ */
+bool RouteCalculation::Start( sd_event* loop )
+{
+	if( sd_event_add_time(loop, &timer_, CLOCK_MONOTONIC, 0, 1000, RouteCalculation::OnTimer, this) < 0 )
+	{
+		fprintf(stderr, "Error:cannot add route calculation timer\n");
+		timer_ = NULL;
+		return false;
+	}
+
+	sd_event_source_set_enabled(timer_, SD_EVENT_OFF);
+	return true;
+}
+
+/**
+ *  @brief      Call GeniviAPI CalculateRoute, then wait for the end of the calculation
+ *  @param[in]  sessionHandle Session handle
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  timeout Time to wait for the end of the calculation in msec
+ *  @param[in]  callback Called once with the end of the calculation
+ */
+void RouteCalculation::Calculate( uint32_t sessionHandle, uint32_t routeHandle, uint32_t timeout, CompletionCallback callback )
+{
+	uint32_t id;
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+
+		Waiter waiter;
+		waiter.id = id = waiterCount_++;
+		waiter.routeHandle = routeHandle;
+		waiter.deadline = GetTimeUsec() + (uint64_t)timeout * 1000;
+		waiter.callback = callback;
+		waiters_.push_back(waiter);
+	}
+
+	// Called from a worker thread, the timer is a source of the loop
+	loopQueue_->Post( [this]() { ArmTimerLocked(); } );
+
+	geniviRequest_->NavicoreCalculateRouteAsync( sessionHandle, routeHandle, [this, id]( bool isSuccess )
+	{
+		if( !isSuccess )
+		{
+			CompleteWaiter( id, ROUTE_CALCULATION_ERROR );
+		}
+	});
+}
+
+/**
+ *  @brief      Calculations in progress are lost with Genivi
+ *  @param[in]  isAvailable true if Genivi is available again
+ */
+void RouteCalculation::OnServiceStatusChanged( bool isAvailable )
+{
+	if( isAvailable )
+	{
+		return;
+	}
+
+	std::list< Waiter > waiters;
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		waiters.swap(waiters_);
+		ArmTimer();
+	}
+
+	std::map< int32_t, int32_t > none;
+	std::list< Waiter >::iterator it;
+	for (it = waiters.begin(); it != waiters.end(); ++it)
+	{
+		it->callback( ROUTE_CALCULATION_ERROR, 0, none );
+	}
+}
+
+void RouteCalculation::OnRouteDeleted( uint32_t routeHandle )
+{
+	std::map< int32_t, int32_t > none;
+	Complete( routeHandle, ROUTE_CALCULATION_CANCELLED, 0, none );
+}
+
+void RouteCalculation::OnRouteCalculationCancelled( uint32_t routeHandle )
+{
+	std::map< int32_t, int32_t > none;
+	Complete( routeHandle, ROUTE_CALCULATION_CANCELLED, 0, none );
+}
+
+void RouteCalculation::OnRouteCalculationSuccessful( uint32_t routeHandle, const std::map< int32_t, int32_t >& unfullfilledPreferences )
+{
+	Complete( routeHandle, ROUTE_CALCULATION_SUCCESSFUL, 0, unfullfilledPreferences );
+}
+
+void RouteCalculation::OnRouteCalculationFailed( uint32_t routeHandle, int32_t errorCode, const std::map< int32_t, int32_t >& unfullfilledPreferences )
+{
+	Complete( routeHandle, ROUTE_CALCULATION_FAILED, errorCode, unfullfilledPreferences );
+}
+
+/**
+ *  @brief      Complete every waiter of a route
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  result End of the calculation
+ *  @param[in]  errorCode Error of a failed calculation
+ *  @param[in]  unfullfilledPreferences Preferences the route does not satisfy
+ */
+void RouteCalculation::Complete( uint32_t routeHandle, RouteCalculationResult result, int32_t errorCode,
+								 const std::map< int32_t, int32_t >& unfullfilledPreferences )
+{
+	std::vector< CompletionCallback > callbacks;
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+
+		std::list< Waiter >::iterator it = waiters_.begin();
+		while( it != waiters_.end() )
+		{
+			if( it->routeHandle == routeHandle )
+			{
+				callbacks.push_back(it->callback);
+				it = waiters_.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		if( callbacks.empty() )
+		{
+			return;
+		}
+		ArmTimer();
+	}
+
+	// Replied outside the lock, a callback may start another calculation
+	for (size_t i = 0; i < callbacks.size(); i++)
+	{
+		callbacks[i]( result, errorCode, unfullfilledPreferences );
+	}
+}
+
+/**
+ *  @brief      Complete one waiter, if it is still waiting
+ *  @param[in]  id Waiter
+ *  @param[in]  result End of the wait
+ */
+void RouteCalculation::CompleteWaiter( uint32_t id, RouteCalculationResult result )
+{
+	CompletionCallback callback;
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+
+		std::list< Waiter >::iterator it;
+		for (it = waiters_.begin(); it != waiters_.end(); ++it)
+		{
+			if( it->id == id )
+			{
+				break;
+			}
+		}
+
+		if( it == waiters_.end() )
+		{
+			return;
+		}
+		callback = it->callback;
+		waiters_.erase(it);
+		ArmTimer();
+	}
+
+	std::map< int32_t, int32_t > none;
+	callback( result, 0, none );
+}
+
+/**
+ *  @brief  Expire at the earliest deadline, from the event loop
+ */
+void RouteCalculation::ArmTimerLocked()
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+	ArmTimer();
+}
+
+/**
+ *  @brief  Expire at the earliest deadline, mutex_ must be locked, from the event loop
+ */
+void RouteCalculation::ArmTimer()
+{
+	if( timer_ == NULL )
+	{
+		return;
+	}
+
+	if( waiters_.empty() )
+	{
+		sd_event_source_set_enabled(timer_, SD_EVENT_OFF);
+		return;
+	}
+
+	uint64_t deadline = waiters_.front().deadline;
+	std::list< Waiter >::iterator it;
+	for (it = waiters_.begin(); it != waiters_.end(); ++it)
+	{
+		if( it->deadline < deadline )
+		{
+			deadline = it->deadline;
+		}
+	}
+
+	sd_event_source_set_time(timer_, deadline);
+	sd_event_source_set_enabled(timer_, SD_EVENT_ONESHOT);
+}
+
+/**
+ *  @brief  Deadline of a waiter reached, complete the waiters out of time
+ */
+int RouteCalculation::OnTimer( sd_event_source* source, uint64_t usec, void* userdata )
+{
+	RouteCalculation* calculation = (RouteCalculation*)userdata;
+
+	std::vector< CompletionCallback > callbacks;
+	{
+		std::lock_guard< std::mutex > lock( calculation->mutex_ );
+
+		uint64_t now = GetTimeUsec();
+		std::list< Waiter >::iterator it = calculation->waiters_.begin();
+		while( it != calculation->waiters_.end() )
+		{
+			if( it->deadline <= now )
+			{
+				callbacks.push_back(it->callback);
+				it = calculation->waiters_.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		calculation->ArmTimer();
+	}
+
+	std::map< int32_t, int32_t > none;
+	for (size_t i = 0; i < callbacks.size(); i++)
+	{
+		callbacks[i]( ROUTE_CALCULATION_TIMEOUT, 0, none );
+	}
+	return 0;
+}
@@ -0,0 +1,231 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "route_corridor.h"
+#include "navi_geo.h"
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+
+/**
+ *  @brief  Constructor
+ */
+RouteCorridor::RouteCorridor()
+	: latitude0_(0), longitude0_(0), scale_(0)
+{
+}
+
+/**
+ *  @brief      Index the segments of a route, replacing the previous ones
+ *  @param[in]  segments Segments of the route (empty : no route)
+ */
+void RouteCorridor::Build( const std::vector< RouteSegment >& segments )
+{
+	size_t count = segments.size();
+	x0_.resize(count);
+	y0_.resize(count);
+	x1_.resize(count);
+	y1_.resize(count);
+	cells_.clear();
+	if( count == 0 )
+	{
+		return;
+	}
+
+	// Plane tangent at the middle of the route
+	double minLatitude = segments[0].startLatitude;
+	double maxLatitude = segments[0].startLatitude;
+	for (size_t i = 0; i < count; i++)
+	{
+		minLatitude = std::min(minLatitude, std::min(segments[i].startLatitude, segments[i].endLatitude));
+		maxLatitude = std::max(maxLatitude, std::max(segments[i].startLatitude, segments[i].endLatitude));
+	}
+	latitude0_ = (minLatitude + maxLatitude) / 2;
+	longitude0_ = segments[0].startLongitude;
+	scale_ = NAVI_DEG_TO_RAD * NAVI_EARTH_RADIUS * cos(latitude0_ * NAVI_DEG_TO_RAD);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		x0_[i] = (segments[i].startLongitude - longitude0_) * scale_;
+		y0_[i] = (segments[i].startLatitude - latitude0_) * NAVI_DEG_TO_RAD * NAVI_EARTH_RADIUS;
+		x1_[i] = (segments[i].endLongitude - longitude0_) * scale_;
+		y1_[i] = (segments[i].endLatitude - latitude0_) * NAVI_DEG_TO_RAD * NAVI_EARTH_RADIUS;
+
+		Index( i );
+	}
+}
+
+/**
+ *  @brief      List a segment in the cells it crosses, and the cells around them.
+ *
+ *  A point within one cell of the segment is one cell away at most from a
+ *  cell the segment crosses, so every segment within one cell of a point
+ *  is in its cell. The cells crossed are walked along the segment, so a
+ *  long diagonal segment is listed in O(length) cells, not in its whole
+ *  bounding box.
+ *
+ *  @param[in]  segment Segment index, projected on the plane
+ */
+void RouteCorridor::Index( uint32_t segment )
+{
+	double x0 = x0_[segment];
+	double y0 = y0_[segment];
+	double dx = x1_[segment] - x0;
+	double dy = y1_[segment] - y0;
+
+	int32_t row = Cell(y0);
+	int32_t column = Cell(x0);
+	int32_t rowSteps = abs(Cell(y1_[segment]) - row);
+	int32_t columnSteps = abs(Cell(x1_[segment]) - column);
+	int32_t rowStep = (dy > 0) ? 1 : -1;
+	int32_t columnStep = (dx > 0) ? 1 : -1;
+
+	// Fraction of the segment where it enters the next row and the next column
+	double rowNext = (dy != 0) ? ((row + (dy > 0)) * ROUTE_CORRIDOR_CELL_SIZE - y0) / dy : INFINITY;
+	double columnNext = (dx != 0) ? ((column + (dx > 0)) * ROUTE_CORRIDOR_CELL_SIZE - x0) / dx : INFINITY;
+	double rowDelta = (dy != 0) ? ROUTE_CORRIDOR_CELL_SIZE / fabs(dy) : INFINITY;
+	double columnDelta = (dx != 0) ? ROUTE_CORRIDOR_CELL_SIZE / fabs(dx) : INFINITY;
+
+	std::vector< uint64_t > keys;
+	while( true )
+	{
+		for (int32_t r = row - 1; r <= row + 1; r++)
+		{
+			for (int32_t c = column - 1; c <= column + 1; c++)
+			{
+				keys.push_back(CellKey(r, c));
+			}
+		}
+
+		// Exactly one step per row and column crossed, whatever the rounding
+		if( rowSteps == 0 && columnSteps == 0 )
+		{
+			break;
+		}
+		if( columnSteps == 0 || (rowSteps != 0 && rowNext < columnNext) )
+		{
+			row += rowStep;
+			rowNext += rowDelta;
+			rowSteps--;
+		}
+		else
+		{
+			column += columnStep;
+			columnNext += columnDelta;
+			columnSteps--;
+		}
+	}
+
+	// The cells around two crossed cells overlap
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		cells_[keys[i]].push_back(segment);
+	}
+}
+
+/**
+ *  @brief      Whether a route is indexed
+ */
+bool RouteCorridor::IsEmpty() const
+{
+	return x0_.empty();
+}
+
+/**
+ *  @brief      Distance from a position to the route
+ *  @param[in]  latitude Latitude of the position
+ *  @param[in]  longitude Longitude of the position
+ *  @param[out] bearing Direction of the nearest segment, degree clockwise from north
+ *  @return     Distance in m, the route must not be empty
+ */
+double RouteCorridor::Distance( double latitude, double longitude, double& bearing ) const
+{
+	double x = (longitude - longitude0_) * scale_;
+	double y = (latitude - latitude0_) * NAVI_DEG_TO_RAD * NAVI_EARTH_RADIUS;
+
+	uint32_t nearest = 0;
+	double nearestDistance = -1;
+	std::map< uint64_t, std::vector< uint32_t > >::const_iterator cell = cells_.find(CellKey(Cell(y), Cell(x)));
+	if( cell != cells_.end() )
+	{
+		for (size_t i = 0; i < cell->second.size(); i++)
+		{
+			double distance = SegmentDistance(cell->second[i], x, y);
+			if( nearestDistance < 0 || distance < nearestDistance )
+			{
+				nearest = cell->second[i];
+				nearestDistance = distance;
+			}
+		}
+	}
+
+	// Off the corridor, a segment of another cell may be nearer
+	if( nearestDistance < 0 || nearestDistance > ROUTE_CORRIDOR_CELL_SIZE )
+	{
+		for (uint32_t i = 0; i < x0_.size(); i++)
+		{
+			double distance = SegmentDistance(i, x, y);
+			if( nearestDistance < 0 || distance < nearestDistance )
+			{
+				nearest = i;
+				nearestDistance = distance;
+			}
+		}
+	}
+
+	bearing = atan2(x1_[nearest] - x0_[nearest], y1_[nearest] - y0_[nearest]) / NAVI_DEG_TO_RAD;
+	if( bearing < 0 )
+	{
+		bearing += 360.0;
+	}
+	return nearestDistance;
+}
+
+/**
+ *  @brief      Row or column of the grid
+ *  @param[in]  meter Coordinate on the plane
+ *  @return     Cell index on the axis
+ */
+int32_t RouteCorridor::Cell( double meter )
+{
+	return (int32_t)floor(meter / ROUTE_CORRIDOR_CELL_SIZE);
+}
+
+/**
+ *  @brief      Key of a cell in cells_
+ *  @param[in]  row Index on the north axis
+ *  @param[in]  column Index on the east axis
+ *  @return     Key
+ */
+uint64_t RouteCorridor::CellKey( int32_t row, int32_t column )
+{
+	return ((uint64_t)(uint32_t)row << 32) | (uint32_t)column;
+}
+
+/**
+ *  @brief      Distance from a point to a segment on the plane
+ *  @param[in]  segment Segment index
+ *  @param[in]  x East coordinate of the point in m
+ *  @param[in]  y North coordinate of the point in m
+ *  @return     Distance in m
+ */
+double RouteCorridor::SegmentDistance( uint32_t segment, double x, double y ) const
+{
+	double dx = x1_[segment] - x0_[segment];
+	double dy = y1_[segment] - y0_[segment];
+	double length = dx * dx + dy * dy;
+
+	// Projection of the point clamped to the segment
+	double t = 0;
+	if( length > 0 )
+	{
+		t = ((x - x0_[segment]) * dx + (y - y0_[segment]) * dy) / length;
+		t = std::max(0.0, std::min(1.0, t));
+	}
+
+	double ex = x0_[segment] + t * dx - x;
+	double ey = y0_[segment] + t * dy - y;
+	return sqrt(ex * ex + ey * ey);
+}
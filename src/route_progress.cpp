@@ -0,0 +1,476 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "genivi/genivi-navicore-constants.h"
+#include "route_progress.h"
+#include "binder_reply.h"
+#include "binder_time.h"
+#include "navi_geo.h"
+#include <memory>
+#include <algorithm>
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  routeCache Segments and waypoints of the routes
+ *  @param[in]  binderReply Used to convert the progress to json format
+ */
+RouteProgress::RouteProgress( RouteCache* routeCache, BinderReply* binderReply )
+	: routeCache_(routeCache), binderReply_(binderReply), route_(0), offset_(0), generation_(0),
+	  isLoaded_(false), isLoading_(false), pushTime_(0), isEventValid_(false)
+{
+}
+
+/**
+ *  @brief      Progress along a route
+ *  @param[in]  routeHandle Route (0 : the tracked route), another route is computed from its start
+ *  @param[in]  callback Called with the progress
+ */
+void RouteProgress::Get( uint32_t routeHandle, const ProgressCallback& callback )
+{
+	if( routeHandle != 0 )
+	{
+		bool isTracked;
+		{
+			std::lock_guard< std::mutex > lock( mutex_ );
+			isTracked = (route_ == routeHandle);
+		}
+		if( !isTracked )
+		{
+			// The offsets notified by Genivi belong to the tracked route only
+			GetUntracked( routeHandle, callback );
+			return;
+		}
+	}
+
+	RouteProgressInfo progress = {0};
+	bool isWaiting = false;
+	bool isLoad = false;
+	uint32_t generation = 0;
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		if( route_ != 0 && isLoaded_ )
+		{
+			progress = Compute();
+		}
+		else if( route_ != 0 )
+		{
+			// Answered by the load in progress, or by a new one if the last load failed
+			waiters_.push_back( callback );
+			isWaiting = true;
+			isLoad = !isLoading_;
+			isLoading_ = true;
+			routeHandle = route_;
+			generation = generation_;
+		}
+	}
+
+	if( isLoad )
+	{
+		Load( routeHandle, generation );
+	}
+	if( !isWaiting )
+	{
+		callback( progress.route != 0, progress );
+	}
+}
+
+/**
+ *  @brief      Subscribe the client to routeprogress event
+ *  @param[in]  req Request from client
+ *  @return     Success or failure of processing
+ */
+bool RouteProgress::Subscribe( afb_req req )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	if( !isEventValid_ )
+	{
+		event_ = afb_daemon_make_event("routeprogress");
+		if( !afb_event_is_valid(event_) )
+		{
+			return false;
+		}
+		isEventValid_ = true;
+	}
+
+	if( afb_req_subscribe(req, event_) < 0 )
+	{
+		return false;
+	}
+
+	// Initial values of the new subscriber
+	if( isLoaded_ )
+	{
+		Push();
+	}
+	return true;
+}
+
+/**
+ *  @brief      Unsubscribe the client from routeprogress event
+ *  @param[in]  req Request from client
+ */
+void RouteProgress::Unsubscribe( afb_req req )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	if( isEventValid_ )
+	{
+		afb_req_unsubscribe(req, event_);
+	}
+}
+
+/**
+ *  @brief      Add a receiver of the route segments, at service startup
+ *  @param[in]  listener Receiver of the route segments
+ */
+void RouteProgress::AddListener( RouteProgressListener* listener )
+{
+	listeners_.push_back(listener);
+}
+
+/**
+ *  @brief      Route handles are not kept across a restart of Genivi
+ *  @param[in]  isAvailable true if Genivi is available again
+ */
+void RouteProgress::OnServiceStatusChanged( bool isAvailable )
+{
+	Track( 0 );
+}
+
+void RouteProgress::OnRouteDeleted( uint32_t routeHandle )
+{
+	std::unique_lock< std::mutex > lock( mutex_ );
+	if( routeHandle == route_ )
+	{
+		lock.unlock();
+		Track( 0 );
+	}
+}
+
+/**
+ *  @brief      Tracked route calculated again : its segments changed
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  unfullfilledPreferences Preferences the route does not satisfy (unused)
+ */
+void RouteProgress::OnRouteCalculationSuccessful( uint32_t routeHandle, const std::map< int32_t, int32_t >& unfullfilledPreferences )
+{
+	std::unique_lock< std::mutex > lock( mutex_ );
+	if( routeHandle == route_ )
+	{
+		lock.unlock();
+		Track( routeHandle );
+	}
+}
+
+/**
+ *  @brief      Guidance started on a route, or stopped
+ *  @param[in]  guidanceStatus NAVICORE_ACTIVE or NAVICORE_INACTIVE
+ *  @param[in]  routeHandle Route under guidance
+ */
+void RouteProgress::OnGuidanceStatusChanged( int32_t guidanceStatus, uint32_t routeHandle )
+{
+	uint32_t tracked = (guidanceStatus == NAVICORE_ACTIVE) ? routeHandle : 0;
+
+	std::unique_lock< std::mutex > lock( mutex_ );
+	if( tracked != route_ )
+	{
+		lock.unlock();
+		Track( tracked );
+	}
+}
+
+/**
+ *  @brief      New offset of the vehicle, pushed to the subscribers at a low rate
+ *  @param[in]  offsetOnRoute m from the start of the route
+ */
+void RouteProgress::OnPositionOnRouteChanged( uint32_t offsetOnRoute )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	offset_ = offsetOnRoute;
+	if( isLoaded_ && GetTimeMsec() - pushTime_ >= ROUTE_PROGRESS_EVENT_INTERVAL )
+	{
+		Push();
+	}
+}
+
+/**
+ *  @brief      The active route was replaced (traffic, off route...) : its segments changed
+ *  @param[in]  changeCause Cause of the change (unused)
+ */
+void RouteProgress::OnActiveRouteChanged( int32_t changeCause )
+{
+	std::unique_lock< std::mutex > lock( mutex_ );
+	uint32_t routeHandle = route_;
+	lock.unlock();
+
+	if( routeHandle != 0 )
+	{
+		Track( routeHandle );
+	}
+}
+
+/**
+ *  @brief      Track a route from its start, and load it
+ *  @param[in]  routeHandle Route handle (0 : none)
+ */
+void RouteProgress::Track( uint32_t routeHandle )
+{
+	std::vector< ProgressCallback > callbacks;
+	uint32_t generation;
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+
+		route_ = routeHandle;
+		offset_ = 0;
+		generation = ++generation_;
+		isLoaded_ = false;
+		isLoading_ = (routeHandle != 0);
+		profile_ = Profile();
+
+		// Waiters of the previous route are answered by the load of the new one
+		if( routeHandle == 0 )
+		{
+			callbacks.swap(waiters_);
+		}
+	}
+
+	RouteProgressInfo progress = {0};
+	for (size_t i = 0; i < callbacks.size(); i++)
+	{
+		callbacks[i]( false, progress );
+	}
+
+	std::vector< RouteSegment > none;
+	for (size_t i = 0; i < listeners_.size(); i++)
+	{
+		listeners_[i]->OnRouteLoaded( routeHandle, none );
+	}
+
+	if( routeHandle != 0 )
+	{
+		Load( routeHandle, generation );
+	}
+}
+
+/**
+ *  @brief      Fetch the segments, then the waypoints of a route
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  generation Tracked route the load belongs to
+ */
+void RouteProgress::Load( uint32_t routeHandle, uint32_t generation )
+{
+	RouteCache* routeCache = routeCache_;
+	routeCache_->GetSegments( routeHandle, [this, routeCache, routeHandle, generation]( bool isSuccess, const std::vector< RouteSegment >& segments )
+	{
+		if( !isSuccess )
+		{
+			Loaded( generation, false, segments, RouteWaypoints() );
+			return;
+		}
+
+		// Kept until the waypoints are fetched
+		std::shared_ptr< std::vector< RouteSegment > > kept = std::make_shared< std::vector< RouteSegment > >( segments );
+		routeCache->GetWaypoints( routeHandle, [this, generation, kept]( bool isSuccess, const RouteWaypoints& waypoints )
+		{
+			Loaded( generation, isSuccess, *kept, waypoints );
+		});
+	});
+}
+
+/**
+ *  @brief      Build the prefix sums of a loaded route and answer the waiters
+ *  @param[in]  generation Tracked route the load belongs to
+ *  @param[in]  isSuccess Success or failure of the fetch
+ *  @param[in]  segments Segments of the route
+ *  @param[in]  waypoints Waypoints of the route
+ */
+void RouteProgress::Loaded( uint32_t generation, bool isSuccess, const std::vector< RouteSegment >& segments, const RouteWaypoints& waypoints )
+{
+	std::vector< ProgressCallback > callbacks;
+	RouteProgressInfo progress = {0};
+	uint32_t routeHandle;
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+
+		// Another route is tracked, its own load answers the waiters
+		if( generation != generation_ )
+		{
+			return;
+		}
+
+		isLoading_ = false;
+		callbacks.swap(waiters_);
+		routeHandle = route_;
+
+		if( isSuccess )
+		{
+			Build( segments, waypoints, profile_ );
+			isLoaded_ = true;
+			progress = Compute();
+			if( isEventValid_ )
+			{
+				Push();
+			}
+		}
+	}
+
+	for (size_t i = 0; i < callbacks.size(); i++)
+	{
+		callbacks[i]( isSuccess, progress );
+	}
+
+	for (size_t i = 0; i < listeners_.size() && isSuccess; i++)
+	{
+		listeners_[i]->OnRouteLoaded( routeHandle, segments );
+	}
+}
+
+/**
+ *  @brief      Progress from the start of a route which is not tracked, no state is changed
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  callback Called with the progress
+ */
+void RouteProgress::GetUntracked( uint32_t routeHandle, const ProgressCallback& callback )
+{
+	RouteCache* routeCache = routeCache_;
+	routeCache_->GetSegments( routeHandle, [routeCache, routeHandle, callback]( bool isSuccess, const std::vector< RouteSegment >& segments )
+	{
+		if( !isSuccess )
+		{
+			RouteProgressInfo progress = {0};
+			callback( false, progress );
+			return;
+		}
+
+		// Kept until the waypoints are fetched
+		std::shared_ptr< std::vector< RouteSegment > > kept = std::make_shared< std::vector< RouteSegment > >( segments );
+		routeCache->GetWaypoints( routeHandle, [routeHandle, callback, kept]( bool isSuccess, const RouteWaypoints& waypoints )
+		{
+			RouteProgressInfo progress = {0};
+			if( isSuccess )
+			{
+				Profile profile;
+				Build( *kept, waypoints, profile );
+				progress = Compute( profile, routeHandle, 0 );
+			}
+			callback( isSuccess, progress );
+		});
+	});
+}
+
+/**
+ *  @brief      Sum the segments of a route and place its waypoints on them
+ *  @param[in]  segments Segments of the route
+ *  @param[in]  waypoints Waypoints of the route
+ *  @param[out] profile Prefix sums
+ */
+void RouteProgress::Build( const std::vector< RouteSegment >& segments, const RouteWaypoints& waypoints, Profile& profile )
+{
+	size_t count = segments.size();
+	profile.distance.resize(count + 1);
+	profile.time.resize(count + 1);
+	profile.distance[0] = 0;
+	profile.time[0] = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		profile.distance[i + 1] = profile.distance[i] + segments[i].distance;
+		profile.time[i + 1] = profile.time[i] + segments[i].time;
+	}
+
+	// Each waypoint is at the nearest segment end after the previous waypoint
+	size_t from = 0;
+	profile.waypointOffset.clear();
+	for (size_t i = 0; i < waypoints.waypoints.size(); i++)
+	{
+		double latitude = std::get<0>(waypoints.waypoints[i]);
+		double longitude = std::get<1>(waypoints.waypoints[i]);
+		size_t nearest = from;
+		double nearestDistance = -1;
+		for (size_t j = from; j < count + 1 && count != 0; j++)
+		{
+			double pointLatitude = (j < count) ? segments[j].startLatitude : segments[count - 1].endLatitude;
+			double pointLongitude = (j < count) ? segments[j].startLongitude : segments[count - 1].endLongitude;
+			double distance = NaviGeoDistance(latitude, longitude, pointLatitude, pointLongitude);
+			if( nearestDistance < 0 || distance < nearestDistance )
+			{
+				nearest = j;
+				nearestDistance = distance;
+			}
+		}
+		profile.waypointOffset.push_back(profile.distance[nearest]);
+		from = nearest;
+	}
+}
+
+/**
+ *  @brief      Progress at the current offset, mutex_ must be locked and the route loaded
+ *  @return     Progress
+ */
+RouteProgressInfo RouteProgress::Compute() const
+{
+	return Compute( profile_, route_, offset_ );
+}
+
+/**
+ *  @brief      Progress at an offset of a loaded route
+ *  @param[in]  profile Prefix sums of the route
+ *  @param[in]  routeHandle Route handle
+ *  @param[in]  offset m from the start of the route
+ *  @return     Progress
+ */
+RouteProgressInfo RouteProgress::Compute( const Profile& profile, uint32_t routeHandle, uint32_t offset )
+{
+	const std::vector< double >& distance = profile.distance;
+	const std::vector< double >& time = profile.time;
+	const std::vector< double >& waypointOffset = profile.waypointOffset;
+
+	RouteProgressInfo progress;
+	progress.route = routeHandle;
+	progress.offset = offset;
+
+	double length = distance.back();
+	double position = std::min((double)offset, length);
+
+	// Segment holding the offset, the time is interpolated in it
+	size_t segment = std::upper_bound(distance.begin(), distance.end(), position) - distance.begin();
+	segment = (segment == 0) ? 0 : segment - 1;
+	double elapsed = time[segment];
+	if( segment + 1 < distance.size() && distance[segment + 1] > distance[segment] )
+	{
+		elapsed += (position - distance[segment]) / (distance[segment + 1] - distance[segment]) * (time[segment + 1] - time[segment]);
+	}
+
+	progress.remainingDistance = (uint32_t)(length - position + 0.5);
+	progress.remainingTime = (uint32_t)(time.back() - elapsed + 0.5);
+
+	std::vector< double >::const_iterator next = std::upper_bound(waypointOffset.begin(), waypointOffset.end(), position);
+	if( next == waypointOffset.end() )
+	{
+		progress.nextWaypoint = -1;
+		progress.nextWaypointDistance = 0;
+	}
+	else
+	{
+		progress.nextWaypoint = next - waypointOffset.begin();
+		progress.nextWaypointDistance = (uint32_t)(*next - position + 0.5);
+	}
+
+	return progress;
+}
+
+/**
+ *  @brief      Push the current progress to the subscribers, mutex_ must be locked and the route loaded
+ */
+void RouteProgress::Push()
+{
+	if( !isEventValid_ )
+	{
+		return;
+	}
+
+	APIResponse response = binderReply_->ReplyNavicoreGetRouteProgress( Compute() );
+	pushTime_ = GetTimeMsec();
+	afb_event_push(event_, response.json_data);
+}
@@ -0,0 +1,287 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "sd_event_dispatcher.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <dbus/dbus.h>
+#include <vector>
+#include <algorithm>
+
+/**
+ *  @brief D-Bus watch of a file descriptor
+ */
+class SdEventWatch : public DBus::Watch
+{
+public:
+	SdEventWatch( DBus::Watch::Internal* internal, SdEventDispatcher* dispatcher )
+		: DBus::Watch(internal), dispatcher_(dispatcher)
+	{
+	}
+
+	void toggle()
+	{
+		dispatcher_->UpdateIo( descriptor() );
+	}
+
+	/**
+	 *  @brief  epoll events waited for by this watch
+	 */
+	uint32_t Events() const
+	{
+		uint32_t events = 0;
+		if( enabled() )
+		{
+			events |= (flags() & DBUS_WATCH_READABLE) ? EPOLLIN : 0;
+			events |= (flags() & DBUS_WATCH_WRITABLE) ? EPOLLOUT : 0;
+		}
+		return events;
+	}
+
+private:
+	SdEventDispatcher* dispatcher_;
+};
+
+/**
+ *  @brief D-Bus timeout, armed as a one shot timer of the loop
+ */
+class SdEventTimeout : public DBus::Timeout
+{
+public:
+	SdEventTimeout( DBus::Timeout::Internal* internal, SdEventDispatcher* dispatcher )
+		: DBus::Timeout(internal), source_(NULL)
+	{
+		if( sd_event_add_time(dispatcher->Loop(), &source_, CLOCK_MONOTONIC, 0, 1000, SdEventTimeout::OnTime, this) < 0 )
+		{
+			fprintf(stderr, "Error:cannot add D-Bus timeout\n");
+			source_ = NULL;
+		}
+		toggle();
+	}
+
+	~SdEventTimeout()
+	{
+		sd_event_source_unref(source_);
+	}
+
+	void toggle()
+	{
+		if( source_ == NULL )
+		{
+			return;
+		}
+
+		if( enabled() )
+		{
+			Arm();
+		}
+		else
+		{
+			sd_event_source_set_enabled(source_, SD_EVENT_OFF);
+		}
+	}
+
+private:
+	sd_event_source* source_;
+
+	/**
+	 *  @brief  Expire one interval from now
+	 */
+	void Arm()
+	{
+		uint64_t now;
+		sd_event_now(sd_event_source_get_event(source_), CLOCK_MONOTONIC, &now);
+		sd_event_source_set_time(source_, now + (uint64_t)interval() * 1000);
+		sd_event_source_set_enabled(source_, SD_EVENT_ONESHOT);
+	}
+
+	static int OnTime( sd_event_source* source, uint64_t usec, void* userdata )
+	{
+		SdEventTimeout* timeout = (SdEventTimeout*)userdata;
+
+		// D-Bus timeouts repeat until they are removed or disabled
+		timeout->Arm();
+		timeout->handle();
+		return 0;
+	}
+};
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  loop Loop the D-Bus connections are dispatched in
+ */
+SdEventDispatcher::SdEventDispatcher( sd_event* loop )
+	: loop_(sd_event_ref(loop)), post_(NULL)
+{
+	// Messages already queued by a blocking call are dispatched after each loop iteration
+	if( sd_event_add_post(loop_, &post_, SdEventDispatcher::OnPost, this) < 0 )
+	{
+		fprintf(stderr, "Error:cannot add D-Bus dispatch source\n");
+		post_ = NULL;
+	}
+}
+
+/**
+ *  @brief Destructor
+ */
+SdEventDispatcher::~SdEventDispatcher()
+{
+	std::map< int, IoSource >::iterator it;
+	for (it = ioSources_.begin(); it != ioSources_.end(); ++it)
+	{
+		sd_event_source_unref(it->second.source);
+	}
+	sd_event_source_unref(post_);
+	sd_event_unref(loop_);
+}
+
+void SdEventDispatcher::enter()
+{
+}
+
+void SdEventDispatcher::leave()
+{
+}
+
+DBus::Timeout* SdEventDispatcher::add_timeout( DBus::Timeout::Internal* internal )
+{
+	return new SdEventTimeout( internal, this );
+}
+
+void SdEventDispatcher::rem_timeout( DBus::Timeout* timeout )
+{
+	delete timeout;
+}
+
+DBus::Watch* SdEventDispatcher::add_watch( DBus::Watch::Internal* internal )
+{
+	SdEventWatch* watch = new SdEventWatch( internal, this );
+	int fd = watch->descriptor();
+
+	std::map< int, IoSource >::iterator it = ioSources_.find(fd);
+	if( it == ioSources_.end() )
+	{
+		IoSource io;
+		if( sd_event_add_io(loop_, &io.source, fd, 0, SdEventDispatcher::OnIo, this) < 0 )
+		{
+			fprintf(stderr, "Error:cannot add D-Bus watch\n");
+			return watch;
+		}
+		it = ioSources_.insert(std::make_pair(fd, io)).first;
+	}
+
+	it->second.watches.push_back(watch);
+	UpdateIo(fd);
+	return watch;
+}
+
+void SdEventDispatcher::rem_watch( DBus::Watch* watch )
+{
+	int fd = watch->descriptor();
+
+	std::map< int, IoSource >::iterator it = ioSources_.find(fd);
+	if( it != ioSources_.end() )
+	{
+		it->second.watches.remove((SdEventWatch*)watch);
+		if( it->second.watches.empty() )
+		{
+			sd_event_source_unref(it->second.source);
+			ioSources_.erase(it);
+		}
+		else
+		{
+			UpdateIo(fd);
+		}
+	}
+
+	delete watch;
+}
+
+/**
+ *  @brief      Wait for the events of every enabled watch of a descriptor
+ *  @param[in]  fd File descriptor
+ */
+void SdEventDispatcher::UpdateIo( int fd )
+{
+	std::map< int, IoSource >::iterator it = ioSources_.find(fd);
+	if( it == ioSources_.end() )
+	{
+		return;
+	}
+
+	uint32_t events = 0;
+	std::list< SdEventWatch* >::iterator watch;
+	for (watch = it->second.watches.begin(); watch != it->second.watches.end(); ++watch)
+	{
+		events |= (*watch)->Events();
+	}
+
+	if( events != 0 )
+	{
+		sd_event_source_set_io_events(it->second.source, events);
+		sd_event_source_set_enabled(it->second.source, SD_EVENT_ON);
+	}
+	else
+	{
+		sd_event_source_set_enabled(it->second.source, SD_EVENT_OFF);
+	}
+}
+
+/**
+ *  @brief  Descriptor of a connection ready, handle it and dispatch the messages read
+ */
+int SdEventDispatcher::OnIo( sd_event_source* source, int fd, uint32_t revents, void* userdata )
+{
+	SdEventDispatcher* dispatcher = (SdEventDispatcher*)userdata;
+
+	int flags = 0;
+	flags |= (revents & EPOLLIN) ? DBUS_WATCH_READABLE : 0;
+	flags |= (revents & EPOLLOUT) ? DBUS_WATCH_WRITABLE : 0;
+	flags |= (revents & EPOLLERR) ? DBUS_WATCH_ERROR : 0;
+	flags |= (revents & EPOLLHUP) ? DBUS_WATCH_HANGUP : 0;
+
+	std::map< int, IoSource >::iterator it = dispatcher->ioSources_.find(fd);
+	if( it != dispatcher->ioSources_.end() )
+	{
+		// A watch can be removed while another one is handled
+		std::vector< SdEventWatch* > watches(it->second.watches.begin(), it->second.watches.end());
+		for (size_t i = 0; i < watches.size(); i++)
+		{
+			it = dispatcher->ioSources_.find(fd);
+			if( it == dispatcher->ioSources_.end() )
+			{
+				break;
+			}
+
+			std::list< SdEventWatch* >& current = it->second.watches;
+			if( std::find(current.begin(), current.end(), watches[i]) == current.end() || !watches[i]->enabled() )
+			{
+				continue;
+			}
+
+			int watchFlags = flags & (watches[i]->flags() | DBUS_WATCH_ERROR | DBUS_WATCH_HANGUP);
+			if( watchFlags != 0 )
+			{
+				watches[i]->handle(watchFlags);
+			}
+		}
+	}
+
+	dispatcher->dispatch_pending();
+	return 0;
+}
+
+/**
+ *  @brief  End of a loop iteration, dispatch the messages left in the connections
+ */
+int SdEventDispatcher::OnPost( sd_event_source* source, void* userdata )
+{
+	SdEventDispatcher* dispatcher = (SdEventDispatcher*)userdata;
+
+	if( dispatcher->has_something_to_dispatch() )
+	{
+		dispatcher->dispatch_pending();
+	}
+	return 0;
+}
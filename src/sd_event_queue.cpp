@@ -0,0 +1,95 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "sd_event_queue.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <systemd/sd-event.h>
+
+/**
+ *  @brief Constructor, tasks can be posted before the queue is started
+ */
+SdEventQueue::SdEventQueue()
+	: source_(NULL)
+{
+	fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+}
+
+/**
+ *  @brief Destructor, the tasks not run yet are dropped
+ */
+SdEventQueue::~SdEventQueue()
+{
+	sd_event_source_unref(source_);
+	if( fd_ >= 0 )
+	{
+		close(fd_);
+	}
+}
+
+/**
+ *  @brief      Run the tasks from a loop
+ *  @param[in]  loop Event loop of the binder
+ *  @return     false if the queue cannot be added to the loop
+ */
+bool SdEventQueue::Start( sd_event* loop )
+{
+	if( fd_ < 0 || sd_event_add_io(loop, &source_, fd_, EPOLLIN, SdEventQueue::OnIo, this) < 0 )
+	{
+		fprintf(stderr, "Error:cannot add loop task queue\n");
+		source_ = NULL;
+		return false;
+	}
+	return true;
+}
+
+/**
+ *  @brief      Run a task from the loop, after the tasks already posted
+ *  @param[in]  task Task
+ */
+void SdEventQueue::Post( const Task& task )
+{
+	bool wake;
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		wake = tasks_.empty();
+		tasks_.push_back(task);
+	}
+
+	if( wake && fd_ >= 0 )
+	{
+		uint64_t one = 1;
+		if( write(fd_, &one, sizeof(one)) < 0 )
+		{
+			fprintf(stderr, "Error:cannot wake the loop\n");
+		}
+	}
+}
+
+/**
+ *  @brief  Tasks posted : run them
+ */
+int SdEventQueue::OnIo( sd_event_source* source, int fd, uint32_t revents, void* userdata )
+{
+	SdEventQueue* queue = (SdEventQueue*)userdata;
+
+	// Reset the eventfd, tasks posted from now on wake the loop again
+	uint64_t count;
+	ssize_t size = read(fd, &count, sizeof(count));
+	(void)size;
+
+	std::vector< Task > tasks;
+	{
+		std::lock_guard< std::mutex > lock( queue->mutex_ );
+		tasks.swap(queue->tasks_);
+	}
+
+	for (size_t i = 0; i < tasks.size(); i++)
+	{
+		tasks[i]();
+	}
+	return 0;
+}
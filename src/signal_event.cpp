@@ -0,0 +1,585 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "signal_event.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ *  @brief Event name of each signal
+ */
+static const char* signalEventNames[SIGNAL_EVENT_MAX] =
+{
+	"sessiondeleted",
+	"routedeleted",
+	"routecalculationcancelled",
+	"routecalculationsuccessful",
+	"routecalculationfailed",
+	"routecalculationprogressupdate",
+	"alternativeroutesavailable",
+	"simulationstatuschanged",
+	"simulationspeedchanged",
+	"positionupdate",
+	"addressupdate",
+	"positiononsegmentupdate",
+	"statusupdate",
+	"offroadpositionchanged",
+	"vehiclelefttheroadnetwork",
+	"guidancestatuschanged",
+	"waypointreached",
+	"maneuverchanged",
+	"positiononroutechanged",
+	"vehiclelefttheroute",
+	"positiontoroutechanged",
+	"activeroutechanged",
+};
+
+/**
+ *  @brief      Convert Genivi key and value pairs to json format
+ *  @param[in]  values Key and value
+ *  @return     Array of {"key", "value"}
+ */
+static json_object* KeyValueArray( const std::map< int32_t, int32_t >& values )
+{
+	json_object* array = json_object_new_array();
+
+	std::map< int32_t, int32_t >::const_iterator it;
+	for (it = values.begin(); it != values.end(); it++)
+	{
+		json_object* obj = json_object_new_object();
+		json_object_object_add(obj, "key", json_object_new_int(it->first));
+		json_object_object_add(obj, "value", json_object_new_int(it->second));
+		json_object_array_add(array, obj);
+	}
+
+	return array;
+}
+
+/**
+ *  @brief Constructor
+ */
+SignalEvent::SignalEvent()
+{
+	for (int i = 0; i < SIGNAL_EVENT_MAX; i++)
+	{
+		groupCount_[i] = 0;
+	}
+}
+
+/**
+ *  @brief      Signal of an event name
+ *  @param[in]  name Event name
+ *  @param[out] type Signal
+ *  @return     false if the name is unknown
+ */
+bool SignalEvent::GetType( const char* name, SignalEventType& type )
+{
+	for (int i = 0; i < SIGNAL_EVENT_MAX; i++)
+	{
+		if( strcmp(name, signalEventNames[i]) == 0 )
+		{
+			type = (SignalEventType)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ *  @brief      Client of a request, created at its first subscription
+ *  @param[in]  req Request from client
+ *  @return     Subscriber, released with the session of the client
+ */
+SignalEvent::Subscriber* SignalEvent::GetSubscriber( afb_req req )
+{
+	Subscriber* subscriber = (Subscriber*)afb_req_context_get(req);
+	if( subscriber == NULL )
+	{
+		subscriber = new Subscriber;
+		subscriber->owner = this;
+		afb_req_context_set(req, subscriber, SignalEvent::OnSessionClosed);
+	}
+	return subscriber;
+}
+
+/**
+ *  @brief      Subscribe the client to signal events, to none of them on failure
+ *  @param[in]  req Request from client
+ *  @param[in]  types Signals to receive
+ *  @param[in]  filter Route and session handles the events are restricted to
+ *  @return     Success or failure of processing
+ */
+bool SignalEvent::Subscribe( afb_req req, const std::vector< SignalEventType >& types, const SignalEventFilter& filter )
+{
+	Subscriber* subscriber = GetSubscriber(req);
+
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	// Groups joined by this request, left again if a later signal fails
+	std::vector< std::list< Group >::iterator > joined;
+	for (size_t i = 0; i < types.size(); i++)
+	{
+		// Join the group of the same signal and filter
+		std::list< Group >::iterator it;
+		for (it = groups_.begin(); it != groups_.end(); it++)
+		{
+			if( it->type == types[i] && it->filter.route == filter.route && it->filter.sessionHandle == filter.sessionHandle )
+			{
+				break;
+			}
+		}
+
+		if( it == groups_.end() )
+		{
+			// e.g. "routecalculationsuccessful", "routecalculationsuccessful/route/3"
+			char name[80];
+			int length = snprintf(name, sizeof(name), "%s", signalEventNames[types[i]]);
+			if( filter.route != 0 )
+			{
+				length += snprintf(name + length, sizeof(name) - length, "/route/%u", filter.route);
+			}
+			if( filter.sessionHandle != 0 )
+			{
+				snprintf(name + length, sizeof(name) - length, "/session/%u", filter.sessionHandle);
+			}
+
+			Group group;
+			group.type = types[i];
+			group.filter = filter;
+			group.event = afb_daemon_make_event(name);
+			if( !afb_event_is_valid(group.event) )
+			{
+				Leave( req, subscriber, joined );
+				return false;
+			}
+			it = groups_.insert(groups_.end(), group);
+			groupCount_[types[i]]++;
+		}
+		else if( it->subscribers.count(subscriber) != 0 )
+		{
+			// Already subscribed
+			continue;
+		}
+
+		if( afb_req_subscribe(req, it->event) < 0 )
+		{
+			if( it->subscribers.empty() )
+			{
+				Drop( it );
+			}
+			Leave( req, subscriber, joined );
+			return false;
+		}
+		it->subscribers.insert(subscriber);
+		joined.push_back(it);
+	}
+
+	return true;
+}
+
+/**
+ *  @brief      Unsubscribe the client from signal events
+ *  @param[in]  req Request from client
+ *  @param[in]  types Signals not to receive anymore (all if empty)
+ */
+void SignalEvent::Unsubscribe( afb_req req, const std::vector< SignalEventType >& types )
+{
+	Subscriber* subscriber = (Subscriber*)afb_req_context_get(req);
+	if( subscriber == NULL )
+	{
+		// Never subscribed
+		return;
+	}
+
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	std::vector< std::list< Group >::iterator > selected;
+	std::list< Group >::iterator it;
+	for (it = groups_.begin(); it != groups_.end(); it++)
+	{
+		bool isSelected = types.empty();
+		for (size_t i = 0; i < types.size() && !isSelected; i++)
+		{
+			isSelected = (it->type == types[i]);
+		}
+
+		if( isSelected && it->subscribers.count(subscriber) != 0 )
+		{
+			selected.push_back(it);
+		}
+	}
+
+	Leave( req, subscriber, selected );
+}
+
+/**
+ *  @brief      Unsubscribe the client from groups, dropping those left without subscriber, mutex_ must be locked
+ *  @param[in]  req Request from client
+ *  @param[in]  subscriber Client
+ *  @param[in]  joined Groups the client is a subscriber of
+ */
+void SignalEvent::Leave( afb_req req, Subscriber* subscriber, const std::vector< std::list< Group >::iterator >& joined )
+{
+	for (size_t i = 0; i < joined.size(); i++)
+	{
+		afb_req_unsubscribe(req, joined[i]->event);
+		joined[i]->subscribers.erase(subscriber);
+		if( joined[i]->subscribers.empty() )
+		{
+			Drop( joined[i] );
+		}
+	}
+}
+
+/**
+ *  @brief      Drop the event of a group, mutex_ must be locked
+ *  @param[in]  it Group
+ *  @return     Next group
+ */
+std::list< SignalEvent::Group >::iterator SignalEvent::Drop( std::list< Group >::iterator it )
+{
+	afb_event_drop(it->event);
+	groupCount_[it->type]--;
+	return groups_.erase(it);
+}
+
+/**
+ *  @brief      Session of a client closed : its subscriptions are gone with it
+ *  @param[in]  context Subscriber
+ */
+void SignalEvent::OnSessionClosed( void* context )
+{
+	Subscriber* subscriber = (Subscriber*)context;
+	SignalEvent* signalEvent = subscriber->owner;
+	{
+		std::lock_guard< std::mutex > lock( signalEvent->mutex_ );
+
+		std::list< Group >::iterator it = signalEvent->groups_.begin();
+		while( it != signalEvent->groups_.end() )
+		{
+			if( it->subscribers.erase(subscriber) != 0 && it->subscribers.empty() )
+			{
+				it = signalEvent->Drop( it );
+			}
+			else
+			{
+				it++;
+			}
+		}
+	}
+	delete subscriber;
+}
+
+/**
+ *  @brief      Whether a signal has subscribers, checked before building its payload
+ *  @param[in]  type Signal
+ */
+bool SignalEvent::IsSubscribed( SignalEventType type ) const
+{
+	return groupCount_[type].load(std::memory_order_relaxed) > 0;
+}
+
+/**
+ *  @brief      Push a signal to the groups whose filter matches
+ *  @param[in]  type Signal
+ *  @param[in]  route Route handle of the signal (0 : none)
+ *  @param[in]  sessionHandle Session handle of the signal (0 : none)
+ *  @param[in]  payload Event data, released here
+ */
+void SignalEvent::Push( SignalEventType type, uint32_t route, uint32_t sessionHandle, json_object* payload )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	std::list< Group >::iterator it = groups_.begin();
+	while( it != groups_.end() )
+	{
+		if( it->type != type
+		 || (route != 0 && it->filter.route != 0 && it->filter.route != route)
+		 || (sessionHandle != 0 && it->filter.sessionHandle != 0 && it->filter.sessionHandle != sessionHandle) )
+		{
+			it++;
+			continue;
+		}
+
+		// Every group shares the payload, its text is cached by json-c at the first serialization
+		if( afb_event_push(it->event, json_object_get(payload)) <= 0 )
+		{
+			// No subscriber anymore
+			it = Drop( it );
+		}
+		else
+		{
+			it++;
+		}
+	}
+
+	json_object_put(payload);
+}
+
+/**
+ *  @brief      Push a signal whose argument is a list of changed keys
+ *  @param[in]  type Signal
+ *  @param[in]  changedValues Changed keys
+ */
+void SignalEvent::PushChangedValues( SignalEventType type, const std::vector< int32_t >& changedValues )
+{
+	if( !IsSubscribed(type) )
+	{
+		return;
+	}
+
+	json_object* keys = json_object_new_array();
+	for (size_t i = 0; i < changedValues.size(); i++)
+	{
+		json_object_array_add(keys, json_object_new_int(changedValues[i]));
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "changedValues", keys);
+	Push( type, 0, 0, payload );
+}
+
+/**
+ *  @brief      Push a signal whose arguments are a distance and a direction
+ *  @param[in]  type Signal
+ *  @param[in]  distance Distance in m
+ *  @param[in]  direction Direction
+ */
+void SignalEvent::PushDistance( SignalEventType type, uint32_t distance, int32_t direction )
+{
+	if( !IsSubscribed(type) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "distance", json_object_new_int64(distance));
+	json_object_object_add(payload, "direction", json_object_new_int(direction));
+	Push( type, 0, 0, payload );
+}
+
+void SignalEvent::OnSessionDeleted( uint32_t sessionHandle )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_SESSIONDELETED) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "sessionHandle", json_object_new_int64(sessionHandle));
+	Push( SIGNAL_EVENT_SESSIONDELETED, 0, sessionHandle, payload );
+}
+
+void SignalEvent::OnRouteDeleted( uint32_t routeHandle )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_ROUTEDELETED) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "route", json_object_new_int64(routeHandle));
+	Push( SIGNAL_EVENT_ROUTEDELETED, routeHandle, 0, payload );
+}
+
+void SignalEvent::OnRouteCalculationCancelled( uint32_t routeHandle )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_ROUTECALCULATIONCANCELLED) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "route", json_object_new_int64(routeHandle));
+	Push( SIGNAL_EVENT_ROUTECALCULATIONCANCELLED, routeHandle, 0, payload );
+}
+
+void SignalEvent::OnRouteCalculationSuccessful( uint32_t routeHandle, const std::map< int32_t, int32_t >& unfullfilledPreferences )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_ROUTECALCULATIONSUCCESSFUL) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "route", json_object_new_int64(routeHandle));
+	json_object_object_add(payload, "unfullfilledPreferences", KeyValueArray(unfullfilledPreferences));
+	Push( SIGNAL_EVENT_ROUTECALCULATIONSUCCESSFUL, routeHandle, 0, payload );
+}
+
+void SignalEvent::OnRouteCalculationFailed( uint32_t routeHandle, int32_t errorCode, const std::map< int32_t, int32_t >& unfullfilledPreferences )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_ROUTECALCULATIONFAILED) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "route", json_object_new_int64(routeHandle));
+	json_object_object_add(payload, "errorCode", json_object_new_int(errorCode));
+	json_object_object_add(payload, "unfullfilledPreferences", KeyValueArray(unfullfilledPreferences));
+	Push( SIGNAL_EVENT_ROUTECALCULATIONFAILED, routeHandle, 0, payload );
+}
+
+void SignalEvent::OnRouteCalculationProgressUpdate( uint32_t routeHandle, int32_t status, uint8_t percentage )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_ROUTECALCULATIONPROGRESSUPDATE) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "route", json_object_new_int64(routeHandle));
+	json_object_object_add(payload, "status", json_object_new_int(status));
+	json_object_object_add(payload, "percentage", json_object_new_int(percentage));
+	Push( SIGNAL_EVENT_ROUTECALCULATIONPROGRESSUPDATE, routeHandle, 0, payload );
+}
+
+void SignalEvent::OnAlternativeRoutesAvailable( const std::vector< uint32_t >& routeHandlesList )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_ALTERNATIVEROUTESAVAILABLE) )
+	{
+		return;
+	}
+
+	json_object* routes = json_object_new_array();
+	for (size_t i = 0; i < routeHandlesList.size(); i++)
+	{
+		json_object_array_add(routes, json_object_new_int64(routeHandlesList[i]));
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "routes", routes);
+	Push( SIGNAL_EVENT_ALTERNATIVEROUTESAVAILABLE, 0, 0, payload );
+}
+
+void SignalEvent::OnSimulationStatusChanged( int32_t simulationStatus )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_SIMULATIONSTATUSCHANGED) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "simulationStatus", json_object_new_int(simulationStatus));
+	Push( SIGNAL_EVENT_SIMULATIONSTATUSCHANGED, 0, 0, payload );
+}
+
+void SignalEvent::OnSimulationSpeedChanged( uint8_t speedFactor )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_SIMULATIONSPEEDCHANGED) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "speedFactor", json_object_new_int(speedFactor));
+	Push( SIGNAL_EVENT_SIMULATIONSPEEDCHANGED, 0, 0, payload );
+}
+
+void SignalEvent::OnPositionUpdate( const std::vector< int32_t >& changedValues )
+{
+	PushChangedValues( SIGNAL_EVENT_POSITIONUPDATE, changedValues );
+}
+
+void SignalEvent::OnAddressUpdate( const std::vector< int32_t >& changedValues )
+{
+	PushChangedValues( SIGNAL_EVENT_ADDRESSUPDATE, changedValues );
+}
+
+void SignalEvent::OnPositionOnSegmentUpdate( const std::vector< int32_t >& changedValues )
+{
+	PushChangedValues( SIGNAL_EVENT_POSITIONONSEGMENTUPDATE, changedValues );
+}
+
+void SignalEvent::OnStatusUpdate( const std::vector< int32_t >& changedValues )
+{
+	PushChangedValues( SIGNAL_EVENT_STATUSUPDATE, changedValues );
+}
+
+void SignalEvent::OnOffRoadPositionChanged( uint32_t distance, int32_t direction )
+{
+	PushDistance( SIGNAL_EVENT_OFFROADPOSITIONCHANGED, distance, direction );
+}
+
+void SignalEvent::OnVehicleLeftTheRoadNetwork()
+{
+	if( IsSubscribed(SIGNAL_EVENT_VEHICLELEFTTHEROADNETWORK) )
+	{
+		Push( SIGNAL_EVENT_VEHICLELEFTTHEROADNETWORK, 0, 0, json_object_new_object() );
+	}
+}
+
+void SignalEvent::OnGuidanceStatusChanged( int32_t guidanceStatus, uint32_t routeHandle )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_GUIDANCESTATUSCHANGED) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "guidanceStatus", json_object_new_int(guidanceStatus));
+	json_object_object_add(payload, "route", json_object_new_int64(routeHandle));
+	Push( SIGNAL_EVENT_GUIDANCESTATUSCHANGED, routeHandle, 0, payload );
+}
+
+void SignalEvent::OnWaypointReached( bool isDestination )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_WAYPOINTREACHED) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "isDestination", json_object_new_boolean(isDestination));
+	Push( SIGNAL_EVENT_WAYPOINTREACHED, 0, 0, payload );
+}
+
+void SignalEvent::OnManeuverChanged( int32_t maneuver )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_MANEUVERCHANGED) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "maneuver", json_object_new_int(maneuver));
+	Push( SIGNAL_EVENT_MANEUVERCHANGED, 0, 0, payload );
+}
+
+void SignalEvent::OnPositionOnRouteChanged( uint32_t offsetOnRoute )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_POSITIONONROUTECHANGED) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "offsetOnRoute", json_object_new_int64(offsetOnRoute));
+	Push( SIGNAL_EVENT_POSITIONONROUTECHANGED, 0, 0, payload );
+}
+
+void SignalEvent::OnVehicleLeftTheRoute()
+{
+	if( IsSubscribed(SIGNAL_EVENT_VEHICLELEFTTHEROUTE) )
+	{
+		Push( SIGNAL_EVENT_VEHICLELEFTTHEROUTE, 0, 0, json_object_new_object() );
+	}
+}
+
+void SignalEvent::OnPositionToRouteChanged( uint32_t distance, int32_t direction )
+{
+	PushDistance( SIGNAL_EVENT_POSITIONTOROUTECHANGED, distance, direction );
+}
+
+void SignalEvent::OnActiveRouteChanged( int32_t changeCause )
+{
+	if( !IsSubscribed(SIGNAL_EVENT_ACTIVEROUTECHANGED) )
+	{
+		return;
+	}
+
+	json_object* payload = json_object_new_object();
+	json_object_object_add(payload, "changeCause", json_object_new_int(changeCause));
+	Push( SIGNAL_EVENT_ACTIVEROUTECHANGED, 0, 0, payload );
+}
@@ -0,0 +1,453 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "track_file.h"
+#include <errno.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ *  @brief      Append a varint : 7 bits per byte, least significant first
+ *  @param[in]  value Value
+ *  @param[out] record Where the bytes are written
+ *  @return     Number of bytes written
+ */
+static size_t PutVarint( uint32_t value, uint8_t* record )
+{
+	size_t size = 0;
+	while( value >= 0x80 )
+	{
+		record[size++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	record[size++] = (uint8_t)value;
+	return size;
+}
+
+/**
+ *  @brief      Read a varint
+ *  @param[in]  data Bytes of the record
+ *  @param[in]  size Number of bytes available
+ *  @param[in,out] offset Offset of the varint, then of the next value
+ *  @param[out] value Value
+ *  @return     false if the varint is cut or longer than 5 bytes
+ */
+static bool GetVarint( const uint8_t* data, size_t size, size_t& offset, uint32_t& value )
+{
+	value = 0;
+	for (uint32_t shift = 0; shift < 35; shift += 7)
+	{
+		if( offset >= size )
+		{
+			return false;
+		}
+		uint8_t byte = data[offset++];
+		value |= (uint32_t)(byte & 0x7f) << shift;
+		if( !(byte & 0x80) )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ *  @brief      Difference mapped to an unsigned value : 0, -1, 1, -2, 2... to 0, 1, 2, 3, 4...
+ *  @param[in]  value Current value
+ *  @param[in]  previous Previous value
+ *  @return     Zigzag encoded difference, modulo 2^32
+ */
+static uint32_t ZigzagDelta( uint32_t value, uint32_t previous )
+{
+	uint32_t delta = value - previous;
+	return (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+}
+
+/**
+ *  @brief      Value from a zigzag encoded difference
+ *  @param[in]  zigzag Zigzag encoded difference
+ *  @param[in]  previous Previous value
+ *  @return     Current value
+ */
+static uint32_t UnzigzagDelta( uint32_t zigzag, uint32_t previous )
+{
+	return previous + ((zigzag >> 1) ^ (0u - (zigzag & 1)));
+}
+
+/**
+ *  @brief      Coordinate in 1e-7 degree
+ *  @param[in]  degree Latitude or longitude
+ *  @return     Coordinate as recorded
+ */
+static int32_t Coordinate( double degree )
+{
+	return (int32_t)lround(degree * TRACK_FILE_COORDINATE_SCALE);
+}
+
+/**
+ *  @brief  Constructor
+ */
+TrackWriter::TrackWriter()
+	: file_(NULL)
+{
+	memset(&previous_, 0, sizeof(previous_));
+}
+
+/**
+ *  @brief  Destructor
+ */
+TrackWriter::~TrackWriter()
+{
+	Close();
+}
+
+/**
+ *  @brief      Create a track file, replacing the file of the same name once closed
+ *  @param[in]  path Path of the file
+ *  @return     Success or failure of processing
+ */
+bool TrackWriter::Open( const char* path )
+{
+	Close();
+
+	// Never written through a link or a file created by someone else
+	std::string temp = std::string(path) + TRACK_FILE_TEMP_SUFFIX;
+	int flags = O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC;
+	int fd = open(temp.c_str(), flags, 0600);
+	if( fd < 0 && errno == EEXIST )
+	{
+		// Left by a recording that did not stop
+		unlink(temp.c_str());
+		fd = open(temp.c_str(), flags, 0600);
+	}
+
+	file_ = (fd < 0) ? NULL : fdopen(fd, "wb");
+	if( file_ == NULL )
+	{
+		fprintf(stderr, "Error:cannot create %s\n", temp.c_str());
+		if( fd >= 0 )
+		{
+			close(fd);
+		}
+		return false;
+	}
+	path_ = path;
+
+	uint8_t header[TRACK_FILE_HEADER_SIZE];
+	memcpy(header, TRACK_FILE_MAGIC, 4);
+	header[4] = TRACK_FILE_VERSION;
+	memset(&previous_, 0, sizeof(previous_));
+	if( fwrite(header, sizeof(header), 1, file_) != 1 )
+	{
+		fprintf(stderr, "Error:cannot write %s\n", temp.c_str());
+		fclose(file_);
+		file_ = NULL;
+		unlink(temp.c_str());
+		return false;
+	}
+	return true;
+}
+
+/**
+ *  @brief      Append a position
+ *  @param[in]  delay Time since the previous position in msec
+ *  @param[in]  position Changed fields
+ *  @return     false if the file is not open or cannot be written
+ */
+bool TrackWriter::Write( uint32_t delay, const NaviPosition& position )
+{
+	if( file_ == NULL )
+	{
+		return false;
+	}
+
+	uint8_t record[TRACK_FILE_MAX_RECORD];
+	size_t size = Encode(delay, position, previous_, record);
+	return (fwrite(record, size, 1, file_) == 1);
+}
+
+/**
+ *  @brief  Flush the records, close the file and give it its name
+ */
+void TrackWriter::Close()
+{
+	if( file_ == NULL )
+	{
+		return;
+	}
+
+	fclose(file_);
+	file_ = NULL;
+
+	// A link of the same name is replaced, not followed
+	std::string temp = path_ + TRACK_FILE_TEMP_SUFFIX;
+	if( rename(temp.c_str(), path_.c_str()) < 0 )
+	{
+		fprintf(stderr, "Error:cannot rename %s\n", temp.c_str());
+	}
+}
+
+/**
+ *  @brief      Create the directory of the track files, written by the service only
+ *  @param[in]  path Path of the directory, its missing parents are created too
+ *  @return     false if it cannot be created, or is not a directory of the service
+ */
+bool TrackWriter::MakeDirectory( const std::string& path )
+{
+	for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1))
+	{
+		std::string parent = path.substr(0, slash);
+		if( mkdir(parent.c_str(), 0700) < 0 && errno != EEXIST )
+		{
+			fprintf(stderr, "Error:cannot create %s\n", parent.c_str());
+			return false;
+		}
+		if( slash == std::string::npos )
+		{
+			break;
+		}
+	}
+
+	struct stat st;
+	if( lstat(path.c_str(), &st) < 0 || !S_ISDIR(st.st_mode) || st.st_uid != geteuid() || (st.st_mode & 0022) )
+	{
+		fprintf(stderr, "Error:%s is not a directory written by the service only\n", path.c_str());
+		return false;
+	}
+	return true;
+}
+
+/**
+ *  @brief      Encode a position
+ *  @param[in]  delay Time since the previous position in msec
+ *  @param[in]  position Changed fields
+ *  @param[in,out] previous Last value of each field, updated with the position
+ *  @param[out] record At least TRACK_FILE_MAX_RECORD bytes
+ *  @return     Size of the record
+ */
+size_t TrackWriter::Encode( uint32_t delay, const NaviPosition& position, TrackState& previous, uint8_t* record )
+{
+	size_t size = PutVarint(delay, record);
+
+	uint8_t mask = (uint8_t)(position.mask & NAVI_POSITION_ALL);
+	if( (position.mask & (1u << NAVI_POSITION_SIMULATION_MODE)) && position.simulationMode )
+	{
+		mask |= TRACK_FILE_SIMULATION_MODE;
+	}
+	record[size++] = mask;
+
+	if( mask & (1u << NAVI_POSITION_TIMESTAMP) )
+	{
+		size += PutVarint(ZigzagDelta(position.timestamp, previous.timestamp), record + size);
+		previous.timestamp = position.timestamp;
+	}
+	if( mask & (1u << NAVI_POSITION_LATITUDE) )
+	{
+		int32_t latitude = Coordinate(position.latitude);
+		size += PutVarint(ZigzagDelta(latitude, previous.latitude), record + size);
+		previous.latitude = latitude;
+	}
+	if( mask & (1u << NAVI_POSITION_LONGITUDE) )
+	{
+		int32_t longitude = Coordinate(position.longitude);
+		size += PutVarint(ZigzagDelta(longitude, previous.longitude), record + size);
+		previous.longitude = longitude;
+	}
+	if( mask & (1u << NAVI_POSITION_HEADING) )
+	{
+		size += PutVarint(ZigzagDelta(position.heading, previous.heading), record + size);
+		previous.heading = position.heading;
+	}
+	if( mask & (1u << NAVI_POSITION_SPEED) )
+	{
+		size += PutVarint(ZigzagDelta(position.speed, previous.speed), record + size);
+		previous.speed = position.speed;
+	}
+	return size;
+}
+
+/**
+ *  @brief  Constructor
+ */
+TrackReader::TrackReader()
+	: data_(NULL), size_(0), offset_(0)
+{
+	memset(&previous_, 0, sizeof(previous_));
+}
+
+/**
+ *  @brief  Destructor
+ */
+TrackReader::~TrackReader()
+{
+	Close();
+}
+
+/**
+ *  @brief      Map a track file in memory
+ *  @param[in]  path Path of the file
+ *  @return     false if the file cannot be read or is not a track file
+ */
+bool TrackReader::Open( const char* path )
+{
+	Close();
+
+	int fd = open(path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+	if( fd < 0 )
+	{
+		fprintf(stderr, "Error:cannot open %s\n", path);
+		return false;
+	}
+
+	struct stat st;
+	if( fstat(fd, &st) < 0 || st.st_size < TRACK_FILE_HEADER_SIZE )
+	{
+		fprintf(stderr, "Error:%s is not a track file\n", path);
+		close(fd);
+		return false;
+	}
+
+	void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if( data == MAP_FAILED )
+	{
+		fprintf(stderr, "Error:cannot map %s\n", path);
+		return false;
+	}
+	data_ = (const uint8_t*)data;
+	size_ = st.st_size;
+
+	if( memcmp(data_, TRACK_FILE_MAGIC, 4) != 0 || data_[4] != TRACK_FILE_VERSION )
+	{
+		fprintf(stderr, "Error:%s is not a track file\n", path);
+		Close();
+		return false;
+	}
+
+	// Read once from the start to the end
+	madvise(data, size_, MADV_SEQUENTIAL);
+	Rewind();
+	return true;
+}
+
+/**
+ *  @brief      Read the next position
+ *  @param[out] record Position and time since the previous one
+ *  @return     false at the end of the file, or at a cut or corrupted record
+ */
+bool TrackReader::Read( TrackRecord& record )
+{
+	if( data_ == NULL )
+	{
+		return false;
+	}
+
+	size_t size = Decode(data_ + offset_, size_ - offset_, previous_, record);
+	offset_ += size;
+	return (size > 0);
+}
+
+/**
+ *  @brief  Read again from the first position
+ */
+void TrackReader::Rewind()
+{
+	offset_ = TRACK_FILE_HEADER_SIZE;
+	memset(&previous_, 0, sizeof(previous_));
+}
+
+/**
+ *  @brief  Unmap the file
+ */
+void TrackReader::Close()
+{
+	if( data_ != NULL )
+	{
+		munmap((void*)data_, size_);
+		data_ = NULL;
+		size_ = 0;
+		offset_ = 0;
+	}
+}
+
+/**
+ *  @brief      Decode a position
+ *  @param[in]  data Bytes from the start of the record
+ *  @param[in]  size Number of bytes available
+ *  @param[in,out] previous Last value of each field, updated with the position
+ *  @param[out] record Position and time since the previous one
+ *  @return     Size of the record, 0 if it is cut or corrupted
+ */
+size_t TrackReader::Decode( const uint8_t* data, size_t size, TrackState& previous, TrackRecord& record )
+{
+	size_t offset = 0;
+	if( !GetVarint(data, size, offset, record.delay) || offset >= size )
+	{
+		return 0;
+	}
+
+	uint8_t mask = data[offset++];
+	if( mask & ~(NAVI_POSITION_ALL | TRACK_FILE_SIMULATION_MODE) )
+	{
+		return 0;
+	}
+
+	// Fields are applied once the whole record is read
+	TrackState state = previous;
+	uint32_t zigzag;
+	if( mask & (1u << NAVI_POSITION_TIMESTAMP) )
+	{
+		if( !GetVarint(data, size, offset, zigzag) )
+		{
+			return 0;
+		}
+		state.timestamp = UnzigzagDelta(zigzag, state.timestamp);
+	}
+	if( mask & (1u << NAVI_POSITION_LATITUDE) )
+	{
+		if( !GetVarint(data, size, offset, zigzag) )
+		{
+			return 0;
+		}
+		state.latitude = (int32_t)UnzigzagDelta(zigzag, state.latitude);
+	}
+	if( mask & (1u << NAVI_POSITION_LONGITUDE) )
+	{
+		if( !GetVarint(data, size, offset, zigzag) )
+		{
+			return 0;
+		}
+		state.longitude = (int32_t)UnzigzagDelta(zigzag, state.longitude);
+	}
+	if( mask & (1u << NAVI_POSITION_HEADING) )
+	{
+		if( !GetVarint(data, size, offset, zigzag) )
+		{
+			return 0;
+		}
+		state.heading = UnzigzagDelta(zigzag, state.heading);
+	}
+	if( mask & (1u << NAVI_POSITION_SPEED) )
+	{
+		if( !GetVarint(data, size, offset, zigzag) )
+		{
+			return 0;
+		}
+		state.speed = (int32_t)UnzigzagDelta(zigzag, state.speed);
+	}
+	previous = state;
+
+	NaviPosition& position = record.position;
+	position.mask = mask & NAVI_POSITION_ALL;
+	position.timestamp = state.timestamp;
+	position.latitude = state.latitude / TRACK_FILE_COORDINATE_SCALE;
+	position.longitude = state.longitude / TRACK_FILE_COORDINATE_SCALE;
+	position.heading = state.heading;
+	position.speed = state.speed;
+	position.simulationMode = ((mask & TRACK_FILE_SIMULATION_MODE) != 0);
+	return offset;
+}
@@ -0,0 +1,96 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "track_recorder.h"
+#include "binder_time.h"
+#include <stdio.h>
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  positionCache Position information notified by Genivi
+ */
+TrackRecorder::TrackRecorder( PositionCache* positionCache )
+	: positionCache_(positionCache), isRecording_(false), isTracking_(false), recordTime_(0), records_(0)
+{
+}
+
+/**
+ *  @brief      Start recording in a new track file, stopping the current recording
+ *  @param[in]  path Path of the file
+ *  @return     Success or failure of processing
+ */
+bool TrackRecorder::Start( const char* path )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	isRecording_ = false;
+	if( !writer_.Open(path) )
+	{
+		return false;
+	}
+
+	// Every field is recorded from now on, until Stop
+	if( !isTracking_ )
+	{
+		positionCache_->Track(NAVI_POSITION_ALL);
+		isTracking_ = true;
+	}
+
+	NaviPosition position;
+	position.mask = 0;
+	positionCache_->Peek(NAVI_POSITION_ALL, position);
+
+	isRecording_ = true;
+	recordTime_ = GetTimeMsec();
+	records_ = 0;
+	if( position.mask != 0 )
+	{
+		writer_.Write(0, position);
+		records_++;
+	}
+	return true;
+}
+
+/**
+ *  @brief  Stop recording and close the track file
+ *  @return Number of positions recorded
+ */
+uint32_t TrackRecorder::Stop()
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	writer_.Close();
+	isRecording_ = false;
+	if( isTracking_ )
+	{
+		positionCache_->Untrack(NAVI_POSITION_ALL);
+		isTracking_ = false;
+	}
+	return records_;
+}
+
+/**
+ *  @brief      Values changed in the position cache : append them to the track
+ *  @param[in]  changedList Changed fields
+ */
+void TrackRecorder::OnPositionChanged( const NaviPosition& changedList )
+{
+	std::lock_guard< std::mutex > lock( mutex_ );
+
+	if( !isRecording_ )
+	{
+		return;
+	}
+
+	uint64_t now = GetTimeMsec();
+	if( !writer_.Write((uint32_t)(now - recordTime_), changedList) )
+	{
+		// The records written so far stay readable
+		fprintf(stderr, "Error:cannot write track, recording stopped\n");
+		writer_.Close();
+		isRecording_ = false;
+		return;
+	}
+	recordTime_ = now;
+	records_++;
+}
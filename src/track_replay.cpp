@@ -0,0 +1,219 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+#include "track_replay.h"
+#include "sd_event_queue.h"
+#include "binder_time.h"
+#include <stdio.h>
+#include <vector>
+#include <systemd/sd-event.h>
+
+/**
+ *  @brief Fields Genivi can be given by SetPosition
+ */
+#define TRACK_REPLAY_FIELDS	(NAVI_POSITION_ALL & ~(1u << NAVI_POSITION_SIMULATION_MODE))
+
+/**
+ *  @brief Time the replay waits for Genivi to reply (usec)
+ */
+#define TRACK_REPLAY_RETRY_DELAY	1000
+
+/**
+ *  @brief      Constructor
+ *  @param[in]  geniviRequest Used to set the positions
+ *  @param[in]  loopQueue Runs the changes of the timer in the event loop
+ */
+TrackReplay::TrackReplay( GeniviRequest* geniviRequest, SdEventQueue* loopQueue )
+	: geniviRequest_(geniviRequest), loopQueue_(loopQueue), timer_(NULL), isPlaying_(false), repeat_(false),
+	  sessionHandle_(0), speed_(TRACK_REPLAY_DEFAULT_SPEED), due_(0), pending_(0)
+{
+}
+
+/**
+ *  @brief Destructor
+ */
+TrackReplay::~TrackReplay()
+{
+	sd_event_source_unref(timer_);
+}
+
+/**
+ *  @brief      Create the timer of the replay
+ *  @param[in]  loop Event loop of the binder
+ *  @return     false if the timer cannot be added to the loop
+ */
+bool TrackReplay::Start( sd_event* loop )
+{
+	if( sd_event_add_time(loop, &timer_, CLOCK_MONOTONIC, 0, 1000, TrackReplay::OnTimer, this) < 0 )
+	{
+		fprintf(stderr, "Error:cannot add track replay timer\n");
+		timer_ = NULL;
+		return false;
+	}
+
+	sd_event_source_set_enabled(timer_, SD_EVENT_OFF);
+	return true;
+}
+
+/**
+ *  @brief      Replay a track file, stopping the current replay
+ *  @param[in]  path Path of the file
+ *  @param[in]  sessionHandle Session handle given to SetPosition
+ *  @param[in]  speed Times the recorded speed, 1 to TRACK_REPLAY_MAX_SPEED
+ *  @param[in]  repeat Start again at the end of the track
+ *  @return     false if the file is not a track file or holds no position
+ */
+bool TrackReplay::Play( const char* path, uint32_t sessionHandle, uint32_t speed, bool repeat )
+{
+	bool isPlaying;
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+
+		isPlaying_ = false;
+		if( timer_ == NULL || !reader_.Open(path) || !reader_.Read(next_) )
+		{
+			reader_.Close();
+		}
+		else
+		{
+			isPlaying_ = true;
+			repeat_ = repeat;
+			sessionHandle_ = sessionHandle;
+			speed_ = speed;
+			due_ = GetTimeUsec();
+		}
+		isPlaying = isPlaying_;
+	}
+
+	PostArmTimer();
+	return isPlaying;
+}
+
+/**
+ *  @brief  Stop the replay
+ */
+void TrackReplay::Stop()
+{
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+
+		isPlaying_ = false;
+		reader_.Close();
+	}
+
+	PostArmTimer();
+}
+
+/**
+ *  @brief      Read the position after next_, mutex_ must be locked
+ *  @return     false at the end of the track
+ */
+bool TrackReplay::ReadNext()
+{
+	if( reader_.Read(next_) )
+	{
+		return true;
+	}
+	if( !repeat_ )
+	{
+		return false;
+	}
+
+	// Wait as long as between two positions before starting again
+	uint32_t delay = next_.delay;
+	reader_.Rewind();
+	if( !reader_.Read(next_) )
+	{
+		return false;
+	}
+	next_.delay = delay;
+	return true;
+}
+
+/**
+ *  @brief  Arm the timer from the event loop, Play and Stop run on worker threads
+ */
+void TrackReplay::PostArmTimer()
+{
+	loopQueue_->Post( [this]()
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		ArmTimer( GetTimeUsec() );
+	});
+}
+
+/**
+ *  @brief      Expire when next_ is due, mutex_ must be locked, from the event loop
+ *  @param[in]  now Current time in usec
+ */
+void TrackReplay::ArmTimer( uint64_t now )
+{
+	if( timer_ == NULL )
+	{
+		return;
+	}
+
+	if( !isPlaying_ )
+	{
+		sd_event_source_set_enabled(timer_, SD_EVENT_OFF);
+		return;
+	}
+
+	// Genivi has not replied to the previous positions yet
+	uint64_t time = due_;
+	if( pending_ >= TRACK_REPLAY_MAX_PENDING && time < now + TRACK_REPLAY_RETRY_DELAY )
+	{
+		time = now + TRACK_REPLAY_RETRY_DELAY;
+	}
+
+	sd_event_source_set_time(timer_, time);
+	sd_event_source_set_enabled(timer_, SD_EVENT_ONESHOT);
+}
+
+/**
+ *  @brief  Positions due : give them to Genivi
+ */
+int TrackReplay::OnTimer( sd_event_source* source, uint64_t usec, void* userdata )
+{
+	TrackReplay* replay = (TrackReplay*)userdata;
+
+	std::vector< NaviPosition > positions;
+	uint32_t sessionHandle;
+	{
+		std::lock_guard< std::mutex > lock( replay->mutex_ );
+
+		uint64_t now = GetTimeUsec();
+		while( replay->isPlaying_ && replay->due_ <= now
+			&& positions.size() < TRACK_REPLAY_MAX_BURST
+			&& replay->pending_ + positions.size() < TRACK_REPLAY_MAX_PENDING )
+		{
+			if( replay->next_.position.mask & TRACK_REPLAY_FIELDS )
+			{
+				positions.push_back(replay->next_.position);
+			}
+
+			if( !replay->ReadNext() )
+			{
+				replay->isPlaying_ = false;
+				replay->reader_.Close();
+				break;
+			}
+			replay->due_ += (uint64_t)replay->next_.delay * 1000 / replay->speed_;
+		}
+
+		sessionHandle = replay->sessionHandle_;
+		replay->pending_ += positions.size();
+		replay->ArmTimer( now );
+	}
+
+	// Sent outside the lock, a failed call is completed at once
+	for (size_t i = 0; i < positions.size(); i++)
+	{
+		replay->geniviRequest_->NavicoreSetPositionAsync( sessionHandle, positions[i], [replay]( bool isSuccess )
+		{
+			std::lock_guard< std::mutex > lock( replay->mutex_ );
+			replay->pending_--;
+		});
+	}
+	return 0;
+}
@@ -0,0 +1,491 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+/*
+ *	Server side of the interfaces of genivi-navigationcore-proxy.h used by
+ *	the binding and the load tests. Same layout as the adaptors generated by
+ *	dbusxx-xml2cpp, but every reply goes through Respond() so that the
+ *	service can delay it.
+ */
+
+#ifndef __genivi_navigationcore_adaptor_h__ADAPTOR_MARSHAL_H
+#define __genivi_navigationcore_adaptor_h__ADAPTOR_MARSHAL_H
+
+#include <dbus-c++-1/dbus-c++/dbus.h>
+#include <functional>
+#include <map>
+#include <vector>
+#include <string>
+
+namespace org {
+namespace genivi {
+namespace navigationcore {
+
+typedef std::map< int32_t, ::DBus::Struct< uint8_t, ::DBus::Variant > > ValueMap;
+typedef ::DBus::Struct< uint16_t, uint16_t, uint16_t, std::string > Version;
+
+/**
+ *  @brief Writes the output arguments of a method into its reply
+ */
+typedef std::function< void( ::DBus::MessageIter& wi ) > ReplyWriter;
+
+/**
+ *  @brief Send the reply of a method call, now or later
+ */
+class Replier
+{
+public:
+	virtual ~Replier() {}
+
+	virtual ::DBus::Message Respond( const ::DBus::CallMessage& call, const ReplyWriter& writer ) = 0;
+};
+
+class Session_adaptor
+: public ::DBus::InterfaceAdaptor, public virtual Replier
+{
+public:
+
+    Session_adaptor()
+    : ::DBus::InterfaceAdaptor("org.genivi.navigationcore.Session")
+    {
+        register_method(Session_adaptor, GetVersion, _GetVersion_stub);
+        register_method(Session_adaptor, CreateSession, _CreateSession_stub);
+        register_method(Session_adaptor, DeleteSession, _DeleteSession_stub);
+        register_method(Session_adaptor, GetSessionStatus, _GetSessionStatus_stub);
+        register_method(Session_adaptor, GetAllSessions, _GetAllSessions_stub);
+    }
+
+public:
+
+    /* methods exported by this interface */
+    virtual Version SessionGetVersion() = 0;
+    virtual uint32_t CreateSession(const std::string& client) = 0;
+    virtual void DeleteSession(const uint32_t& sessionHandle) = 0;
+    virtual int32_t GetSessionStatus(const uint32_t& sessionHandle) = 0;
+    virtual std::vector< ::DBus::Struct< uint32_t, std::string > > GetAllSessions() = 0;
+
+public:
+
+    /* signal emitters for this interface */
+    void SessionDeleted(const uint32_t& sessionHandle)
+    {
+        ::DBus::SignalMessage sig("SessionDeleted");
+        ::DBus::MessageIter wi = sig.writer();
+        wi << sessionHandle;
+        emit_signal(sig);
+    }
+
+private:
+
+    /* unmarshalers (to unpack the DBus message before calling the actual interface method) */
+    ::DBus::Message _GetVersion_stub(const ::DBus::CallMessage &call)
+    {
+        Version argout = SessionGetVersion();
+        return Respond(call, [argout](::DBus::MessageIter& wi) { wi << argout; });
+    }
+    ::DBus::Message _CreateSession_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        std::string client; ri >> client;
+        uint32_t argout = CreateSession(client);
+        return Respond(call, [argout](::DBus::MessageIter& wi) { wi << argout; });
+    }
+    ::DBus::Message _DeleteSession_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t sessionHandle; ri >> sessionHandle;
+        DeleteSession(sessionHandle);
+        return Respond(call, [](::DBus::MessageIter& wi) {});
+    }
+    ::DBus::Message _GetSessionStatus_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t sessionHandle; ri >> sessionHandle;
+        int32_t argout = GetSessionStatus(sessionHandle);
+        return Respond(call, [argout](::DBus::MessageIter& wi) { wi << argout; });
+    }
+    ::DBus::Message _GetAllSessions_stub(const ::DBus::CallMessage &call)
+    {
+        std::vector< ::DBus::Struct< uint32_t, std::string > > argout = GetAllSessions();
+        return Respond(call, [argout](::DBus::MessageIter& wi) { wi << argout; });
+    }
+};
+
+class Routing_adaptor
+: public ::DBus::InterfaceAdaptor, public virtual Replier
+{
+public:
+
+    Routing_adaptor()
+    : ::DBus::InterfaceAdaptor("org.genivi.navigationcore.Routing")
+    {
+        register_method(Routing_adaptor, GetVersion, _GetVersion_stub);
+        register_method(Routing_adaptor, CreateRoute, _CreateRoute_stub);
+        register_method(Routing_adaptor, DeleteRoute, _DeleteRoute_stub);
+        register_method(Routing_adaptor, SetWaypoints, _SetWaypoints_stub);
+        register_method(Routing_adaptor, GetWaypoints, _GetWaypoints_stub);
+        register_method(Routing_adaptor, CalculateRoute, _CalculateRoute_stub);
+        register_method(Routing_adaptor, CancelRouteCalculation, _CancelRouteCalculation_stub);
+        register_method(Routing_adaptor, GetRouteSegments, _GetRouteSegments_stub);
+        register_method(Routing_adaptor, GetRouteBoundingBox, _GetRouteBoundingBox_stub);
+        register_method(Routing_adaptor, GetAllRoutes, _GetAllRoutes_stub);
+    }
+
+public:
+
+    /* methods exported by this interface */
+    virtual Version RoutingGetVersion() = 0;
+    virtual uint32_t CreateRoute(const uint32_t& sessionHandle) = 0;
+    virtual void DeleteRoute(const uint32_t& sessionHandle, const uint32_t& routeHandle) = 0;
+    virtual void SetWaypoints(const uint32_t& sessionHandle, const uint32_t& routeHandle, const bool& startFromCurrentPosition, const std::vector< ValueMap >& waypointsList) = 0;
+    virtual void GetWaypoints(const uint32_t& routeHandle, bool& startFromCurrentPosition, std::vector< ValueMap >& waypointsList) = 0;
+    virtual void CalculateRoute(const uint32_t& sessionHandle, const uint32_t& routeHandle) = 0;
+    virtual void CancelRouteCalculation(const uint32_t& sessionHandle, const uint32_t& routeHandle) = 0;
+    virtual void GetRouteSegments(const uint32_t& routeHandle, const int16_t& detailLevel, const std::vector< int32_t >& valuesToReturn, const uint32_t& numberOfSegments, const uint32_t& offset, uint32_t& totalNumberOfSegments, std::vector< ValueMap >& routeSegments) = 0;
+    virtual ::DBus::Struct< ::DBus::Struct< double, double >, ::DBus::Struct< double, double > > GetRouteBoundingBox(const uint32_t& routeHandle) = 0;
+    virtual std::vector< uint32_t > GetAllRoutes() = 0;
+
+public:
+
+    /* signal emitters for this interface */
+    void RouteDeleted(const uint32_t& routeHandle)
+    {
+        ::DBus::SignalMessage sig("RouteDeleted");
+        ::DBus::MessageIter wi = sig.writer();
+        wi << routeHandle;
+        emit_signal(sig);
+    }
+    void RouteCalculationCancelled(const uint32_t& routeHandle)
+    {
+        ::DBus::SignalMessage sig("RouteCalculationCancelled");
+        ::DBus::MessageIter wi = sig.writer();
+        wi << routeHandle;
+        emit_signal(sig);
+    }
+    void RouteCalculationSuccessful(const uint32_t& routeHandle, const std::map< int32_t, int32_t >& unfullfilledPreferences)
+    {
+        ::DBus::SignalMessage sig("RouteCalculationSuccessful");
+        ::DBus::MessageIter wi = sig.writer();
+        wi << routeHandle;
+        wi << unfullfilledPreferences;
+        emit_signal(sig);
+    }
+    void RouteCalculationFailed(const uint32_t& routeHandle, const int32_t& errorCode, const std::map< int32_t, int32_t >& unfullfilledPreferences)
+    {
+        ::DBus::SignalMessage sig("RouteCalculationFailed");
+        ::DBus::MessageIter wi = sig.writer();
+        wi << routeHandle;
+        wi << errorCode;
+        wi << unfullfilledPreferences;
+        emit_signal(sig);
+    }
+    void RouteCalculationProgressUpdate(const uint32_t& routeHandle, const int32_t& status, const uint8_t& percentage)
+    {
+        ::DBus::SignalMessage sig("RouteCalculationProgressUpdate");
+        ::DBus::MessageIter wi = sig.writer();
+        wi << routeHandle;
+        wi << status;
+        wi << percentage;
+        emit_signal(sig);
+    }
+
+private:
+
+    /* unmarshalers (to unpack the DBus message before calling the actual interface method) */
+    ::DBus::Message _GetVersion_stub(const ::DBus::CallMessage &call)
+    {
+        Version argout = RoutingGetVersion();
+        return Respond(call, [argout](::DBus::MessageIter& wi) { wi << argout; });
+    }
+    ::DBus::Message _CreateRoute_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t sessionHandle; ri >> sessionHandle;
+        uint32_t argout = CreateRoute(sessionHandle);
+        return Respond(call, [argout](::DBus::MessageIter& wi) { wi << argout; });
+    }
+    ::DBus::Message _DeleteRoute_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t sessionHandle; ri >> sessionHandle;
+        uint32_t routeHandle; ri >> routeHandle;
+        DeleteRoute(sessionHandle, routeHandle);
+        return Respond(call, [](::DBus::MessageIter& wi) {});
+    }
+    ::DBus::Message _SetWaypoints_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t sessionHandle; ri >> sessionHandle;
+        uint32_t routeHandle; ri >> routeHandle;
+        bool startFromCurrentPosition; ri >> startFromCurrentPosition;
+        std::vector< ValueMap > waypointsList; ri >> waypointsList;
+        SetWaypoints(sessionHandle, routeHandle, startFromCurrentPosition, waypointsList);
+        return Respond(call, [](::DBus::MessageIter& wi) {});
+    }
+    ::DBus::Message _GetWaypoints_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t routeHandle; ri >> routeHandle;
+        bool startFromCurrentPosition = false;
+        std::vector< ValueMap > waypointsList;
+        GetWaypoints(routeHandle, startFromCurrentPosition, waypointsList);
+        return Respond(call, [startFromCurrentPosition, waypointsList](::DBus::MessageIter& wi) {
+            wi << startFromCurrentPosition;
+            wi << waypointsList;
+        });
+    }
+    ::DBus::Message _CalculateRoute_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t sessionHandle; ri >> sessionHandle;
+        uint32_t routeHandle; ri >> routeHandle;
+        CalculateRoute(sessionHandle, routeHandle);
+        return Respond(call, [](::DBus::MessageIter& wi) {});
+    }
+    ::DBus::Message _CancelRouteCalculation_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t sessionHandle; ri >> sessionHandle;
+        uint32_t routeHandle; ri >> routeHandle;
+        CancelRouteCalculation(sessionHandle, routeHandle);
+        return Respond(call, [](::DBus::MessageIter& wi) {});
+    }
+    ::DBus::Message _GetRouteSegments_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t routeHandle; ri >> routeHandle;
+        int16_t detailLevel; ri >> detailLevel;
+        std::vector< int32_t > valuesToReturn; ri >> valuesToReturn;
+        uint32_t numberOfSegments; ri >> numberOfSegments;
+        uint32_t offset; ri >> offset;
+        uint32_t totalNumberOfSegments = 0;
+        std::vector< ValueMap > routeSegments;
+        GetRouteSegments(routeHandle, detailLevel, valuesToReturn, numberOfSegments, offset, totalNumberOfSegments, routeSegments);
+        return Respond(call, [totalNumberOfSegments, routeSegments](::DBus::MessageIter& wi) {
+            wi << totalNumberOfSegments;
+            wi << routeSegments;
+        });
+    }
+    ::DBus::Message _GetRouteBoundingBox_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t routeHandle; ri >> routeHandle;
+        ::DBus::Struct< ::DBus::Struct< double, double >, ::DBus::Struct< double, double > > argout = GetRouteBoundingBox(routeHandle);
+        return Respond(call, [argout](::DBus::MessageIter& wi) { wi << argout; });
+    }
+    ::DBus::Message _GetAllRoutes_stub(const ::DBus::CallMessage &call)
+    {
+        std::vector< uint32_t > argout = GetAllRoutes();
+        return Respond(call, [argout](::DBus::MessageIter& wi) { wi << argout; });
+    }
+};
+
+class MapMatchedPosition_adaptor
+: public ::DBus::InterfaceAdaptor, public virtual Replier
+{
+public:
+
+    MapMatchedPosition_adaptor()
+    : ::DBus::InterfaceAdaptor("org.genivi.navigationcore.MapMatchedPosition")
+    {
+        register_method(MapMatchedPosition_adaptor, GetVersion, _GetVersion_stub);
+        register_method(MapMatchedPosition_adaptor, SetSimulationMode, _SetSimulationMode_stub);
+        register_method(MapMatchedPosition_adaptor, GetSimulationStatus, _GetSimulationStatus_stub);
+        register_method(MapMatchedPosition_adaptor, StartSimulation, _StartSimulation_stub);
+        register_method(MapMatchedPosition_adaptor, PauseSimulation, _PauseSimulation_stub);
+        register_method(MapMatchedPosition_adaptor, GetPosition, _GetPosition_stub);
+        register_method(MapMatchedPosition_adaptor, SetPosition, _SetPosition_stub);
+    }
+
+public:
+
+    /* methods exported by this interface */
+    virtual Version MapMatchedPositionGetVersion() = 0;
+    virtual void SetSimulationMode(const uint32_t& sessionHandle, const bool& activate) = 0;
+    virtual int32_t GetSimulationStatus() = 0;
+    virtual void StartSimulation(const uint32_t& sessionHandle) = 0;
+    virtual void PauseSimulation(const uint32_t& sessionHandle) = 0;
+    virtual ValueMap GetPosition(const std::vector< int32_t >& valuesToReturn) = 0;
+    virtual void SetPosition(const uint32_t& sessionHandle, const ValueMap& position) = 0;
+
+public:
+
+    /* signal emitters for this interface */
+    void SimulationStatusChanged(const int32_t& simulationStatus)
+    {
+        ::DBus::SignalMessage sig("SimulationStatusChanged");
+        ::DBus::MessageIter wi = sig.writer();
+        wi << simulationStatus;
+        emit_signal(sig);
+    }
+    void PositionUpdate(const std::vector< int32_t >& changedValues)
+    {
+        ::DBus::SignalMessage sig("PositionUpdate");
+        ::DBus::MessageIter wi = sig.writer();
+        wi << changedValues;
+        emit_signal(sig);
+    }
+
+private:
+
+    /* unmarshalers (to unpack the DBus message before calling the actual interface method) */
+    ::DBus::Message _GetVersion_stub(const ::DBus::CallMessage &call)
+    {
+        Version argout = MapMatchedPositionGetVersion();
+        return Respond(call, [argout](::DBus::MessageIter& wi) { wi << argout; });
+    }
+    ::DBus::Message _SetSimulationMode_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t sessionHandle; ri >> sessionHandle;
+        bool activate; ri >> activate;
+        SetSimulationMode(sessionHandle, activate);
+        return Respond(call, [](::DBus::MessageIter& wi) {});
+    }
+    ::DBus::Message _GetSimulationStatus_stub(const ::DBus::CallMessage &call)
+    {
+        int32_t argout = GetSimulationStatus();
+        return Respond(call, [argout](::DBus::MessageIter& wi) { wi << argout; });
+    }
+    ::DBus::Message _StartSimulation_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t sessionHandle; ri >> sessionHandle;
+        StartSimulation(sessionHandle);
+        return Respond(call, [](::DBus::MessageIter& wi) {});
+    }
+    ::DBus::Message _PauseSimulation_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t sessionHandle; ri >> sessionHandle;
+        PauseSimulation(sessionHandle);
+        return Respond(call, [](::DBus::MessageIter& wi) {});
+    }
+    ::DBus::Message _GetPosition_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        std::vector< int32_t > valuesToReturn; ri >> valuesToReturn;
+        ValueMap argout = GetPosition(valuesToReturn);
+        return Respond(call, [argout](::DBus::MessageIter& wi) { wi << argout; });
+    }
+    ::DBus::Message _SetPosition_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t sessionHandle; ri >> sessionHandle;
+        ValueMap position; ri >> position;
+        SetPosition(sessionHandle, position);
+        return Respond(call, [](::DBus::MessageIter& wi) {});
+    }
+};
+
+class Guidance_adaptor
+: public ::DBus::InterfaceAdaptor, public virtual Replier
+{
+public:
+
+    Guidance_adaptor()
+    : ::DBus::InterfaceAdaptor("org.genivi.navigationcore.Guidance")
+    {
+        register_method(Guidance_adaptor, GetVersion, _GetVersion_stub);
+        register_method(Guidance_adaptor, StartGuidance, _StartGuidance_stub);
+        register_method(Guidance_adaptor, StopGuidance, _StopGuidance_stub);
+        register_method(Guidance_adaptor, GetGuidanceStatus, _GetGuidanceStatus_stub);
+    }
+
+public:
+
+    /* methods exported by this interface */
+    virtual Version GuidanceGetVersion() = 0;
+    virtual void StartGuidance(const uint32_t& sessionHandle, const uint32_t& routeHandle) = 0;
+    virtual void StopGuidance(const uint32_t& sessionHandle) = 0;
+    virtual void GetGuidanceStatus(int32_t& guidanceStatus, uint32_t& routeHandle) = 0;
+
+public:
+
+    /* signal emitters for this interface */
+    void GuidanceStatusChanged(const int32_t& guidanceStatus, const uint32_t& routeHandle)
+    {
+        ::DBus::SignalMessage sig("GuidanceStatusChanged");
+        ::DBus::MessageIter wi = sig.writer();
+        wi << guidanceStatus;
+        wi << routeHandle;
+        emit_signal(sig);
+    }
+    void WaypointReached(const bool& isDestination)
+    {
+        ::DBus::SignalMessage sig("WaypointReached");
+        ::DBus::MessageIter wi = sig.writer();
+        wi << isDestination;
+        emit_signal(sig);
+    }
+    void PositionOnRouteChanged(const uint32_t& offsetOnRoute)
+    {
+        ::DBus::SignalMessage sig("PositionOnRouteChanged");
+        ::DBus::MessageIter wi = sig.writer();
+        wi << offsetOnRoute;
+        emit_signal(sig);
+    }
+    void ActiveRouteChanged(const int32_t& changeCause)
+    {
+        ::DBus::SignalMessage sig("ActiveRouteChanged");
+        ::DBus::MessageIter wi = sig.writer();
+        wi << changeCause;
+        emit_signal(sig);
+    }
+
+private:
+
+    /* unmarshalers (to unpack the DBus message before calling the actual interface method) */
+    ::DBus::Message _GetVersion_stub(const ::DBus::CallMessage &call)
+    {
+        Version argout = GuidanceGetVersion();
+        return Respond(call, [argout](::DBus::MessageIter& wi) { wi << argout; });
+    }
+    ::DBus::Message _StartGuidance_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t sessionHandle; ri >> sessionHandle;
+        uint32_t routeHandle; ri >> routeHandle;
+        StartGuidance(sessionHandle, routeHandle);
+        return Respond(call, [](::DBus::MessageIter& wi) {});
+    }
+    ::DBus::Message _StopGuidance_stub(const ::DBus::CallMessage &call)
+    {
+        ::DBus::MessageIter ri = call.reader();
+
+        uint32_t sessionHandle; ri >> sessionHandle;
+        StopGuidance(sessionHandle);
+        return Respond(call, [](::DBus::MessageIter& wi) {});
+    }
+    ::DBus::Message _GetGuidanceStatus_stub(const ::DBus::CallMessage &call)
+    {
+        int32_t guidanceStatus = 0;
+        uint32_t routeHandle = 0;
+        GetGuidanceStatus(guidanceStatus, routeHandle);
+        return Respond(call, [guidanceStatus, routeHandle](::DBus::MessageIter& wi) {
+            wi << guidanceStatus;
+            wi << routeHandle;
+        });
+    }
+};
+
+} } }
+
+#endif
@@ -0,0 +1,395 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+/*
+ *	Load driver of the naviapi binding, through libnavi.
+ *
+ *	Keeps a fixed number of requests in flight (closed loop) for a given
+ *	duration, then prints the throughput and the latency percentiles of
+ *	each verb, and the rate of the position events.
+ *
+ *	usage: navi_loadgen <port> <token> [-d seconds] [-c concurrency]
+ *	                    [-v verb,verb...] [-e event interval msec]
+ *	verbs: getposition getallroutes getallsessions createroute
+ */
+
+#include "libnavicore.hpp"
+#include "binder_metrics.h"
+#include "binder_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <deque>
+#include <atomic>
+
+/**
+ *  @brief A request not answered after this time is counted lost (msec)
+ */
+#define LOADGEN_TIMEOUT		5000
+
+/**
+ *  @brief Verbs that libnavi reports the reply of
+ */
+enum LoadVerb
+{
+	LOAD_GETPOSITION,
+	LOAD_GETALLROUTES,
+	LOAD_GETALLSESSIONS,
+	LOAD_CREATEROUTE,
+	LOAD_VERB_MAX
+};
+
+static const char* verbNames[LOAD_VERB_MAX] = { "getposition", "getallroutes", "getallsessions", "createroute" };
+
+/**
+ *  @brief Requests in flight and latencies of one verb
+ */
+struct LoadVerbState
+{
+	bool isEnabled;
+	std::deque< uint64_t > pending;		// usec, send time of each request in flight
+	uint64_t sent;
+	uint64_t received;
+	uint64_t lost;
+	LatencyHistogram latency;
+};
+
+/**
+ *  @brief Closed loop over the enabled verbs
+ */
+class LoadGenerator : public naviapi::NavicoreListener
+{
+public:
+	LoadGenerator() : next_(0), session_(0), isRunning_(false), events_(0)
+	{
+		pthread_mutex_init(&mutex_, NULL);
+		for (int i = 0; i < LOAD_VERB_MAX; i++)
+		{
+			verbs_[i].isEnabled = false;
+			verbs_[i].sent = verbs_[i].received = verbs_[i].lost = 0;
+		}
+	}
+
+	bool Enable( const char* name )
+	{
+		for (int i = 0; i < LOAD_VERB_MAX; i++)
+		{
+			if( strcmp(name, verbNames[i]) == 0 )
+			{
+				verbs_[i].isEnabled = true;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool Connect( int argc, char** argv )
+	{
+		return navicore_.connect(argc, argv, this);
+	}
+
+	/**
+	 *  @brief      Run the load
+	 *  @param[in]  duration Duration in sec
+	 *  @param[in]  concurrency Requests in flight
+	 *  @param[in]  eventInterval Interval of the position events in msec (0 : no subscription)
+	 */
+	void Run( uint32_t duration, uint32_t concurrency, uint32_t eventInterval )
+	{
+		// createroute needs a session
+		if( verbs_[LOAD_CREATEROUTE].isEnabled )
+		{
+			navicore_.getAllSessions();
+			for (int wait = 0; wait < 100 && session_ == 0; wait++)
+			{
+				usleep(10000);
+			}
+			if( session_ == 0 )
+			{
+				fprintf(stderr, "Error:no Genivi session, createroute disabled\n");
+				verbs_[LOAD_CREATEROUTE].isEnabled = false;
+			}
+		}
+
+		bool hasVerb = false;
+		for (int i = 0; i < LOAD_VERB_MAX; i++)
+		{
+			hasVerb = hasVerb || verbs_[i].isEnabled;
+		}
+		if( !hasVerb )
+		{
+			return;
+		}
+
+		if( eventInterval > 0 )
+		{
+			std::vector< int32_t > params;
+			params.push_back(naviapi::NAVICORE_LATITUDE);
+			params.push_back(naviapi::NAVICORE_LONGITUDE);
+			params.push_back(naviapi::NAVICORE_HEADING);
+			navicore_.subscribePosition(params, eventInterval);
+		}
+
+		uint64_t start = GetTimeUsec();
+		isRunning_ = true;
+		for (uint32_t i = 0; i < concurrency; i++)
+		{
+			SendNext();
+		}
+
+		uint64_t end = start + (uint64_t)duration * 1000000;
+		while( GetTimeUsec() < end )
+		{
+			usleep(100000);
+			ReplaceLost();
+		}
+		isRunning_ = false;
+		uint64_t elapsed = GetTimeUsec() - start;
+
+		if( eventInterval > 0 )
+		{
+			navicore_.unsubscribePosition();
+		}
+
+		// Let the requests in flight complete
+		usleep(LOADGEN_TIMEOUT * 1000 / 10);
+		Print(elapsed);
+	}
+
+	void getAllSessions_reply( const std::map< uint32_t, std::string >& allSessions )
+	{
+		if( session_ == 0 && !allSessions.empty() )
+		{
+			session_ = allSessions.begin()->first;
+		}
+		OnReply(LOAD_GETALLSESSIONS);
+	}
+
+	void getPosition_reply( const naviapi::Position& position )
+	{
+		OnReply(LOAD_GETPOSITION);
+	}
+
+	void getAllRoutes_reply( std::vector< uint32_t > allRoutes )
+	{
+		OnReply(LOAD_GETALLROUTES);
+	}
+
+	void createRoute_reply( uint32_t routeHandle )
+	{
+		OnReply(LOAD_CREATEROUTE);
+	}
+
+	void position_event( const naviapi::Position& position )
+	{
+		events_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+private:
+	naviapi::Navicore navicore_;
+	LoadVerbState verbs_[LOAD_VERB_MAX];
+	pthread_mutex_t mutex_;
+	int next_;			// next verb of the round robin
+	uint32_t session_;
+	std::atomic< bool > isRunning_;
+	std::atomic< uint64_t > events_;
+
+	/**
+	 *  @brief  Send the next verb of the round robin
+	 */
+	void SendNext()
+	{
+		pthread_mutex_lock(&mutex_);
+		int verb = next_;
+		for (int i = 0; i < LOAD_VERB_MAX; i++)
+		{
+			verb = (next_ + i) % LOAD_VERB_MAX;
+			if( verbs_[verb].isEnabled )
+			{
+				break;
+			}
+		}
+		next_ = (verb + 1) % LOAD_VERB_MAX;
+		verbs_[verb].pending.push_back(GetTimeUsec());
+		verbs_[verb].sent++;
+		pthread_mutex_unlock(&mutex_);
+
+		switch( verb )
+		{
+		case LOAD_GETPOSITION:
+		{
+			std::vector< int32_t > params;
+			params.push_back(naviapi::NAVICORE_LATITUDE);
+			params.push_back(naviapi::NAVICORE_LONGITUDE);
+			params.push_back(naviapi::NAVICORE_HEADING);
+			params.push_back(naviapi::NAVICORE_SIMULATION_MODE);
+			navicore_.getPosition(params);
+			break;
+		}
+		case LOAD_GETALLROUTES:
+			navicore_.getAllRoutes();
+			break;
+		case LOAD_GETALLSESSIONS:
+			navicore_.getAllSessions();
+			break;
+		case LOAD_CREATEROUTE:
+			navicore_.createRoute(session_);
+			break;
+		}
+	}
+
+	/**
+	 *  @brief  Record a reply and send the next request.
+	 *          Replies of a verb come back in the order of the requests.
+	 */
+	void OnReply( LoadVerb verb )
+	{
+		pthread_mutex_lock(&mutex_);
+		LoadVerbState& state = verbs_[verb];
+		if( state.pending.empty() )
+		{
+			// Reply of a request counted lost, or of the setup
+			pthread_mutex_unlock(&mutex_);
+			return;
+		}
+		state.latency.Record(GetTimeUsec() - state.pending.front());
+		state.pending.pop_front();
+		state.received++;
+		pthread_mutex_unlock(&mutex_);
+
+		if( isRunning_ )
+		{
+			SendNext();
+		}
+	}
+
+	/**
+	 *  @brief  Replace the requests without reply (error replies are not
+	 *          reported by libnavi) to keep the concurrency
+	 */
+	void ReplaceLost()
+	{
+		uint64_t limit = GetTimeUsec() - LOADGEN_TIMEOUT * 1000;
+		uint32_t count = 0;
+
+		pthread_mutex_lock(&mutex_);
+		for (int i = 0; i < LOAD_VERB_MAX; i++)
+		{
+			while( !verbs_[i].pending.empty() && verbs_[i].pending.front() < limit )
+			{
+				verbs_[i].pending.pop_front();
+				verbs_[i].lost++;
+				count++;
+			}
+		}
+		pthread_mutex_unlock(&mutex_);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			SendNext();
+		}
+	}
+
+	void Print( uint64_t elapsed )
+	{
+		printf("%-16s %10s %10s %6s %10s %8s %8s %8s %8s\n",
+		       "verb", "replies", "req/s", "lost", "mean(us)", "p50", "p90", "p99", "max");
+
+		pthread_mutex_lock(&mutex_);
+		for (int i = 0; i < LOAD_VERB_MAX; i++)
+		{
+			if( verbs_[i].sent == 0 )
+			{
+				continue;
+			}
+
+			json_object* latency = verbs_[i].latency.ToJson();
+			json_object* value;
+			int64_t stats[5] = { 0 };
+			const char* keys[5] = { "mean", "p50", "p90", "p99", "max" };
+			for (int k = 0; k < 5; k++)
+			{
+				if( json_object_object_get_ex(latency, keys[k], &value) )
+				{
+					stats[k] = json_object_get_int64(value);
+				}
+			}
+			json_object_put(latency);
+
+			printf("%-16s %10llu %10.1f %6llu %10lld %8lld %8lld %8lld %8lld\n", verbNames[i],
+			       (unsigned long long)verbs_[i].received, verbs_[i].received * 1000000.0 / elapsed,
+			       (unsigned long long)verbs_[i].lost,
+			       (long long)stats[0], (long long)stats[1], (long long)stats[2], (long long)stats[3], (long long)stats[4]);
+		}
+		pthread_mutex_unlock(&mutex_);
+
+		printf("position events: %llu (%.1f/s)\n", (unsigned long long)events_.load(),
+		       events_.load() * 1000000.0 / elapsed);
+	}
+};
+
+int main( int argc, char** argv )
+{
+	uint32_t duration = 10;
+	uint32_t concurrency = 1;
+	uint32_t eventInterval = 0;
+	const char* verbs = "getposition,getallroutes,getallsessions";
+
+	int opt;
+	while( (opt = getopt(argc, argv, "d:c:v:e:")) != -1 )
+	{
+		switch( opt )
+		{
+		case 'd': duration = strtoul(optarg, NULL, 10); break;
+		case 'c': concurrency = strtoul(optarg, NULL, 10); break;
+		case 'v': verbs = optarg; break;
+		case 'e': eventInterval = strtoul(optarg, NULL, 10); break;
+		default:
+			optind = argc;
+			break;
+		}
+	}
+
+	if( argc - optind != 2 || concurrency == 0 )
+	{
+		fprintf(stderr, "usage: %s [-d seconds] [-c concurrency] [-v verb,verb...] [-e event interval ms] <port> <token>\n", argv[0]);
+		return 1;
+	}
+
+	LoadGenerator generator;
+
+	std::string verbList(verbs);
+	size_t pos = 0;
+	bool hasVerb = false;
+	while( pos <= verbList.size() )
+	{
+		size_t comma = verbList.find(',', pos);
+		std::string name = verbList.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+		if( !generator.Enable(name.c_str()) )
+		{
+			fprintf(stderr, "Error:unknown verb %s\n", name.c_str());
+			return 1;
+		}
+		hasVerb = true;
+		if( comma == std::string::npos )
+		{
+			break;
+		}
+		pos = comma + 1;
+	}
+
+	// libnavi expects the port and the token as its only arguments
+	char* connectArgv[3] = { argv[0], argv[optind], argv[optind + 1] };
+	if( !hasVerb || !generator.Connect(3, connectArgv) )
+	{
+		fprintf(stderr, "Error:cannot connect to naviapi\n");
+		return 1;
+	}
+
+	generator.Run(duration, concurrency, eventInterval);
+
+	return 0;
+}
@@ -0,0 +1,854 @@
+// Copyright 2017 AW SOFTWARE CO.,LTD
+// Copyright 2017 AISIN AW CO.,LTD
+
+/*
+ *	Stand-in for the GENIVI navigation core, to load the binding without it.
+ *
+ *	Serves the Session, Routing, MapMatchedPosition and Guidance interfaces
+ *	at /org/genivi/navicore on the session bus. Routes are straight lines
+ *	between waypoints cut in short segments, and the vehicle drives along the
+ *	last calculated route (or around its start point) at a fixed speed.
+ *
+ *	usage: navicore_mock [-l latency] [-r calculation] [-p rate] [-s speed]
+ *	                     [-g segment] [-n name] [-x latitude] [-y longitude]
+ */
+
+#include "genivi-navigationcore-adaptor.h"
+#include "genivi/genivi-navicore-constants.h"
+#include "binder_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <math.h>
+#include <algorithm>
+#include <map>
+#include <list>
+#include <vector>
+#include <string>
+
+using namespace org::genivi::navigationcore;
+
+#define EARTH_RADIUS	6371000.0	// m
+#define DEG_TO_RAD	(M_PI / 180.0)
+
+/**
+ *  @brief Options of the service
+ */
+struct MockOptions
+{
+	uint32_t latency;		// msec, delay of every method reply
+	uint32_t calculationTime;	// msec, from CalculateRoute to RouteCalculationSuccessful
+	uint32_t positionRate;		// PositionUpdate per second (0 : none)
+	double speed;			// km/h
+	double segmentLength;		// m
+	const char* busName;
+	double latitude;		// start position
+	double longitude;
+};
+
+/**
+ *  @brief Point of a route
+ */
+struct MockPoint
+{
+	double latitude;
+	double longitude;
+};
+
+/**
+ *  @brief Route of the service
+ */
+struct MockRoute
+{
+	uint32_t session;
+	bool startFromCurrentPosition;
+	std::vector< ValueMap > waypoints;
+	std::vector< MockPoint > points;	// route polyline, empty until calculated
+	std::vector< double > offsets;		// m, distance from the start to each point
+	uint64_t calculationEnd;		// msec, 0 when not calculating
+	int progress;				// percentage of the calculation already notified
+};
+
+/**
+ *  @brief      Distance between two points
+ *  @param[in]  a First point
+ *  @param[in]  b Second point
+ *  @return     Distance in m (haversine)
+ */
+static double Distance( const MockPoint& a, const MockPoint& b )
+{
+	double dlat = (b.latitude - a.latitude) * DEG_TO_RAD;
+	double dlon = (b.longitude - a.longitude) * DEG_TO_RAD;
+	double h = sin(dlat / 2) * sin(dlat / 2)
+		+ cos(a.latitude * DEG_TO_RAD) * cos(b.latitude * DEG_TO_RAD) * sin(dlon / 2) * sin(dlon / 2);
+	return 2 * EARTH_RADIUS * asin(sqrt(h));
+}
+
+/**
+ *  @brief      Direction from a point to another
+ *  @param[in]  a Start point
+ *  @param[in]  b End point
+ *  @return     Heading in degrees, 0 is north, clockwise
+ */
+static uint32_t Heading( const MockPoint& a, const MockPoint& b )
+{
+	double dlon = (b.longitude - a.longitude) * DEG_TO_RAD;
+	double y = sin(dlon) * cos(b.latitude * DEG_TO_RAD);
+	double x = cos(a.latitude * DEG_TO_RAD) * sin(b.latitude * DEG_TO_RAD)
+		- sin(a.latitude * DEG_TO_RAD) * cos(b.latitude * DEG_TO_RAD) * cos(dlon);
+	double heading = atan2(y, x) / DEG_TO_RAD;
+	return (uint32_t)(heading < 0 ? heading + 360 : heading) % 360;
+}
+
+/**
+ *  @brief      Value of a Genivi key and value map
+ *  @param[in]  type D-Bus type of the value
+ *  @return     Entry whose variant is to be written
+ */
+static ::DBus::Struct< uint8_t, ::DBus::Variant > Value( char type )
+{
+	::DBus::Struct< uint8_t, ::DBus::Variant > value;
+	value._1 = (uint8_t)type;
+	return value;
+}
+
+/**
+ *  @brief Navigation core served on D-Bus
+ */
+class MockNavicore :
+	public Session_adaptor,
+	public Routing_adaptor,
+	public MapMatchedPosition_adaptor,
+	public Guidance_adaptor,
+	public DBus::IntrospectableAdaptor,
+	public DBus::ObjectAdaptor
+{
+public:
+	MockNavicore( DBus::Connection& connection, DBus::BusDispatcher& dispatcher, const MockOptions& options )
+		: DBus::ObjectAdaptor(connection, "/org/genivi/navicore"),
+		  options_(options), sessionCount_(0), routeCount_(0), activeRoute_(0), guidedRoute_(0),
+		  simulationStatus_(NAVICORE_SIMULATION_STATUS_NO_SIMULATION), offset_(0), angle_(0),
+		  tickTimer_(1, true, &dispatcher), positionTimer_(NULL), positionTime_(GetTimeMsec())
+	{
+		start_.latitude = options.latitude;
+		start_.longitude = options.longitude;
+		position_ = start_;
+		heading_ = 0;
+
+		tickTimer_.expired = new DBus::Callback< MockNavicore, void, DBus::DefaultTimeout& >( this, &MockNavicore::OnTick );
+
+		if( options.positionRate > 0 )
+		{
+			positionTimer_ = new DBus::DefaultTimeout( 1000 / options.positionRate, true, &dispatcher );
+			positionTimer_->expired = new DBus::Callback< MockNavicore, void, DBus::DefaultTimeout& >( this, &MockNavicore::OnPositionTimer );
+		}
+	}
+
+	~MockNavicore()
+	{
+		delete positionTimer_;
+	}
+
+	/**
+	 *  @brief      Reply now, or after the configured latency
+	 *  @param[in]  call Method call
+	 *  @param[in]  writer Writes the output arguments
+	 *  @return     Reply to send now
+	 */
+	DBus::Message Respond( const DBus::CallMessage& call, const ReplyWriter& writer )
+	{
+		if( options_.latency == 0 )
+		{
+			DBus::ReturnMessage reply(call);
+			DBus::MessageIter wi = reply.writer();
+			writer(wi);
+			return reply;
+		}
+
+		DelayedReply delayed;
+		delayed.tag = new DBus::Tag();
+		delayed.writer = writer;
+		delayed_.insert(std::make_pair(GetTimeMsec() + options_.latency, delayed));
+
+		// The reply is sent by OnTick
+		return_later(delayed.tag);
+		return DBus::Message();
+	}
+
+	// Session
+	Version SessionGetVersion()
+	{
+		return GetVersion();
+	}
+
+	uint32_t CreateSession( const std::string& client )
+	{
+		sessions_[++sessionCount_] = client;
+		return sessionCount_;
+	}
+
+	void DeleteSession( const uint32_t& sessionHandle )
+	{
+		if( sessions_.erase(sessionHandle) == 0 )
+		{
+			throw DBus::ErrorInvalidArgs("unknown session");
+		}
+
+		// Routes of the session go with it
+		std::map< uint32_t, MockRoute >::iterator it = routes_.begin();
+		while( it != routes_.end() )
+		{
+			uint32_t routeHandle = it->first;
+			bool isOwned = (it->second.session == sessionHandle);
+			++it;
+			if( isOwned )
+			{
+				RemoveRoute(routeHandle);
+			}
+		}
+
+		SessionDeleted(sessionHandle);
+	}
+
+	int32_t GetSessionStatus( const uint32_t& sessionHandle )
+	{
+		return sessions_.count(sessionHandle) ? NAVICORE_AVAILABLE : NAVICORE_NOT_AVAILABLE;
+	}
+
+	std::vector< ::DBus::Struct< uint32_t, std::string > > GetAllSessions()
+	{
+		std::vector< ::DBus::Struct< uint32_t, std::string > > allSessions;
+		std::map< uint32_t, std::string >::iterator it;
+		for (it = sessions_.begin(); it != sessions_.end(); ++it)
+		{
+			::DBus::Struct< uint32_t, std::string > session;
+			session._1 = it->first;
+			session._2 = it->second;
+			allSessions.push_back(session);
+		}
+		return allSessions;
+	}
+
+	// Routing
+	Version RoutingGetVersion()
+	{
+		return GetVersion();
+	}
+
+	uint32_t CreateRoute( const uint32_t& sessionHandle )
+	{
+		CheckSession(sessionHandle);
+
+		MockRoute& route = routes_[++routeCount_];
+		route.session = sessionHandle;
+		route.startFromCurrentPosition = false;
+		route.calculationEnd = 0;
+		route.progress = 0;
+		return routeCount_;
+	}
+
+	void DeleteRoute( const uint32_t& sessionHandle, const uint32_t& routeHandle )
+	{
+		CheckSession(sessionHandle);
+		GetRoute(routeHandle);
+		RemoveRoute(routeHandle);
+	}
+
+	void SetWaypoints( const uint32_t& sessionHandle, const uint32_t& routeHandle, const bool& startFromCurrentPosition, const std::vector< ValueMap >& waypointsList )
+	{
+		CheckSession(sessionHandle);
+		MockRoute& route = GetRoute(routeHandle);
+		route.startFromCurrentPosition = startFromCurrentPosition;
+		route.waypoints = waypointsList;
+		route.points.clear();
+		route.offsets.clear();
+	}
+
+	void GetWaypoints( const uint32_t& routeHandle, bool& startFromCurrentPosition, std::vector< ValueMap >& waypointsList )
+	{
+		MockRoute& route = GetRoute(routeHandle);
+		startFromCurrentPosition = route.startFromCurrentPosition;
+		waypointsList = route.waypoints;
+	}
+
+	void CalculateRoute( const uint32_t& sessionHandle, const uint32_t& routeHandle )
+	{
+		CheckSession(sessionHandle);
+		MockRoute& route = GetRoute(routeHandle);
+		route.calculationEnd = GetTimeMsec() + options_.calculationTime;
+		route.progress = 0;
+	}
+
+	void CancelRouteCalculation( const uint32_t& sessionHandle, const uint32_t& routeHandle )
+	{
+		CheckSession(sessionHandle);
+		MockRoute& route = GetRoute(routeHandle);
+		if( route.calculationEnd != 0 )
+		{
+			route.calculationEnd = 0;
+			RouteCalculationCancelled(routeHandle);
+		}
+	}
+
+	void GetRouteSegments( const uint32_t& routeHandle, const int16_t& detailLevel, const std::vector< int32_t >& valuesToReturn,
+			const uint32_t& numberOfSegments, const uint32_t& offset, uint32_t& totalNumberOfSegments, std::vector< ValueMap >& routeSegments )
+	{
+		MockRoute& route = GetRoute(routeHandle);
+		totalNumberOfSegments = route.points.size() > 1 ? route.points.size() - 1 : 0;
+
+		for (uint32_t i = offset; i < totalNumberOfSegments && i - offset < numberOfSegments; i++)
+		{
+			ValueMap segment;
+			for (size_t v = 0; v < valuesToReturn.size(); v++)
+			{
+				AddSegmentValue(route, i, valuesToReturn[v], segment);
+			}
+			routeSegments.push_back(segment);
+		}
+	}
+
+	::DBus::Struct< ::DBus::Struct< double, double >, ::DBus::Struct< double, double > > GetRouteBoundingBox( const uint32_t& routeHandle )
+	{
+		MockRoute& route = GetRoute(routeHandle);
+		if( route.points.empty() )
+		{
+			throw DBus::ErrorInvalidArgs("route not calculated");
+		}
+
+		::DBus::Struct< ::DBus::Struct< double, double >, ::DBus::Struct< double, double > > box;
+		box._1._1 = box._2._1 = route.points[0].latitude;
+		box._1._2 = box._2._2 = route.points[0].longitude;
+		for (size_t i = 1; i < route.points.size(); i++)
+		{
+			box._1._1 = fmin(box._1._1, route.points[i].latitude);
+			box._1._2 = fmin(box._1._2, route.points[i].longitude);
+			box._2._1 = fmax(box._2._1, route.points[i].latitude);
+			box._2._2 = fmax(box._2._2, route.points[i].longitude);
+		}
+		return box;
+	}
+
+	std::vector< uint32_t > GetAllRoutes()
+	{
+		std::vector< uint32_t > allRoutes;
+		std::map< uint32_t, MockRoute >::iterator it;
+		for (it = routes_.begin(); it != routes_.end(); ++it)
+		{
+			allRoutes.push_back(it->first);
+		}
+		return allRoutes;
+	}
+
+	// MapMatchedPosition
+	Version MapMatchedPositionGetVersion()
+	{
+		return GetVersion();
+	}
+
+	void SetSimulationMode( const uint32_t& sessionHandle, const bool& activate )
+	{
+		CheckSession(sessionHandle);
+		SetSimulationStatus(activate ? NAVICORE_SIMULATION_STATUS_PAUSED : NAVICORE_SIMULATION_STATUS_NO_SIMULATION);
+	}
+
+	int32_t GetSimulationStatus()
+	{
+		return simulationStatus_;
+	}
+
+	void StartSimulation( const uint32_t& sessionHandle )
+	{
+		CheckSession(sessionHandle);
+		SetSimulationStatus(NAVICORE_SIMULATION_STATUS_RUNNING);
+	}
+
+	void PauseSimulation( const uint32_t& sessionHandle )
+	{
+		CheckSession(sessionHandle);
+		SetSimulationStatus(NAVICORE_SIMULATION_STATUS_PAUSED);
+	}
+
+	ValueMap GetPosition( const std::vector< int32_t >& valuesToReturn )
+	{
+		ValueMap position;
+		for (size_t i = 0; i < valuesToReturn.size(); i++)
+		{
+			::DBus::Struct< uint8_t, ::DBus::Variant > value;
+			switch( valuesToReturn[i] )
+			{
+			case NAVICORE_LATITUDE:
+				value = Value('d');
+				value._2.writer().append_double(position_.latitude);
+				break;
+			case NAVICORE_LONGITUDE:
+				value = Value('d');
+				value._2.writer().append_double(position_.longitude);
+				break;
+			case NAVICORE_HEADING:
+				value = Value('u');
+				value._2.writer().append_uint32(heading_);
+				break;
+			case NAVICORE_SPEED:
+				value = Value('i');
+				value._2.writer().append_int32(IsDriving() ? (int32_t)options_.speed : 0);
+				break;
+			case NAVICORE_TIMESTAMP:
+				value = Value('u');
+				value._2.writer().append_uint32((uint32_t)positionTime_);
+				break;
+			case NAVICORE_SIMULATION_MODE:
+				value = Value('b');
+				value._2.writer().append_bool(simulationStatus_ != NAVICORE_SIMULATION_STATUS_NO_SIMULATION);
+				break;
+			default:
+				continue;
+			}
+			position[valuesToReturn[i]] = value;
+		}
+		return position;
+	}
+
+	void SetPosition( const uint32_t& sessionHandle, const ValueMap& position )
+	{
+		CheckSession(sessionHandle);
+
+		std::vector< int32_t > changedValues;
+		ValueMap::const_iterator it;
+		for (it = position.begin(); it != position.end(); ++it)
+		{
+			::DBus::Variant value = it->second._2;
+			switch( it->first )
+			{
+			case NAVICORE_LATITUDE:
+				position_.latitude = value.reader().get_double();
+				break;
+			case NAVICORE_LONGITUDE:
+				position_.longitude = value.reader().get_double();
+				break;
+			case NAVICORE_HEADING:
+				heading_ = value.reader().get_uint32();
+				break;
+			default:
+				continue;
+			}
+			changedValues.push_back(it->first);
+		}
+
+		// Fixed until the next SetPosition or simulation start
+		SetSimulationStatus(NAVICORE_SIMULATION_STATUS_FIXED_POSITION);
+		positionTime_ = GetTimeMsec();
+		changedValues.push_back(NAVICORE_TIMESTAMP);
+		PositionUpdate(changedValues);
+	}
+
+	// Guidance
+	Version GuidanceGetVersion()
+	{
+		return GetVersion();
+	}
+
+	void StartGuidance( const uint32_t& sessionHandle, const uint32_t& routeHandle )
+	{
+		CheckSession(sessionHandle);
+		MockRoute& route = GetRoute(routeHandle);
+		if( route.points.empty() )
+		{
+			throw DBus::ErrorInvalidArgs("route not calculated");
+		}
+
+		guidedRoute_ = routeHandle;
+		SetActiveRoute(routeHandle);
+		GuidanceStatusChanged(NAVICORE_ACTIVE, routeHandle);
+	}
+
+	void StopGuidance( const uint32_t& sessionHandle )
+	{
+		CheckSession(sessionHandle);
+		if( guidedRoute_ != 0 )
+		{
+			guidedRoute_ = 0;
+			GuidanceStatusChanged(NAVICORE_INACTIVE, 0);
+		}
+	}
+
+	void GetGuidanceStatus( int32_t& guidanceStatus, uint32_t& routeHandle )
+	{
+		guidanceStatus = (guidedRoute_ != 0) ? NAVICORE_ACTIVE : NAVICORE_INACTIVE;
+		routeHandle = guidedRoute_;
+	}
+
+private:
+	/**
+	 *  @brief Reply sent after the latency
+	 */
+	struct DelayedReply
+	{
+		DBus::Tag* tag;
+		ReplyWriter writer;
+	};
+
+	MockOptions options_;
+	std::map< uint32_t, std::string > sessions_;
+	std::map< uint32_t, MockRoute > routes_;
+	uint32_t sessionCount_;
+	uint32_t routeCount_;
+	uint32_t activeRoute_;		// route the vehicle drives along
+	uint32_t guidedRoute_;
+	int32_t simulationStatus_;
+	MockPoint start_;
+	MockPoint position_;
+	uint32_t heading_;
+	double offset_;			// m, driven along the active route
+	double angle_;			// rad, driven around the start point without route
+	DBus::DefaultTimeout tickTimer_;
+	DBus::DefaultTimeout* positionTimer_;
+	uint64_t positionTime_;		// msec, last position change
+	std::multimap< uint64_t, DelayedReply > delayed_;
+
+	static Version GetVersion()
+	{
+		Version version;
+		version._1 = 3;
+		version._2 = 0;
+		version._3 = 0;
+		version._4 = "mock";
+		return version;
+	}
+
+	void CheckSession( uint32_t sessionHandle )
+	{
+		if( sessions_.count(sessionHandle) == 0 )
+		{
+			throw DBus::ErrorInvalidArgs("unknown session");
+		}
+	}
+
+	MockRoute& GetRoute( uint32_t routeHandle )
+	{
+		std::map< uint32_t, MockRoute >::iterator it = routes_.find(routeHandle);
+		if( it == routes_.end() )
+		{
+			throw DBus::ErrorInvalidArgs("unknown route");
+		}
+		return it->second;
+	}
+
+	void RemoveRoute( uint32_t routeHandle )
+	{
+		routes_.erase(routeHandle);
+		if( guidedRoute_ == routeHandle )
+		{
+			guidedRoute_ = 0;
+			GuidanceStatusChanged(NAVICORE_INACTIVE, 0);
+		}
+		if( activeRoute_ == routeHandle )
+		{
+			SetActiveRoute(0);
+		}
+		RouteDeleted(routeHandle);
+	}
+
+	void SetActiveRoute( uint32_t routeHandle )
+	{
+		if( activeRoute_ != routeHandle )
+		{
+			activeRoute_ = routeHandle;
+			offset_ = 0;
+			ActiveRouteChanged(NAVICORE_MANUAL);
+		}
+	}
+
+	void SetSimulationStatus( int32_t simulationStatus )
+	{
+		if( simulationStatus_ != simulationStatus )
+		{
+			simulationStatus_ = simulationStatus;
+			SimulationStatusChanged(simulationStatus);
+		}
+	}
+
+	bool IsDriving() const
+	{
+		return simulationStatus_ != NAVICORE_SIMULATION_STATUS_PAUSED
+		    && simulationStatus_ != NAVICORE_SIMULATION_STATUS_FIXED_POSITION;
+	}
+
+	/**
+	 *  @brief      Build the polyline of a route from its waypoints
+	 *  @param[in]  route Route to calculate
+	 *  @return     false if the route has less than two points
+	 */
+	bool Calculate( MockRoute& route )
+	{
+		std::vector< MockPoint > stops;
+		if( route.startFromCurrentPosition )
+		{
+			stops.push_back(position_);
+		}
+		for (size_t i = 0; i < route.waypoints.size(); i++)
+		{
+			ValueMap::iterator lat = route.waypoints[i].find(NAVICORE_LATITUDE);
+			ValueMap::iterator lon = route.waypoints[i].find(NAVICORE_LONGITUDE);
+			if( lat != route.waypoints[i].end() && lon != route.waypoints[i].end() )
+			{
+				MockPoint stop;
+				stop.latitude = lat->second._2.reader().get_double();
+				stop.longitude = lon->second._2.reader().get_double();
+				stops.push_back(stop);
+			}
+		}
+
+		if( stops.size() < 2 )
+		{
+			return false;
+		}
+
+		route.points.clear();
+		route.offsets.clear();
+		route.points.push_back(stops[0]);
+		route.offsets.push_back(0);
+
+		for (size_t i = 1; i < stops.size(); i++)
+		{
+			double length = Distance(stops[i - 1], stops[i]);
+			int count = (int)ceil(length / options_.segmentLength);
+			for (int step = 1; step <= count; step++)
+			{
+				MockPoint point;
+				point.latitude = stops[i - 1].latitude + (stops[i].latitude - stops[i - 1].latitude) * step / count;
+				point.longitude = stops[i - 1].longitude + (stops[i].longitude - stops[i - 1].longitude) * step / count;
+				route.offsets.push_back(route.offsets.back() + Distance(route.points.back(), point));
+				route.points.push_back(point);
+			}
+		}
+
+		return true;
+	}
+
+	void AddSegmentValue( const MockRoute& route, uint32_t index, int32_t key, ValueMap& segment )
+	{
+		const MockPoint& start = route.points[index];
+		const MockPoint& end = route.points[index + 1];
+		double length = route.offsets[index + 1] - route.offsets[index];
+		::DBus::Struct< uint8_t, ::DBus::Variant > value;
+
+		switch( key )
+		{
+		case NAVICORE_START_LATITUDE:
+			value = Value('d');
+			value._2.writer().append_double(start.latitude);
+			break;
+		case NAVICORE_START_LONGITUDE:
+			value = Value('d');
+			value._2.writer().append_double(start.longitude);
+			break;
+		case NAVICORE_END_LATITUDE:
+			value = Value('d');
+			value._2.writer().append_double(end.latitude);
+			break;
+		case NAVICORE_END_LONGITUDE:
+			value = Value('d');
+			value._2.writer().append_double(end.longitude);
+			break;
+		case NAVICORE_DISTANCE:
+			value = Value('d');
+			value._2.writer().append_double(length);
+			break;
+		case NAVICORE_TIME:
+			value = Value('u');
+			value._2.writer().append_uint32((uint32_t)(length * 3.6 / options_.speed + 0.5));
+			break;
+		case NAVICORE_SPEED:
+			value = Value('i');
+			value._2.writer().append_int32((int32_t)options_.speed);
+			break;
+		case NAVICORE_ROAD_NAME:
+			value = Value('s');
+			value._2.writer().append_string("mock road");
+			break;
+		default:
+			return;
+		}
+		segment[key] = value;
+	}
+
+	/**
+	 *  @brief  Delayed replies and route calculations, every msec
+	 */
+	void OnTick( DBus::DefaultTimeout& timeout )
+	{
+		uint64_t now = GetTimeMsec();
+
+		while( !delayed_.empty() && delayed_.begin()->first <= now )
+		{
+			DelayedReply delayed = delayed_.begin()->second;
+			delayed_.erase(delayed_.begin());
+
+			Continuation* reply = find_continuation(delayed.tag);
+			if( reply != NULL )
+			{
+				delayed.writer(reply->writer());
+				return_now(reply);
+			}
+			delete delayed.tag;
+		}
+
+		std::map< uint32_t, MockRoute >::iterator it;
+		for (it = routes_.begin(); it != routes_.end(); ++it)
+		{
+			MockRoute& route = it->second;
+			if( route.calculationEnd == 0 )
+			{
+				continue;
+			}
+
+			// Progress by steps of 25%
+			uint64_t remaining = route.calculationEnd > now ? route.calculationEnd - now : 0;
+			int progress = options_.calculationTime > 0 ? 100 - (int)(remaining * 100 / options_.calculationTime) : 100;
+			if( progress / 25 > route.progress / 25 && progress < 100 )
+			{
+				route.progress = progress;
+				RouteCalculationProgressUpdate(it->first, NAVICORE_SEARCHING, (uint8_t)progress);
+			}
+
+			if( remaining == 0 )
+			{
+				route.calculationEnd = 0;
+				std::map< int32_t, int32_t > unfullfilledPreferences;
+				if( Calculate(route) )
+				{
+					SetActiveRoute(it->first);
+					RouteCalculationSuccessful(it->first, unfullfilledPreferences);
+				}
+				else
+				{
+					RouteCalculationFailed(it->first, NAVICORE_UNREACHABLE_DESTINATION, unfullfilledPreferences);
+				}
+			}
+		}
+	}
+
+	/**
+	 *  @brief  Move the vehicle and notify its new position
+	 */
+	void OnPositionTimer( DBus::DefaultTimeout& timeout )
+	{
+		uint64_t now = GetTimeMsec();
+		double distance = options_.speed / 3.6 * (now - positionTime_) / 1000.0;
+		positionTime_ = now;
+
+		std::vector< int32_t > changedValues;
+		changedValues.push_back(NAVICORE_TIMESTAMP);
+
+		if( IsDriving() )
+		{
+			MockPoint previous = position_;
+			std::map< uint32_t, MockRoute >::iterator route = routes_.find(activeRoute_);
+
+			if( route != routes_.end() && route->second.points.size() > 1 )
+			{
+				const std::vector< MockPoint >& points = route->second.points;
+				const std::vector< double >& offsets = route->second.offsets;
+				bool isArrived = (offset_ + distance >= offsets.back());
+				offset_ = isArrived ? 0 : offset_ + distance;
+
+				// Segment of the new offset
+				size_t index = std::upper_bound(offsets.begin(), offsets.end(), offset_) - offsets.begin();
+				index = index == 0 ? 0 : (index >= points.size() ? points.size() - 2 : index - 1);
+				double length = offsets[index + 1] - offsets[index];
+				double ratio = length > 0 ? (offset_ - offsets[index]) / length : 0;
+				position_.latitude = points[index].latitude + (points[index + 1].latitude - points[index].latitude) * ratio;
+				position_.longitude = points[index].longitude + (points[index + 1].longitude - points[index].longitude) * ratio;
+
+				if( guidedRoute_ == activeRoute_ )
+				{
+					PositionOnRouteChanged((uint32_t)offset_);
+					if( isArrived )
+					{
+						WaypointReached(true);
+					}
+				}
+			}
+			else
+			{
+				// Circle of 500 m around the start point
+				angle_ += distance / 500.0;
+				position_.latitude = start_.latitude + 500.0 * cos(angle_) / EARTH_RADIUS / DEG_TO_RAD;
+				position_.longitude = start_.longitude + 500.0 * sin(angle_) / EARTH_RADIUS / DEG_TO_RAD / cos(start_.latitude * DEG_TO_RAD);
+			}
+
+			heading_ = Heading(previous, position_);
+			changedValues.push_back(NAVICORE_LATITUDE);
+			changedValues.push_back(NAVICORE_LONGITUDE);
+			changedValues.push_back(NAVICORE_HEADING);
+			changedValues.push_back(NAVICORE_SPEED);
+		}
+
+		PositionUpdate(changedValues);
+	}
+};
+
+static DBus::BusDispatcher dispatcher;
+
+static void OnSignal( int sig )
+{
+	dispatcher.leave();
+}
+
+int main( int argc, char** argv )
+{
+	MockOptions options;
+	options.latency = 0;
+	options.calculationTime = 200;
+	options.positionRate = 1;
+	options.speed = 50;
+	options.segmentLength = 25;
+	options.busName = "org.agl.naviapi";
+	options.latitude = 35.6586125;
+	options.longitude = 139.7454316;
+
+	int opt;
+	while( (opt = getopt(argc, argv, "l:r:p:s:g:n:x:y:")) != -1 )
+	{
+		switch( opt )
+		{
+		case 'l': options.latency = strtoul(optarg, NULL, 10); break;
+		case 'r': options.calculationTime = strtoul(optarg, NULL, 10); break;
+		case 'p': options.positionRate = strtoul(optarg, NULL, 10); break;
+		case 's': options.speed = atof(optarg); break;
+		case 'g': options.segmentLength = atof(optarg); break;
+		case 'n': options.busName = optarg; break;
+		case 'x': options.latitude = atof(optarg); break;
+		case 'y': options.longitude = atof(optarg); break;
+		default:
+			fprintf(stderr, "usage: %s [-l latency ms] [-r calculation ms] [-p position rate Hz] [-s speed km/h]\n"
+			                "          [-g segment length m] [-n bus name] [-x latitude] [-y longitude]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if( options.speed <= 0 || options.segmentLength <= 0 || options.positionRate > 1000 )
+	{
+		fprintf(stderr, "Error:invalid option value\n");
+		return 1;
+	}
+
+	signal(SIGINT, OnSignal);
+	signal(SIGTERM, OnSignal);
+
+	DBus::default_dispatcher = &dispatcher;
+	DBus::Connection conn = DBus::Connection::SessionBus();
+	conn.request_name(options.busName);
+
+	MockNavicore navicore(conn, dispatcher, options);
+
+	fprintf(stdout, "navicore_mock: %s ready (latency %u ms, calculation %u ms, %u positions/s)\n",
+	        options.busName, options.latency, options.calculationTime, options.positionRate);
+	fflush(stdout);
+
+	dispatcher.enter();
+
+	return 0;
+}
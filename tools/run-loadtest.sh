@@ -0,0 +1,35 @@
+#!/bin/sh
+# Copyright 2017 AW SOFTWARE CO.,LTD
+# Copyright 2017 AISIN AW CO.,LTD
+#
+# Run the binding against navicore_mock on a private session bus and load it
+# with navi_loadgen.
+#
+# usage: run-loadtest.sh <build dir> [navicore_mock options] -- [navi_loadgen options]
+# e.g.   run-loadtest.sh build -l 2 -p 50 -- -d 30 -c 8 -e 100
+
+BUILD=${1:?build directory}
+shift
+
+MOCK_OPTS=""
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do
+	MOCK_OPTS="$MOCK_OPTS $1"
+	shift
+done
+[ "$1" = "--" ] && shift
+
+PORT=${NAVI_LOADTEST_PORT:-1234}
+TOKEN=${NAVI_LOADTEST_TOKEN:-loadtest}
+
+eval $(dbus-launch --sh-syntax)
+trap 'kill $AFB_PID $MOCK_PID 2>/dev/null; kill $DBUS_SESSION_BUS_PID' EXIT
+
+"$BUILD"/navicore_mock $MOCK_OPTS &
+MOCK_PID=$!
+sleep 1
+
+afb-daemon --port=$PORT --token=$TOKEN --ldpaths="$BUILD" &
+AFB_PID=$!
+sleep 1
+
+"$BUILD"/navi_loadgen "$@" $PORT $TOKEN